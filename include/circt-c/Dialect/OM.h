@@ -103,6 +103,14 @@ typedef struct OMEvaluatorValue OMEvaluatorValue;
 /// Construct an Evaluator with an IR module.
 MLIR_CAPI_EXPORTED OMEvaluator omEvaluatorNew(MlirModule mod);
 
+/// Construct an Evaluator with an IR module. If `memoizeInstances` is set,
+/// instantiations of a class with identical actual parameters are evaluated
+/// only once. If `lazy` is set, the fields of an Object are evaluated when
+/// they are first read.
+MLIR_CAPI_EXPORTED OMEvaluator omEvaluatorNewWithOptions(MlirModule mod,
+                                                         bool memoizeInstances,
+                                                         bool lazy);
+
 /// Use the Evaluator to Instantiate an Object from its class name and actual
 /// parameters.
 MLIR_CAPI_EXPORTED OMEvaluatorValue
@@ -193,6 +193,9 @@ MLIR_CAPI_EXPORTED void
 circtFirtoolOptionsSetAddVivadoRAMAddressConflictSynthesisBugWorkaround(
     CirctFirtoolFirtoolOptions options, bool value);
 
+MLIR_CAPI_EXPORTED void circtFirtoolOptionsSetOptimizeMemoriesForSimulation(
+    CirctFirtoolFirtoolOptions options, bool value);
+
 MLIR_CAPI_EXPORTED void
 circtFirtoolOptionsSetCkgModuleName(CirctFirtoolFirtoolOptions options,
                                     MlirStringRef value);
@@ -0,0 +1,208 @@
+//===- BitParallelSimulation.h - Simulate many input patterns at once -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header declares a simulator for `hw`, `comb`, and `seq` logic that
+// evaluates a circuit on many input patterns at once. It is meant as a cheap
+// filter in front of formal tools, for example to refute equivalences before
+// handing them to a solver or to replay counterexamples.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_ANALYSIS_BITPARALLELSIMULATION_H
+#define CIRCT_ANALYSIS_BITPARALLELSIMULATION_H
+
+#include "circt/Support/LLVM.h"
+#include "mlir/IR/Value.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/DenseMap.h"
+#include <random>
+
+namespace mlir {
+class Block;
+class Operation;
+} // namespace mlir
+
+namespace circt {
+namespace analysis {
+
+/// A simulator evaluating the operations of a block on `64 * numWords` input
+/// patterns at once.
+///
+/// Values are stored bit-sliced: every bit of a value is represented by
+/// `numWords` consecutive words, and bit `j` of word `k` holds the bit's value
+/// in pattern `64 * k + j`. Bitwise logic, multiplexers, comparisons,
+/// additions and shifts thus process 64 patterns per word operation, and the
+/// loops over the words vectorize for larger `numWords`. Only divisions and
+/// remainders are evaluated pattern by pattern, using native integers up to 64
+/// bits and `APInt` beyond.
+///
+/// Registers are simulated cycle by cycle: `evaluate` computes all values from
+/// the current inputs and register states, and `step` then updates every
+/// register as if its clock had ticked once. Resets are treated as
+/// synchronous.
+///
+/// Results that the IR leaves undefined, such as a division by zero, are
+/// tracked per pattern, and propagate to all values depending on them.
+class BitParallelSimulator {
+public:
+  explicit BitParallelSimulator(unsigned numWords = 1);
+
+  /// Prepare the simulation of `block`. The block arguments are the inputs and
+  /// the terminator operands the outputs of the simulated circuit. Operations
+  /// without results are ignored. Unsupported operations and values of
+  /// unsupported types emit an error, unless `allowUnknown` is set, in which
+  /// case they and everything depending on them are simply not simulated.
+  LogicalResult compile(Block &block, bool allowUnknown = false);
+
+  unsigned getNumWords() const { return numWords; }
+  unsigned getNumPatterns() const { return 64 * numWords; }
+  ArrayRef<Value> getInputs() const { return inputs; }
+  ArrayRef<Value> getOutputs() const { return outputs; }
+
+  /// Return whether `value` is simulated.
+  bool isKnown(Value value) const { return slotIndices.count(value); }
+
+  /// Return the bit-sliced patterns of a simulated value.
+  ArrayRef<uint64_t> getWords(Value value) const;
+
+  /// Return the bit-sliced patterns of a simulated input, to be filled in by
+  /// the caller.
+  MutableArrayRef<uint64_t> getInputWords(unsigned input);
+
+  /// Return a mask of the patterns in which `value` is undefined, in the same
+  /// layout as a single bit of the value. Empty if `value` is always defined.
+  ArrayRef<uint64_t> getUndefinedMask(Value value) const;
+
+  /// Return whether `value` is defined in all patterns.
+  bool isDefined(Value value) const;
+
+  /// Return the value `value` takes in a single pattern.
+  APInt getPattern(Value value, unsigned pattern) const;
+
+  /// Set the value of an input in a single pattern.
+  void setInputPattern(unsigned input, unsigned pattern, const APInt &value);
+
+  /// Fill all inputs with uniformly random patterns.
+  void randomizeInputs(std::mt19937_64 &rng);
+
+  /// Set all registers to their preset value, or zero if they have none.
+  void resetRegisters();
+
+  /// Fill all registers with uniformly random patterns.
+  void randomizeRegisters(std::mt19937_64 &rng);
+
+  /// Compute all values from the current inputs and register states.
+  void evaluate();
+
+  /// Update the registers with the values computed by the last `evaluate`.
+  void step();
+
+private:
+  /// The storage of a simulated value.
+  struct Slot {
+    unsigned offset;
+    unsigned width;
+    /// The offset of the undefined mask, or `~0U` if always defined.
+    unsigned undefOffset = ~0U;
+  };
+
+  enum class Kind {
+    Copy,
+    And,
+    Or,
+    Xor,
+    Add,
+    Sub,
+    Mul,
+    DivU,
+    DivS,
+    ModU,
+    ModS,
+    Shl,
+    ShrU,
+    ShrS,
+    Eq,
+    Ne,
+    Ult,
+    Ule,
+    Ugt,
+    Uge,
+    Slt,
+    Sle,
+    Sgt,
+    Sge,
+    Mux,
+    Concat,
+    Extract,
+    Replicate,
+    Parity,
+    TruthTable,
+  };
+
+  static bool isDivision(Kind kind) {
+    return kind == Kind::DivU || kind == Kind::DivS || kind == Kind::ModU ||
+           kind == Kind::ModS;
+  }
+
+  struct Instruction {
+    Kind kind;
+    unsigned result;
+    SmallVector<unsigned, 2> operands;
+    /// The low bit of an extract, or the lookup table of a truth table.
+    uint64_t immediate = 0;
+    Operation *op = nullptr;
+  };
+
+  /// A register, referring to the slots of its state and inputs. Optional
+  /// inputs are `~0U` if absent; a `next` of `~0U` marks a register whose
+  /// inputs are not simulated.
+  struct Register {
+    unsigned state;
+    unsigned next = ~0U;
+    unsigned enable = ~0U;
+    unsigned reset = ~0U;
+    unsigned resetValue = ~0U;
+    APInt preset;
+  };
+
+  unsigned addSlot(Value value, unsigned width);
+  LogicalResult compileOperation(Operation *op, bool allowUnknown);
+  void allocateUndefinedMasks();
+  void execute(const Instruction &inst);
+  void executeDivision(const Instruction &inst);
+
+  uint64_t *getBit(unsigned slot, unsigned bit) {
+    return storage.data() + slots[slot].offset + bit * numWords;
+  }
+  const uint64_t *getBit(unsigned slot, unsigned bit) const {
+    return storage.data() + slots[slot].offset + bit * numWords;
+  }
+  uint64_t *getUndef(unsigned slot) {
+    return slots[slot].undefOffset == ~0U
+               ? nullptr
+               : storage.data() + slots[slot].undefOffset;
+  }
+
+  unsigned numWords;
+  SmallVector<Value> inputs, outputs;
+  SmallVector<Slot> slots;
+  DenseMap<Value, unsigned> slotIndices;
+  SmallVector<std::pair<unsigned, APInt>> constants;
+  SmallVector<Instruction> instructions;
+  SmallVector<Register> registers;
+
+  /// The values of all slots, followed by the undefined masks.
+  SmallVector<uint64_t> storage;
+  /// Temporary storage for the instructions and register updates.
+  SmallVector<uint64_t> scratch;
+};
+
+} // namespace analysis
+} // namespace circt
+
+#endif // CIRCT_ANALYSIS_BITPARALLELSIMULATION_H
@@ -59,8 +59,9 @@ using MemoryDependenceResult =
     DenseMap<Operation *, SmallVector<MemoryDependence>>;
 
 /// MemoryDependenceAnalysis traverses any AffineForOps in the FuncOp body and
-/// checks for affine memory access dependences. Non-affine memory dependences
-/// are currently not supported. Results are captured in a
+/// checks for affine memory access dependences. Non-affine memory accesses are
+/// only considered in scf.for loops, where accesses to the same memref are
+/// conservatively assumed to conflict. Results are captured in a
 /// MemoryDependenceResult, and an API is exposed to query dependences of a
 /// given Operation.
 /// TODO(mikeurbach): consider upstreaming this to MLIR's AffineAnalysis.
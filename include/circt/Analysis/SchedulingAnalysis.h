@@ -28,18 +28,18 @@ class FuncOp;
 namespace circt {
 namespace analysis {
 
-/// CyclicSchedulingAnalysis constructs a CyclicProblem for each AffineForOp by
-/// performing a memory dependence analysis and inserting dependences into the
-/// problem. The client should retrieve the partially complete problem to add
-/// and associate operator types.
+/// CyclicSchedulingAnalysis constructs a CyclicProblem for each AffineForOp and
+/// innermost scf::ForOp by performing a memory dependence analysis and
+/// inserting dependences into the problem. The client should retrieve the
+/// partially complete problem to add and associate operator types.
 struct CyclicSchedulingAnalysis {
   CyclicSchedulingAnalysis(Operation *funcOp, mlir::AnalysisManager &am);
 
-  scheduling::CyclicProblem &getProblem(mlir::affine::AffineForOp forOp);
+  scheduling::CyclicProblem &getProblem(Operation *forOp);
 
 private:
-  void analyzeForOp(mlir::affine::AffineForOp forOp,
-                    MemoryDependenceAnalysis memoryAnalysis);
+  template <typename ForOpTy>
+  void analyzeForOp(ForOpTy forOp, MemoryDependenceAnalysis memoryAnalysis);
 
   DenseMap<Operation *, scheduling::CyclicProblem> problems;
 };
@@ -27,6 +27,9 @@ namespace circt {
 #include "circt/Conversion/Passes.h.inc"
 
 std::unique_ptr<mlir::Pass> createConvertHWToBTOR2Pass(llvm::raw_ostream &os);
+std::unique_ptr<mlir::Pass>
+createConvertHWToBTOR2Pass(llvm::raw_ostream &os,
+                           const ConvertHWToBTOR2Options &options);
 std::unique_ptr<mlir::Pass> createConvertHWToBTOR2Pass();
 
 } // namespace circt
@@ -49,6 +49,15 @@ struct ImportVerilogOptions {
   /// Generate debug information in the form of debug dialect ops in the IR.
   bool debugInfo = false;
 
+  /// Print the memory used by the frontend after each of its phases to
+  /// stderr.
+  bool printMemoryUsage = false;
+
+  /// Convert the bodies of instantiated modules concurrently, following the
+  /// threading setting of the MLIR context. This is experimental: Slang lazily
+  /// evaluates and caches parts of the AST, which is not thread-safe.
+  bool parallelModuleBodies = false;
+
   //===--------------------------------------------------------------------===//
   // Include paths
   //===--------------------------------------------------------------------===//
@@ -18,10 +18,14 @@ class Namespace;
 #define GEN_PASS_DECL_CONVERTVERIFTOSMT
 #include "circt/Conversion/Passes.h.inc"
 
-/// Get the Verif to SMT conversion patterns.
+/// Get the Verif to SMT conversion patterns. If `reportBoundFunc` is not empty,
+/// the lowering of bounded model checking problems calls an external function
+/// of that name with the index of each checked bound and whether a violation
+/// was found.
 void populateVerifToSMTConversionPatterns(TypeConverter &converter,
                                           RewritePatternSet &patterns,
-                                          Namespace &names);
+                                          Namespace &names,
+                                          StringRef reportBoundFunc = {});
 
 } // namespace circt
 
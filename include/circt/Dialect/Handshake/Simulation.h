@@ -16,6 +16,7 @@
 
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/MLIRContext.h"
+#include <optional>
 #include <string>
 
 namespace circt {
@@ -24,6 +25,17 @@ bool simulate(llvm::StringRef toplevelFunction,
               llvm::ArrayRef<std::string> inputArgs,
               mlir::OwningOpRef<mlir::ModuleOp> &module,
               mlir::MLIRContext &context);
+
+/// Execute a handshake.func top-level function by first translating it into a
+/// flat execution plan with typed value slots, which avoids the per-token
+/// overheads of the interpreter. Results are identical to `simulate`. Returns
+/// std::nullopt without executing anything if the function uses constructs
+/// the compiled engine does not support, in which case callers should fall
+/// back to `simulate`.
+std::optional<bool> simulateCompiled(llvm::StringRef toplevelFunction,
+                                     llvm::ArrayRef<std::string> inputArgs,
+                                     mlir::OwningOpRef<mlir::ModuleOp> &module,
+                                     mlir::MLIRContext &context);
 } // namespace handshake
 } // namespace circt
 
@@ -0,0 +1,107 @@
+//===- Engine.h - Event-driven LLHD simulator -------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header declares the simulation engine behind `llhd-sim`. The engine
+// elaborates an `hw.module` hierarchy, compiles the logic of every module and
+// every `llhd.process` into closures over dense per-instance value slots, and
+// runs them on a delta-cycle scheduler driven by a timing wheel.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_DIALECT_LLHD_SIMULATOR_ENGINE_H
+#define CIRCT_DIALECT_LLHD_SIMULATOR_ENGINE_H
+
+#include "circt/Support/LLVM.h"
+#include "llvm/ADT/APInt.h"
+#include <memory>
+#include <string>
+
+namespace circt {
+namespace llhd {
+namespace sim {
+
+/// The format of the textual trace of signal changes.
+enum class TraceFormat {
+  /// Every change of every signal, at every delta and epsilon step.
+  Full,
+  /// Like `Full`, restricted to the signals of the root module.
+  Reduced,
+  /// The changed signals at the end of every real time step.
+  Merged,
+  /// Like `Merged`, restricted to the signals of the root module.
+  MergedReduce,
+  /// Like `Full`, restricted to signals with an explicit name.
+  NamedOnly,
+  /// No trace at all.
+  None,
+};
+
+/// A signal of the elaborated design.
+struct Signal {
+  /// The hierarchical name of the signal, such as `root/child/s`.
+  std::string path;
+  /// The name of the signal within its instance.
+  std::string name;
+  /// The index of the instance owning the signal.
+  unsigned instance;
+  /// Whether the signal was explicitly named in the IR.
+  bool named;
+  llvm::APInt value;
+};
+
+struct EngineOptions {
+  /// Stop after this many time steps, including the initial one. Zero runs
+  /// until no events are left.
+  uint64_t maxSteps = 0;
+  /// Stop before the first step later than this real time in femtoseconds.
+  /// Zero runs until no events are left.
+  uint64_t maxTime = 0;
+  /// The maximum number of consecutive delta and epsilon steps within a
+  /// single real time step, to catch combinational loops.
+  uint64_t maxDeltas = 100000;
+  TraceFormat traceFormat = TraceFormat::Full;
+};
+
+/// An event-driven simulator for designs made of `hw.module`s containing
+/// `llhd` signals and processes and `comb`, `hw`, and `sim` operations.
+///
+/// The module-level operations of every instance form an implicit process
+/// that re-runs whenever one of the signals or ports it reads changes. Each
+/// `llhd.process` resumes at its `llhd.wait` whenever one of the signals its
+/// observed values are probed from changes or its timeout expires. Drives are
+/// queued on a timing wheel and applied in time, delta, and epsilon order.
+class Engine {
+public:
+  Engine(mlir::ModuleOp module, StringRef root);
+  ~Engine();
+
+  /// Elaborate the hierarchy below the root module and compile all logic.
+  LogicalResult elaborate();
+
+  /// Run the simulation, writing the trace to `traceOS` and, if given, a
+  /// value change dump to `vcdOS`.
+  LogicalResult run(const EngineOptions &options, llvm::raw_ostream &traceOS,
+                    llvm::raw_ostream *vcdOS = nullptr);
+
+  /// Return all signals of the elaborated design.
+  ArrayRef<Signal> getSignals() const;
+
+  /// Return the hierarchical names of the elaborated instances. The instance
+  /// at index zero is the root.
+  ArrayRef<std::string> getInstancePaths() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl;
+};
+
+} // namespace sim
+} // namespace llhd
+} // namespace circt
+
+#endif // CIRCT_DIALECT_LLHD_SIMULATOR_ENGINE_H
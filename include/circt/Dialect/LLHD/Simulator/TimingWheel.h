@@ -0,0 +1,184 @@
+//===- TimingWheel.h - Event queue of the LLHD simulator --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header defines the simulation time of the LLHD simulator and the timing
+// wheel used to queue events on it.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_DIALECT_LLHD_SIMULATOR_TIMINGWHEEL_H
+#define CIRCT_DIALECT_LLHD_SIMULATOR_TIMINGWHEEL_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+namespace circt {
+namespace llhd {
+namespace sim {
+
+/// A point in simulation time: a real time in femtoseconds, refined by a
+/// delta step and an epsilon step.
+struct SimTime {
+  uint64_t time = 0;
+  uint64_t delta = 0;
+  uint64_t epsilon = 0;
+
+  /// Return the time reached by waiting `delay` from this time. A non-zero
+  /// real time delay starts a new time slot, a delta delay starts a new delta
+  /// step within the current time slot, and an epsilon delay only advances
+  /// the epsilon step.
+  SimTime operator+(const SimTime &delay) const {
+    if (delay.time)
+      return {time + delay.time, delay.delta, delay.epsilon};
+    if (delay.delta)
+      return {time, delta + delay.delta, delay.epsilon};
+    return {time, delta, epsilon + delay.epsilon};
+  }
+
+  bool operator<(const SimTime &other) const {
+    return std::tie(time, delta, epsilon) <
+           std::tie(other.time, other.delta, other.epsilon);
+  }
+  bool operator==(const SimTime &other) const {
+    return std::tie(time, delta, epsilon) ==
+           std::tie(other.time, other.delta, other.epsilon);
+  }
+  bool operator!=(const SimTime &other) const { return !(*this == other); }
+};
+
+/// A queue of items scheduled at points in simulation time.
+///
+/// The near future is covered by a ring of slots, each spanning `resolution`
+/// femtoseconds of real time. Scheduling into the ring and advancing it are
+/// constant-time operations. Items beyond the ring are kept in a heap and
+/// migrate into the ring as it advances. Delta and epsilon steps share the
+/// slot of their real time, which is where the bulk of the events of a
+/// typical design lands.
+template <typename T>
+class TimingWheel {
+public:
+  explicit TimingWheel(uint64_t resolution = 1000, unsigned numSlots = 256)
+      : resolution(resolution ? resolution : 1), slots(numSlots ? numSlots : 1) {
+  }
+
+  bool empty() const { return size == 0; }
+  size_t getSize() const { return size; }
+
+  /// Schedule `item` at `time`, which must not be earlier than the time of
+  /// the last `popNext`. Items scheduled at the same time are returned in the
+  /// order they were scheduled.
+  void schedule(SimTime time, T item) {
+    assert(time.time >= base && "cannot schedule into the past");
+    Entry entry{time, nextOrder++, std::move(item)};
+    ++size;
+    if (time.time < getHorizon())
+      insert(std::move(entry));
+    else
+      overflow.push(std::move(entry));
+  }
+
+  /// Return the earliest time at which an item is scheduled.
+  SimTime peekTime() {
+    advance();
+    auto &slot = slots[cursor];
+    SimTime earliest = slot.front().time;
+    for (auto &entry : slot)
+      if (entry.time < earliest)
+        earliest = entry.time;
+    return earliest;
+  }
+
+  /// Remove all items scheduled at the earliest time, append them to `items`
+  /// in the order they were scheduled, and return that time.
+  SimTime popNext(std::vector<T> &items) {
+    SimTime earliest = peekTime();
+    auto &slot = slots[cursor];
+    std::vector<Entry> ready;
+    auto it = std::stable_partition(
+        slot.begin(), slot.end(),
+        [&](const Entry &entry) { return entry.time != earliest; });
+    std::move(it, slot.end(), std::back_inserter(ready));
+    slot.erase(it, slot.end());
+    // Items migrated from the overflow heap may have been appended after
+    // items scheduled later, so restore the scheduling order.
+    std::sort(ready.begin(), ready.end(),
+              [](const Entry &a, const Entry &b) { return a.order < b.order; });
+    for (auto &entry : ready)
+      items.push_back(std::move(entry.item));
+    size -= ready.size();
+    inWheel -= ready.size();
+    return earliest;
+  }
+
+private:
+  struct Entry {
+    SimTime time;
+    uint64_t order;
+    T item;
+  };
+  struct Later {
+    bool operator()(const Entry &a, const Entry &b) const {
+      if (a.time != b.time)
+        return b.time < a.time;
+      return b.order < a.order;
+    }
+  };
+
+  uint64_t getHorizon() const { return base + resolution * slots.size(); }
+
+  void insert(Entry entry) {
+    size_t index = cursor + (entry.time.time - base) / resolution;
+    slots[index % slots.size()].push_back(std::move(entry));
+    ++inWheel;
+  }
+
+  /// Move items from the overflow heap into the ring up to its horizon.
+  void migrate() {
+    while (!overflow.empty() && overflow.top().time.time < getHorizon()) {
+      insert(overflow.top());
+      overflow.pop();
+    }
+  }
+
+  /// Advance the ring to the first non-empty slot.
+  void advance() {
+    assert(!empty() && "no items scheduled");
+    while (slots[cursor].empty()) {
+      if (inWheel == 0) {
+        // Jump straight to the next overflowing item.
+        uint64_t next = overflow.top().time.time;
+        base = next - next % resolution;
+      } else {
+        base += resolution;
+        cursor = (cursor + 1) % slots.size();
+      }
+      migrate();
+    }
+  }
+
+  uint64_t resolution;
+  std::vector<std::vector<Entry>> slots;
+  std::priority_queue<Entry, std::vector<Entry>, Later> overflow;
+  /// The real time at which the slot under the cursor starts.
+  uint64_t base = 0;
+  size_t cursor = 0;
+  size_t size = 0;
+  size_t inWheel = 0;
+  uint64_t nextOrder = 0;
+};
+
+} // namespace sim
+} // namespace llhd
+} // namespace circt
+
+#endif // CIRCT_DIALECT_LLHD_SIMULATOR_TIMINGWHEEL_H
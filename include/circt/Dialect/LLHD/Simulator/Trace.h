@@ -0,0 +1,97 @@
+//===- Trace.h - Signal traces of the LLHD simulator ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header declares the writers of the textual signal trace and of value
+// change dumps produced by `llhd-sim`.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_DIALECT_LLHD_SIMULATOR_TRACE_H
+#define CIRCT_DIALECT_LLHD_SIMULATOR_TRACE_H
+
+#include "circt/Dialect/LLHD/Simulator/Engine.h"
+#include "circt/Dialect/LLHD/Simulator/TimingWheel.h"
+#include "llvm/ADT/MapVector.h"
+#include <optional>
+
+namespace circt {
+namespace llhd {
+namespace sim {
+
+/// Writes the signal changes of every step in one of the textual trace
+/// formats.
+class TraceWriter {
+public:
+  TraceWriter(llvm::raw_ostream &os, TraceFormat format,
+              ArrayRef<Signal> signals);
+
+  /// Record the signals that changed in the step at `time`. The initial step
+  /// lists all signals.
+  void step(SimTime time, ArrayRef<unsigned> changed);
+
+  /// Write out any pending merged step.
+  void finish();
+
+private:
+  bool isTraced(unsigned signal) const;
+  void sortByPath(SmallVectorImpl<unsigned> &indices) const;
+  void flushMerged();
+
+  llvm::raw_ostream &os;
+  TraceFormat format;
+  ArrayRef<Signal> signals;
+  /// The position of every signal in the order of hierarchical names.
+  SmallVector<unsigned> rank;
+
+  /// The real time and last values of the signals changed in the current
+  /// real time step, for the merged formats.
+  std::optional<uint64_t> mergedTime;
+  llvm::MapVector<unsigned, APInt> mergedValues;
+};
+
+/// Writes a value change dump. VCD has no notion of delta or epsilon steps,
+/// so all changes within a real time step are folded into the value at its
+/// end.
+class VCDWriter {
+public:
+  VCDWriter(llvm::raw_ostream &os, ArrayRef<Signal> signals,
+            ArrayRef<std::string> instancePaths);
+
+  /// Write the declarations of all signals.
+  void writeHeader();
+
+  /// Record the signals that changed in the step at `time`. The initial step
+  /// lists all signals.
+  void step(SimTime time, ArrayRef<unsigned> changed);
+
+  /// Write out the pending real time step.
+  void finish();
+
+private:
+  void writeScope(unsigned instance);
+  void flush();
+
+  llvm::raw_ostream &os;
+  ArrayRef<Signal> signals;
+  ArrayRef<std::string> instancePaths;
+  /// The VCD identifier code of every signal.
+  SmallVector<std::string> codes;
+  /// The values last written to the dump.
+  SmallVector<std::optional<APInt>> dumped;
+  /// Whether the initial values have been written.
+  bool dumpedVars = false;
+
+  std::optional<uint64_t> pendingTime;
+  llvm::MapVector<unsigned, APInt> pendingValues;
+};
+
+} // namespace sim
+} // namespace llhd
+} // namespace circt
+
+#endif // CIRCT_DIALECT_LLHD_SIMULATOR_TRACE_H
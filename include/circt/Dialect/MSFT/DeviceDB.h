@@ -19,6 +19,8 @@
 #include "mlir/IR/Operation.h"
 #include "llvm/ADT/DenseMap.h"
 
+#include <map>
+
 namespace circt {
 namespace msft {
 
@@ -37,6 +39,11 @@ public:
   /// Iterate over all the primitive locations, executing 'callback' on each
   /// one.
   void foreach (function_ref<void(PhysLocationAttr)> callback) const;
+  /// Iterate over all the primitive locations without creating attributes for
+  /// them, executing 'callback' on each one.
+  void foreachLocation(
+      function_ref<void(PrimitiveType, size_t x, size_t y, size_t num)>
+          callback) const;
 
 private:
   using DimPrimitiveType = DenseSet<PrimitiveType>;
@@ -129,17 +136,35 @@ private:
   MLIRContext *ctxt;
   mlir::ModuleOp topMod;
 
+  // The dimensions are ordered so that bounded walks only visit the columns
+  // and rows within the bounds, and ordered walks need no sorting.
   using DimDevType = DenseMap<PrimitiveType, PlacementCell>;
-  using DimNumMap = DenseMap<size_t, DimDevType>;
-  using DimYMap = DenseMap<size_t, DimNumMap>;
-  using DimXMap = DenseMap<size_t, DimYMap>;
+  using DimNumMap = std::map<size_t, DimDevType>;
+  using DimYMap = std::map<size_t, DimNumMap>;
+  using DimXMap = std::map<size_t, DimYMap>;
   using RegionPlacements = SmallVector<PDPhysRegionOp>;
 
+  /// The rows of a column containing free cells of one primitive type, mapped
+  /// to the number of free cells in the row.
+  using FreeRows = std::map<size_t, unsigned>;
+
   /// Get the leaf node. Abstract this out to make it easier to change the
-  /// underlying data structure.
+  /// underlying data structure. Creates the leaf if the DB isn't seeded.
   PlacementCell *getLeaf(PhysLocationAttr);
+  /// Get the leaf node if it exists, without creating it.
+  PlacementCell *findLeaf(PhysLocationAttr);
+  /// Get the leaf node at a location, creating it as a free cell if needed.
+  PlacementCell &addLeaf(PrimitiveType, size_t x, size_t y, size_t num);
+
+  /// Set the op placed in a cell, keeping the free cell index up to date.
+  void setLeafOp(PlacementCell &, PhysLocationAttr, DynInstDataOpInterface);
+  /// Record that a cell became free or occupied.
+  void updateFreeRows(PrimitiveType, size_t x, size_t y, bool nowFree);
 
   DimXMap placements;
+  /// An index of the free cells for each column and primitive type, used to
+  /// find the nearest free cell in a column without walking the column.
+  DenseMap<std::pair<size_t, PrimitiveType>, FreeRows> freeRows;
   RegionPlacements regionPlacements;
   bool seeded;
 
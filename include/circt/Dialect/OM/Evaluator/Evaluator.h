@@ -23,13 +23,18 @@
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Allocator.h"
 
+#include <memory>
+#include <optional>
 #include <queue>
 #include <utility>
 
 namespace circt {
 namespace om {
 
+struct Evaluator;
+
 namespace evaluator {
 struct EvaluatorValue;
 
@@ -37,9 +42,55 @@ struct EvaluatorValue;
 /// primitive Attribute. Further refinement is expected.
 using EvaluatorValuePtr = std::shared_ptr<EvaluatorValue>;
 
-/// The fields of a composite Object, currently represented as a map. Further
-/// refinement is expected.
-using ObjectFields = SmallDenseMap<StringAttr, EvaluatorValuePtr>;
+/// The fields of a composite Object, indexed by their position in the
+/// Object's ObjectLayout.
+using ObjectFields = SmallVector<EvaluatorValuePtr>;
+
+/// The storage of the values created by an Evaluator. Values are allocated
+/// from a bump allocator together with their reference count, and are never
+/// freed individually. The arena is released once the Evaluator and all the
+/// values it created are gone.
+class ValueArena {
+public:
+  void *allocate(size_t size, size_t alignment) {
+    return allocator.Allocate(size, llvm::Align(alignment));
+  }
+
+  /// Return the number of bytes allocated for values so far.
+  size_t getBytesAllocated() const { return allocator.getBytesAllocated(); }
+
+private:
+  llvm::BumpPtrAllocator allocator;
+};
+
+/// An allocator for `std::allocate_shared` that places values in a
+/// ValueArena. Every value keeps its arena alive through the copy of the
+/// allocator stored next to its reference count, such that values handed out
+/// through the C API remain valid after the Evaluator is destroyed.
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+
+  ArenaAllocator(std::shared_ptr<ValueArena> arena) : arena(std::move(arena)) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *, size_t) {}
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const {
+    return arena == other.arena;
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const {
+    return arena != other.arena;
+  }
+
+  std::shared_ptr<ValueArena> arena;
+};
 
 /// Base class for evaluator runtime values.
 /// Enables the shared_from_this functionality so Evaluator Value pointers can
@@ -253,31 +304,107 @@ private:
   DenseMap<Attribute, EvaluatorValuePtr> elements;
 };
 
+/// The layout of the fields shared by all Objects of a Class. Fields are
+/// numbered in the order of the `om.class.field` ops in the Class body.
+class ObjectLayout {
+public:
+  ObjectLayout(om::ClassOp cls);
+
+  om::ClassOp getClassOp() const { return cls; }
+
+  /// Return the number of fields.
+  unsigned getNumFields() const { return names.size(); }
+
+  /// Return the names of the fields, in field number order.
+  ArrayRef<StringAttr> getFieldNames() const { return names; }
+
+  /// Return the field names sorted alphabetically.
+  ArrayAttr getSortedFieldNames() const { return sortedNames; }
+
+  /// Return the number of the field with the given name, if there is one.
+  std::optional<unsigned> getFieldIndex(StringAttr name) const;
+
+private:
+  om::ClassOp cls;
+  SmallVector<StringAttr> names;
+  DenseMap<StringAttr, unsigned> indices;
+  ArrayAttr sortedNames;
+};
+
 /// A composite Object, which has a type and fields.
 struct ObjectValue : EvaluatorValue {
-  ObjectValue(om::ClassOp cls, ObjectFields fields, Location loc)
-      : EvaluatorValue(cls.getContext(), Kind::Object, loc), cls(cls),
-        fields(std::move(fields)) {
+  ObjectValue(std::shared_ptr<const ObjectLayout> layout, ObjectFields fields,
+              Location loc)
+      : EvaluatorValue(layout->getClassOp().getContext(), Kind::Object, loc),
+        layout(std::move(layout)), fields(std::move(fields)) {
+    assert(this->fields.size() == this->layout->getNumFields() &&
+           "fields do not match the layout");
     markFullyEvaluated();
   }
 
   // Partially evaluated value.
+  ObjectValue(std::shared_ptr<const ObjectLayout> layout, Location loc)
+      : EvaluatorValue(layout->getClassOp().getContext(), Kind::Object, loc),
+        layout(std::move(layout)) {}
   ObjectValue(om::ClassOp cls, Location loc)
-      : EvaluatorValue(cls.getContext(), Kind::Object, loc), cls(cls) {}
+      : ObjectValue(std::make_shared<ObjectLayout>(cls), loc) {}
 
-  om::ClassOp getClassOp() const { return cls; }
-  const auto &getFields() const { return fields; }
+  om::ClassOp getClassOp() const { return layout->getClassOp(); }
+  const ObjectLayout &getLayout() const { return *layout; }
+
+  /// Return the fields, indexed by field number.
+  ArrayRef<EvaluatorValuePtr> getFields() const { return fields; }
 
-  void setFields(llvm::SmallDenseMap<StringAttr, EvaluatorValuePtr> newFields) {
+  void setFields(ObjectFields newFields) {
+    assert(newFields.size() == layout->getNumFields() &&
+           "fields do not match the layout");
     fields = std::move(newFields);
     markFullyEvaluated();
   }
 
+  /// Mark the Object as lazily evaluated. The Class body is evaluated in the
+  /// context of `actualParams` once one of the fields is read.
+  void setLazy(Evaluator *evaluator,
+               SmallVectorImpl<EvaluatorValuePtr> *actualParams) {
+    lazyEvaluator = evaluator;
+    lazyParams = actualParams;
+    markFullyEvaluated();
+  }
+
+  /// Return the Evaluator that still has to evaluate the fields of a lazily
+  /// evaluated Object, or null.
+  Evaluator *getLazyEvaluator() const { return lazyEvaluator; }
+  void detachLazyEvaluator() { lazyEvaluator = nullptr; }
+
+  /// Detach a lazily evaluated Object whose fields failed to evaluate. Later
+  /// reads of its fields fail instead of returning partially evaluated values.
+  void markLazyFailed() {
+    lazyEvaluator = nullptr;
+    lazyFailed = true;
+  }
+  bool hasLazyFailed() const { return lazyFailed; }
+
+  /// Return the actual parameters of a lazily evaluated Object.
+  SmallVectorImpl<EvaluatorValuePtr> *getLazyParameters() const {
+    return lazyParams;
+  }
+
+  /// Return true if the fields have been created. They may still refer to
+  /// partially evaluated values.
+  bool isExpanded() const { return fields.size() == layout->getNumFields(); }
+
+  /// Set the possibly partially evaluated fields of a lazily evaluated Object.
+  void expand(ObjectFields newFields) {
+    assert(newFields.size() == layout->getNumFields() &&
+           "fields do not match the layout");
+    fields = std::move(newFields);
+  }
+
   /// Return the type of the value, which is a ClassType.
   om::ClassType getObjectType() const {
-    auto clsConst = const_cast<ClassOp &>(cls);
-    return ClassType::get(clsConst.getContext(),
-                          FlatSymbolRefAttr::get(clsConst.getNameAttr()));
+    auto cls = getClassOp();
+    return ClassType::get(cls.getContext(),
+                          FlatSymbolRefAttr::get(cls.getNameAttr()));
   }
 
   Type getType() const { return getObjectType(); }
@@ -287,12 +414,17 @@ struct ObjectValue : EvaluatorValue {
     return e->getKind() == Kind::Object;
   }
 
-  /// Get a field of the Object by name.
+  /// Get a field of the Object by name. The fields of a lazily evaluated
+  /// Object are evaluated on first access.
   FailureOr<EvaluatorValuePtr> getField(StringAttr field);
   FailureOr<EvaluatorValuePtr> getField(StringRef field) {
     return getField(StringAttr::get(getContext(), field));
   }
 
+  /// Get a field of the Object by name, without evaluating it. The field may
+  /// be partially evaluated.
+  FailureOr<EvaluatorValuePtr> lookupField(StringAttr field);
+
   /// Get all the field names of the Object.
   ArrayAttr getFieldNames();
 
@@ -300,8 +432,11 @@ struct ObjectValue : EvaluatorValue {
   LogicalResult finalizeImpl();
 
 private:
-  om::ClassOp cls;
-  llvm::SmallDenseMap<StringAttr, EvaluatorValuePtr> fields;
+  std::shared_ptr<const ObjectLayout> layout;
+  ObjectFields fields;
+  Evaluator *lazyEvaluator = nullptr;
+  SmallVectorImpl<EvaluatorValuePtr> *lazyParams = nullptr;
+  bool lazyFailed = false;
 };
 
 /// Tuple values.
@@ -415,11 +550,23 @@ SmallVector<EvaluatorValuePtr>
 getEvaluatorValuesFromAttributes(MLIRContext *context,
                                  ArrayRef<Attribute> attributes);
 
+struct EvaluatorOptions {
+  /// Evaluate the instantiations of a Class with identical actual parameters
+  /// only once. Later instantiations get their own Object, whose fields refer
+  /// to the values of the first one.
+  bool memoizeInstances = false;
+
+  /// Evaluate the body of a Class only once a field of one of its Objects is
+  /// read, instead of evaluating the entire object graph upfront.
+  bool lazy = false;
+};
+
 /// An Evaluator, which is constructed with an IR module and can instantiate
 /// Objects. Further refinement is expected.
 struct Evaluator {
   /// Construct an Evaluator with an IR module.
-  Evaluator(ModuleOp mod);
+  Evaluator(ModuleOp mod, EvaluatorOptions options = {});
+  ~Evaluator();
 
   /// Instantiate an Object with its class name and actual parameters.
   FailureOr<evaluator::EvaluatorValuePtr>
@@ -436,7 +583,33 @@ struct Evaluator {
 
   using ObjectKey = std::pair<Value, ActualParameters>;
 
+  /// Evaluate the fields of a lazily evaluated Object, and everything they
+  /// depend on.
+  LogicalResult forceObject(evaluator::ObjectValue &object);
+
+  /// Return the number of instantiations answered from the memoization cache.
+  size_t getNumMemoizedInstances() const { return numMemoizedInstances; }
+
+  /// Return the number of bytes allocated for values so far.
+  size_t getBytesAllocated() const { return arena->getBytesAllocated(); }
+
 private:
+  /// Allocate a value or field layout in the arena.
+  template <typename ValueT, typename... Args>
+  std::shared_ptr<ValueT> allocate(Args &&...args) {
+    return std::allocate_shared<ValueT>(
+        evaluator::ArenaAllocator<ValueT>(arena), std::forward<Args>(args)...);
+  }
+
+  /// Return the field layout shared by the Objects of a Class.
+  std::shared_ptr<const evaluator::ObjectLayout> getObjectLayout(ClassOp cls);
+
+  /// Build the key identifying an instantiation of a Class with the given
+  /// actual parameters. Fails if a parameter is not evaluated far enough to be
+  /// compared.
+  LogicalResult getInstanceKey(ClassOp cls, ActualParameters actualParams,
+                               SmallVectorImpl<const void *> &key);
+
   bool isFullyEvaluated(Value value, ActualParameters key) {
     return isFullyEvaluated({value, key});
   }
@@ -448,6 +621,13 @@ private:
 
   FailureOr<EvaluatorValuePtr>
   getOrCreateValue(Value value, ActualParameters actualParams, Location loc);
+
+  /// Create the values of the Class body of a lazily evaluated Object and put
+  /// them on the worklist.
+  LogicalResult expandObject(evaluator::ObjectValue &object);
+
+  /// Evaluate the values on the worklist until all are fully evaluated.
+  LogicalResult evaluateWorklist(Location loc);
   FailureOr<EvaluatorValuePtr>
   allocateObjectInstance(StringAttr clasName, ActualParameters actualParams);
 
@@ -521,6 +701,33 @@ private:
   /// Evaluator value storage. Return an evaluator value for the given
   /// instantiation context (a pair of Value and parameters).
   DenseMap<ObjectKey, std::shared_ptr<evaluator::EvaluatorValue>> objects;
+
+  EvaluatorOptions options;
+
+  /// The arena owning all values created by this Evaluator.
+  std::shared_ptr<evaluator::ValueArena> arena;
+
+  /// The field layout of each Class instantiated so far.
+  DenseMap<Operation *, std::shared_ptr<const evaluator::ObjectLayout>>
+      layouts;
+
+  /// The first Object created for each instantiation key, if instances are
+  /// memoized. The keys are allocated in `instanceKeyAllocator`.
+  DenseMap<ArrayRef<const void *>, EvaluatorValuePtr> memoizedInstances;
+  llvm::BumpPtrAllocator instanceKeyAllocator;
+  size_t numMemoizedInstances = 0;
+
+  /// The lazily evaluated Objects returned by `instantiate`, which need to be
+  /// detached from the Evaluator when it is destroyed.
+  SmallVector<std::weak_ptr<evaluator::EvaluatorValue>> lazyInstances;
+
+  /// The lazily evaluated Objects expanded while forcing an Object. If the
+  /// force fails, all of them are left with partially evaluated fields.
+  SmallVector<evaluator::ObjectValue *> expandedObjects;
+
+  /// The actual parameters of lazily evaluated Objects whose class body
+  /// failed to evaluate. Memoized Objects sharing them fail as well.
+  SmallPtrSet<ActualParameters, 4> failedParameters;
 };
 
 /// Helper to enable printing objects in Diagnostics.
@@ -44,7 +44,7 @@ public:
             // Variable/symbol declaration
             DeclareFunOp, ApplyFuncOp,
             // solver interaction
-            SolverOp, AssertOp, CheckOp,
+            SolverOp, AssertOp, CheckOp, PushOp, PopOp,
             // Boolean logic
             NotOp, AndOp, OrOp, XOrOp, ImpliesOp,
             // Arrays
@@ -125,6 +125,8 @@ public:
   HANDLE(SolverOp, Unhandled);
   HANDLE(AssertOp, Unhandled);
   HANDLE(CheckOp, Unhandled);
+  HANDLE(PushOp, Unhandled);
+  HANDLE(PopOp, Unhandled);
 
   // Boolean logic operations
   HANDLE(NotOp, Unhandled);
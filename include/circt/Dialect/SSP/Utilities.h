@@ -166,6 +166,10 @@ ProblemT loadProblem(InstanceOp instOp,
   if (auto libName = libraryOp.getSymNameAttr())
     prob.setLibraryName(libName);
 
+  // Operations typically share a small number of operator types, so remember
+  // how each reference was resolved instead of looking it up every time.
+  SmallDenseMap<Attribute, Operation *> resolvedOperatorTypeRefs;
+
   // Register all operations first, in order to retain their original order.
   auto graphOp = instOp.getDependenceGraph();
   graphOp.walk([&](OperationOp opOp) {
@@ -185,9 +189,10 @@ ProblemT loadProblem(InstanceOp instOp,
     // type is available.
     SymbolRefAttr oprRef = opOp.getLinkedOperatorTypeAttr().getValue();
 
-    Operation *oprOp;
+    Operation *&oprOp = resolvedOperatorTypeRefs[oprRef];
     // 1) Look in the instance's library.
-    oprOp = SymbolTable::lookupSymbolIn(libraryOp, oprRef);
+    if (!oprOp)
+      oprOp = SymbolTable::lookupSymbolIn(libraryOp, oprRef);
     // 2) Try to resolve a nested reference to the instance's library.
     if (!oprOp)
       oprOp = SymbolTable::lookupSymbolIn(instOp, oprRef);
@@ -209,7 +214,10 @@ ProblemT loadProblem(InstanceOp instOp,
   });
 
   // Then walk them again, and load auxiliary dependences as well as any
-  // dependence properties.
+  // dependence properties. Build the symbol table lazily, as only instances
+  // with auxiliary dependences need it, but then do so only once to avoid
+  // scanning the entire graph for every dependence.
+  std::optional<SymbolTable> graphSymbols;
   graphOp.walk([&](OperationOp opOp) {
     ArrayAttr depsAttr = opOp.getDependencesAttr();
     if (!depsAttr)
@@ -218,7 +226,9 @@ ProblemT loadProblem(InstanceOp instOp,
     for (auto depAttr : depsAttr.getAsRange<DependenceAttr>()) {
       Dependence dep;
       if (FlatSymbolRefAttr sourceRef = depAttr.getSourceRef()) {
-        Operation *sourceOp = SymbolTable::lookupSymbolIn(graphOp, sourceRef);
+        if (!graphSymbols)
+          graphSymbols.emplace(graphOp);
+        Operation *sourceOp = graphSymbols->lookup(sourceRef.getAttr());
         assert(sourceOp);
         dep = Dependence(sourceOp, opOp);
         LogicalResult res = prob.insertDependence(dep);
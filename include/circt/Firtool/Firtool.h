@@ -129,6 +129,9 @@ public:
   bool shouldAddVivadoRAMAddressConflictSynthesisBugWorkaround() const {
     return addVivadoRAMAddressConflictSynthesisBugWorkaround;
   }
+  bool shouldOptimizeMemoriesForSimulation() const {
+    return optimizeMemoriesForSimulation;
+  }
   bool shouldExtractTestCode() const { return extractTestCode; }
   bool shouldFixupEICGWrapper() const { return fixupEICGWrapper; }
   bool shouldAddCompanionAssume() const { return addCompanionAssume; }
@@ -312,6 +315,11 @@ public:
     return *this;
   }
 
+  FirtoolOptions &setOptimizeMemoriesForSimulation(bool value) {
+    optimizeMemoriesForSimulation = value;
+    return *this;
+  }
+
   FirtoolOptions &setCkgModuleName(StringRef value) {
     ckgModuleName = value;
     return *this;
@@ -398,6 +406,7 @@ private:
   bool etcDisableRegisterExtraction;
   bool etcDisableModuleInlining;
   bool addVivadoRAMAddressConflictSynthesisBugWorkaround;
+  bool optimizeMemoriesForSimulation;
   std::string ckgModuleName;
   std::string ckgInputName;
   std::string ckgOutputName;
@@ -47,6 +47,12 @@ public:
   /// Return whether the file in the given path is interesting.
   bool isInteresting(llvm::StringRef testCase) const;
 
+  /// Run the interestingness testing script on multiple test cases
+  /// concurrently, in separate processes. Each test case caches the result as
+  /// if `TestCase::isInteresting` had been called on it. Invalid test cases and
+  /// test cases that have already been tested are skipped.
+  void testConcurrently(llvm::ArrayRef<TestCase *> testCases) const;
+
   /// Create a new test case for the given `module`.
   TestCase get(mlir::ModuleOp module) const;
 
@@ -54,6 +60,9 @@ public:
   TestCase get(llvm::Twine filepath) const;
 
 private:
+  /// Interpret the exit code of a tester process.
+  bool isInterestingResult(int result, llvm::StringRef errMsg) const;
+
   /// The binary to execute in order to check a reduction attempt for
   /// interestingness.
   llvm::StringRef testScript;
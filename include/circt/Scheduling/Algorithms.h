@@ -15,6 +15,8 @@
 
 #include "circt/Scheduling/Problems.h"
 
+#include <memory>
+
 namespace circt {
 namespace scheduling {
 
@@ -74,6 +76,40 @@ LogicalResult scheduleSimplex(ChainingProblem &prob, Operation *lastOp,
 LogicalResult scheduleSimplex(ChainingCyclicProblem &prob, Operation *lastOp,
                               float cycleTime);
 
+/// An incremental variant of the simplex schedulers for the basic `Problem` and
+/// the resource-free `CyclicProblem`, intended for clients that repeatedly
+/// re-schedule a slightly modified problem. The scheduler keeps its tableau
+/// between calls to `schedule()`. Changes to the problem must be made through
+/// this class, which applies them to the tableau in place, such that the next
+/// call continues from the previous optimal basis and typically needs only a
+/// few pivot steps. Changes that cannot be applied in place (e.g. new
+/// operations, or relaxing a cyclic problem, which might allow a smaller II)
+/// cause the next call to rebuild the tableau from scratch. The results are
+/// the same as with the corresponding `scheduleSimplex` function.
+class IncrementalSimplexScheduler {
+public:
+  IncrementalSimplexScheduler(Problem &prob, Operation *lastOp);
+  IncrementalSimplexScheduler(CyclicProblem &prob, Operation *lastOp);
+  ~IncrementalSimplexScheduler();
+
+  /// Solve the current problem and store the solution in it.
+  LogicalResult schedule();
+
+  /// Include \p dep in the problem. Fails if the problem rejects \p dep.
+  LogicalResult insertDependence(Problem::Dependence dep);
+  /// Remove the auxiliary dependence \p dep from the problem.
+  LogicalResult eraseDependence(Problem::Dependence dep);
+  /// Set the latency of \p opr in the problem.
+  void setLatency(Problem::OperatorType opr, unsigned latency);
+
+  /// Return the number of pivot steps performed by the last `schedule()` call.
+  unsigned getNumPivots();
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl;
+};
+
 /// Solve the basic problem using linear programming and an external LP solver.
 /// The objective is to minimize the start time of the given \p lastOp. Fails if
 /// the dependence graph contains cycles, or \p prob does not include \p lastOp.
@@ -150,6 +150,11 @@ public:
   /// The endpoints become registered operations w.r.t. the problem.
   LogicalResult insertDependence(Dependence dep);
 
+  /// Remove the auxiliary dependence \p dep from the scheduling problem. Return
+  /// failure if \p dep is a def-use dependence, as these are implied by the
+  /// SSA graph and cannot be removed. The endpoints remain registered.
+  LogicalResult eraseDependence(Dependence dep);
+
   /// Include \p opr in this scheduling problem.
   void insertOperatorType(OperatorType opr) { operatorTypes.insert(opr); }
 
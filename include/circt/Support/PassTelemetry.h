@@ -0,0 +1,88 @@
+//===- PassTelemetry.h - Machine-readable pass telemetry --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A pass instrumentation that records per-pass wall time, memory usage, IR
+// size deltas, and the thread utilization of parallel nested pipelines. The
+// collected events are written out in the Chrome trace-event JSON format, such
+// that they can be inspected in `chrome://tracing` or Perfetto, or diffed
+// across nightly builds to track compiler performance.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_SUPPORT_PASSTELEMETRY_H
+#define CIRCT_SUPPORT_PASSTELEMETRY_H
+
+#include "circt/Support/LLVM.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Chrono.h"
+#include <mutex>
+
+namespace circt {
+
+/// A collector for pass telemetry. One collector may be shared by the
+/// instrumentations of multiple pass managers, for example when a tool runs
+/// several pipelines in sequence, such that a single trace covers the entire
+/// run. All recording methods are thread-safe.
+class PassTelemetry {
+public:
+  using TimePoint = llvm::sys::TimePoint<>;
+
+  /// A single completed pass or pipeline execution.
+  struct Event {
+    std::string name;
+    /// Either "pass" or "pipeline".
+    StringRef category;
+    /// Name of the operation the pass or pipeline ran on.
+    std::string opName;
+    TimePoint start;
+    TimePoint end;
+    uint64_t threadId;
+    /// Number of operations nested under the anchor before and after.
+    size_t opsBefore = 0;
+    size_t opsAfter = 0;
+    /// Memory usage in bytes. Zero if unavailable on this platform.
+    size_t mallocBefore = 0;
+    size_t mallocAfter = 0;
+    size_t peakRSS = 0;
+    /// Parallel nested pipelines spawned by this pass: the number of distinct
+    /// threads that participated and the fraction of the pass' wall time these
+    /// threads spent busy in nested pipelines.
+    unsigned numThreads = 0;
+    double utilization = 0.0;
+    bool failed = false;
+  };
+
+  PassTelemetry();
+
+  /// Create an instrumentation that reports into this collector. The collector
+  /// must outlive the pass manager the instrumentation is added to.
+  std::unique_ptr<mlir::PassInstrumentation> createInstrumentation();
+
+  /// Record a completed event.
+  void addEvent(Event event);
+
+  /// Write the collected events as a Chrome trace-event JSON document.
+  void print(llvm::raw_ostream &os) const;
+
+  /// Write the collected events to the given file. Emits an error to stderr
+  /// and returns failure if the file cannot be opened.
+  LogicalResult writeToFile(StringRef path) const;
+
+private:
+  mutable std::mutex mutex;
+  TimePoint origin;
+  std::vector<Event> events;
+  /// Small dense thread numbers in order of first appearance, which makes the
+  /// trace much easier to read than raw system thread IDs.
+  llvm::DenseMap<uint64_t, unsigned> threadNumbers;
+};
+
+} // namespace circt
+
+#endif // CIRCT_SUPPORT_PASSTELEMETRY_H
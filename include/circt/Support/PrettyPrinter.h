@@ -250,6 +250,10 @@ private:
   /// Print out tokens we know sizes for, and drop from token buffer.
   void advanceLeft();
 
+  /// Print a group that fits on the current line, starting at the front of the
+  /// token buffer, and drop it from the token buffer.
+  void printFittingGroup();
+
   /// Break encountered, set sizes of begin/breaks in scanStack we now know.
   void checkStack();
 
@@ -266,6 +270,9 @@ private:
   /// Reset leftTotal and tokenOffset, rebase size data and scanStack indices.
   void rebaseIfNeeded();
 
+  /// Drop the first unprinted token from the token buffer.
+  void popFrontToken();
+
   /// Get current printing frame.
   auto &getPrintFrame() {
     return printStack.empty() ? defaultFrame : printStack.back();
@@ -278,9 +285,13 @@ private:
   int32_t leftTotal;
   int32_t rightTotal;
 
-  /// Unprinted tokens, combination of 'token' and 'size' in Oppen.
-  std::deque<FormattedToken> tokens;
-  /// index of first token, for resolving scanStack entries.
+  /// Unprinted tokens, combination of 'token' and 'size' in Oppen, starting at
+  /// index `firstToken`. Tokens are bump-allocated in this buffer, which is
+  /// reset once all of them have been printed.
+  SmallVector<FormattedToken, 0> tokens;
+  /// Index of the first unprinted token in `tokens`.
+  uint32_t firstToken = 0;
+  /// index of first token in `tokens`, for resolving scanStack entries.
   uint32_t tokenOffset = 0;
 
   /// Stack of begin/break tokens, adjust by tokenOffset to index into tokens.
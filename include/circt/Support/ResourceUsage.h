@@ -0,0 +1,27 @@
+//===- ResourceUsage.h - Process resource usage queries ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Queries for the resources consumed by the current process, shared by tools
+// that report memory usage.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_SUPPORT_RESOURCEUSAGE_H
+#define CIRCT_SUPPORT_RESOURCEUSAGE_H
+
+#include <cstddef>
+
+namespace circt {
+
+/// Return the peak resident set size of the process in bytes, or zero if it
+/// cannot be determined on this platform.
+size_t getPeakRSS();
+
+} // namespace circt
+
+#endif // CIRCT_SUPPORT_RESOURCEUSAGE_H
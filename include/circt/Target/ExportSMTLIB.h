@@ -26,6 +26,12 @@ struct SMTEmissionOptions {
   bool inlineSingleUseValues = false;
   // Increase indentation for each 'let' expression body.
   bool indentLetBody = false;
+  // Emit subterms needed by more than one assertion once as a 'define-fun'
+  // instead of repeating them in every assertion.
+  bool defineSharedTerms = false;
+  // Emit all solver scopes into a single incremental session, where each
+  // scope is enclosed in a 'push'/'pop' pair instead of ending with a 'reset'.
+  bool incremental = false;
 };
 
 /// Run the ExportSMTLIB pass.
@@ -0,0 +1,26 @@
+//===- CirctFIRRTLLspServerMain.h - FIRRTL Language Server main -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Main entry function for circt-firrtl-lsp-server, a language server for
+// .fir files.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef CIRCT_TOOLS_CIRCT_FIRRTL_LSP_SERVER_CIRCTFIRRTLLSPSERVERMAIN_H
+#define CIRCT_TOOLS_CIRCT_FIRRTL_LSP_SERVER_CIRCTFIRRTLLSPSERVERMAIN_H
+
+#include "circt/Support/LLVM.h"
+
+namespace circt {
+
+/// Implementation for tools like `circt-firrtl-lsp-server`.
+LogicalResult CirctFIRRTLLspServerMain(int argc, char **argv);
+
+} // namespace circt
+
+#endif // CIRCT_TOOLS_CIRCT_FIRRTL_LSP_SERVER_CIRCTFIRRTLLSPSERVERMAIN_H
@@ -59,6 +59,11 @@ with Context() as ctx, Location.unknown():
       # CHECK: hw.struct_extract [[STRUCT1]]["a"] : !hw.struct<a: i32, b: i1>
       hw.StructExtractOp.create(struct1, 'a')
 
+      # CHECK: %c3_i32 = hw.constant 3 : i32
+      # CHECK: %c-4_i32 = hw.constant -4 : i32
+      consts = hw.ConstantOp.create_many(i32, [3, -4])
+      assert len(consts) == 2 and consts[0].type == i32
+
     hw.HWModuleOp(name="test", body_builder=build)
 
   print(m)
@@ -235,6 +235,114 @@ with ir.Context() as ctx, ir.Location.unknown():
   assert should_be_none is None
   assert pdb.get_instance_at(new_location) == old_loc_repl
 
+  print("=== Nearest free:")
+  devdb = msft.PrimitiveDB()
+  devdb.add_primitive(msft.PhysLocationAttr.get(msft.M20K, x=3, y=10, num=0))
+  devdb.add_primitive(msft.PhysLocationAttr.get(msft.M20K, x=3, y=20, num=0))
+  devdb.add_primitive(msft.PhysLocationAttr.get(msft.M20K, x=3, y=20, num=1))
+  devdb.add_primitive(msft.PhysLocationAttr.get(msft.M20K, x=3, y=30, num=0))
+  devdb.add_primitive(msft.PhysLocationAttr.get(msft.FF, x=4, y=5, num=0))
+  pdb = msft.PlacementDB(mod, devdb)
+
+  def m20k(x, y, num):
+    return msft.PhysLocationAttr.get(msft.M20K, x=x, y=y, num=num)
+
+  # CHECK-LABEL: === Nearest free:
+  # Rows at the same distance resolve to the lower one.
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 15))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 16))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 0>
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 0))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 100))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 30, 0>
+  print(pdb.get_nearest_free_in_column(msft.FF, 4, 0))
+  # CHECK-NEXT: #msft.physloc<FF, 4, 5, 0>
+  assert pdb.get_nearest_free_in_column(msft.M20K, 4, 5) is None
+  assert pdb.get_nearest_free_in_column(msft.M20K, 5, 5) is None
+
+  # The lowest free number in a row is picked, and full rows are skipped.
+  loc20_0 = pdb.place(dyn_inst, m20k(3, 20, 0), "", ir.Location.current)
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 20))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 1>
+  loc20_1 = pdb.place(dyn_inst, m20k(3, 20, 1), "", ir.Location.current)
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 20))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 21))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 30, 0>
+
+  # A move frees the old location and occupies the new one.
+  assert pdb.move_placement(loc20_1, m20k(3, 30, 0))
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 25))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 1>
+  loc10_0 = pdb.place(dyn_inst, m20k(3, 10, 0), "", ir.Location.current)
+  loc20_1b = pdb.place(dyn_inst, m20k(3, 20, 1), "", ir.Location.current)
+  assert pdb.get_nearest_free_in_column(msft.M20K, 3, 20) is None
+
+  # A removal frees the location again.
+  pdb.remove_placement(loc20_0)
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 0))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 0>
+
+  print("=== Bounded ASC, ASC:")
+  walk_order = msft.WalkOrder(columns=msft.Direction.ASC,
+                              rows=msft.Direction.ASC)
+  pdb.walk_placements(print_placement,
+                      bounds=(3, 4, 5, 20),
+                      walk_order=walk_order)
+  # CHECK-LABEL: === Bounded ASC, ASC:
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 0>, (unoccupied)
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 1>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<FF, 4, 5, 0>, (unoccupied)
+
+  print("=== Bounded DESC, DESC:")
+  walk_order = msft.WalkOrder(columns=msft.Direction.DESC,
+                              rows=msft.Direction.DESC)
+  pdb.walk_placements(print_placement,
+                      bounds=(3, 4, 5, 20),
+                      walk_order=walk_order)
+  # CHECK-LABEL: === Bounded DESC, DESC:
+  # CHECK-NEXT: #msft.physloc<FF, 4, 5, 0>, (unoccupied)
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 0>, (unoccupied)
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 1>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>, [#hw.innerNameRef<@top::@inst1>
+
+  # An unseeded DB only knows about the placed locations and accepts any new
+  # one, while the seeded DB also walks and returns the free primitives.
+  print("=== Seeded and unseeded:")
+  unseeded_pdb = msft.PlacementDB(mod)
+  walk_order = msft.WalkOrder(rows=msft.Direction.ASC)
+  pdb.walk_placements(print_placement,
+                      bounds=(3, 3, None, None),
+                      walk_order=walk_order)
+  unseeded_pdb.walk_placements(print_placement,
+                               bounds=(3, 3, None, None),
+                               walk_order=walk_order)
+  # CHECK-LABEL: === Seeded and unseeded:
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 0>, (unoccupied)
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 1>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 30, 0>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 10, 0>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 1>, [#hw.innerNameRef<@top::@inst1>
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 30, 0>, [#hw.innerNameRef<@top::@inst1>
+  print(pdb.get_nearest_free_in_column(msft.M20K, 3, 20))
+  # CHECK-NEXT: #msft.physloc<M20K, 3, 20, 0>
+  assert unseeded_pdb.get_nearest_free_in_column(msft.M20K, 3, 20) is None
+
+  loc9 = unseeded_pdb.place(dyn_inst, m20k(9, 9, 0), "", ir.Location.current)
+  assert loc9 is not None
+  assert unseeded_pdb.get_nearest_free_in_column(msft.M20K, 9, 0) is None
+  unseeded_pdb.remove_placement(loc9)
+  print(unseeded_pdb.get_nearest_free_in_column(msft.M20K, 9, 0))
+  # CHECK-NEXT: #msft.physloc<M20K, 9, 9, 0>
+  assert pdb.get_nearest_free_in_column(msft.M20K, 9, 0) is None
+
+  for loc_op in [loc10_0, loc20_1b, loc20_1]:
+    pdb.remove_placement(loc_op)
+
   print("=== Errors:", file=sys.stderr)
   # TODO: Python's sys.stderr doesn't seem to be shared with C++ errors.
   # See https://github.com/llvm/circt/issues/1983 for more info.
@@ -3,7 +3,7 @@
 
 import circt
 from circt.dialects import om
-from circt.ir import Context, InsertionPoint, Location, Module, IntegerAttr, IntegerType, Type
+from circt.ir import Attribute, Context, InsertionPoint, Location, Module, IntegerAttr, IntegerType, Type
 from circt.support import var_to_attribute
 
 from dataclasses import dataclass
@@ -117,6 +117,13 @@ with Context() as ctx, Location.unknown():
       %5 = om.integer.add %1, %3 : !om.integer
       om.class.field @result, %5 : !om.integer
     }
+
+    om.class @IntegerList() {
+      %0 = om.constant #om.integer<1 : si64> : !om.integer
+      %1 = om.constant #om.integer<-2 : si8> : !om.integer
+      %list = om.list_create %0, %1 : !om.integer
+      om.class.field @list, %list : !om.list<!om.integer>
+    }
   }
   """)
 
@@ -272,6 +279,10 @@ delayed = evaluator.instantiate("IntegerBinaryArithmeticObjectsDelayed")
 # CHECK: 3
 print(delayed.result)
 
+int_list = evaluator.instantiate("IntegerList").list
+# CHECK: [1, -2]
+print(memoryview(int_list.to_int64_array()).tolist())
+
 with Context() as ctx:
   circt.register_dialects(ctx)
 
@@ -316,3 +327,11 @@ with Context() as ctx:
   list_type = Type.parse("!om.list<!om.any>")
   assert isinstance(list_type, om.ListType)
   assert isinstance(list_type.element_type, om.AnyType)
+
+  # Test bulk integer extraction from a ListAttr
+  list_attr = om.ListAttr(
+      Attribute.parse(
+          "#om.list<!om.integer, [#om.integer<3 : si8>, #om.integer<4 : si8>]>"
+      ))
+  # CHECK: [3, 4]
+  print(memoryview(list_attr.to_int64_array()).tolist())
@@ -0,0 +1,42 @@
+// REQUIRES: libz3
+// REQUIRES: circt-bmc-jit
+
+//  RUN: circt-bmc %s -b 10 --module Counter --shared-libs=%libz3 --print-bound-times 2>&1 | FileCheck %s --check-prefix=TIMES
+//  TIMES: bound 0: no violation
+//  TIMES: bound 9: no violation
+//  TIMES: Bound reached with no violations!
+
+//  RUN: circt-bmc %s -b 10 --module Counter --shared-libs=%libz3 --portfolio=3 -j 2 | FileCheck %s --check-prefix=PORTFOLIO
+//  PORTFOLIO: Bound reached with no violations!
+
+//  RUN: circt-bmc %s -b 10 --module Counter --shared-libs=%libz3 --split-properties | FileCheck %s --check-prefix=SPLIT
+//  SPLIT-DAG: Property 0: Bound reached with no violations!
+//  SPLIT-DAG: Property 1: Bound reached with no violations!
+
+//  RUN: circt-bmc %s -b 10 --module Violated --shared-libs=%libz3 --split-properties --portfolio=2 | FileCheck %s --check-prefix=VIOLATED
+//  VIOLATED-DAG: Property 0: Bound reached with no violations!
+//  VIOLATED-DAG: Property 1: Assertion can be violated!
+
+hw.module @Counter(in %clk: !seq.clock, in %i0: i1) {
+  %c-1_i1 = hw.constant -1 : i1
+  %reg = seq.compreg %i0, %clk : i1
+  %not_reg = comb.xor bin %reg, %c-1_i1 : i1
+  %not_not_reg = comb.xor bin %not_reg, %c-1_i1 : i1
+  %clk_i1 = seq.from_clock %clk
+  %nclk = comb.xor bin %clk_i1, %c-1_i1 : i1
+  %eq = comb.icmp bin eq %not_not_reg, %reg : i1
+  %imp = comb.or bin %nclk, %eq : i1
+  verif.assert %imp : i1
+  %ne = comb.icmp bin ne %not_reg, %reg : i1
+  verif.assert %ne : i1
+}
+
+hw.module @Violated(in %i0: i1, in %i1: i1) {
+  %or0 = comb.or bin %i0, %i1 : i1
+  %or1 = comb.or bin %i1, %i0 : i1
+  %eq = comb.icmp bin eq %or0, %or1 : i1
+  verif.assert %eq : i1
+  %and = comb.and bin %i0, %i1 : i1
+  %eq2 = comb.icmp bin eq %or0, %and : i1
+  verif.assert %eq2 : i1
+}
@@ -13,6 +13,8 @@ hw.module @not(in %in: i1, out out: i1) {
 
 // comb.add
 //  RUN: circt-lec %s -c1=adder -c2=completeAdder --shared-libs=%libz3 | FileCheck %s --check-prefix=COMB_ADD
+//  RUN: circt-lec %s -c1=adder -c2=completeAdder --simplify --shared-libs=%libz3 | FileCheck %s --check-prefix=COMB_ADD
+//  RUN: circt-lec %s -c1=adder -c2=completeAdder --simplify -j 2 --shared-libs=%libz3 | FileCheck %s --check-prefix=COMB_ADD
 //  COMB_ADD: c1 == c2
 
 hw.module @adder(in %in1: i2, in %in2: i2, out out: i2) {
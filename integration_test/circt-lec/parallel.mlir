@@ -0,0 +1,44 @@
+// REQUIRES: libz3
+// REQUIRES: circt-lec-jit
+
+// Each output needs the solver, so `--simplify` leaves one check per output
+// and `-j` runs them on separate threads.
+
+// RUN: circt-lec %s -c1=twoOutputs -c2=twoOutputsAlt --simplify -j 2 --shared-libs=%libz3 | FileCheck %s --check-prefix=EQUAL
+// RUN: circt-lec %s -c1=twoOutputs -c2=twoOutputsAlt --simplify -j 0 --shared-libs=%libz3 | FileCheck %s --check-prefix=EQUAL
+// EQUAL: c1 == c2
+
+hw.module @twoOutputs(in %a: i8, in %b: i8, out mul: i8, out mux: i8) {
+  %c2 = hw.constant 2 : i8
+  %mul = comb.mul bin %a, %c2 : i8
+  %cond = comb.icmp bin ult %a, %b : i8
+  %mux = comb.mux bin %cond, %a, %b : i8
+  hw.output %mul, %mux : i8, i8
+}
+
+hw.module @twoOutputsAlt(in %a: i8, in %b: i8, out mul: i8, out mux: i8) {
+  %mul = comb.add bin %a, %a : i8
+  %cond = comb.icmp bin uge %a, %b : i8
+  %mux = comb.mux bin %cond, %b, %a : i8
+  hw.output %mul, %mux : i8, i8
+}
+
+// The last output only differs for a single input value, which random
+// simulation is unlikely to hit.
+// RUN: circt-lec %s -c1=twoOutputs32 -c2=twoOutputs32Bad --simplify -j 2 --shared-libs=%libz3 | FileCheck %s --check-prefix=DIFFER
+// DIFFER: c1 != c2
+
+hw.module @twoOutputs32(in %a: i32, out mul: i32, out same: i32) {
+  %c2 = hw.constant 2 : i32
+  %mul = comb.mul bin %a, %c2 : i32
+  hw.output %mul, %a : i32, i32
+}
+
+hw.module @twoOutputs32Bad(in %a: i32, out mul: i32, out same: i32) {
+  %mul = comb.add bin %a, %a : i32
+  %magic = hw.constant 305419896 : i32
+  %zero = hw.constant 0 : i32
+  %isMagic = comb.icmp bin eq %a, %magic : i32
+  %same = comb.mux bin %isMagic, %zero, %a : i32
+  hw.output %mul, %same : i32, i32
+}
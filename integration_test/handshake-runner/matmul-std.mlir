@@ -1,5 +1,6 @@
 // RUN: handshake-runner %s | FileCheck %s
 // RUN: circt-opt -lower-cf-to-handshake -handshake-materialize-forks-sinks %s | handshake-runner | FileCheck %s
+// RUN: circt-opt -lower-cf-to-handshake -handshake-materialize-forks-sinks %s | handshake-runner --compiled | FileCheck %s
 // CHECK: 0
 
 module {
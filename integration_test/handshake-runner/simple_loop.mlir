@@ -1,4 +1,5 @@
 // RUN: circt-opt -lower-cf-to-handshake -handshake-materialize-forks-sinks %s | handshake-runner | FileCheck %s
+// RUN: circt-opt -lower-cf-to-handshake -handshake-materialize-forks-sinks %s | handshake-runner --compiled | FileCheck %s
 // RUN: handshake-runner %s | FileCheck %s
 // CHECK: 42
 module {
@@ -1,6 +1,9 @@
 // RUN: circt-opt -lower-cf-to-handshake -handshake-materialize-forks-sinks %s \
 // RUN: | circt-opt --handshake-insert-buffers="strategy=all" \
 // RUN: | handshake-runner | FileCheck %s
+// RUN: circt-opt -lower-cf-to-handshake -handshake-materialize-forks-sinks %s \
+// RUN: | circt-opt --handshake-insert-buffers="strategy=all" \
+// RUN: | handshake-runner --compiled | FileCheck %s
 // CHECK: 42
 module {
   func.func @main() -> index {
@@ -0,0 +1,825 @@
+//===- BitParallelSimulation.cpp - Simulate many input patterns at once ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a bit-parallel simulator for `hw`, `comb`, and `seq`
+// logic.
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Analysis/BitParallelSimulation.h"
+#include "circt/Dialect/Comb/CombOps.h"
+#include "circt/Dialect/HW/HWOps.h"
+#include "circt/Dialect/Seq/SeqOps.h"
+#include "mlir/Analysis/TopologicalSortUtils.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+using namespace mlir;
+using namespace circt;
+using namespace analysis;
+using llvm::APInt;
+
+//===----------------------------------------------------------------------===//
+// Bit-sliced arithmetic
+//===----------------------------------------------------------------------===//
+
+// The helpers below operate on bit-sliced values of `width` bits with `n`
+// words per bit, as described in the header.
+
+/// Compute `a + b`, or `a - b` if `subtract` is set. `result` may alias the
+/// operands. `carry` provides `n` words of scratch space.
+static void addWords(uint64_t *result, const uint64_t *a, const uint64_t *b,
+                     unsigned width, unsigned n, bool subtract,
+                     uint64_t *carry) {
+  uint64_t invert = subtract ? ~0ULL : 0;
+  std::fill_n(carry, n, invert);
+  for (unsigned i = 0; i < width; ++i) {
+    for (unsigned k = 0; k < n; ++k) {
+      uint64_t x = a[i * n + k], y = b[i * n + k] ^ invert, c = carry[k];
+      result[i * n + k] = x ^ y ^ c;
+      carry[k] = (x & y) | (c & (x ^ y));
+    }
+  }
+}
+
+/// Compute `a * b` as a sum of shifted partial products. `result` must not
+/// alias the operands. `carry` provides `n` words of scratch space.
+static void mulWords(uint64_t *result, const uint64_t *a, const uint64_t *b,
+                     unsigned width, unsigned n, uint64_t *carry) {
+  std::fill_n(result, width * n, 0);
+  for (unsigned i = 0; i < width; ++i) {
+    std::fill_n(carry, n, 0);
+    for (unsigned j = i; j < width; ++j) {
+      for (unsigned k = 0; k < n; ++k) {
+        uint64_t p = a[(j - i) * n + k] & b[i * n + k];
+        uint64_t r = result[j * n + k], c = carry[k];
+        result[j * n + k] = r ^ p ^ c;
+        carry[k] = (r & p) | (c & (r ^ p));
+      }
+    }
+  }
+}
+
+/// Compute the mask of patterns in which `a < b` into the `n` words of
+/// `result`.
+static void lessThanWords(uint64_t *result, const uint64_t *a,
+                          const uint64_t *b, unsigned width, unsigned n,
+                          bool isSigned) {
+  // `a < b` iff `a + ~b + 1` does not carry out. Flipping the sign bits maps
+  // the signed onto the unsigned comparison.
+  std::fill_n(result, n, ~0ULL);
+  for (unsigned i = 0; i < width; ++i) {
+    uint64_t flip = isSigned && i == width - 1 ? ~0ULL : 0;
+    for (unsigned k = 0; k < n; ++k) {
+      uint64_t x = a[i * n + k] ^ flip, y = ~(b[i * n + k] ^ flip);
+      uint64_t c = result[k];
+      result[k] = (x & y) | (c & (x ^ y));
+    }
+  }
+  for (unsigned k = 0; k < n; ++k)
+    result[k] = ~result[k];
+}
+
+/// Shift `value` by `amount` with a barrel shifter, one stage per bit of the
+/// amount. `result` must not alias the operands. `stage` provides `width * n`
+/// words of scratch space.
+static void shiftWords(uint64_t *result, const uint64_t *value,
+                       const uint64_t *amount, unsigned width,
+                       unsigned amountWidth, unsigned n, bool left,
+                       bool arithmetic, uint64_t *stage) {
+  if (width == 0)
+    return;
+  std::copy_n(value, width * n, result);
+  const uint64_t *sign = &value[(width - 1) * n];
+
+  // Stages shifting by less than the width.
+  unsigned numStages = 0;
+  for (; numStages < amountWidth && numStages < 32 &&
+         (1U << numStages) < width;
+       ++numStages) {
+    unsigned distance = 1U << numStages;
+    const uint64_t *select = &amount[numStages * n];
+    for (unsigned j = 0; j < width; ++j) {
+      const uint64_t *from = nullptr;
+      if (left ? j >= distance : j + distance < width)
+        from = &result[(left ? j - distance : j + distance) * n];
+      else if (arithmetic)
+        from = sign;
+      for (unsigned k = 0; k < n; ++k) {
+        uint64_t shifted = from ? from[k] : 0;
+        stage[j * n + k] =
+            (select[k] & shifted) | (~select[k] & result[j * n + k]);
+      }
+    }
+    std::copy_n(stage, width * n, result);
+  }
+
+  // Any higher amount bit shifts out the entire value.
+  for (unsigned i = numStages; i < amountWidth; ++i) {
+    const uint64_t *select = &amount[i * n];
+    for (unsigned j = 0; j < width; ++j)
+      for (unsigned k = 0; k < n; ++k) {
+        uint64_t fill = arithmetic ? sign[k] : 0;
+        result[j * n + k] =
+            (select[k] & fill) | (~select[k] & result[j * n + k]);
+      }
+  }
+}
+
+/// Transpose a 64x64 bit matrix, such that bit `j` of `rows[i]` ends up as
+/// bit `i` of `rows[j]`.
+static void transpose64(uint64_t rows[64]) {
+  uint64_t mask = 0x00000000FFFFFFFFULL;
+  for (unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+    for (unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      uint64_t t = ((rows[k] >> j) ^ rows[k | j]) & mask;
+      rows[k] ^= t << j;
+      rows[k | j] ^= t;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Compilation
+//===----------------------------------------------------------------------===//
+
+BitParallelSimulator::BitParallelSimulator(unsigned numWords)
+    : numWords(numWords) {
+  assert(numWords > 0 && "must simulate at least one word of patterns");
+}
+
+/// Return the number of bits used to simulate a value of type `type`.
+static std::optional<unsigned> getSimulatedWidth(Type type) {
+  if (auto intType = dyn_cast<IntegerType>(type))
+    return intType.getWidth();
+  if (isa<seq::ClockType>(type))
+    return 1;
+  return std::nullopt;
+}
+
+static bool isRegister(Operation *op) {
+  return isa<seq::CompRegOp, seq::CompRegClockEnabledOp, seq::FirRegOp>(op);
+}
+
+unsigned BitParallelSimulator::addSlot(Value value, unsigned width) {
+  unsigned offset =
+      slots.empty() ? 0 : slots.back().offset + slots.back().width * numWords;
+  slots.push_back({offset, width});
+  slotIndices[value] = slots.size() - 1;
+  return slots.size() - 1;
+}
+
+LogicalResult BitParallelSimulator::compile(Block &block, bool allowUnknown) {
+  assert(slots.empty() && "simulator already compiled");
+
+  for (auto arg : block.getArguments()) {
+    inputs.push_back(arg);
+    if (auto width = getSimulatedWidth(arg.getType()))
+      addSlot(arg, *width);
+    else if (!allowUnknown)
+      return mlir::emitError(arg.getLoc())
+             << "input of type " << arg.getType()
+             << " not supported by the bit-parallel simulator";
+  }
+
+  // Registers break cycles in the logic, so allocate their state first and
+  // sort the remaining operations topologically.
+  SmallVector<Operation *> ops, registerOps;
+  for (auto &op : block.without_terminator()) {
+    if (op.getNumResults() == 0)
+      continue;
+    if (!isRegister(&op)) {
+      ops.push_back(&op);
+      continue;
+    }
+    auto width = getSimulatedWidth(op.getResult(0).getType());
+    if (!width) {
+      if (allowUnknown)
+        continue;
+      return op.emitOpError("of type ")
+             << op.getResult(0).getType()
+             << " not supported by the bit-parallel simulator";
+    }
+    registerOps.push_back(&op);
+    registers.push_back({addSlot(op.getResult(0), *width)});
+  }
+  if (!computeTopologicalSorting(ops))
+    return mlir::emitError(block.getParentOp()->getLoc())
+           << "combinational cycle prevents bit-parallel simulation";
+  for (auto *op : ops)
+    if (failed(compileOperation(op, allowUnknown)))
+      return failure();
+
+  for (unsigned i = 0, e = registers.size(); i < e; ++i) {
+    Operation *op = registerOps[i];
+    Register &reg = registers[i];
+    Value next, enable, reset, resetValue;
+    TypeSwitch<Operation *>(op)
+        .Case<seq::CompRegOp>([&](auto op) {
+          next = op.getInput();
+          reset = op.getReset();
+          resetValue = op.getResetValue();
+        })
+        .Case<seq::CompRegClockEnabledOp>([&](auto op) {
+          next = op.getInput();
+          enable = op.getClockEnable();
+          reset = op.getReset();
+          resetValue = op.getResetValue();
+        })
+        .Case<seq::FirRegOp>([&](auto op) {
+          next = op.getNext();
+          reset = op.getReset();
+          resetValue = op.getResetValue();
+          if (auto preset = op.getPresetAttr())
+            reg.preset = preset.getValue();
+        });
+
+    bool known = true;
+    auto lookup = [&](Value value) {
+      if (!value)
+        return ~0U;
+      auto it = slotIndices.find(value);
+      if (it != slotIndices.end())
+        return it->second;
+      known = false;
+      return ~0U;
+    };
+    unsigned nextSlot = lookup(next);
+    reg.enable = lookup(enable);
+    reg.reset = lookup(reset);
+    reg.resetValue = lookup(resetValue);
+    if (known)
+      reg.next = nextSlot;
+    else if (!allowUnknown)
+      return op->emitOpError("inputs not supported by the bit-parallel "
+                             "simulator");
+  }
+
+  for (auto operand : block.getTerminator()->getOperands()) {
+    outputs.push_back(operand);
+    if (!allowUnknown && !isKnown(operand))
+      return block.getTerminator()->emitOpError(
+          "output not supported by the bit-parallel simulator");
+  }
+
+  allocateUndefinedMasks();
+  for (auto &[slot, value] : constants) {
+    for (unsigned i = 0, e = slots[slot].width; i < e; ++i)
+      std::fill_n(getBit(slot, i), numWords, value[i] ? ~0ULL : 0);
+  }
+  resetRegisters();
+  return success();
+}
+
+LogicalResult BitParallelSimulator::compileOperation(Operation *op,
+                                                     bool allowUnknown) {
+  auto unsupported = [&]() -> LogicalResult {
+    if (allowUnknown)
+      return success();
+    return op->emitOpError("not supported by the bit-parallel simulator");
+  };
+  if (op->getNumResults() != 1 || op->getNumRegions() != 0)
+    return unsupported();
+  auto width = getSimulatedWidth(op->getResult(0).getType());
+  if (!width)
+    return unsupported();
+
+  Instruction inst;
+  inst.op = op;
+  for (auto operand : op->getOperands()) {
+    auto it = slotIndices.find(operand);
+    if (it == slotIndices.end())
+      return unsupported();
+    inst.operands.push_back(it->second);
+  }
+
+  auto kind =
+      TypeSwitch<Operation *, std::optional<Kind>>(op)
+          .Case<hw::ConstantOp>([&](auto op) -> std::optional<Kind> {
+            constants.push_back({addSlot(op, *width), op.getValue()});
+            return std::nullopt;
+          })
+          .Case<hw::WireOp, seq::ToClockOp, seq::FromClockOp>(
+              [](auto) { return Kind::Copy; })
+          .Case<hw::BitcastOp>([&](auto op) -> std::optional<Kind> {
+            if (!getSimulatedWidth(op.getInput().getType()))
+              return std::nullopt;
+            return Kind::Copy;
+          })
+          .Case<comb::AndOp>([](auto) { return Kind::And; })
+          .Case<comb::OrOp>([](auto) { return Kind::Or; })
+          .Case<comb::XorOp>([](auto) { return Kind::Xor; })
+          .Case<comb::AddOp>([](auto) { return Kind::Add; })
+          .Case<comb::SubOp>([](auto) { return Kind::Sub; })
+          .Case<comb::MulOp>([](auto) { return Kind::Mul; })
+          .Case<comb::DivUOp>([](auto) { return Kind::DivU; })
+          .Case<comb::DivSOp>([](auto) { return Kind::DivS; })
+          .Case<comb::ModUOp>([](auto) { return Kind::ModU; })
+          .Case<comb::ModSOp>([](auto) { return Kind::ModS; })
+          .Case<comb::ShlOp>([](auto) { return Kind::Shl; })
+          .Case<comb::ShrUOp>([](auto) { return Kind::ShrU; })
+          .Case<comb::ShrSOp>([](auto) { return Kind::ShrS; })
+          .Case<comb::ICmpOp>([](auto op) {
+            switch (op.getPredicate()) {
+            case comb::ICmpPredicate::eq:
+            case comb::ICmpPredicate::ceq:
+            case comb::ICmpPredicate::weq:
+              return Kind::Eq;
+            case comb::ICmpPredicate::ne:
+            case comb::ICmpPredicate::cne:
+            case comb::ICmpPredicate::wne:
+              return Kind::Ne;
+            case comb::ICmpPredicate::ult:
+              return Kind::Ult;
+            case comb::ICmpPredicate::ule:
+              return Kind::Ule;
+            case comb::ICmpPredicate::ugt:
+              return Kind::Ugt;
+            case comb::ICmpPredicate::uge:
+              return Kind::Uge;
+            case comb::ICmpPredicate::slt:
+              return Kind::Slt;
+            case comb::ICmpPredicate::sle:
+              return Kind::Sle;
+            case comb::ICmpPredicate::sgt:
+              return Kind::Sgt;
+            case comb::ICmpPredicate::sge:
+              return Kind::Sge;
+            }
+            llvm_unreachable("unknown icmp predicate");
+          })
+          .Case<comb::MuxOp>([](auto) { return Kind::Mux; })
+          .Case<comb::ConcatOp>([](auto) { return Kind::Concat; })
+          .Case<comb::ExtractOp>([&](auto op) {
+            inst.immediate = op.getLowBit();
+            return Kind::Extract;
+          })
+          .Case<comb::ReplicateOp>([](auto) { return Kind::Replicate; })
+          .Case<comb::ParityOp>([](auto) { return Kind::Parity; })
+          .Case<comb::TruthTableOp>([&](auto op) -> std::optional<Kind> {
+            // Tables with up to 64 entries fit into the immediate.
+            if (op.getInputs().size() > 6)
+              return std::nullopt;
+            for (auto [i, entry] : llvm::enumerate(op.getLookupTable()))
+              if (cast<BoolAttr>(entry).getValue())
+                inst.immediate |= 1ULL << i;
+            return Kind::TruthTable;
+          })
+          .Default([](auto) { return std::nullopt; });
+
+  if (isa<hw::ConstantOp>(op))
+    return success();
+  if (!kind)
+    return unsupported();
+  inst.kind = *kind;
+  inst.result = addSlot(op->getResult(0), *width);
+  instructions.push_back(std::move(inst));
+  return success();
+}
+
+void BitParallelSimulator::allocateUndefinedMasks() {
+  // A value may be undefined if it is the result of a division, or depends on
+  // a possibly undefined value. Registers feed back into the logic, so iterate
+  // until nothing changes.
+  SmallVector<bool> mayBeUndefined(slots.size(), false);
+  auto anyUndefined = [&](ArrayRef<unsigned> operands) {
+    return llvm::any_of(operands, [&](unsigned slot) {
+      return slot != ~0U && mayBeUndefined[slot];
+    });
+  };
+  for (bool changed = true; changed;) {
+    changed = false;
+    auto update = [&](unsigned slot, bool undefined) {
+      if (undefined && !mayBeUndefined[slot])
+        mayBeUndefined[slot] = changed = true;
+    };
+    for (auto &inst : instructions)
+      update(inst.result,
+             isDivision(inst.kind) || anyUndefined(inst.operands));
+    for (auto &reg : registers)
+      update(reg.state,
+             reg.next == ~0U ||
+                 anyUndefined({reg.next, reg.enable, reg.reset,
+                               reg.resetValue}));
+  }
+
+  // Lay out the masks after the values and size the scratch space.
+  unsigned size =
+      slots.empty() ? 0 : slots.back().offset + slots.back().width * numWords;
+  unsigned maxWidth = 0, registerSize = 0;
+  for (auto [slot, undefined] : llvm::zip(slots, mayBeUndefined)) {
+    maxWidth = std::max(maxWidth, slot.width);
+    if (undefined) {
+      slot.undefOffset = size;
+      size += numWords;
+    }
+  }
+  for (auto &reg : registers)
+    registerSize += (slots[reg.state].width + 1) * numWords;
+  storage.assign(size, 0);
+  scratch.assign(std::max((2 * maxWidth + 1) * numWords, registerSize), 0);
+}
+
+//===----------------------------------------------------------------------===//
+// Simulation
+//===----------------------------------------------------------------------===//
+
+void BitParallelSimulator::evaluate() {
+  for (auto &inst : instructions)
+    execute(inst);
+}
+
+void BitParallelSimulator::execute(const Instruction &inst) {
+  unsigned n = numWords;
+  unsigned width = slots[inst.result].width;
+  uint64_t *result = getBit(inst.result, 0);
+  auto operand = [&](unsigned i) -> const uint64_t * {
+    return getBit(inst.operands[i], 0);
+  };
+  auto operandWidth = [&](unsigned i) {
+    return slots[inst.operands[i]].width;
+  };
+
+  // A result is undefined wherever any of its operands is.
+  if (uint64_t *undef = getUndef(inst.result)) {
+    std::fill_n(undef, n, 0);
+    for (auto slot : inst.operands)
+      if (const uint64_t *operandUndef = getUndef(slot))
+        for (unsigned k = 0; k < n; ++k)
+          undef[k] |= operandUndef[k];
+  }
+
+  auto bitwise = [&](auto fn) {
+    std::copy_n(operand(0), width * n, result);
+    for (unsigned i = 1, e = inst.operands.size(); i < e; ++i) {
+      const uint64_t *other = operand(i);
+      for (unsigned k = 0; k < width * n; ++k)
+        result[k] = fn(result[k], other[k]);
+    }
+  };
+  auto compare = [&](bool swap, bool negate, bool isSigned) {
+    lessThanWords(result, operand(swap ? 1 : 0), operand(swap ? 0 : 1),
+                  operandWidth(0), n, isSigned);
+    if (negate)
+      for (unsigned k = 0; k < n; ++k)
+        result[k] = ~result[k];
+  };
+
+  switch (inst.kind) {
+  case Kind::Copy:
+    std::copy_n(operand(0), width * n, result);
+    break;
+  case Kind::And:
+    bitwise([](uint64_t a, uint64_t b) { return a & b; });
+    break;
+  case Kind::Or:
+    bitwise([](uint64_t a, uint64_t b) { return a | b; });
+    break;
+  case Kind::Xor:
+    bitwise([](uint64_t a, uint64_t b) { return a ^ b; });
+    break;
+  case Kind::Add:
+    std::copy_n(operand(0), width * n, result);
+    for (unsigned i = 1, e = inst.operands.size(); i < e; ++i)
+      addWords(result, result, operand(i), width, n, false, scratch.data());
+    break;
+  case Kind::Sub:
+    addWords(result, operand(0), operand(1), width, n, true, scratch.data());
+    break;
+  case Kind::Mul:
+    std::copy_n(operand(0), width * n, result);
+    for (unsigned i = 1, e = inst.operands.size(); i < e; ++i) {
+      mulWords(scratch.data(), result, operand(i), width, n,
+               scratch.data() + width * n);
+      std::copy_n(scratch.data(), width * n, result);
+    }
+    break;
+  case Kind::DivU:
+  case Kind::DivS:
+  case Kind::ModU:
+  case Kind::ModS:
+    executeDivision(inst);
+    break;
+  case Kind::Shl:
+  case Kind::ShrU:
+  case Kind::ShrS:
+    shiftWords(result, operand(0), operand(1), width, operandWidth(1), n,
+               inst.kind == Kind::Shl, inst.kind == Kind::ShrS,
+               scratch.data());
+    break;
+  case Kind::Eq:
+  case Kind::Ne: {
+    std::fill_n(result, n, 0);
+    const uint64_t *a = operand(0), *b = operand(1);
+    for (unsigned i = 0, e = operandWidth(0); i < e; ++i)
+      for (unsigned k = 0; k < n; ++k)
+        result[k] |= a[i * n + k] ^ b[i * n + k];
+    if (inst.kind == Kind::Eq)
+      for (unsigned k = 0; k < n; ++k)
+        result[k] = ~result[k];
+    break;
+  }
+  case Kind::Ult:
+    compare(false, false, false);
+    break;
+  case Kind::Ule:
+    compare(true, true, false);
+    break;
+  case Kind::Ugt:
+    compare(true, false, false);
+    break;
+  case Kind::Uge:
+    compare(false, true, false);
+    break;
+  case Kind::Slt:
+    compare(false, false, true);
+    break;
+  case Kind::Sle:
+    compare(true, true, true);
+    break;
+  case Kind::Sgt:
+    compare(true, false, true);
+    break;
+  case Kind::Sge:
+    compare(false, true, true);
+    break;
+  case Kind::Mux: {
+    const uint64_t *cond = operand(0), *t = operand(1), *f = operand(2);
+    for (unsigned i = 0; i < width; ++i)
+      for (unsigned k = 0; k < n; ++k)
+        result[i * n + k] =
+            (cond[k] & t[i * n + k]) | (~cond[k] & f[i * n + k]);
+    break;
+  }
+  case Kind::Concat: {
+    // The first operand holds the most significant bits.
+    uint64_t *dest = result;
+    for (unsigned i = inst.operands.size(); i-- > 0;) {
+      unsigned size = operandWidth(i) * n;
+      std::copy_n(operand(i), size, dest);
+      dest += size;
+    }
+    break;
+  }
+  case Kind::Extract:
+    std::copy_n(operand(0) + inst.immediate * n, width * n, result);
+    break;
+  case Kind::Replicate: {
+    unsigned size = operandWidth(0) * n;
+    for (unsigned offset = 0; offset < width * n; offset += size)
+      std::copy_n(operand(0), size, result + offset);
+    break;
+  }
+  case Kind::Parity: {
+    std::fill_n(result, n, 0);
+    const uint64_t *a = operand(0);
+    for (unsigned i = 0, e = operandWidth(0); i < e; ++i)
+      for (unsigned k = 0; k < n; ++k)
+        result[k] ^= a[i * n + k];
+    break;
+  }
+  case Kind::TruthTable: {
+    // The first input selects the most significant bit of the table index.
+    unsigned numInputs = inst.operands.size();
+    std::fill_n(result, n, 0);
+    for (unsigned entry = 0, e = 1U << numInputs; entry < e; ++entry) {
+      if (!(inst.immediate >> entry & 1))
+        continue;
+      for (unsigned k = 0; k < n; ++k) {
+        uint64_t match = ~0ULL;
+        for (unsigned i = 0; i < numInputs; ++i) {
+          uint64_t bit = operand(i)[k];
+          match &= (entry >> (numInputs - 1 - i) & 1) ? bit : ~bit;
+        }
+        result[k] |= match;
+      }
+    }
+    break;
+  }
+  }
+}
+
+/// Evaluate a division or remainder on one pattern. Returns false if the
+/// result is undefined.
+static bool divide(bool isSigned, bool isRemainder, const APInt &lhs,
+                   const APInt &rhs, APInt &result) {
+  if (rhs.isZero())
+    return false;
+  if (isSigned)
+    result = isRemainder ? lhs.srem(rhs) : lhs.sdiv(rhs);
+  else
+    result = isRemainder ? lhs.urem(rhs) : lhs.udiv(rhs);
+  return true;
+}
+
+void BitParallelSimulator::executeDivision(const Instruction &inst) {
+  unsigned n = numWords;
+  unsigned width = slots[inst.result].width;
+  unsigned lhsSlot = inst.operands[0], rhsSlot = inst.operands[1];
+  bool isSigned = inst.kind == Kind::DivS || inst.kind == Kind::ModS;
+  bool isRemainder = inst.kind == Kind::ModU || inst.kind == Kind::ModS;
+  uint64_t *undef = getUndef(inst.result);
+
+  // Narrow values are transposed into one native integer per pattern, 64
+  // patterns at a time.
+  if (width <= 64) {
+    uint64_t lhs[64], rhs[64];
+    for (unsigned k = 0; k < n; ++k) {
+      for (unsigned i = 0; i < 64; ++i) {
+        lhs[i] = i < width ? getBit(lhsSlot, i)[k] : 0;
+        rhs[i] = i < width ? getBit(rhsSlot, i)[k] : 0;
+      }
+      transpose64(lhs);
+      transpose64(rhs);
+      uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+      for (unsigned p = 0; p < 64; ++p) {
+        uint64_t a = lhs[p], b = rhs[p];
+        if (b == 0) {
+          undef[k] |= 1ULL << p;
+          lhs[p] = 0;
+          continue;
+        }
+        if (isSigned && width > 0) {
+          // Sign-extend to 64 bits; the result is truncated again below, which
+          // also covers the overflow of the most negative value divided by -1.
+          unsigned shift = 64 - width;
+          int64_t sa = static_cast<int64_t>(a << shift) >> shift;
+          int64_t sb = static_cast<int64_t>(b << shift) >> shift;
+          if (sb == -1)
+            lhs[p] = isRemainder ? 0 : 0 - a;
+          else
+            lhs[p] = static_cast<uint64_t>(isRemainder ? sa % sb : sa / sb);
+        } else {
+          lhs[p] = isRemainder ? a % b : a / b;
+        }
+        lhs[p] &= mask;
+      }
+      transpose64(lhs);
+      for (unsigned i = 0; i < width; ++i)
+        getBit(inst.result, i)[k] = lhs[i];
+    }
+    return;
+  }
+
+  // Wide values go through `APInt`, one pattern at a time.
+  for (unsigned p = 0, e = getNumPatterns(); p < e; ++p) {
+    unsigned k = p / 64, j = p % 64;
+    APInt lhs(width, 0), rhs(width, 0), result(width, 0);
+    for (unsigned i = 0; i < width; ++i) {
+      if (getBit(lhsSlot, i)[k] >> j & 1)
+        lhs.setBit(i);
+      if (getBit(rhsSlot, i)[k] >> j & 1)
+        rhs.setBit(i);
+    }
+    if (!divide(isSigned, isRemainder, lhs, rhs, result))
+      undef[k] |= 1ULL << j;
+    for (unsigned i = 0; i < width; ++i) {
+      uint64_t &word = getBit(inst.result, i)[k];
+      word = (word & ~(1ULL << j)) | (uint64_t(result[i]) << j);
+    }
+  }
+}
+
+void BitParallelSimulator::step() {
+  // Compute all next states before updating any register, since registers
+  // may feed each other directly.
+  unsigned n = numWords;
+  uint64_t *next = scratch.data();
+  auto undefAt = [&](unsigned slot, unsigned k) -> uint64_t {
+    if (slot == ~0U)
+      return 0;
+    const uint64_t *undef = getUndef(slot);
+    return undef ? undef[k] : 0;
+  };
+  for (auto &reg : registers) {
+    unsigned width = slots[reg.state].width;
+    uint64_t *nextUndef = next + width * n;
+    if (reg.next == ~0U) {
+      std::fill_n(next, (width + 1) * n, ~0ULL);
+      next += (width + 1) * n;
+      continue;
+    }
+
+    // The reset takes precedence over the enable.
+    const uint64_t *enable =
+        reg.enable == ~0U ? nullptr : getBit(reg.enable, 0);
+    const uint64_t *reset = reg.reset == ~0U ? nullptr : getBit(reg.reset, 0);
+    for (unsigned i = 0; i < width; ++i) {
+      const uint64_t *state = getBit(reg.state, i);
+      const uint64_t *input = getBit(reg.next, i);
+      const uint64_t *resetValue =
+          reset ? getBit(reg.resetValue, i) : nullptr;
+      for (unsigned k = 0; k < n; ++k) {
+        uint64_t value = input[k];
+        if (enable)
+          value = (enable[k] & value) | (~enable[k] & state[k]);
+        if (reset)
+          value = (reset[k] & resetValue[k]) | (~reset[k] & value);
+        next[i * n + k] = value;
+      }
+    }
+
+    // The new state is undefined wherever the selected input is.
+    if (getUndef(reg.state)) {
+      for (unsigned k = 0; k < n; ++k) {
+        uint64_t en = enable ? enable[k] : ~0ULL;
+        uint64_t rst = reset ? reset[k] : 0;
+        nextUndef[k] = undefAt(reg.enable, k) | undefAt(reg.reset, k) |
+                       (undefAt(reg.next, k) & en & ~rst) |
+                       (undefAt(reg.resetValue, k) & rst) |
+                       (undefAt(reg.state, k) & ~en & ~rst);
+      }
+    }
+    next += (width + 1) * n;
+  }
+
+  next = scratch.data();
+  for (auto &reg : registers) {
+    unsigned width = slots[reg.state].width;
+    std::copy_n(next, width * n, getBit(reg.state, 0));
+    if (uint64_t *undef = getUndef(reg.state))
+      std::copy_n(next + width * n, n, undef);
+    next += (width + 1) * n;
+  }
+}
+
+void BitParallelSimulator::resetRegisters() {
+  for (auto &reg : registers) {
+    unsigned width = slots[reg.state].width;
+    for (unsigned i = 0; i < width; ++i)
+      std::fill_n(getBit(reg.state, i), numWords,
+                  reg.preset.getBitWidth() == width && reg.preset[i] ? ~0ULL
+                                                                     : 0);
+    if (uint64_t *undef = getUndef(reg.state))
+      std::fill_n(undef, numWords, 0);
+  }
+}
+
+void BitParallelSimulator::randomizeRegisters(std::mt19937_64 &rng) {
+  for (auto &reg : registers) {
+    unsigned width = slots[reg.state].width;
+    std::generate_n(getBit(reg.state, 0), width * numWords,
+                    [&] { return rng(); });
+    if (uint64_t *undef = getUndef(reg.state))
+      std::fill_n(undef, numWords, 0);
+  }
+}
+
+void BitParallelSimulator::randomizeInputs(std::mt19937_64 &rng) {
+  for (unsigned i = 0, e = inputs.size(); i < e; ++i)
+    if (isKnown(inputs[i]))
+      for (auto &word : getInputWords(i))
+        word = rng();
+}
+
+//===----------------------------------------------------------------------===//
+// Accessors
+//===----------------------------------------------------------------------===//
+
+ArrayRef<uint64_t> BitParallelSimulator::getWords(Value value) const {
+  unsigned slot = slotIndices.lookup(value);
+  return ArrayRef<uint64_t>(getBit(slot, 0), slots[slot].width * numWords);
+}
+
+MutableArrayRef<uint64_t> BitParallelSimulator::getInputWords(unsigned input) {
+  unsigned slot = slotIndices.lookup(inputs[input]);
+  return MutableArrayRef<uint64_t>(getBit(slot, 0),
+                                   slots[slot].width * numWords);
+}
+
+ArrayRef<uint64_t> BitParallelSimulator::getUndefinedMask(Value value) const {
+  const Slot &slot = slots[slotIndices.lookup(value)];
+  if (slot.undefOffset == ~0U)
+    return {};
+  return ArrayRef<uint64_t>(storage.data() + slot.undefOffset, numWords);
+}
+
+bool BitParallelSimulator::isDefined(Value value) const {
+  return llvm::all_of(getUndefinedMask(value),
+                      [](uint64_t word) { return word == 0; });
+}
+
+APInt BitParallelSimulator::getPattern(Value value, unsigned pattern) const {
+  unsigned slot = slotIndices.lookup(value);
+  unsigned width = slots[slot].width;
+  APInt result(width, 0);
+  for (unsigned i = 0; i < width; ++i)
+    if (getBit(slot, i)[pattern / 64] >> (pattern % 64) & 1)
+      result.setBit(i);
+  return result;
+}
+
+void BitParallelSimulator::setInputPattern(unsigned input, unsigned pattern,
+                                           const APInt &value) {
+  unsigned slot = slotIndices.lookup(inputs[input]);
+  assert(value.getBitWidth() == slots[slot].width && "width mismatch");
+  uint64_t bit = 1ULL << (pattern % 64);
+  for (unsigned i = 0, e = slots[slot].width; i < e; ++i) {
+    uint64_t &word = getBit(slot, i)[pattern / 64];
+    word = value[i] ? word | bit : word & ~bit;
+  }
+}
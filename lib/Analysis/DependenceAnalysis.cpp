@@ -19,7 +19,10 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Affine/LoopUtils.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
 
 using namespace mlir;
 using namespace mlir::affine;
@@ -127,6 +130,86 @@ static void checkMemrefDependence(SmallVectorImpl<Operation *> &memoryOps,
   }
 }
 
+/// Returns the scf.for loop directly enclosing a memory operation, or null if
+/// the innermost loop around it is of another kind.
+static scf::ForOp getEnclosingSCFForOp(Operation *op) {
+  return dyn_cast_or_null<scf::ForOp>(
+      op->getParentOfType<LoopLikeOpInterface>());
+}
+
+/// Helper to check memory operation pairs in scf.for loops for dependences.
+/// The induction variable of an scf.for is no valid affine dimension, so
+/// neither memref nor affine accesses have an access function in terms of it.
+/// This conservatively assumes that two accesses to the same memref, at least
+/// one of them a store, touch the same location. The dependence is within the
+/// same iteration if the source comes first in the loop body, and from the
+/// previous iteration otherwise. The latter is ruled out if both are memref
+/// accesses with the same indices and one of them is the induction variable.
+/// This currently does not consider aliasing.
+static void checkSCFMemrefDependence(SmallVectorImpl<Operation *> &memoryOps,
+                                     MemoryDependenceResult &results) {
+  auto getMemRef = [](Operation *op) -> Value {
+    if (auto readOp = dyn_cast<AffineReadOpInterface>(op))
+      return readOp.getMemRef();
+    if (auto writeOp = dyn_cast<AffineWriteOpInterface>(op))
+      return writeOp.getMemRef();
+    if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+      return loadOp.getMemRef();
+    return cast<memref::StoreOp>(op).getMemRef();
+  };
+  auto isStore = [](Operation *op) {
+    return isa<memref::StoreOp, AffineWriteOpInterface>(op);
+  };
+  auto haveSameIVIndices = [](Operation *a, Operation *b, Value iv) {
+    auto getIndices = [](Operation *op) -> std::optional<ValueRange> {
+      if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+        return ValueRange(loadOp.getIndices());
+      if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+        return ValueRange(storeOp.getIndices());
+      return std::nullopt;
+    };
+    auto aIndices = getIndices(a);
+    auto bIndices = getIndices(b);
+    return aIndices && bIndices && llvm::equal(*aIndices, *bIndices) &&
+           llvm::is_contained(*aIndices, iv);
+  };
+
+  // The memory operations are collected in program order.
+  for (auto [srcIndex, source] : llvm::enumerate(memoryOps)) {
+    scf::ForOp forOp = getEnclosingSCFForOp(source);
+    for (auto [dstIndex, destination] : llvm::enumerate(memoryOps)) {
+      if (source == destination ||
+          getEnclosingSCFForOp(destination) != forOp)
+        continue;
+
+      // Initialize the dependence list for this destination.
+      if (results.count(destination) == 0)
+        results[destination] = SmallVector<MemoryDependence>();
+
+      if (!isStore(source) && !isStore(destination))
+        continue;
+      if (getMemRef(source) != getMemRef(destination))
+        continue;
+
+      int64_t distance = 0;
+      if (srcIndex > dstIndex) {
+        if (haveSameIVIndices(source, destination, forOp.getInductionVar()))
+          continue;
+        distance = 1;
+      }
+
+      // Only the smallest distance is known, which is all the scheduling
+      // problem needs.
+      DependenceComponent depComp;
+      depComp.op = forOp;
+      depComp.lb = distance;
+      depComp.ub = distance;
+      results[destination].emplace_back(source, DependenceResult::HasDependence,
+                                        ArrayRef(depComp));
+    }
+  }
+}
+
 /// MemoryDependenceAnalysis traverses any AffineForOps in the FuncOp body and
 /// checks for memory access dependences. Results are captured in a
 /// MemoryDependenceResult, which can by queried by Operation.
@@ -148,6 +231,16 @@ circt::analysis::MemoryDependenceAnalysis::MemoryDependenceAnalysis(
   // For each depth, check memref accesses.
   for (unsigned depth = 1, e = depthToLoops.size(); depth <= e; ++depth)
     checkMemrefDependence(memoryOps, depth, results);
+
+  // Collect and check load and store operations in scf.for loops.
+  SmallVector<Operation *> scfMemoryOps;
+  funcOp.walk([&](Operation *op) {
+    if (isa<memref::LoadOp, memref::StoreOp, AffineReadOpInterface,
+            AffineWriteOpInterface>(op) &&
+        getEnclosingSCFForOp(op))
+      scfMemoryOps.push_back(op);
+  });
+  checkSCFMemrefDependence(scfMemoryOps, results);
 }
 
 /// Returns the dependences, if any, that the given Operation depends on.
@@ -19,6 +19,7 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
 #include "mlir/Pass/AnalysisManager.h"
 #include <limits>
 
@@ -26,10 +27,10 @@ using namespace mlir;
 using namespace mlir::affine;
 using namespace circt::scheduling;
 
-/// CyclicSchedulingAnalysis constructs a CyclicProblem for each AffineForOp by
-/// performing a memory dependence analysis and inserting dependences into the
-/// problem. The client should retrieve the partially complete problem to add
-/// and associate operator types.
+/// CyclicSchedulingAnalysis constructs a CyclicProblem for each AffineForOp and
+/// innermost scf::ForOp by performing a memory dependence analysis and
+/// inserting dependences into the problem. The client should retrieve the
+/// partially complete problem to add and associate operator types.
 circt::analysis::CyclicSchedulingAnalysis::CyclicSchedulingAnalysis(
     Operation *op, AnalysisManager &am) {
   auto funcOp = cast<func::FuncOp>(op);
@@ -43,10 +44,19 @@ circt::analysis::CyclicSchedulingAnalysis::CyclicSchedulingAnalysis(
     getPerfectlyNestedLoops(nestedLoops, root);
     analyzeForOp(nestedLoops.back(), memoryAnalysis);
   }
+
+  // Only consider scf::ForOps without nested loops.
+  for (auto forOp : funcOp.getOps<scf::ForOp>()) {
+    auto nested = forOp.getBody()->walk(
+        [](LoopLikeOpInterface) { return WalkResult::interrupt(); });
+    if (!nested.wasInterrupted())
+      analyzeForOp(forOp, memoryAnalysis);
+  }
 }
 
+template <typename ForOpTy>
 void circt::analysis::CyclicSchedulingAnalysis::analyzeForOp(
-    AffineForOp forOp, MemoryDependenceAnalysis memoryAnalysis) {
+    ForOpTy forOp, MemoryDependenceAnalysis memoryAnalysis) {
   // Create a cyclic scheduling problem.
   CyclicProblem problem(forOp);
 
@@ -155,7 +165,7 @@ void circt::analysis::CyclicSchedulingAnalysis::analyzeForOp(
 }
 
 CyclicProblem &
-circt::analysis::CyclicSchedulingAnalysis::getProblem(AffineForOp forOp) {
+circt::analysis::CyclicSchedulingAnalysis::getProblem(Operation *forOp) {
   auto problem = problems.find(forOp);
   assert(problem != problems.end() && "expected problem to exist");
   return problem->second;
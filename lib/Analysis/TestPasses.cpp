@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "circt/Analysis/BitParallelSimulation.h"
 #include "circt/Analysis/DebugAnalysis.h"
 #include "circt/Analysis/DependenceAnalysis.h"
 #include "circt/Analysis/FIRRTLInstanceInfo.h"
@@ -17,12 +18,16 @@
 #include "circt/Analysis/SchedulingAnalysis.h"
 #include "circt/Dialect/FIRRTL/FIRRTLInstanceGraph.h"
 #include "circt/Dialect/HW/HWInstanceGraph.h"
+#include "circt/Dialect/HW/HWOps.h"
 #include "circt/Scheduling/Problems.h"
 #include "mlir/Dialect/Affine/IR/AffineMemoryOpInterfaces.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Value.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
 #include "mlir/Pass/Pass.h"
 #include "llvm/ADT/DepthFirstIterator.h"
 #include "llvm/Support/Debug.h"
@@ -82,7 +87,11 @@ void TestDependenceAnalysisPass::runOnOperation() {
   MemoryDependenceAnalysis analysis(getOperation());
 
   getOperation().walk([&](Operation *op) {
-    if (!isa<AffineReadOpInterface, AffineWriteOpInterface>(op))
+    bool isSCFMemoryOp =
+        isa<memref::LoadOp, memref::StoreOp>(op) &&
+        isa_and_nonnull<scf::ForOp>(op->getParentOfType<LoopLikeOpInterface>());
+    if (!isa<AffineReadOpInterface, AffineWriteOpInterface>(op) &&
+        !isSCFMemoryOp)
       return;
 
     SmallVector<Attribute> deps;
@@ -132,18 +141,30 @@ void TestSchedulingAnalysisPass::runOnOperation() {
 
   CyclicSchedulingAnalysis analysis = getAnalysis<CyclicSchedulingAnalysis>();
 
-  getOperation().walk([&](AffineForOp forOp) {
-    if (isa<AffineForOp>(forOp.getBody()->front()))
-      return;
+  auto annotateDependences = [&](Operation *forOp, Block *body) {
     CyclicProblem problem = analysis.getProblem(forOp);
-    forOp.getBody()->walk([&](Operation *op) {
+    body->walk([&](Operation *op) {
       for (auto dep : problem.getDependences(op)) {
         assert(!dep.isInvalid());
         if (dep.isAuxiliary())
           op->setAttr("dependence", UnitAttr::get(context));
       }
     });
+  };
+
+  getOperation().walk([&](AffineForOp forOp) {
+    if (isa<AffineForOp>(forOp.getBody()->front()))
+      return;
+    annotateDependences(forOp, forOp.getBody());
   });
+
+  // The analysis only covers top-level scf.for loops without nested loops.
+  for (auto forOp : getOperation().getOps<scf::ForOp>()) {
+    auto nested = forOp.getBody()->walk(
+        [](LoopLikeOpInterface) { return WalkResult::interrupt(); });
+    if (!nested.wasInterrupted())
+      annotateDependences(forOp, forOp.getBody());
+  }
 }
 
 //===----------------------------------------------------------------------===//
@@ -255,6 +276,82 @@ void FIRRTLInstanceInfoPass::runOnOperation() {
     printModuleInfo(op, iInfo);
 }
 
+//===----------------------------------------------------------------------===//
+// BitParallelSimulation
+//===----------------------------------------------------------------------===//
+
+namespace {
+struct TestBitParallelSimulationPass
+    : public PassWrapper<TestBitParallelSimulationPass,
+                         OperationPass<hw::HWModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestBitParallelSimulationPass)
+
+  TestBitParallelSimulationPass() = default;
+  TestBitParallelSimulationPass(const TestBitParallelSimulationPass &pass)
+      : PassWrapper(pass) {}
+
+  void runOnOperation() override;
+  StringRef getArgument() const override {
+    return "test-bit-parallel-simulation";
+  }
+  StringRef getDescription() const override {
+    return "Simulate each module on the patterns where input `i` is `p + i` "
+           "and annotate the values of the first patterns as attributes";
+  }
+
+  Option<unsigned> numPatterns{*this, "patterns",
+                               llvm::cl::desc("Number of patterns to show"),
+                               llvm::cl::init(4)};
+  Option<unsigned> numCycles{
+      *this, "cycles",
+      llvm::cl::desc("Number of clock cycles to simulate before annotating"),
+      llvm::cl::init(0)};
+};
+} // namespace
+
+void TestBitParallelSimulationPass::runOnOperation() {
+  auto module = getOperation();
+  BitParallelSimulator sim(llvm::divideCeil(std::max(numPatterns, 1U), 64));
+  if (failed(sim.compile(*module.getBodyBlock())))
+    return signalPassFailure();
+
+  for (unsigned i = 0, e = sim.getInputs().size(); i < e; ++i) {
+    unsigned width = sim.getPattern(sim.getInputs()[i], 0).getBitWidth();
+    for (unsigned p = 0, e = sim.getNumPatterns(); p < e; ++p)
+      sim.setInputPattern(i, p, APInt(64, p + i).zextOrTrunc(width));
+  }
+  for (unsigned cycle = 0; cycle < numCycles; ++cycle) {
+    sim.evaluate();
+    sim.step();
+  }
+  sim.evaluate();
+
+  auto getPatterns = [&](Value value) -> Attribute {
+    SmallVector<Attribute> patterns;
+    auto undefined = sim.getUndefinedMask(value);
+    for (unsigned p = 0; p < numPatterns; ++p) {
+      if (!undefined.empty() && (undefined[p / 64] >> (p % 64) & 1))
+        patterns.push_back(StringAttr::get(&getContext(), "x"));
+      else if (auto type = dyn_cast<IntegerType>(value.getType()))
+        patterns.push_back(IntegerAttr::get(type, sim.getPattern(value, p)));
+      else
+        patterns.push_back(
+            IntegerAttr::get(IntegerType::get(&getContext(), 1),
+                             sim.getPattern(value, p)));
+    }
+    return ArrayAttr::get(&getContext(), patterns);
+  };
+  module.walk([&](Operation *op) {
+    if (op->getNumResults() == 1 && sim.isKnown(op->getResult(0)))
+      op->setAttr("sim.values", getPatterns(op->getResult(0)));
+  });
+  SmallVector<Attribute> outputs;
+  for (auto output : sim.getOutputs())
+    outputs.push_back(getPatterns(output));
+  module.getBodyBlock()->getTerminator()->setAttr(
+      "sim.outputs", ArrayAttr::get(&getContext(), outputs));
+}
+
 //===----------------------------------------------------------------------===//
 // Pass registration
 //===----------------------------------------------------------------------===//
@@ -277,6 +374,9 @@ void registerAnalysisTestPasses() {
   registerPass([]() -> std::unique_ptr<Pass> {
     return std::make_unique<FIRRTLInstanceInfoPass>();
   });
+  registerPass([]() -> std::unique_ptr<Pass> {
+    return std::make_unique<TestBitParallelSimulationPass>();
+  });
 }
 } // namespace test
 } // namespace circt
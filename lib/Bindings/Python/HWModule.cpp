@@ -11,6 +11,7 @@
 #include "circt-c/Dialect/HW.h"
 
 #include "mlir-c/BuiltinAttributes.h"
+#include "mlir-c/BuiltinTypes.h"
 #include "mlir/Bindings/Python/PybindAdaptors.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/raw_ostream.h"
@@ -20,16 +21,79 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/pytypes.h>
 #include <pybind11/stl.h>
+
+#include <cstring>
 namespace py = pybind11;
 
 using namespace circt;
 using namespace mlir::python::adaptors;
 
+/// Read a flat sequence of integers. Objects implementing the buffer protocol
+/// with 64-bit integer elements, such as NumPy `int64` arrays, are read
+/// directly from their memory; anything else is converted element by element.
+static std::vector<int64_t> getInt64Values(py::handle values) {
+  if (py::isinstance<py::buffer>(values)) {
+    py::buffer_info info =
+        py::reinterpret_borrow<py::buffer>(values).request();
+    if (info.ndim == 1 && info.itemsize == sizeof(int64_t) &&
+        (info.format == "q" || info.format == "l")) {
+      std::vector<int64_t> result(info.shape[0]);
+      auto *data = static_cast<const char *>(info.ptr);
+      for (size_t i = 0, e = result.size(); i < e; ++i)
+        std::memcpy(&result[i], data + i * info.strides[0], sizeof(int64_t));
+      return result;
+    }
+  }
+  return values.cast<std::vector<int64_t>>();
+}
+
+/// Create one `hw.constant` of the given type per integer in `values`. The ops
+/// are inserted into `block`, before `before` if it is given and at the end of
+/// the block otherwise. This builds the ops through the C API in a single call
+/// instead of constructing a Python `ConstantOp` per value.
+static std::vector<MlirValue>
+createConstants(MlirType type, py::handle values, py::object block,
+                std::optional<MlirOperation> before, MlirLocation loc) {
+  MlirBlock mlirBlock =
+      mlirPythonCapsuleToBlock(mlirApiObjectToCapsule(block).ptr());
+  if (mlirBlockIsNull(mlirBlock))
+    throw py::type_error("expected a Block");
+  if (!mlirTypeIsAInteger(type))
+    throw py::type_error("hw.constant requires an integer type");
+
+  MlirContext context = mlirTypeGetContext(type);
+  MlirIdentifier valueName =
+      mlirIdentifierGet(context, mlirStringRefCreateFromCString("value"));
+  MlirStringRef opName = mlirStringRefCreateFromCString("hw.constant");
+
+  std::vector<int64_t> ints = getInt64Values(values);
+  std::vector<MlirValue> results;
+  results.reserve(ints.size());
+  for (int64_t value : ints) {
+    MlirNamedAttribute attr =
+        mlirNamedAttributeGet(valueName, mlirIntegerAttrGet(type, value));
+    MlirOperationState state = mlirOperationStateGet(opName, loc);
+    mlirOperationStateAddResults(&state, 1, &type);
+    mlirOperationStateAddAttributes(&state, 1, &attr);
+    MlirOperation op = mlirOperationCreate(&state);
+    if (before)
+      mlirBlockInsertOwnedOperationBefore(mlirBlock, *before, op);
+    else
+      mlirBlockAppendOwnedOperation(mlirBlock, op);
+    results.push_back(mlirOperationGetResult(op, 0));
+  }
+  return results;
+}
+
 /// Populate the hw python module.
 void circt::python::populateDialectHWSubmodule(py::module &m) {
   m.doc() = "HW dialect Python native extension";
 
   m.def("get_bitwidth", &hwGetBitWidth);
+  m.def("create_constants", &createConstants,
+        "Create a `hw.constant` for each integer in a sequence or buffer",
+        py::arg("type"), py::arg("values"), py::arg("block"),
+        py::arg("before") = py::none(), py::arg("loc") = py::none());
 
   mlir_type_subclass(m, "InOutType", hwTypeIsAInOut)
       .def_classmethod("get",
@@ -15,6 +15,8 @@
 #include "mlir/Bindings/Python/PybindAdaptors.h"
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+
+#include <limits>
 namespace py = pybind11;
 
 using namespace mlir;
@@ -51,6 +53,14 @@ OMEvaluatorValue pythonValueToOMEvaluatorValue(PythonValue result,
 static PythonPrimitive omPrimitiveToPythonValue(MlirAttribute attr);
 static MlirAttribute omPythonValueToPrimitive(PythonPrimitive value,
                                               MlirContext ctx);
+static int64_t omIntegerToInt64(MlirAttribute attr);
+
+/// An owned array of 64-bit integers exposed through the Python buffer
+/// protocol, so that `memoryview` and `numpy.asarray` can view the values
+/// without copying or converting them one by one.
+struct IntegerArray {
+  std::vector<int64_t> values;
+};
 
 /// Provides a List class by simply wrapping the OMObject CAPI.
 struct List {
@@ -61,6 +71,14 @@ struct List {
   intptr_t getNumElements() { return omEvaluatorListGetNumElements(value); }
 
   PythonValue getElement(intptr_t i);
+
+  /// Return all elements, converted in a single call.
+  std::vector<PythonValue> getElements();
+
+  /// Return all elements as integers. Throws if an element is not an integer
+  /// or does not fit in 64 bits.
+  IntegerArray getIntegers();
+
   OMEvaluatorValue getValue() const { return value; }
 
 private:
@@ -102,6 +120,21 @@ struct Map {
     return pyFieldNames;
   }
 
+  /// Return all key-value pairs, converted in a single call.
+  std::vector<std::pair<PythonPrimitive, PythonValue>> getItems() {
+    MlirAttribute keys = omEvaluatorMapGetKeys(value);
+    intptr_t numKeys = mlirArrayAttrGetNumElements(keys);
+
+    std::vector<std::pair<PythonPrimitive, PythonValue>> items;
+    items.reserve(numKeys);
+    for (intptr_t i = 0; i < numKeys; ++i) {
+      MlirAttribute key = mlirArrayAttrGetElement(keys, i);
+      items.emplace_back(omPrimitiveToPythonValue(key), dunderGetItemAttr(key));
+    }
+
+    return items;
+  }
+
   /// Look up the value. A key is an integer, string or attribute.
   PythonValue dunderGetItemAttr(MlirAttribute key);
   PythonValue dunderGetItemNamed(const std::string &key);
@@ -229,7 +262,8 @@ private:
 /// Provides an Evaluator class by simply wrapping the OMEvaluator CAPI.
 struct Evaluator {
   // Instantiate an Evaluator with a reference to the underlying OMEvaluator.
-  Evaluator(MlirModule mod) : evaluator(omEvaluatorNew(mod)) {}
+  Evaluator(MlirModule mod, bool memoize, bool lazy)
+      : evaluator(omEvaluatorNewWithOptions(mod, memoize, lazy)) {}
 
   // Instantiate an Object.
   Object instantiate(MlirAttribute className,
@@ -290,6 +324,43 @@ PythonValue List::getElement(intptr_t i) {
   return omEvaluatorValueToPythonValue(omEvaluatorListGetElement(value, i));
 }
 
+std::vector<PythonValue> List::getElements() {
+  intptr_t numElements = getNumElements();
+  std::vector<PythonValue> elements;
+  elements.reserve(numElements);
+  for (intptr_t i = 0; i < numElements; ++i)
+    elements.push_back(getElement(i));
+  return elements;
+}
+
+IntegerArray List::getIntegers() {
+  IntegerArray array;
+  intptr_t numElements = getNumElements();
+  array.values.reserve(numElements);
+  for (intptr_t i = 0; i < numElements; ++i) {
+    OMEvaluatorValue element = omEvaluatorListGetElement(value, i);
+    while (omEvaluatorValueIsAReference(element))
+      element = omEvaluatorValueGetReferenceValue(element);
+    if (omEvaluatorValueIsNull(element))
+      throw py::value_error("unable to get element, see previous error(s)");
+    if (!omEvaluatorValueIsAPrimitive(element))
+      throw py::type_error("list element is not an integer");
+    array.values.push_back(
+        omIntegerToInt64(omEvaluatorValueGetPrimitive(element)));
+  }
+  return array;
+}
+
+/// Return all integers of a ListAttr.
+static IntegerArray omListAttrGetIntegers(MlirAttribute attr) {
+  IntegerArray array;
+  intptr_t numElements = omListAttrGetNumElements(attr);
+  array.values.reserve(numElements);
+  for (intptr_t i = 0; i < numElements; ++i)
+    array.values.push_back(omIntegerToInt64(omListAttrGetElement(attr, i)));
+  return array;
+}
+
 class PyMapAttrIterator {
 public:
   PyMapAttrIterator(MlirAttribute attr) : attr(std::move(attr)) {}
@@ -426,6 +497,29 @@ static PythonPrimitive omPrimitiveToPythonValue(MlirAttribute attr) {
   throw py::type_error("Unexpected OM primitive attribute");
 }
 
+// Convert an OM or builtin integer attribute to an int64_t. Signless and
+// unsigned integers are zero-extended, which matches their conversion to Python
+// integers above.
+static int64_t omIntegerToInt64(MlirAttribute attr) {
+  if (omAttrIsAIntegerAttr(attr))
+    attr = omIntegerAttrGetInt(attr);
+  if (!mlirAttributeIsAInteger(attr))
+    throw py::type_error("list element is not an integer");
+
+  MlirType type = mlirAttributeGetType(attr);
+  if (mlirTypeIsAIndex(type))
+    return mlirIntegerAttrGetValueInt(attr);
+  if (mlirIntegerTypeGetWidth(type) > 64)
+    throw py::overflow_error("integer is wider than 64 bits");
+  if (mlirIntegerTypeIsSigned(type))
+    return mlirIntegerAttrGetValueSInt(attr);
+
+  uint64_t value = mlirIntegerAttrGetValueUInt(attr);
+  if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+    throw py::overflow_error("integer does not fit in a signed 64-bit value");
+  return value;
+}
+
 // Convert a primitive PythonValue to a generic MLIR Attribute. This is
 // basically a C++ fast path of the parts of var_to_attribute that we use in the
 // OM dialect.
@@ -528,7 +622,8 @@ void circt::python::populateDialectOMSubmodule(py::module &m) {
 
   // Add the Evaluator class definition.
   py::class_<Evaluator>(m, "Evaluator")
-      .def(py::init<MlirModule>(), py::arg("module"))
+      .def(py::init<MlirModule, bool, bool>(), py::arg("module"),
+           py::arg("memoize") = false, py::arg("lazy") = false)
       .def("instantiate", &Evaluator::instantiate, "Instantiate an Object",
            py::arg("class_name"), py::arg("actual_params"))
       .def_property_readonly("module", &Evaluator::getModule,
@@ -538,7 +633,10 @@ void circt::python::populateDialectOMSubmodule(py::module &m) {
   py::class_<List>(m, "List")
       .def(py::init<List>(), py::arg("list"))
       .def("__getitem__", &List::getElement)
-      .def("__len__", &List::getNumElements);
+      .def("__len__", &List::getNumElements)
+      .def("elements", &List::getElements, "Get all elements of the List")
+      .def("to_int64_array", &List::getIntegers,
+           "Get the integer elements of the List as a buffer of int64 values");
 
   py::class_<Tuple>(m, "Tuple")
       .def(py::init<Tuple>(), py::arg("tuple"))
@@ -550,8 +648,21 @@ void circt::python::populateDialectOMSubmodule(py::module &m) {
       .def(py::init<Map>(), py::arg("map"))
       .def("__getitem__", &Map::dunderGetItem)
       .def("keys", &Map::getKeys)
+      .def("items", &Map::getItems, "Get all key-value pairs of the Map")
       .def_property_readonly("type", &Map::getType, "The Type of the Map");
 
+  // Add the IntegerArray class definition.
+  py::class_<IntegerArray>(m, "IntegerArray", py::buffer_protocol())
+      .def_buffer([](IntegerArray &array) {
+        return py::buffer_info(
+            array.values.data(), sizeof(int64_t),
+            py::format_descriptor<int64_t>::format(), /*ndim=*/1,
+            {static_cast<py::ssize_t>(array.values.size())},
+            {static_cast<py::ssize_t>(sizeof(int64_t))}, /*readonly=*/true);
+      })
+      .def("__len__",
+           [](const IntegerArray &array) { return array.values.size(); });
+
   // Add the BasePath class definition.
   py::class_<BasePath>(m, "BasePath")
       .def(py::init<BasePath>(), py::arg("basepath"))
@@ -603,13 +714,26 @@ void circt::python::populateDialectOMSubmodule(py::module &m) {
       .def("__getitem__", &omListAttrGetElement)
       .def("__len__", &omListAttrGetNumElements)
       .def("__iter__",
-           [](MlirAttribute arr) { return PyListAttrIterator(arr); });
+           [](MlirAttribute arr) { return PyListAttrIterator(arr); })
+      .def("to_int64_array", &omListAttrGetIntegers,
+           "Get the integer elements as a buffer of int64 values");
   PyListAttrIterator::bind(m);
 
   // Add the MapAttr definition
   mlir_attribute_subclass(m, "MapAttr", omAttrIsAMapAttr)
       .def("__iter__", [](MlirAttribute arr) { return PyMapAttrIterator(arr); })
-      .def("__len__", &omMapAttrGetNumElements);
+      .def("__len__", &omMapAttrGetNumElements)
+      .def("items", [](MlirAttribute attr) {
+        std::vector<std::pair<std::string, PythonPrimitive>> items;
+        for (intptr_t i = 0, e = omMapAttrGetNumElements(attr); i < e; ++i) {
+          MlirStringRef key =
+              mlirIdentifierStr(omMapAttrGetElementKey(attr, i));
+          items.emplace_back(
+              std::string(key.data, key.length),
+              omPrimitiveToPythonValue(omMapAttrGetElementValue(attr, i)));
+        }
+        return items;
+      });
   PyMapAttrIterator::bind(m);
 
   // Add the AnyType class definition.
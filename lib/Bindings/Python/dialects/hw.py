@@ -393,6 +393,14 @@ class ConstantOp(ConstantOp):
   def create(data_type, value):
     return hw.ConstantOp(IntegerAttr.get(data_type, value))
 
+  @staticmethod
+  def create_many(data_type, values) -> list[Value]:
+    """Create a constant of `data_type` for each integer in `values` at the
+    current insertion point, returning the constant values. `values` may be any
+    sequence of integers; NumPy int64 arrays are read without conversion."""
+    ip = InsertionPoint.current
+    return create_constants(data_type, values, ip.block, ip.ref_operation)
+
 
 @_ods_cext.register_operation(_Dialect, replace=True)
 class BitcastOp(BitcastOp):
@@ -84,10 +84,11 @@ class List(BaseList):
     val = super().__getitem__(i)
     return wrap_mlir_object(val)
 
-  # Support iterating over a List by yielding its elements.
+  # Support iterating over a List by yielding its elements, which are
+  # converted in one call instead of one call per element.
   def __iter__(self):
-    for i in range(0, self.__len__()):
-      yield self.__getitem__(i)
+    for val in super().elements():
+      yield wrap_mlir_object(val)
 
 
 class Tuple(BaseTuple):
@@ -118,17 +119,16 @@ class Map(BaseMap):
     return [wrap_mlir_object(arg) for arg in super().keys()]
 
   def items(self):
-    for i in self:
-      yield i
+    for (k, v) in super().items():
+      yield (wrap_mlir_object(k), wrap_mlir_object(v))
 
   def values(self):
-    for (_, v) in self:
+    for (_, v) in self.items():
       yield v
 
   # Support iterating over a Map
   def __iter__(self):
-    for i in super().keys():
-      yield (wrap_mlir_object(i), self.__getitem__(i))
+    return self.items()
 
 
 class BasePath(BaseBasePath):
@@ -163,11 +163,17 @@ class Object(BaseObject):
 # Define the Evaluator class by inheriting from the base implementation in C++.
 class Evaluator(BaseEvaluator):
 
-  def __init__(self, mod: Module) -> None:
-    """Instantiate an Evaluator with a Module."""
+  def __init__(self,
+               mod: Module,
+               memoize: bool = False,
+               lazy: bool = False) -> None:
+    """Instantiate an Evaluator with a Module. If `memoize` is set,
+    instantiations of a class with identical actual parameters are evaluated
+    only once. If `lazy` is set, the fields of an Object are evaluated when
+    they are first read."""
 
     # Call the base constructor.
-    super().__init__(mod)
+    super().__init__(mod, memoize, lazy)
 
     # Set up logging for diagnostics.
     logging.basicConfig(
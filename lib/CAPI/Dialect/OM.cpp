@@ -124,6 +124,15 @@ OMEvaluator omEvaluatorNew(MlirModule mod) {
   return wrap(new Evaluator(unwrap(mod)));
 }
 
+/// Construct an Evaluator with an IR module and options.
+OMEvaluator omEvaluatorNewWithOptions(MlirModule mod, bool memoizeInstances,
+                                      bool lazy) {
+  EvaluatorOptions options;
+  options.memoizeInstances = memoizeInstances;
+  options.lazy = lazy;
+  return wrap(new Evaluator(unwrap(mod), options));
+}
+
 /// Use the Evaluator to Instantiate an Object from its class name and actual
 /// parameters.
 OMEvaluatorValue omEvaluatorInstantiate(OMEvaluator evaluator,
@@ -281,6 +281,11 @@ void circtFirtoolOptionsSetAddVivadoRAMAddressConflictSynthesisBugWorkaround(
   unwrap(options)->setAddVivadoRAMAddressConflictSynthesisBugWorkaround(value);
 }
 
+void circtFirtoolOptionsSetOptimizeMemoriesForSimulation(
+    CirctFirtoolFirtoolOptions options, bool value) {
+  unwrap(options)->setOptimizeMemoriesForSimulation(value);
+}
+
 void circtFirtoolOptionsSetCkgModuleName(CirctFirtoolFirtoolOptions options,
                                          MlirStringRef value) {
   unwrap(options)->setCkgModuleName(unwrap(value));
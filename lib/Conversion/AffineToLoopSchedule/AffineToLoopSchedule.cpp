@@ -24,10 +24,13 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Dominance.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/ImplicitLocOpBuilder.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/ADT/STLExtras.h"
@@ -35,6 +38,7 @@
 #include "llvm/Support/Debug.h"
 #include <cassert>
 #include <limits>
+#include <optional>
 
 #define DEBUG_TYPE "affine-to-loopschedule"
 
@@ -64,13 +68,18 @@ private:
   ModuloProblem getModuloProblem(CyclicProblem &prob);
   LogicalResult
   lowerAffineStructures(MemoryDependenceAnalysis &dependenceAnalysis);
-  LogicalResult populateOperatorTypes(SmallVectorImpl<AffineForOp> &loopNest,
+  template <typename ForOpTy>
+  LogicalResult pipelineLoopNest(SmallVectorImpl<ForOpTy> &loopNest,
+                                 bool skipUnschedulable = false);
+  template <typename ForOpTy>
+  LogicalResult populateOperatorTypes(SmallVectorImpl<ForOpTy> &loopNest,
                                       ModuloProblem &problem);
-  LogicalResult solveSchedulingProblem(SmallVectorImpl<AffineForOp> &loopNest,
+  template <typename ForOpTy>
+  LogicalResult solveSchedulingProblem(SmallVectorImpl<ForOpTy> &loopNest,
                                        ModuloProblem &problem);
-  LogicalResult
-  createLoopSchedulePipeline(SmallVectorImpl<AffineForOp> &loopNest,
-                             ModuloProblem &problem);
+  template <typename ForOpTy>
+  LogicalResult createLoopSchedulePipeline(SmallVectorImpl<ForOpTy> &loopNest,
+                                           ModuloProblem &problem);
 
   CyclicSchedulingAnalysis *schedulingAnalysis;
 };
@@ -127,23 +136,59 @@ void AffineToLoopSchedule::runOnOperation() {
     if (nestedLoops.size() != 1)
       continue;
 
-    ModuloProblem moduloProblem =
-        getModuloProblem(schedulingAnalysis->getProblem(nestedLoops.back()));
-
-    // Populate the target operator types.
-    if (failed(populateOperatorTypes(nestedLoops, moduloProblem)))
+    if (failed(pipelineLoopNest(nestedLoops)))
       return signalPassFailure();
+  }
 
-    // Solve the scheduling problem computed by the analysis.
-    if (failed(solveSchedulingProblem(nestedLoops, moduloProblem)))
-      return signalPassFailure();
+  // Pipeline scf.for loops without nested loops, whose memory dependences are
+  // derived from the memrefs they access rather than affine access functions.
+  // Loops that cannot be scheduled are left to the sequential lowering.
+  auto scfLoops = getOperation().getOps<scf::ForOp>();
+  for (auto root : llvm::make_early_inc_range(scfLoops)) {
+    auto nested = root.getBody()->walk(
+        [](LoopLikeOpInterface) { return WalkResult::interrupt(); });
+    if (nested.wasInterrupted())
+      continue;
 
-    // Convert the IR.
-    if (failed(createLoopSchedulePipeline(nestedLoops, moduloProblem)))
+    SmallVector<scf::ForOp> nestedLoops = {root};
+    if (failed(pipelineLoopNest(nestedLoops, /*skipUnschedulable=*/true)))
       return signalPassFailure();
   }
 }
 
+/// Schedule a loop nest and lower it to a loopschedule pipeline. If
+/// `skipUnschedulable` is set, a loop nest containing unsupported operations or
+/// without a valid schedule is left untouched instead of failing the pass.
+template <typename ForOpTy>
+LogicalResult
+AffineToLoopSchedule::pipelineLoopNest(SmallVectorImpl<ForOpTy> &loopNest,
+                                       bool skipUnschedulable) {
+  ModuloProblem moduloProblem =
+      getModuloProblem(schedulingAnalysis->getProblem(loopNest.back()));
+
+  {
+    // Drop the diagnostics of a loop nest that is skipped.
+    std::optional<ScopedDiagnosticHandler> skipHandler;
+    if (skipUnschedulable)
+      skipHandler.emplace(&getContext(),
+                          [](Diagnostic &) { return success(); });
+
+    // Populate the target operator types, and solve the scheduling problem
+    // computed by the analysis.
+    if (failed(populateOperatorTypes(loopNest, moduloProblem)) ||
+        failed(solveSchedulingProblem(loopNest, moduloProblem))) {
+      if (!skipUnschedulable)
+        return failure();
+      LLVM_DEBUG(llvm::dbgs() << "Skipping unschedulable loop "
+                              << *loopNest.back() << "\n");
+      return success();
+    }
+  }
+
+  // Convert the IR.
+  return createLoopSchedulePipeline(loopNest, moduloProblem);
+}
+
 /// Apply the affine map from an 'affine.load' operation to its operands, and
 /// feed the results to a newly created 'memref.load' operation (which replaces
 /// the original 'affine.load').
@@ -283,8 +328,9 @@ LogicalResult AffineToLoopSchedule::lowerAffineStructures(
 /// targetting. Right now, we assume Calyx, which has a standard library with
 /// well-defined operator latencies. Ultimately, we should move this to a
 /// dialect interface in the Scheduling dialect.
+template <typename ForOpTy>
 LogicalResult AffineToLoopSchedule::populateOperatorTypes(
-    SmallVectorImpl<AffineForOp> &loopNest, ModuloProblem &problem) {
+    SmallVectorImpl<ForOpTy> &loopNest, ModuloProblem &problem) {
   // Scheduling analyis only considers the innermost loop nest for now.
   auto forOp = loopNest.back();
 
@@ -359,8 +405,9 @@ LogicalResult AffineToLoopSchedule::populateOperatorTypes(
 }
 
 /// Solve the pre-computed scheduling problem.
+template <typename ForOpTy>
 LogicalResult AffineToLoopSchedule::solveSchedulingProblem(
-    SmallVectorImpl<AffineForOp> &loopNest, ModuloProblem &problem) {
+    SmallVectorImpl<ForOpTy> &loopNest, ModuloProblem &problem) {
   // Scheduling analyis only considers the innermost loop nest for now.
   auto forOp = loopNest.back();
 
@@ -403,9 +450,52 @@ LogicalResult AffineToLoopSchedule::solveSchedulingProblem(
   return success();
 }
 
+namespace {
+/// The iteration space of a loop, materialized for a loopschedule pipeline.
+struct LoopBounds {
+  Value lowerBound;
+  Value upperBound;
+  Value step;
+  /// The comparison of the induction variable against the upper bound that
+  /// holds while the loop runs.
+  arith::CmpIPredicate predicate;
+  std::optional<int64_t> tripCount;
+};
+} // namespace
+
+static LoopBounds getLoopBounds(AffineForOp forOp,
+                                ImplicitLocOpBuilder &builder) {
+  LoopBounds bounds;
+  bounds.lowerBound = lowerAffineLowerBound(forOp, builder);
+  bounds.upperBound = lowerAffineUpperBound(forOp, builder);
+  int64_t stepValue = forOp.getStep().getSExtValue();
+  bounds.step = builder.create<arith::ConstantOp>(
+      IntegerAttr::get(builder.getIndexType(), stepValue));
+  bounds.predicate = arith::CmpIPredicate::ult;
+  if (auto tripCount = getConstantTripCount(forOp))
+    bounds.tripCount = *tripCount;
+  return bounds;
+}
+
+static LoopBounds getLoopBounds(scf::ForOp forOp,
+                                ImplicitLocOpBuilder &builder) {
+  LoopBounds bounds;
+  bounds.lowerBound = forOp.getLowerBound();
+  bounds.upperBound = forOp.getUpperBound();
+  bounds.step = forOp.getStep();
+  bounds.predicate = arith::CmpIPredicate::slt;
+  auto lb = getConstantIntValue(bounds.lowerBound);
+  auto ub = getConstantIntValue(bounds.upperBound);
+  auto step = getConstantIntValue(bounds.step);
+  if (lb && ub && step && *step > 0)
+    bounds.tripCount = *ub > *lb ? llvm::divideCeil(*ub - *lb, *step) : 0;
+  return bounds;
+}
+
 /// Create the loopschedule pipeline op for a loop nest.
+template <typename ForOpTy>
 LogicalResult AffineToLoopSchedule::createLoopSchedulePipeline(
-    SmallVectorImpl<AffineForOp> &loopNest, ModuloProblem &problem) {
+    SmallVectorImpl<ForOpTy> &loopNest, ModuloProblem &problem) {
   // Scheduling analyis only considers the innermost loop nest for now.
   auto forOp = loopNest.back();
 
@@ -414,11 +504,10 @@ LogicalResult AffineToLoopSchedule::createLoopSchedulePipeline(
   ImplicitLocOpBuilder builder(outerLoop.getLoc(), outerLoop);
 
   // Create Values for the loop's lower and upper bounds.
-  Value lowerBound = lowerAffineLowerBound(innerLoop, builder);
-  Value upperBound = lowerAffineUpperBound(innerLoop, builder);
-  int64_t stepValue = innerLoop.getStep().getSExtValue();
-  auto step = builder.create<arith::ConstantOp>(
-      IntegerAttr::get(builder.getIndexType(), stepValue));
+  LoopBounds bounds = getLoopBounds(innerLoop, builder);
+  Value lowerBound = bounds.lowerBound;
+  Value upperBound = bounds.upperBound;
+  Value step = bounds.step;
 
   // Create the pipeline op, with the same result types as the inner loop. An
   // iter arg is created for the induction variable.
@@ -433,8 +522,8 @@ LogicalResult AffineToLoopSchedule::createLoopSchedulePipeline(
   // If possible, attach a constant trip count attribute. This could be
   // generalized to support non-constant trip counts by supporting an AffineMap.
   std::optional<IntegerAttr> tripCountAttr;
-  if (auto tripCount = getConstantTripCount(forOp))
-    tripCountAttr = builder.getI64IntegerAttr(*tripCount);
+  if (bounds.tripCount)
+    tripCountAttr = builder.getI64IntegerAttr(*bounds.tripCount);
 
   auto pipeline = builder.create<LoopSchedulePipelineOp>(
       resultTypes, ii, tripCountAttr, iterArgs);
@@ -444,7 +533,7 @@ LogicalResult AffineToLoopSchedule::createLoopSchedulePipeline(
   Block &condBlock = pipeline.getCondBlock();
   builder.setInsertionPointToStart(&condBlock);
   auto cmpResult = builder.create<arith::CmpIOp>(
-      builder.getI1Type(), arith::CmpIPredicate::ult, condBlock.getArgument(0),
+      builder.getI1Type(), bounds.predicate, condBlock.getArgument(0),
       upperBound);
   condBlock.getTerminator()->insertOperands(0, {cmpResult});
 
@@ -488,13 +577,14 @@ LogicalResult AffineToLoopSchedule::createLoopSchedulePipeline(
   // For storing the range of stages an operation's results need to be valid for
   DenseMap<Operation *, std::pair<unsigned, unsigned>> pipeTimes;
 
+  Operation *loopTerminator = forOp.getBody()->getTerminator();
   for (auto startTime : startTimes) {
     auto group = startGroups[startTime];
 
     // Collect the return types for this stage. Operations whose results are not
     // used within this stage are returned.
-    auto isLoopTerminator = [forOp](Operation *op) {
-      return isa<AffineYieldOp>(op) && op->getParentOp() == forOp;
+    auto isLoopTerminator = [loopTerminator](Operation *op) {
+      return op == loopTerminator;
     };
 
     // Initialize set of registers up until this point in time
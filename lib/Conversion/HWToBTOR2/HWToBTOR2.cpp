@@ -31,8 +31,11 @@
 #include "circt/Dialect/Verif/VerifVisitors.h"
 #include "mlir/Pass/Pass.h"
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/raw_ostream.h"
+#include <map>
 
 namespace circt {
 #define GEN_PASS_DEF_CONVERTHWTOBTOR2
@@ -42,6 +45,115 @@ namespace circt {
 using namespace circt;
 using namespace hw;
 
+// Folds a value computed from constants, such as a register initializer, into
+// a single constant. Returns nothing if the value isn't constant.
+static std::optional<APInt> foldConstant(Value value) {
+  if (auto constOp = value.getDefiningOp<hw::ConstantOp>())
+    return constOp.getValue();
+
+  // Only combinational logic is folded
+  Operation *op = value.getDefiningOp();
+  if (!op || op->getNumResults() != 1 ||
+      !isa<comb::CombDialect>(op->getDialect()))
+    return {};
+
+  SmallVector<Attribute> operands;
+  for (auto operand : op->getOperands()) {
+    auto operandValue = foldConstant(operand);
+    if (!operandValue)
+      return {};
+    operands.push_back(IntegerAttr::get(operand.getType(), *operandValue));
+  }
+
+  SmallVector<OpFoldResult> results;
+  if (failed(op->fold(operands, results)) || results.size() != 1)
+    return {};
+  if (auto attr = dyn_cast_if_present<IntegerAttr>(
+          dyn_cast_if_present<Attribute>(results[0])))
+    return attr.getValue();
+  return {};
+}
+
+namespace {
+// Assigns the same number to values computed by structurally identical
+// expressions. Registers are leaves, numbered by the equivalence class they
+// are currently in.
+struct StructuralNumbering {
+  StructuralNumbering(const DenseMap<Operation *, unsigned> &regClasses)
+      : regClasses(regClasses) {}
+
+  unsigned get(Value root);
+
+private:
+  // Tags for the leaves, which can't collide with operation names
+  enum : uintptr_t { ArgTag, RegTag, OpaqueTag };
+
+  const DenseMap<Operation *, unsigned> &regClasses;
+  DenseMap<Value, unsigned> numbers;
+  DenseSet<Value> expanded;
+  std::map<SmallVector<uintptr_t, 8>, unsigned> table;
+};
+} // namespace
+
+unsigned StructuralNumbering::get(Value root) {
+  SmallVector<Value> worklist{root};
+  while (!worklist.empty()) {
+    Value value = worklist.back();
+    if (numbers.contains(value)) {
+      worklist.pop_back();
+      continue;
+    }
+
+    SmallVector<uintptr_t, 8> key;
+    Operation *op = value.getDefiningOp();
+    if (!op) {
+      key = {ArgTag, cast<BlockArgument>(value).getArgNumber()};
+    } else if (auto it = regClasses.find(op); it != regClasses.end()) {
+      key = {RegTag, it->second};
+    } else if (op->getNumRegions() == 0) {
+      // Number the operands first. Operands that are still unnumbered once
+      // we come back to the value are part of a cycle.
+      bool firstVisit = expanded.insert(value).second;
+      bool ready = true;
+      for (auto operand : op->getOperands()) {
+        if (numbers.contains(operand))
+          continue;
+        ready = false;
+        if (firstVisit)
+          worklist.push_back(operand);
+      }
+      if (!ready && firstVisit)
+        continue;
+
+      if (ready) {
+        // Inherent attributes live in the properties; discardable attributes
+        // such as name hints must not prevent sharing.
+        key.push_back(
+            reinterpret_cast<uintptr_t>(op->getName().getAsOpaquePointer()));
+        key.push_back(reinterpret_cast<uintptr_t>(
+            op->getPropertiesAsAttribute().getAsOpaquePointer()));
+        if (op->getPropertiesStorageSize() == 0)
+          key.push_back(reinterpret_cast<uintptr_t>(
+              op->getRawDictionaryAttrs().getAsOpaquePointer()));
+        key.push_back(
+            reinterpret_cast<uintptr_t>(value.getType().getAsOpaquePointer()));
+        key.push_back(cast<OpResult>(value).getResultNumber());
+        size_t operandsBegin = key.size();
+        for (auto operand : op->getOperands())
+          key.push_back(numbers.lookup(operand));
+        if (op->hasTrait<OpTrait::IsCommutative>())
+          llvm::sort(key.begin() + operandsBegin, key.end());
+      }
+    }
+    if (key.empty())
+      key = {OpaqueTag, reinterpret_cast<uintptr_t>(value.getAsOpaquePointer())};
+
+    numbers[value] = table.try_emplace(key, table.size()).first->second;
+    worklist.pop_back();
+  }
+  return numbers.lookup(root);
+}
+
 namespace {
 // The goal here is to traverse the operations in order and convert them one by
 // one into btor2
@@ -53,9 +165,20 @@ struct ConvertHWToBTOR2Pass
       public verif::Visitor<ConvertHWToBTOR2Pass> {
 public:
   ConvertHWToBTOR2Pass(raw_ostream &os) : os(os) {}
+  ConvertHWToBTOR2Pass(raw_ostream &os, const ConvertHWToBTOR2Options &options)
+      : ConvertHWToBTOR2Base(options), os(os) {}
   // Executes the pass
   void runOnOperation() override;
 
+private:
+  // Finds the registers which always hold the same value as an earlier
+  // register and fills in `mergedRegs`
+  void mergeEquivalentRegisters(hw::HWModuleOp module);
+
+  // Finds the operations and inputs the assertions and assumptions depend on
+  // and fills in `liveOps` and `liveInputs`
+  void computeConeOfInfluence(hw::HWModuleOp module);
+
 private:
   // Output stream in which the btor2 will be emitted
   raw_ostream &os;
@@ -99,6 +222,22 @@ private:
   // Keeps track of operations that have been declared
   DenseSet<Operation *> handledOps;
 
+  // Keeps track of text -> LID mappings of the emitted expressions (i.e. a
+  // line without its LID). This is used to emit structurally identical
+  // expressions only once when expressions are shared.
+  llvm::StringMap<size_t> exprLIDs;
+
+  // Operations and input ports (by block argument index) in the cone of
+  // influence of the assertions and assumptions. Only these are emitted when
+  // the cone of influence reduction is enabled.
+  DenseSet<Operation *> liveOps;
+  DenseSet<size_t> liveInputs;
+
+  // Keeps track of register -> register mappings for registers which always
+  // hold the same value as an earlier register, and are thus represented by
+  // that register's state.
+  DenseMap<Operation *, Operation *> mergedRegs;
+
   // Constants used during the conversion
   static constexpr size_t noLID = -1UL;
   [[maybe_unused]] static constexpr int64_t noWidth = -1L;
@@ -120,14 +259,6 @@ public:
     return f;
   }
 
-  // Associates the current lid to an operation
-  // The LID is then incremented to maintain uniqueness
-  size_t setOpLID(Operation *op) {
-    size_t oplid = lid++;
-    opLIDMap[op] = oplid;
-    return oplid;
-  }
-
   // Checks if an operation was declared
   // If so, its lid will be returned
   // Otherwise -1 will be returned
@@ -183,14 +314,6 @@ private:
     return noLID;
   }
 
-  // Associates a constant declaration to a new lid
-  size_t setConstLID(int64_t val, size_t w) {
-    size_t constlid = lid;
-    // Keep track of this value in a constant declaration tracker
-    constToLIDMap[APInt(w, val)] = lid++;
-    return constlid;
-  }
-
   /// String generation helper functions
 
   // Generates a sort declaration instruction given a type ("bitvec" or array)
@@ -220,18 +343,50 @@ private:
        << " " << sid << " " << name << "\n";
   }
 
-  // Generates a constant declaration given a value, a width and a name.
-  void genConst(int64_t value, size_t width, Operation *op) {
-    // For now we're going to assume that the name isn't taken, given that hw
-    // is already in SSA form
-    size_t opLID = getOpLID(op);
+  // Generates an expression instruction given its text without the LID, and
+  // associates it to the source operation if there is one. When expressions
+  // are shared, a previously emitted identical expression is reused instead.
+  size_t genExpr(Operation *srcop, StringRef text) {
+    if (shareExpressions) {
+      auto it = exprLIDs.find(text);
+      if (it != exprLIDs.end()) {
+        ++numSharedExprs;
+        if (srcop)
+          opLIDMap[srcop] = it->second;
+        return it->second;
+      }
+    }
+
+    // Register the source operation with the current line id
+    size_t exprLID = srcop ? getOpLID(srcop) : lid++;
+    if (shareExpressions)
+      exprLIDs[text] = exprLID;
 
+    os << exprLID << " " << text << "\n";
+    return exprLID;
+  }
+
+  // Generates a constant declaration given a value, a width and the source
+  // operation, if any. Values that don't fit in 64 bits are emitted in binary.
+  size_t genConst(const APInt &value, size_t width, Operation *op) {
     // Retrieve the lid associated with the sort (sid)
     size_t sid = sortToLIDMap.at(width);
 
-    os << opLID << " "
-       << "constd"
-       << " " << sid << " " << value << "\n";
+    SmallString<32> text;
+    raw_svector_ostream stream(text);
+    if (value.getSignificantBits() <= 64) {
+      stream << "constd"
+             << " " << sid << " " << value.getSExtValue();
+    } else {
+      SmallString<64> bits;
+      value.toString(bits, 2, /*Signed=*/false);
+      stream << "const"
+             << " " << sid << " ";
+      for (size_t i = bits.size(); i < width; ++i)
+        stream << '0';
+      stream << bits;
+    }
+    return genExpr(op, text);
   }
 
   // Generates a zero constant expression
@@ -244,23 +399,27 @@ private:
     // Retrieve the lid associated with the sort (sid)
     size_t sid = sortToLIDMap.at(width);
 
-    // Associate an lid to the new constant
-    size_t constlid = setConstLID(0, width);
-
-    // Build and return the zero btor instruction
-    os << constlid << " "
-       << "zero"
-       << " " << sid << "\n";
+    // Build and emit the zero btor instruction, then keep track of it in the
+    // constant declaration tracker
+    SmallString<16> text;
+    raw_svector_ostream(text) << "zero"
+                              << " " << sid;
+    size_t constlid = genExpr(nullptr, text);
+    constToLIDMap[APInt(width, 0)] = constlid;
     return constlid;
   }
 
   // Generates an init statement, which allows for the use of powerOnValue
   // operands in compreg registers
   void genInit(Operation *reg, Value initVal, int64_t width) {
+    genInit(reg, getOpLID(initVal), width);
+  }
+
+  // Generates an init statement given the LID of the initial value
+  void genInit(Operation *reg, size_t initValLID, int64_t width) {
     // Retrieve the various identifiers we require for this
     size_t regLID = getOpLID(reg);
     size_t sid = sortToLIDMap.at(width);
-    size_t initValLID = getOpLID(initVal);
 
     // Build and emit the string (the lid here doesn't need to be associated
     // to an op as it won't be used)
@@ -273,9 +432,6 @@ private:
   // and a result width.
   void genBinOp(StringRef inst, Operation *binop, Value op1, Value op2,
                 size_t width) {
-    // Set the LID for this operation
-    size_t opLID = getOpLID(binop);
-
     // Find the sort's lid
     size_t sid = sortToLIDMap.at(width);
 
@@ -284,16 +440,21 @@ private:
     size_t op1LID = getOpLID(op1);
     size_t op2LID = getOpLID(op2);
 
-    // Build and return the string
-    os << opLID << " " << inst << " " << sid << " " << op1LID << " " << op2LID
-       << "\n";
+    // Order the operands of commutative operations so that they are shared
+    // regardless of how they were written
+    if (shareExpressions && binop->hasTrait<OpTrait::IsCommutative>() &&
+        op1LID > op2LID)
+      std::swap(op1LID, op2LID);
+
+    // Build and emit the string
+    SmallString<32> text;
+    raw_svector_ostream(text) << inst << " " << sid << " " << op1LID << " "
+                              << op2LID;
+    genExpr(binop, text);
   }
 
   // Generates a slice instruction given an operand, the lowbit, and the width
   void genSlice(Operation *srcop, Value op0, size_t lowbit, int64_t width) {
-    // Assign a LID to this operation
-    size_t opLID = getOpLID(srcop);
-
     // Find the sort's associated lid in order to use it in the instruction
     size_t sid = sortToLIDMap.at(width);
 
@@ -301,54 +462,55 @@ private:
     // Find the LID associated to the operand
     size_t op0LID = getOpLID(op0);
 
-    // Build and return the slice instruction
-    os << opLID << " "
-       << "slice"
-       << " " << sid << " " << op0LID << " " << (width - 1) << " " << lowbit
-       << "\n";
+    // Build and emit the slice instruction
+    SmallString<32> text;
+    raw_svector_ostream(text) << "slice"
+                              << " " << sid << " " << op0LID << " "
+                              << (width - 1) << " " << lowbit;
+    genExpr(srcop, text);
   }
 
-  // Generates a constant declaration given a value, a width and a name
-  void genUnaryOp(Operation *srcop, Operation *op0, StringRef inst,
-                  size_t width) {
-    // Register the source operation with the current line id
-    size_t opLID = getOpLID(srcop);
-
+  // Generates a unary operation instruction given the source operation, the
+  // operand's LID, an op name and a result width, and returns its LID
+  size_t genUnaryOp(Operation *srcop, size_t op0LID, StringRef inst,
+                    size_t width) {
     // Retrieve the lid associated with the sort (sid)
     size_t sid = sortToLIDMap.at(width);
 
+    SmallString<32> text;
+    raw_svector_ostream(text) << inst << " " << sid << " " << op0LID;
+    return genExpr(srcop, text);
+  }
+
+  // Generates a unary operation instruction given the source operation, an
+  // operand, an op name and a result width
+  void genUnaryOp(Operation *srcop, Operation *op0, StringRef inst,
+                  size_t width) {
     // Assuming that the operand has already been emitted
     // Find the LID associated to the operand
-    size_t op0LID = getOpLID(op0);
-
-    os << opLID << " " << inst << " " << sid << " " << op0LID << "\n";
+    genUnaryOp(srcop, getOpLID(op0), inst, width);
   }
 
-  // Generates a constant declaration given a value, a width and a name and
-  // returns the LID associated to it
+  // Generates a unary operation instruction given the source operation, an
+  // operand, an op name and a result width
   void genUnaryOp(Operation *srcop, Value op0, StringRef inst, size_t width) {
     genUnaryOp(srcop, op0.getDefiningOp(), inst, width);
   }
 
-  // Generates a constant declaration given a operand lid, a width and a name
+  // Generates a unary operation instruction that isn't associated to an op
+  // given an operand lid, an op name and a result width, and returns its LID
   size_t genUnaryOp(size_t op0LID, StringRef inst, size_t width) {
-    // Register the source operation with the current line id
-    size_t curLid = lid++;
-
-    // Retrieve the lid associated with the sort (sid)
-    size_t sid = sortToLIDMap.at(width);
-
-    os << curLid << " " << inst << " " << sid << " " << op0LID << "\n";
-    return curLid;
+    return genUnaryOp(nullptr, op0LID, inst, width);
   }
 
-  // Generates a constant declaration given a value, a width and a name
+  // Generates a unary operation instruction given an operand, an op name and
+  // a result width, and returns its LID
   size_t genUnaryOp(Operation *op0, StringRef inst, size_t width) {
     return genUnaryOp(getOpLID(op0), inst, width);
   }
 
-  // Generates a constant declaration given a value, a width and a name and
-  // returns the LID associated to it
+  // Generates a unary operation instruction given an operand, an op name and
+  // a result width, and returns its LID
   size_t genUnaryOp(Value op0, StringRef inst, size_t width) {
     return genUnaryOp(getOpLID(op0), inst, width);
   }
@@ -371,6 +533,7 @@ private:
     os << lid++ << " "
        << "bad"
        << " " << assertLID << "\n";
+    ++numBads;
   }
 
   // Generate a btor2 constraint given an expression from an assumption
@@ -390,6 +553,7 @@ private:
     os << lid++ << " "
        << "constraint"
        << " " << exprLID << "\n";
+    ++numConstraints;
   }
 
   // Generate an ite instruction (if then else) given a predicate, two values
@@ -404,19 +568,18 @@ private:
   }
 
   // Generate an ite instruction (if then else) given a predicate, two values
-  // and a res width
-  void genIte(Operation *srcop, size_t condLID, size_t tLID, size_t fLID,
-              int64_t width) {
-    // Register the source operation with the current line id
-    size_t opLID = getOpLID(srcop);
-
+  // and a res width, and returns its LID
+  size_t genIte(Operation *srcop, size_t condLID, size_t tLID, size_t fLID,
+                int64_t width) {
     // Retrieve the lid associated with the sort (sid)
     size_t sid = sortToLIDMap.at(width);
 
-    // Build and return the ite instruction
-    os << opLID << " "
-       << "ite"
-       << " " << sid << " " << condLID << " " << tLID << " " << fLID << "\n";
+    // Build and emit the ite instruction
+    SmallString<32> text;
+    raw_svector_ostream(text) << "ite"
+                              << " " << sid << " " << condLID << " " << tLID
+                              << " " << fLID;
+    return genExpr(srcop, text);
   }
 
   // Generate a logical implication given a lhs and a rhs
@@ -430,19 +593,13 @@ private:
 
   // Generate a logical implication given a lhs and a rhs
   size_t genImplies(Operation *srcop, size_t lhsLID, size_t rhsLID) {
-    // Register the source operation with the current line id
-    size_t opLID = getOpLID(srcop);
-    return genImplies(opLID, lhsLID, rhsLID);
-  }
-
-  size_t genImplies(size_t opLID, size_t lhsLID, size_t rhsLID) {
     // Retrieve the lid associated with the sort (sid)
     size_t sid = sortToLIDMap.at(1);
     // Build and emit the implies operation
-    os << opLID << " "
-       << "implies"
-       << " " << sid << " " << lhsLID << " " << rhsLID << "\n";
-    return opLID;
+    SmallString<32> text;
+    raw_svector_ostream(text) << "implies"
+                              << " " << sid << " " << lhsLID << " " << rhsLID;
+    return genExpr(srcop, text);
   }
 
   // Generates a state instruction given a width and a name
@@ -457,17 +614,17 @@ private:
     os << opLID << " "
        << "state"
        << " " << sid << " " << name << "\n";
+    ++numStates;
   }
 
   // Generates a next instruction, given a width, a state LID, and a next
   // value LID
-  void genNext(Value next, Operation *reg, int64_t width) {
+  void genNext(size_t nextLID, Operation *reg, int64_t width) {
     // Retrieve the lid associated with the sort (sid)
     size_t sid = sortToLIDMap.at(width);
 
-    // Retrieve the LIDs associated to reg and next
+    // Retrieve the LID associated to reg
     size_t regLID = getOpLID(reg);
-    size_t nextLID = getOpLID(next);
 
     // Build and return the next instruction
     // Also update the lid as this instruction is not associated to an mlir op
@@ -556,13 +713,10 @@ private:
 
       // Check for a reset value, if none exists assume it's zero
       if (resetVal)
-        resetValLID = getOpLID(resetVal.getDefiningOp());
+        resetValLID = getOpLID(resetVal);
       else
         resetValLID = genZero(width);
 
-      // Assign a new LID to next
-      setOpLID(next.getDefiningOp());
-
       // Sanity check: at this point the next operation should have had it's
       // btor2 counterpart emitted if not then something terrible must have
       // happened.
@@ -570,7 +724,9 @@ private:
 
       // Generate the ite for the register update reset condition
       // i.e. reg <= reset ? 0 : next
-      genIte(next.getDefiningOp(), resetLID, resetValLID, nextLID, width);
+      // The ite isn't associated to the next operation, as other users of
+      // that operation must still see the value without the reset.
+      nextLID = genIte(nullptr, resetLID, resetValLID, nextLID, width);
     } else {
       // Sanity check: next should have been assigned
       if (nextLID == noLID) {
@@ -581,7 +737,7 @@ private:
     }
 
     // Finally generate the next statement
-    genNext(next, op, width);
+    genNext(nextLID, op, width);
   }
 
 public:
@@ -596,6 +752,12 @@ public:
     // input declaration We only consider ports with an explicit bit-width (so
     // ignore clocks)
     if (port.isInput() && !isa<seq::ClockType>(port.type)) {
+      // Inputs outside of the cone of influence are dropped
+      if (coneOfInfluence && !liveInputs.contains(port.argNum)) {
+        ++numPrunedInputs;
+        return;
+      }
+
       // Generate the associated btor declaration for the inputs
       StringRef iName = port.getName();
 
@@ -614,6 +776,7 @@ public:
       lid++;
 
       genInput(inlid, w, iName);
+      ++numInputs;
     }
   }
 
@@ -624,10 +787,8 @@ public:
     // Make sure that a sort has been created for our operation
     int64_t w = requireSort(op.getType());
 
-    // Prepare for for const generation by extracting the const value and
-    // generting the btor2 string
-    int64_t value = op.getValue().getSExtValue();
-    genConst(value, w, op);
+    // Generate the btor2 string from the const value
+    genConst(op.getValue(), w, op);
   }
 
   // Wires should have been removed in PrepareForFormal
@@ -860,6 +1021,10 @@ public:
     // Generate state instruction (represents the register declaration)
     genState(reg, w, regName);
 
+    // Presets are the register's initial value
+    if (auto preset = reg.getPresetAttr())
+      genInit(reg, genConst(preset.getValue(), w, nullptr), w);
+
     // Record the operation for future `next` instruction generation
     // This is required to model transitions between states (i.e. how a
     // register's value evolves over time)
@@ -880,20 +1045,24 @@ public:
     genState(reg, w, regName);
 
     if (init) {
-      // Check that the initial value is a non-null constant
-      auto initialConstant = circt::seq::unwrapImmutableValue(init)
-                                 .getDefiningOp<hw::ConstantOp>();
-      if (!initialConstant)
+      // Check whether the initial value is a constant
+      Value initVal = circt::seq::unwrapImmutableValue(init);
+      if (auto initialConstant = initVal.getDefiningOp<hw::ConstantOp>()) {
+        // Visit the powerOn Value to generate the constant
+        dispatchTypeOpVisitor(initialConstant);
+
+        // Add it to the list of visited operations
+        handledOps.insert(initialConstant);
+
+        // Finally generate the init statement
+        genInit(reg, initialConstant, w);
+      } else if (auto value = foldConstant(initVal)) {
+        // Initializers computed from constants are folded into a single one
+        genInit(reg, genConst(*value, w, nullptr), w);
+      } else {
         reg->emitError("PowerOn Value must be constant!!");
-
-      // Visit the powerOn Value to generate the constant
-      dispatchTypeOpVisitor(initialConstant);
-
-      // Add it to the list of visited operations
-      handledOps.insert(initialConstant);
-
-      // Finally generate the init statement
-      genInit(reg, initialConstant, w);
+        return signalPassFailure();
+      }
     }
 
     // Record the operation for future `next` instruction generation
@@ -938,11 +1107,134 @@ public:
 };
 } // end anonymous namespace
 
+void ConvertHWToBTOR2Pass::mergeEquivalentRegisters(hw::HWModuleOp module) {
+  SmallVector<Operation *> regs;
+  module.walk([&](Operation *op) {
+    if (isa<seq::FirRegOp, seq::CompRegOp>(op))
+      regs.push_back(op);
+  });
+  if (regs.size() < 2)
+    return;
+
+  // Start with the registers grouped by their type and initial value
+  DenseMap<Operation *, unsigned> regClasses;
+  std::map<SmallVector<uintptr_t, 8>, unsigned> classes;
+  for (auto *reg : regs) {
+    Type type = reg->getResult(0).getType();
+    SmallVector<uintptr_t, 8> key{
+        reinterpret_cast<uintptr_t>(reg->getName().getAsOpaquePointer()),
+        reinterpret_cast<uintptr_t>(type.getAsOpaquePointer())};
+
+    // A state without an init starts out with an arbitrary value in btor2, so
+    // only registers with the same known initial value can be merged
+    std::optional<APInt> init;
+    if (auto compReg = dyn_cast<seq::CompRegOp>(reg)) {
+      if (auto initVal = compReg.getInitialValue())
+        init = foldConstant(seq::unwrapImmutableValue(initVal));
+    } else if (auto preset = cast<seq::FirRegOp>(reg).getPresetAttr()) {
+      init = preset.getValue();
+    }
+    if (init)
+      key.push_back(reinterpret_cast<uintptr_t>(
+          IntegerAttr::get(IntegerType::get(&getContext(), init->getBitWidth()),
+                           *init)
+              .getAsOpaquePointer()));
+    else
+      key.push_back(reinterpret_cast<uintptr_t>(reg));
+
+    regClasses[reg] = classes.try_emplace(key, classes.size()).first->second;
+  }
+
+  // Refine the groups by the structure of the registers' operands, in which
+  // registers stand for their group, until a fixpoint is reached. Registers
+  // that end up in the same group always hold the same value.
+  size_t numClasses = classes.size();
+  while (true) {
+    StructuralNumbering numbering(regClasses);
+    std::map<SmallVector<uintptr_t, 8>, unsigned> refinedClasses;
+    DenseMap<Operation *, unsigned> refinedRegClasses;
+    for (auto *reg : regs) {
+      SmallVector<uintptr_t, 8> key{regClasses.lookup(reg)};
+      for (auto operand : reg->getOperands()) {
+        // Initial values were taken care of above
+        if (isa<seq::ImmutableType>(operand.getType()))
+          continue;
+        key.push_back(numbering.get(operand));
+      }
+      refinedRegClasses[reg] =
+          refinedClasses.try_emplace(key, refinedClasses.size()).first->second;
+    }
+
+    regClasses = std::move(refinedRegClasses);
+    if (refinedClasses.size() == numClasses)
+      break;
+    numClasses = refinedClasses.size();
+  }
+
+  // The first register of every group represents the others
+  DenseMap<unsigned, Operation *> leaders;
+  for (auto *reg : regs) {
+    auto *&leader = leaders[regClasses.lookup(reg)];
+    if (!leader)
+      leader = reg;
+    else
+      mergedRegs[reg] = leader;
+  }
+}
+
+void ConvertHWToBTOR2Pass::computeConeOfInfluence(hw::HWModuleOp module) {
+  SmallVector<Operation *> worklist;
+  auto markLive = [&](Operation *op) {
+    if (liveOps.insert(op).second)
+      worklist.push_back(op);
+  };
+
+  // The assertions and assumptions are the roots of the cone, along with the
+  // operations enclosing them (e.g. an `sv.if` acting as an enable)
+  module.walk([&](Operation *op) {
+    if (!isa<sv::AssertOp, sv::AssumeOp, verif::AssertOp,
+             verif::ClockedAssertOp, verif::AssumeOp, verif::ClockedAssumeOp,
+             verif::CoverOp, verif::ClockedCoverOp>(op))
+      return;
+    for (; op != module.getOperation(); op = op->getParentOp())
+      markLive(op);
+  });
+
+  while (!worklist.empty()) {
+    Operation *op = worklist.pop_back_val();
+
+    // Merged registers only depend on the register representing them
+    if (auto it = mergedRegs.find(op); it != mergedRegs.end()) {
+      markLive(it->second);
+      continue;
+    }
+
+    for (auto operand : op->getOperands()) {
+      // Clocks are implicit in btor2
+      if (isa<seq::ClockType>(operand.getType()))
+        continue;
+      if (auto *defOp = operand.getDefiningOp())
+        markLive(defOp);
+      else if (operand.getParentBlock() == module.getBodyBlock())
+        liveInputs.insert(cast<BlockArgument>(operand).getArgNumber());
+    }
+  }
+}
+
 void ConvertHWToBTOR2Pass::runOnOperation() {
   // Btor2 does not have the concept of modules or module
   // hierarchies, so we assume that no nested modules exist at this point.
   // This greatly simplifies translation.
   getOperation().walk([&](hw::HWModuleOp module) {
+    size_t firstLID = lid;
+
+    // Analyze the module before anything is emitted, as the emission is
+    // streamed out line by line
+    if (mergeRegisters)
+      mergeEquivalentRegisters(module);
+    if (coneOfInfluence)
+      computeConeOfInfluence(module);
+
     // Start by extracting the inputs and generating appropriate instructions
     for (auto &port : module.getPortList()) {
       visit(port);
@@ -952,7 +1244,17 @@ void ConvertHWToBTOR2Pass::runOnOperation() {
     module.walk([&](Operation *op) {
       TypeSwitch<Operation *, void>(op)
           .Case<seq::FirRegOp, seq::CompRegOp>([&](auto reg) {
-            visit(reg);
+            if (coneOfInfluence && !liveOps.contains(op))
+              return;
+
+            // Merged registers share the state of the register representing
+            // them, which always comes first
+            if (auto it = mergedRegs.find(op); it != mergedRegs.end()) {
+              opLIDMap[op] = getOpLID(it->second);
+              ++numMergedRegs;
+            } else {
+              visit(reg);
+            }
             handledOps.insert(op);
           })
           .Default([&](auto expr) {});
@@ -970,6 +1272,13 @@ void ConvertHWToBTOR2Pass::runOnOperation() {
       if (handledOps.contains(op))
         return;
 
+      // Don't process ops that no property depends on
+      if (coneOfInfluence && !liveOps.contains(op)) {
+        if (op->getNumResults())
+          ++numPrunedOps;
+        return;
+      }
+
       // Fill in our worklist
       worklist.insert({op, op->operand_begin()});
 
@@ -1008,6 +1317,8 @@ void ConvertHWToBTOR2Pass::runOnOperation() {
     for (size_t i = 0; i < regOps.size(); ++i) {
       finalizeRegVisit(regOps[i]);
     }
+
+    numLines += lid - firstLID;
   });
   // Clear data structures to allow for pass reuse
   sortToLIDMap.clear();
@@ -1017,6 +1328,10 @@ void ConvertHWToBTOR2Pass::runOnOperation() {
   regOps.clear();
   handledOps.clear();
   worklist.clear();
+  exprLIDs.clear();
+  liveOps.clear();
+  liveInputs.clear();
+  mergedRegs.clear();
 }
 
 // Constructor with a custom ostream
@@ -1025,6 +1340,13 @@ circt::createConvertHWToBTOR2Pass(llvm::raw_ostream &os) {
   return std::make_unique<ConvertHWToBTOR2Pass>(os);
 }
 
+// Constructor with a custom ostream and options
+std::unique_ptr<mlir::Pass>
+circt::createConvertHWToBTOR2Pass(llvm::raw_ostream &os,
+                                  const ConvertHWToBTOR2Options &options) {
+  return std::make_unique<ConvertHWToBTOR2Pass>(os, options);
+}
+
 // Basic default constructor
 std::unique_ptr<mlir::Pass> circt::createConvertHWToBTOR2Pass() {
   return std::make_unique<ConvertHWToBTOR2Pass>(llvm::outs());
@@ -1024,6 +1024,7 @@ Value Context::materializeConstant(const slang::ConstantValue &constant,
 slang::ConstantValue
 Context::evaluateConstant(const slang::ast::Expression &expr) {
   using slang::ast::EvalFlags;
+  std::lock_guard<std::mutex> lock(global->evalMutex);
   slang::ast::EvalContext evalContext(
       compilation, EvalFlags::CacheResults | EvalFlags::SpecparamsAllowed);
   return expr.eval(evalContext);
@@ -17,6 +17,8 @@
 #include "mlir/Support/Timing.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
 #include "llvm/ADT/Hashing.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/SourceMgr.h"
 
 #include "slang/diagnostics/DiagnosticClient.h"
@@ -163,6 +165,9 @@ struct ImportDriver {
   LogicalResult importVerilog(ModuleOp module);
   LogicalResult preprocessVerilog(llvm::raw_ostream &os);
 
+  void recordMemoryUsage(StringRef phase);
+  void printMemoryUsage(llvm::raw_ostream &os);
+
   MLIRContext *mlirContext;
   TimingScope &ts;
   const ImportVerilogOptions &options;
@@ -180,6 +185,10 @@ struct ImportDriver {
   //
   // See: https://github.com/MikePopoloski/slang/discussions/658
   SmallDenseMap<slang::BufferID, StringRef> bufferFilePaths;
+
+  /// The heap memory in use after each phase of the import, if the options
+  /// ask for it to be printed.
+  SmallVector<std::pair<StringRef, size_t>> memoryUsage;
 };
 } // namespace
 
@@ -244,12 +253,17 @@ LogicalResult ImportDriver::prepareDriver(SourceMgr &sourceMgr) {
 /// Parse and elaborate the prepared source files, and populate the given MLIR
 /// `module` with corresponding operations.
 LogicalResult ImportDriver::importVerilog(ModuleOp module) {
+  recordMemoryUsage("Initial");
+
   // Parse the input.
   auto parseTimer = ts.nest("Verilog parser");
   bool parseSuccess = driver.parseAllSources();
   parseTimer.stop();
+  recordMemoryUsage("Verilog parser");
 
-  // Elaborate the input.
+  // Elaborate the input. Collecting all diagnostics fully elaborates the
+  // design, which keeps most of the lazy AST construction out of the
+  // conversion below.
   auto compileTimer = ts.nest("Verilog elaboration");
   auto compilation = driver.createCompilation();
   for (auto &diag : compilation->getAllDiagnostics())
@@ -257,6 +271,7 @@ LogicalResult ImportDriver::importVerilog(ModuleOp module) {
   if (!parseSuccess || driver.diagEngine.getNumErrors() > 0)
     return failure();
   compileTimer.stop();
+  recordMemoryUsage("Verilog elaboration");
 
   // If we were only supposed to lint the input, return here. This leaves the
   // module empty, but any Slang linting messages got reported as diagnostics.
@@ -273,12 +288,36 @@ LogicalResult ImportDriver::importVerilog(ModuleOp module) {
   if (failed(context.convertCompilation()))
     return failure();
   conversionTimer.stop();
+  recordMemoryUsage("Verilog to dialect mapping");
 
   // Run the verifier on the constructed module to ensure it is clean.
   auto verifierTimer = ts.nest("Post-parse verification");
   return verify(module);
 }
 
+/// Record the heap memory in use after a phase of the import.
+void ImportDriver::recordMemoryUsage(StringRef phase) {
+  if (options.printMemoryUsage)
+    memoryUsage.push_back({phase, llvm::sys::Process::GetMallocUsage()});
+}
+
+/// Print the memory recorded after each phase of the import, along with the
+/// growth over the previous phase.
+void ImportDriver::printMemoryUsage(llvm::raw_ostream &os) {
+  if (memoryUsage.empty())
+    return;
+  constexpr double MiB = 1024.0 * 1024.0;
+  os << "===- Verilog frontend memory usage -===\n";
+  os << "     Total        Delta   Phase\n";
+  size_t previous = memoryUsage.front().second;
+  for (auto [phase, bytes] : memoryUsage) {
+    double delta = (double(bytes) - double(previous)) / MiB;
+    os << llvm::format("%8.1f MiB %+9.1f MiB  ", bytes / MiB, delta) << phase
+       << "\n";
+    previous = bytes;
+  }
+}
+
 /// Preprocess the prepared source files and print them to the given output
 /// stream.
 LogicalResult ImportDriver::preprocessVerilog(llvm::raw_ostream &os) {
@@ -361,7 +400,9 @@ LogicalResult circt::importVerilog(SourceMgr &sourceMgr,
     ImportDriver importDriver(mlirContext, ts, options);
     if (failed(importDriver.prepareDriver(sourceMgr)))
       return failure();
-    return importDriver.importVerilog(module);
+    auto result = importDriver.importVerilog(module);
+    importDriver.printMemoryUsage(llvm::errs());
+    return result;
   });
 }
 
@@ -20,6 +20,8 @@
 #include "llvm/ADT/ScopedHashTable.h"
 #include "llvm/Support/Debug.h"
 #include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
 
 #define DEBUG_TYPE "import-verilog"
@@ -58,18 +60,56 @@ struct LoopFrame {
   Block *breakBlock;
 };
 
+/// The part of the conversion state that concerns the top-level MLIR module.
+/// It is shared by all contexts that convert module bodies concurrently, which
+/// must hold `mutex` while accessing it.
+struct GlobalState {
+  GlobalState(mlir::ModuleOp intoModuleOp) : symbolTable(intoModuleOp) {}
+
+  /// Guards all other members while module bodies are converted concurrently.
+  std::mutex mutex;
+
+  /// Serializes the constant evaluation of Slang expressions, which caches
+  /// its results in the shared AST.
+  std::mutex evalMutex;
+
+  /// A symbol table of the MLIR module we are emitting into.
+  SymbolTable symbolTable;
+
+  /// The top-level operations ordered by their Slang source location. This is
+  /// used to produce IR that follows the source file order.
+  std::map<slang::SourceLocation, Operation *> orderedRootOps;
+
+  /// How we have lowered modules to MLIR.
+  DenseMap<const slang::ast::InstanceBodySymbol *,
+           std::unique_ptr<ModuleLowering>>
+      modules;
+  /// A list of modules for which the header has been created, but the body has
+  /// not been converted yet.
+  std::queue<const slang::ast::InstanceBodySymbol *> moduleWorklist;
+
+  /// Functions that have already been converted.
+  DenseMap<const slang::ast::SubroutineSymbol *,
+           std::unique_ptr<FunctionLowering>>
+      functions;
+};
+
 /// A helper class to facilitate the conversion from a Slang AST to MLIR
 /// operations. Keeps track of the destination MLIR module, builders, and
-/// various worklists and utilities needed for conversion.
+/// various worklists and utilities needed for conversion. Module bodies are
+/// converted by separate contexts that share the `GlobalState` of the context
+/// converting the compilation.
 struct Context {
   Context(const ImportVerilogOptions &options,
           slang::ast::Compilation &compilation, mlir::ModuleOp intoModuleOp,
           const slang::SourceManager &sourceManager,
-          SmallDenseMap<slang::BufferID, StringRef> &bufferFilePaths)
+          SmallDenseMap<slang::BufferID, StringRef> &bufferFilePaths,
+          std::shared_ptr<GlobalState> global = {})
       : options(options), compilation(compilation), intoModuleOp(intoModuleOp),
         sourceManager(sourceManager), bufferFilePaths(bufferFilePaths),
         builder(OpBuilder::atBlockEnd(intoModuleOp.getBody())),
-        symbolTable(intoModuleOp) {}
+        global(global ? std::move(global)
+                      : std::make_shared<GlobalState>(intoModuleOp)) {}
   Context(const Context &) = delete;
 
   /// Return the MLIR context.
@@ -91,6 +131,9 @@ struct Context {
   LogicalResult convertCompilation();
   ModuleLowering *
   convertModuleHeader(const slang::ast::InstanceBodySymbol *module);
+  LogicalResult declareModuleMembers(const slang::ast::Scope &scope);
+  LogicalResult convertModuleBodies(
+      ArrayRef<const slang::ast::InstanceBodySymbol *> modules);
   LogicalResult convertModuleBody(const slang::ast::InstanceBodySymbol *module);
   LogicalResult convertPackage(const slang::ast::PackageSymbol &package);
   FunctionLowering *
@@ -150,25 +193,9 @@ struct Context {
 
   /// The builder used to create IR operations.
   OpBuilder builder;
-  /// A symbol table of the MLIR module we are emitting into.
-  SymbolTable symbolTable;
-
-  /// The top-level operations ordered by their Slang source location. This is
-  /// used to produce IR that follows the source file order.
-  std::map<slang::SourceLocation, Operation *> orderedRootOps;
-
-  /// How we have lowered modules to MLIR.
-  DenseMap<const slang::ast::InstanceBodySymbol *,
-           std::unique_ptr<ModuleLowering>>
-      modules;
-  /// A list of modules for which the header has been created, but the body has
-  /// not been converted yet.
-  std::queue<const slang::ast::InstanceBodySymbol *> moduleWorklist;
-
-  /// Functions that have already been converted.
-  DenseMap<const slang::ast::SubroutineSymbol *,
-           std::unique_ptr<FunctionLowering>>
-      functions;
+  /// The state of the top-level MLIR module, shared with the contexts that
+  /// convert module bodies.
+  std::shared_ptr<GlobalState> global;
 
   /// A table of defined values, such as variables, that may be referred to by
   /// name in expressions. The expressions use this table to lookup the MLIR
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "ImportVerilogInternals.h"
+#include "mlir/IR/Threading.h"
 #include "slang/ast/Compilation.h"
 
 using namespace circt;
@@ -96,8 +97,11 @@ struct BaseVisitor {
         context.materializeConstant(param.getValue(), param.getType(), loc);
     if (!value)
       return;
-    if (builder.getInsertionBlock()->getParentOp() == context.intoModuleOp)
-      context.orderedRootOps.insert({param.location, value.getDefiningOp()});
+    if (builder.getInsertionBlock()->getParentOp() == context.intoModuleOp) {
+      std::lock_guard<std::mutex> lock(context.global->mutex);
+      context.global->orderedRootOps.insert(
+          {param.location, value.getDefiningOp()});
+    }
 
     // Prefix the parameter name with the surrounding namespace to create
     // somewhat sane names in the IR.
@@ -259,8 +263,13 @@ struct ModuleVisitor : public BaseVisitor {
     auto module = moduleLowering->op;
     auto moduleType = module.getModuleType();
 
-    // Set visibility attribute for instantiated module.
-    SymbolTable::setSymbolVisibility(module, SymbolTable::Visibility::Private);
+    // Set visibility attribute for instantiated module. This has usually been
+    // done by `declareModuleMembers` already.
+    if (!module.isPrivate()) {
+      std::lock_guard<std::mutex> lock(context.global->mutex);
+      SymbolTable::setSymbolVisibility(module,
+                                       SymbolTable::Visibility::Private);
+    }
 
     // Prepare the values that are involved in port connections. This creates
     // rvalues for input ports and appropriate lvalues for output, inout, and
@@ -579,17 +588,81 @@ LogicalResult Context::convertCompilation() {
     if (!convertModuleHeader(&inst->body))
       return failure();
 
-  // Convert all the root module definitions.
+  // Convert all the root module definitions. First declare all instantiated
+  // modules and all functions in a breadth-first walk of the hierarchy, which
+  // assigns symbol names in a deterministic order, then convert the module
+  // bodies concurrently. The worklist only fills up again if a body conversion
+  // comes across a module that was not declared up front.
+  auto &moduleWorklist = global->moduleWorklist;
   while (!moduleWorklist.empty()) {
-    auto *module = moduleWorklist.front();
-    moduleWorklist.pop();
-    if (failed(convertModuleBody(module)))
+    SmallVector<const slang::ast::InstanceBodySymbol *> modules;
+    while (!moduleWorklist.empty()) {
+      auto *module = moduleWorklist.front();
+      moduleWorklist.pop();
+      modules.push_back(module);
+      if (failed(declareModuleMembers(*module)))
+        return failure();
+    }
+    if (failed(convertModuleBodies(modules)))
       return failure();
   }
 
   return success();
 }
 
+/// Create the module headers for all instances and the declarations for all
+/// functions in a module body, including the ones nested in generate blocks.
+/// This visits the members in the same order as `ModuleVisitor`.
+LogicalResult Context::declareModuleMembers(const slang::ast::Scope &scope) {
+  for (auto &member : scope.members()) {
+    if (auto *instNode = member.as_if<slang::ast::InstanceSymbol>()) {
+      auto *lowering = convertModuleHeader(&instNode->body);
+      if (!lowering)
+        return failure();
+      SymbolTable::setSymbolVisibility(lowering->op,
+                                       SymbolTable::Visibility::Private);
+      continue;
+    }
+    if (auto *subroutine = member.as_if<slang::ast::SubroutineSymbol>()) {
+      if (!declareFunction(*subroutine))
+        return failure();
+      continue;
+    }
+    if (auto *genNode = member.as_if<slang::ast::GenerateBlockSymbol>()) {
+      if (!genNode->isUninstantiated && failed(declareModuleMembers(*genNode)))
+        return failure();
+      continue;
+    }
+    if (auto *genArrNode =
+            member.as_if<slang::ast::GenerateBlockArraySymbol>()) {
+      for (auto *entry : genArrNode->entries)
+        if (!entry->isUninstantiated && failed(declareModuleMembers(*entry)))
+          return failure();
+      continue;
+    }
+  }
+  return success();
+}
+
+/// Convert the bodies of the given modules, whose headers have already been
+/// created. Each body is converted by a separate context into the region of
+/// its module op. If enabled in the options, the bodies are converted on
+/// multiple threads, with diagnostics reported in the order of the modules.
+LogicalResult Context::convertModuleBodies(
+    ArrayRef<const slang::ast::InstanceBodySymbol *> modules) {
+  auto convertBody = [&](const slang::ast::InstanceBodySymbol *module) {
+    Context bodyContext(options, compilation, intoModuleOp, sourceManager,
+                        bufferFilePaths, global);
+    return bodyContext.convertModuleBody(module);
+  };
+  if (options.parallelModuleBodies)
+    return failableParallelForEach(getContext(), modules, convertBody);
+  for (auto *module : modules)
+    if (failed(convertBody(module)))
+      return failure();
+  return success();
+}
+
 /// Convert a module and its ports to an empty module op in the IR. Also adds
 /// the op to the worklist of module bodies to be lowered. This acts like a
 /// module "declaration", allowing instances to already refer to a module even
@@ -602,6 +675,10 @@ Context::convertModuleHeader(const slang::ast::InstanceBodySymbol *module) {
   using slang::ast::PortSymbol;
   using slang::ast::TypeParameterSymbol;
 
+  std::lock_guard<std::mutex> lock(global->mutex);
+  auto &modules = global->modules;
+  auto &orderedRootOps = global->orderedRootOps;
+
   auto parameters = module->parameters;
   bool hasModuleSame = false;
   // If there is already exist a module that has the same name with this
@@ -726,10 +803,10 @@ Context::convertModuleHeader(const slang::ast::InstanceBodySymbol *module) {
 
   // Add the module to the symbol table of the MLIR module, which uniquifies its
   // name as we'd expect.
-  symbolTable.insert(moduleOp);
+  global->symbolTable.insert(moduleOp);
 
   // Schedule the body to be lowered.
-  moduleWorklist.push(module);
+  global->moduleWorklist.push(module);
 
   // Map duplicate port by Syntax
   for (const auto &port : lowering.ports)
@@ -742,7 +819,12 @@ Context::convertModuleHeader(const slang::ast::InstanceBodySymbol *module) {
 /// already been created earlier through a `convertModuleHeader` call.
 LogicalResult
 Context::convertModuleBody(const slang::ast::InstanceBodySymbol *module) {
-  auto &lowering = *modules[module];
+  ModuleLowering *loweringPtr;
+  {
+    std::lock_guard<std::mutex> lock(global->mutex);
+    loweringPtr = global->modules.find(module)->second.get();
+  }
+  auto &lowering = *loweringPtr;
   OpBuilder::InsertionGuard g(builder);
   builder.setInsertionPointToEnd(lowering.op.getBody());
 
@@ -816,8 +898,11 @@ FunctionLowering *
 Context::declareFunction(const slang::ast::SubroutineSymbol &subroutine) {
   using slang::ast::ArgumentDirection;
 
+  std::lock_guard<std::mutex> lock(global->mutex);
+  auto &orderedRootOps = global->orderedRootOps;
+
   // Check if there already is a declaration for this function.
-  auto &lowering = functions[&subroutine];
+  auto &lowering = global->functions[&subroutine];
   if (lowering) {
     if (!lowering->op)
       return {};
@@ -879,7 +964,7 @@ Context::declareFunction(const slang::ast::SubroutineSymbol &subroutine) {
 
   // Add the function to the symbol table of the MLIR module, which uniquifies
   // its name.
-  symbolTable.insert(funcOp);
+  global->symbolTable.insert(funcOp);
 
   return lowering.get();
 }
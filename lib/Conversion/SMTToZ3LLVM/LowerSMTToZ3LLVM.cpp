@@ -564,6 +564,20 @@ struct SolverOpLowering : public SMTLoweringPattern<SolverOp> {
     auto ptrToVoidFunc = LLVM::LLVMFunctionType::get(voidTy, ptrTy);
     auto ptrPtrToVoidFunc = LLVM::LLVMFunctionType::get(voidTy, {ptrTy, ptrTy});
 
+    // Set the user-provided global parameters, such as random seeds or
+    // solver heuristics. These have to be set before the context is created.
+    // ```
+    // void Z3_API Z3_global_param_set(Z3_string param_id,
+    //                                 Z3_string param_value);
+    // ```
+    for (StringRef param : options.z3Params) {
+      auto [key, value] = param.split('=');
+      Value paramKey = buildString(rewriter, loc, key);
+      Value paramValue = buildString(rewriter, loc, value);
+      buildCall(rewriter, loc, "Z3_global_param_set", ptrPtrToVoidFunc,
+                {paramKey, paramValue});
+    }
+
     // Create the configuration.
     Value config = buildCall(rewriter, loc, "Z3_mk_config",
                              LLVM::LLVMFunctionType::get(ptrTy, {}), {})
@@ -666,6 +680,51 @@ struct AssertOpLowering : public SMTLoweringPattern<AssertOp> {
   }
 };
 
+/// Lower `smt.push` operations to (repeated) Z3 API calls of the form:
+/// ```
+/// void Z3_API Z3_solver_push(Z3_context c, Z3_solver s);
+/// ```
+struct PushOpLowering : public SMTLoweringPattern<PushOp> {
+  using SMTLoweringPattern::SMTLoweringPattern;
+
+  LogicalResult
+  matchAndRewrite(PushOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const final {
+    Location loc = op.getLoc();
+    for (unsigned i = 0, e = op.getCount(); i < e; ++i)
+      buildAPICallWithContext(rewriter, loc, "Z3_solver_push",
+                              LLVM::LLVMVoidType::get(getContext()),
+                              {buildSolverPtr(rewriter, loc)});
+
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+/// Lower `smt.pop` operations to Z3 API calls of the form:
+/// ```
+/// void Z3_API Z3_solver_pop(Z3_context c, Z3_solver s, unsigned n);
+/// ```
+struct PopOpLowering : public SMTLoweringPattern<PopOp> {
+  using SMTLoweringPattern::SMTLoweringPattern;
+
+  LogicalResult
+  matchAndRewrite(PopOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const final {
+    Location loc = op.getLoc();
+    if (op.getCount() != 0) {
+      Value count = rewriter.create<LLVM::ConstantOp>(
+          loc, rewriter.getI32Type(), op.getCount());
+      buildAPICallWithContext(rewriter, loc, "Z3_solver_pop",
+                              LLVM::LLVMVoidType::get(getContext()),
+                              {buildSolverPtr(rewriter, loc), count});
+    }
+
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 /// Lower `smt.yield` operations to `scf.yield` operations. This not necessary
 /// for the yield in `smt.solver` or in quantifiers since they are deleted
 /// directly by the parent operation, but makes the lowering of the `smt.check`
@@ -1375,7 +1434,8 @@ void circt::populateSMTToZ3LLVMConversionPatterns(
   // Other lowering patterns. Refer to their implementation directly for more
   // information.
   patterns.add<BVConstantOpLowering, DeclareFunOpLowering, AssertOpLowering,
-               CheckOpLowering, SolverOpLowering, ApplyFuncOpLowering,
+               PushOpLowering, PopOpLowering, CheckOpLowering,
+               SolverOpLowering, ApplyFuncOpLowering,
                YieldOpLowering, RepeatOpLowering, ExtractOpLowering,
                BoolConstantOpLowering, IntConstantOpLowering,
                ArrayBroadcastOpLowering, BVCmpOpLowering, IntCmpOpLowering,
@@ -1387,6 +1447,7 @@ void circt::populateSMTToZ3LLVMConversionPatterns(
 void LowerSMTToZ3LLVMPass::runOnOperation() {
   LowerSMTToZ3LLVMOptions options;
   options.debug = debug;
+  options.z3Params.assign(z3Params.begin(), z3Params.end());
 
   // Set up the type converter
   LLVMTypeConverter converter(&getContext());
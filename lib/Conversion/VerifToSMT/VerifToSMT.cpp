@@ -168,6 +168,29 @@ struct LogicEquivalenceCheckingOpConversion
   }
 };
 
+/// Return true if the given region, or any module instantiated within it,
+/// contains an assumption.
+static bool containsAssumptions(Region &region) {
+  SmallVector<Operation *> worklist;
+  DenseSet<Operation *> visited;
+  auto visit = [&](Operation *op) {
+    if (isa<verif::AssumeOp>(op))
+      return WalkResult::interrupt();
+    if (auto inst = dyn_cast<InstanceOp>(op))
+      if (auto *module = SymbolTable::lookupNearestSymbolFrom(
+              inst, inst.getModuleNameAttr()))
+        if (visited.insert(module).second)
+          worklist.push_back(module);
+    return WalkResult::advance();
+  };
+  if (region.walk(visit).wasInterrupted())
+    return true;
+  while (!worklist.empty())
+    if (worklist.pop_back_val()->walk(visit).wasInterrupted())
+      return true;
+  return false;
+}
+
 /// Lower a verif::BMCOp operation to an MLIR program that performs the bounded
 /// model check
 struct VerifBoundedModelCheckingOpConversion
@@ -175,13 +198,35 @@ struct VerifBoundedModelCheckingOpConversion
   using OpConversionPattern<verif::BoundedModelCheckingOp>::OpConversionPattern;
 
   VerifBoundedModelCheckingOpConversion(TypeConverter &converter,
-                                        MLIRContext *context, Namespace &names)
-      : OpConversionPattern(converter, context), names(names) {}
+                                        MLIRContext *context, Namespace &names,
+                                        StringRef reportBoundFunc)
+      : OpConversionPattern(converter, context), names(names),
+        reportBoundFunc(reportBoundFunc) {}
 
   LogicalResult
   matchAndRewrite(verif::BoundedModelCheckingOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op.getLoc();
+    // Check each bound in its own assertion scope, such that only the
+    // violation at the current bound is asserted and the solver can reuse what
+    // it learned at earlier bounds. The property is taken out of the circuit
+    // and returned as an additional result instead, such that the circuit can
+    // be evaluated outside of the scope and the assumptions it asserts keep
+    // constraining all later bounds. A property in an instantiated module stays
+    // where it is, and the circuit is evaluated inside the scope.
+    bool hoistProperty = false;
+    auto asserts = op.getCircuit().front().getOps<verif::AssertOp>();
+    if (!asserts.empty() &&
+        (*asserts.begin()).getProperty().getType().isInteger(1)) {
+      auto assertOp = *asserts.begin();
+      auto *yieldOp = op.getCircuit().front().getTerminator();
+      rewriter.modifyOpInPlace(yieldOp, [&] {
+        yieldOp->insertOperands(yieldOp->getNumOperands(),
+                                assertOp.getProperty());
+      });
+      rewriter.eraseOp(assertOp);
+      hoistProperty = true;
+    }
     SmallVector<Type> oldLoopInputTy(op.getLoop().getArgumentTypes());
     SmallVector<Type> oldCircuitInputTy(op.getCircuit().getArgumentTypes());
     // TODO: the init and loop regions should be able to be concrete instead of
@@ -216,7 +261,7 @@ struct VerifBoundedModelCheckingOpConversion
     auto circuitFuncTy =
         rewriter.getFunctionType(circuitInputTy, circuitOutputTy);
 
-    func::FuncOp initFuncOp, loopFuncOp, circuitFuncOp;
+    func::FuncOp initFuncOp, loopFuncOp, circuitFuncOp, reportFuncOp;
 
     {
       OpBuilder::InsertionGuard guard(rewriter);
@@ -248,6 +293,20 @@ struct VerifBoundedModelCheckingOpConversion
               rewriter, loc, outputTy[i], operands[i]));
         rewriter.create<func::ReturnOp>(loc, toReturn);
       }
+
+      // Declare the external function notified after each checked bound.
+      if (!reportBoundFunc.empty()) {
+        auto module = op->getParentOfType<ModuleOp>();
+        reportFuncOp = module.lookupSymbol<func::FuncOp>(reportBoundFunc);
+        if (!reportFuncOp) {
+          rewriter.setInsertionPointToEnd(module.getBody());
+          reportFuncOp = rewriter.create<func::FuncOp>(
+              loc, reportBoundFunc,
+              rewriter.getFunctionType(
+                  {rewriter.getI32Type(), rewriter.getI1Type()}, {}));
+          reportFuncOp.setPrivate();
+        }
+      }
     }
 
     auto solver =
@@ -297,6 +356,9 @@ struct VerifBoundedModelCheckingOpConversion
     auto forOp = rewriter.create<scf::ForOp>(
         loc, lowerBound, upperBound, step, inputDecls,
         [&](OpBuilder &builder, Location loc, Value i, ValueRange iterArgs) {
+          if (!hoistProperty)
+            builder.create<smt::PushOp>(loc, 1);
+
           // Execute the circuit
           ValueRange circuitCallOuts =
               builder
@@ -304,6 +366,17 @@ struct VerifBoundedModelCheckingOpConversion
                       loc, circuitFuncOp,
                       iterArgs.take_front(circuitFuncOp.getNumArguments()))
                   ->getResults();
+
+          // Assert the violation of the property at this bound only
+          if (hoistProperty) {
+            builder.create<smt::PushOp>(loc, 1);
+            Value property = typeConverter->materializeTargetConversion(
+                builder, loc, smt::BoolType::get(getContext()),
+                circuitCallOuts.back());
+            Value notProperty = builder.create<smt::NotOp>(loc, property);
+            builder.create<smt::AssertOp>(loc, notProperty);
+            circuitCallOuts = circuitCallOuts.drop_back();
+          }
           auto checkOp =
               rewriter.create<smt::CheckOp>(loc, builder.getI1Type());
           {
@@ -316,6 +389,11 @@ struct VerifBoundedModelCheckingOpConversion
             builder.create<smt::YieldOp>(loc, constFalse);
           }
 
+          builder.create<smt::PopOp>(loc, 1);
+          if (reportFuncOp)
+            builder.create<func::CallOp>(loc, reportFuncOp,
+                                         ValueRange{i, checkOp.getResult(0)});
+
           Value violated = builder.create<arith::OrIOp>(
               loc, checkOp.getResult(0), iterArgs.back());
 
@@ -362,6 +440,7 @@ struct VerifBoundedModelCheckingOpConversion
   }
 
   Namespace &names;
+  StringRef reportBoundFunc;
 };
 
 } // namespace
@@ -373,18 +452,20 @@ struct VerifBoundedModelCheckingOpConversion
 namespace {
 struct ConvertVerifToSMTPass
     : public circt::impl::ConvertVerifToSMTBase<ConvertVerifToSMTPass> {
+  using ConvertVerifToSMTBase::ConvertVerifToSMTBase;
   void runOnOperation() override;
 };
 } // namespace
 
 void circt::populateVerifToSMTConversionPatterns(TypeConverter &converter,
                                                  RewritePatternSet &patterns,
-                                                 Namespace &names) {
+                                                 Namespace &names,
+                                                 StringRef reportBoundFunc) {
   patterns.add<VerifAssertOpConversion, VerifAssumeOpConversion,
                LogicEquivalenceCheckingOpConversion>(converter,
                                                      patterns.getContext());
   patterns.add<VerifBoundedModelCheckingOpConversion>(
-      converter, patterns.getContext(), names);
+      converter, patterns.getContext(), names, reportBoundFunc);
 }
 
 void ConvertVerifToSMTPass::runOnOperation() {
@@ -402,6 +483,7 @@ void ConvertVerifToSMTPass::runOnOperation() {
         if (isa<verif::BoundedModelCheckingOp>(op)) {
           SmallVector<mlir::Operation *> worklist;
           int numAssertions = 0;
+          bool nestedAssertion = false;
           op->walk([&](Operation *curOp) {
             if (isa<verif::AssertOp>(curOp))
               numAssertions++;
@@ -413,8 +495,10 @@ void ConvertVerifToSMTPass::runOnOperation() {
           while (!worklist.empty()) {
             auto *module = worklist.pop_back_val();
             module->walk([&](Operation *curOp) {
-              if (isa<verif::AssertOp>(curOp))
+              if (isa<verif::AssertOp>(curOp)) {
                 numAssertions++;
+                nestedAssertion = true;
+              }
               if (auto inst = dyn_cast<InstanceOp>(curOp))
                 worklist.push_back(symbolTable.lookup(inst.getModuleName()));
             });
@@ -429,6 +513,16 @@ void ConvertVerifToSMTPass::runOnOperation() {
                 "conjunction of your assertions");
             return WalkResult::interrupt();
           }
+          // An assertion in an instantiated module cannot be checked in its
+          // own scope without also dropping the assumptions of earlier bounds
+          if (nestedAssertion &&
+              containsAssumptions(
+                  cast<verif::BoundedModelCheckingOp>(op).getCircuit())) {
+            op->emitError("bounded model checking problems with assumptions "
+                          "require the assertion to be in the checked module "
+                          "- instead, you can flatten the design first");
+            return WalkResult::interrupt();
+          }
         }
         return WalkResult::advance();
       });
@@ -443,7 +537,8 @@ void ConvertVerifToSMTPass::runOnOperation() {
   Namespace names;
   names.add(symCache);
 
-  populateVerifToSMTConversionPatterns(converter, patterns, names);
+  populateVerifToSMTConversionPatterns(converter, patterns, names,
+                                       reportBoundFunc);
 
   if (failed(mlir::applyPartialConversion(getOperation(), target,
                                           std::move(patterns))))
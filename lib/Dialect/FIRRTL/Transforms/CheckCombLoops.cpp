@@ -24,10 +24,17 @@
 // operation, to record the values that can potentially drive another value.
 // Each node in the graph is a fieldRef. Each edge represents a dataflow from
 // the source to the sink.
-// 3. Perform a DFS traversal on the graph, to detect combinational loops and
-// paths between ports.
+// 3. Perform a single post-order traversal of the graph to detect
+// combinational loops, and to compute a summary of the paths between ports.
+// Each node accumulates a sparse bitset of the ports that transitively drive
+// it, such that the graph is walked only once regardless of the number of
+// output ports.
 // 4. Inline the combinational paths discovered in each module to its instance
-// and continue the analysis through the instance graph.
+// and continue the analysis through the instance graph. Modules that do not
+// instantiate each other are independent, and are analyzed in parallel, one
+// level of the instance hierarchy at a time.
+// 5. Only if a loop is found, re-traverse the offending module to reconstruct
+// and report a sample path through the loop.
 //===----------------------------------------------------------------------===//
 
 #include "circt/Dialect/FIRRTL/CHIRRTLDialect.h"
@@ -36,10 +43,12 @@
 #include "circt/Dialect/FIRRTL/FIRRTLUtils.h"
 #include "circt/Dialect/FIRRTL/FIRRTLVisitors.h"
 #include "circt/Dialect/FIRRTL/Passes.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Pass/Pass.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/EquivalenceClasses.h"
 #include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/SparseBitVector.h"
 
 #define DEBUG_TYPE "check-comb-loops"
 
@@ -74,10 +83,18 @@ public:
       : module(module), instanceGraph(instanceGraph),
         modulePortPaths(otherModulePortPaths), portPaths(thisModulePortPaths) {}
 
-  LogicalResult processModule() {
+  /// Construct the connectivity graph and compute the port paths of the
+  /// module. Returns failure if the module contains a combinational loop. The
+  /// loop is only reconstructed and reported as an error if `reportLoops` is
+  /// set.
+  LogicalResult processModule(bool reportLoops = true) {
     LLVM_DEBUG(llvm::dbgs() << "\n processing module :" << module.getName());
     constructConnectivityGraph(module);
-    return dfsTraverse(drivenBy);
+    if (succeeded(computePortPaths()))
+      return success();
+    if (reportLoops)
+      (void)dfsTraverse(drivenBy);
+    return failure();
   }
 
   void constructConnectivityGraph(FModuleOp module) {
@@ -644,27 +661,114 @@ public:
 
   void addToPortPathsIfRWProbe(unsigned srcNode,
                                DenseSet<FieldRef> &inputPortPaths) {
+    forEachRWProbePort(srcNode,
+                       [&](FieldRef probe) { inputPortPaths.insert(probe); });
+  }
+
+  // Call `fn` with every RWProbe port that refers to the data of `srcNode`.
+  void forEachRWProbePort(unsigned srcNode,
+                          llvm::function_ref<void(FieldRef)> fn) {
     // Check if there exists any RWProbe for the srcNode.
     auto baseFieldRef = drivenBy[srcNode].first;
-    if (auto defOp = dyn_cast_or_null<Forceable>(baseFieldRef.getDefiningOp()))
-      if (defOp.isForceable() && !defOp.getDataRef().use_empty()) {
-        // Assumption, the probe must exist in the equivalence classes.
-        auto rwProbeNode =
-            rwProbeClasses.getLeaderValue(getOrAddNode(defOp.getDataRef()));
-        // For all the probes, that are in the same eqv class, i.e., refer to
-        // the same value.
-        for (auto probe :
-             llvm::make_range(rwProbeClasses.member_begin(
-                                  rwProbeClasses.findValue(rwProbeNode)),
-                              rwProbeClasses.member_end())) {
-          auto probeVal = drivenBy[probe].first;
-          // If the probe is a port, then record the path from the probe to the
-          // input port.
-          if (isa<BlockArgument>(probeVal.getValue())) {
-            inputPortPaths.insert(probeVal);
+    auto defOp = dyn_cast_or_null<Forceable>(baseFieldRef.getDefiningOp());
+    if (!defOp || !defOp.isForceable() || defOp.getDataRef().use_empty())
+      return;
+    // The probe must have been recorded while constructing the graph.
+    auto nodeIt = nodes.find(FieldRef(defOp.getDataRef(), 0));
+    if (nodeIt == nodes.end())
+      return;
+    auto leader = rwProbeClasses.findLeader(nodeIt->second);
+    if (leader == rwProbeClasses.member_end())
+      return;
+    // For all the probes, that are in the same eqv class, i.e., refer to the
+    // same value. If the probe is a port, then record the path from the probe
+    // to the input port.
+    for (auto probe : llvm::make_range(leader, rwProbeClasses.member_end())) {
+      auto probeVal = drivenBy[probe].first;
+      if (isa<BlockArgument>(probeVal.getValue()))
+        fn(probeVal);
+    }
+  }
+
+  bool isOutputPort(unsigned node) {
+    auto arg = dyn_cast<BlockArgument>(drivenBy[node].first.getValue());
+    return arg && module.getPortDirection(arg.getArgNumber()) == Direction::Out;
+  }
+
+  // Detect cycles and compute the paths between the ports of this module.
+  // Every node is visited exactly once, in post-order over its drivers, and
+  // accumulates the set of ports that transitively drive it as a sparse bitset
+  // indexing into `sources`. The bitset of an output port is exactly its
+  // entry in `portPaths`. A bitset is released once all the nodes it drives
+  // have merged it, so only the sets on the frontier of the search are alive.
+  // Returns failure without reporting if the graph contains a cycle.
+  LogicalResult computePortPaths() {
+    auto numNodes = drivenBy.size();
+    SmallVector<FieldRef> sources;
+    DenseMap<FieldRef, unsigned> sourceIds;
+    auto addSource = [&](FieldRef source, llvm::SparseBitVector<> &bits) {
+      auto [it, inserted] = sourceIds.try_emplace(source, sources.size());
+      if (inserted)
+        sources.push_back(source);
+      bits.set(it->second);
+    };
+
+    enum : uint8_t { Unvisited, OnStack, Done };
+    SmallVector<uint8_t> state(numNodes, Unvisited);
+    std::vector<llvm::SparseBitVector<>> reachedBy(numNodes);
+    // The number of driven nodes that have yet to merge each node's bitset.
+    SmallVector<unsigned> numPendingUses(numNodes, 0);
+    for (auto &[_, drivers] : drivenBy)
+      for (auto driver : drivers)
+        ++numPendingUses[driver];
+    // Pairs of a node and the index of the next driver to visit.
+    SmallVector<std::pair<unsigned, unsigned>> stack;
+
+    for (unsigned root = 0; root < numNodes; ++root) {
+      if (state[root] != Unvisited)
+        continue;
+      state[root] = OnStack;
+      stack.push_back({root, 0});
+      while (!stack.empty()) {
+        auto node = stack.back().first;
+        auto &drivers = drivenBy[node].second;
+        if (stack.back().second < drivers.size()) {
+          auto driver = drivers[stack.back().second++];
+          if (state[driver] == OnStack)
+            return failure();
+          if (state[driver] == Unvisited) {
+            state[driver] = OnStack;
+            stack.push_back({driver, 0});
           }
+          continue;
+        }
+
+        // All drivers are done, merge their sets into this node.
+        auto &bits = reachedBy[node];
+        for (auto driver : drivers)
+          bits |= reachedBy[driver];
+        if (!drivers.empty() && isOutputPort(node)) {
+          auto &paths = portPaths[drivenBy[node].first];
+          for (auto id : bits)
+            paths.insert(sources[id]);
         }
+        // The node itself is a source for the nodes it drives.
+        if (isa<BlockArgument>(drivenBy[node].first.getValue()))
+          addSource(drivenBy[node].first, bits);
+        forEachRWProbePort(node,
+                           [&](FieldRef probe) { addSource(probe, bits); });
+
+        for (auto driver : drivers)
+          if (--numPendingUses[driver] == 0)
+            reachedBy[driver].clear();
+        if (numPendingUses[node] == 0)
+          bits.clear();
+
+        state[node] = Done;
+        stack.pop_back();
       }
+    }
+    return success();
   }
 
 private:
@@ -711,16 +815,56 @@ public:
 
     // Traverse modules in a post order to make sure the combinational paths
     // between IOs of a module have been detected and recorded in
-    // `modulePortPaths` before we handle its parent modules.
+    // `modulePortPaths` before we handle its parent modules. Group the modules
+    // into levels, such that each module only instantiates modules of lower
+    // levels. The modules of one level can then be analyzed in parallel.
+    SmallVector<FModuleOp> modules;
+    SmallVector<SmallVector<unsigned>> levels;
+    DenseMap<igraph::InstanceGraphNode *, unsigned> nodeLevels;
     for (auto *igNode : llvm::post_order<InstanceGraph *>(&instanceGraph)) {
+      unsigned level = 0;
+      for (auto *record : *igNode)
+        level = std::max(level, nodeLevels.lookup(record->getTarget()) + 1);
+      nodeLevels[igNode] = level;
       if (auto module = dyn_cast<FModuleOp>(*igNode->getModule())) {
-        DiscoverLoops rdf(module, instanceGraph, modulePortPaths,
-                          modulePortPaths[module]);
-        if (rdf.processModule().failed()) {
-          return signalPassFailure();
-        }
+        // Create the entry up front, such that the parallel workers do not
+        // modify the map itself.
+        modulePortPaths[module];
+        if (levels.size() <= level)
+          levels.resize(level + 1);
+        levels[level].push_back(modules.size());
+        modules.push_back(module);
       }
     }
+
+    // Only the loop in the first module in post order is reported. Modules
+    // after it need not be analyzed.
+    unsigned firstLoop = modules.size();
+    SmallVector<uint8_t> hasLoop(modules.size(), false);
+    for (auto &level : levels) {
+      SmallVector<unsigned> worklist;
+      for (auto index : level)
+        if (index < firstLoop)
+          worklist.push_back(index);
+      mlir::parallelForEach(&getContext(), worklist, [&](unsigned index) {
+        auto module = modules[index];
+        DiscoverLoops rdf(module, instanceGraph, modulePortPaths,
+                          modulePortPaths.find(module)->second);
+        hasLoop[index] = failed(rdf.processModule(/*reportLoops=*/false));
+      });
+      for (auto index : worklist)
+        if (hasLoop[index])
+          firstLoop = std::min(firstLoop, index);
+    }
+
+    if (firstLoop != modules.size()) {
+      // Analyze the module again to reconstruct and report the loop.
+      DrivenBysMapType portPaths;
+      DiscoverLoops rdf(modules[firstLoop], instanceGraph, modulePortPaths,
+                        portPaths);
+      (void)rdf.processModule();
+      return signalPassFailure();
+    }
     markAllAnalysesPreserved();
   }
 };
@@ -13,6 +13,8 @@
 #include "circt/Dialect/Handshake/HandshakeOps.h"
 #include "circt/Dialect/Handshake/HandshakePasses.h"
 #include "circt/Dialect/Handshake/HandshakeUtils.h"
+#include "circt/Scheduling/Algorithms.h"
+#include "circt/Scheduling/Problems.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
@@ -29,6 +31,7 @@ namespace handshake {
 using namespace circt;
 using namespace handshake;
 using namespace mlir;
+using namespace circt::scheduling;
 
 namespace {
 
@@ -178,6 +181,285 @@ static void bufferAllFIFOStrategy(Region &r, OpBuilder &builder,
                     /*bufferType=*/BufferTypeEnum::fifo);
 }
 
+namespace {
+/// Summary of the buffering performed by the throughput strategy.
+struct ThroughputBuffering {
+  /// The smallest initiation interval the buffered region can sustain.
+  unsigned achievableII = 1;
+  unsigned numCycleBuffers = 0;
+  unsigned numSlackBuffers = 0;
+  unsigned numSlackSlots = 0;
+};
+} // namespace
+
+// Inserts a buffer on a single channel, leaving other uses of the value alone.
+static void insertBufferOnOperand(OpOperand &operand, OpBuilder &builder,
+                                  unsigned numSlots,
+                                  BufferTypeEnum bufferType) {
+  Value value = operand.get();
+  OpBuilder::InsertionGuard guard(builder);
+  builder.setInsertionPointAfterValue(value);
+  auto bufferOp = builder.create<handshake::BufferOp>(value.getLoc(), value,
+                                                      numSlots, bufferType);
+  operand.set(bufferOp);
+}
+
+// Returns the channels which close a cycle during a depth first search of the
+// dataflow graph, such that every cycle contains at least one of them.
+// 'breaksCycle' is a function which determines whether an operation breaks all
+// cycles through it. Channels for which 'ignoreEdge' returns true are not
+// followed.
+static SmallVector<OpOperand *>
+findBackEdges(Region &r, llvm::function_ref<bool(Operation *)> breaksCycle,
+              llvm::function_ref<bool(OpOperand &)> ignoreEdge = nullptr) {
+  struct Frame {
+    Operation *op;
+    SmallVector<OpOperand *> uses;
+    unsigned next = 0;
+  };
+  SmallVector<OpOperand *> backEdges;
+  DenseSet<Operation *> visited, onStack;
+  SmallVector<Frame> stack;
+
+  auto push = [&](Operation *op) {
+    visited.insert(op);
+    onStack.insert(op);
+    Frame frame{op, {}};
+    if (!breaksCycle(op))
+      for (auto res : op->getResults())
+        for (auto &use : res.getUses())
+          if (!ignoreEdge || !ignoreEdge(use))
+            frame.uses.push_back(&use);
+    stack.push_back(std::move(frame));
+  };
+
+  for (auto &root : r.getOps()) {
+    if (visited.contains(&root))
+      continue;
+    push(&root);
+    while (!stack.empty()) {
+      Frame &frame = stack.back();
+      if (frame.next == frame.uses.size()) {
+        onStack.erase(frame.op);
+        stack.pop_back();
+        continue;
+      }
+      OpOperand *use = frame.uses[frame.next++];
+      Operation *user = use->getOwner();
+      if (onStack.contains(user))
+        backEdges.push_back(use);
+      else if (!visited.contains(user))
+        push(user);
+    }
+  }
+  return backEdges;
+}
+
+// Returns the strongly connected component of each operation in the dataflow
+// graph. Two operations are in the same component iff they lie on a common
+// cycle.
+static DenseMap<Operation *, unsigned> computeSCCs(Region &r) {
+  // Order the operations by the time a depth first search finishes them.
+  struct Frame {
+    Operation *op;
+    SmallVector<Operation *> users;
+    unsigned next = 0;
+  };
+  SmallVector<Operation *> postOrder;
+  DenseSet<Operation *> visited;
+  SmallVector<Frame> stack;
+  for (auto &root : r.getOps()) {
+    if (!visited.insert(&root).second)
+      continue;
+    stack.push_back({&root, llvm::to_vector(root.getUsers())});
+    while (!stack.empty()) {
+      Frame &frame = stack.back();
+      if (frame.next == frame.users.size()) {
+        postOrder.push_back(frame.op);
+        stack.pop_back();
+        continue;
+      }
+      Operation *user = frame.users[frame.next++];
+      if (visited.insert(user).second)
+        stack.push_back({user, llvm::to_vector(user->getUsers())});
+    }
+  }
+
+  // Collect the components on the transposed graph, in reverse finishing
+  // order.
+  DenseMap<Operation *, unsigned> sccs;
+  unsigned numSCCs = 0;
+  for (Operation *root : llvm::reverse(postOrder)) {
+    if (!sccs.try_emplace(root, numSCCs).second)
+      continue;
+    SmallVector<Operation *> worklist = {root};
+    while (!worklist.empty()) {
+      Operation *op = worklist.pop_back_val();
+      for (Value operand : op->getOperands())
+        if (Operation *def = operand.getDefiningOp())
+          if (sccs.try_emplace(def, numSCCs).second)
+            worklist.push_back(def);
+    }
+    ++numSCCs;
+  }
+  return sccs;
+}
+
+// Returns the number of tokens on a channel at the start of an iteration. The
+// token of the next iteration enters a cycle through a data input of the
+// merge-like operation heading it. Buffers with initial values hold one token
+// per value.
+static unsigned
+getNumInitialTokens(OpOperand &operand,
+                    const DenseMap<Operation *, unsigned> &sccs) {
+  Operation *src = operand.get().getDefiningOp();
+  if (!src)
+    return 0;
+
+  unsigned numTokens = 0;
+  if (auto bufferOp = dyn_cast<handshake::BufferOp>(src);
+      bufferOp && bufferOp.getInitValues())
+    numTokens += bufferOp.getInitValueArray().size();
+
+  Operation *dst = operand.getOwner();
+  if (auto mergeOp = dyn_cast<MergeLikeOpInterface>(dst)) {
+    auto dataOperands = mergeOp.getDataOperands();
+    unsigned index = operand.getOperandNumber();
+    if (index >= dataOperands.getBeginOperandIndex() &&
+        index < dataOperands.getBeginOperandIndex() + dataOperands.size() &&
+        sccs.lookup(src) == sccs.lookup(dst))
+      ++numTokens;
+  }
+  return numTokens;
+}
+
+// Place the buffers needed to sustain 'targetII', or the smallest achievable
+// initiation interval if that is larger. The region is modelled as a cyclic
+// scheduling problem in which sequential buffers have a latency of one cycle
+// per slot, all other operations are combinational, and each cycle of the
+// dataflow graph carries the tokens entering it through merge-like operations
+// or held by initialized buffers. A token arriving at an operation before the
+// tokens it has to join with must wait in a FIFO buffer, so the slack of each
+// channel in the schedule determines the FIFO's size.
+//
+// Choice is not modelled: merge-like operations wait for all of their inputs
+// and branches feed both of their outputs. The predicted II is therefore bound
+// by the slowest cycle, whether or not it is taken in every iteration.
+static FailureOr<ThroughputBuffering>
+bufferThroughputStrategy(Region &r, OpBuilder &builder, unsigned targetII) {
+  ThroughputBuffering result;
+  auto isSeqBuffer = [](Operation *op) {
+    auto bufferOp = dyn_cast<handshake::BufferOp>(op);
+    return bufferOp && bufferOp.isSequential();
+  };
+
+  // Break combinational cycles with as few registers as possible, since each
+  // register on a cycle delays the token circulating through it.
+  for (OpOperand *use : findBackEdges(r, isSeqBuffer)) {
+    insertBufferOnOperand(*use, builder, /*numSlots=*/1, BufferTypeEnum::seq);
+    ++result.numCycleBuffers;
+  }
+
+  Operation *terminator = r.front().getTerminator();
+  CyclicProblem problem(r.getParentOp());
+  auto combOpr = problem.getOrInsertOperatorType("comb");
+  problem.setLatency(combOpr, 0);
+  for (auto &op : r.getOps()) {
+    problem.insertOperation(&op);
+    if (isSeqBuffer(&op)) {
+      unsigned numSlots = cast<handshake::BufferOp>(op).getNumSlots();
+      auto seqOpr =
+          problem.getOrInsertOperatorType(("seq" + Twine(numSlots)).str());
+      problem.setLatency(seqOpr, numSlots);
+      problem.setLinkedOperatorType(&op, seqOpr);
+    } else {
+      problem.setLinkedOperatorType(&op, combOpr);
+    }
+
+    // The terminator has to (transitively) depend on every other operation to
+    // serve as the scheduler's last operation.
+    if (&op != terminator && op.use_empty())
+      if (failed(problem.insertDependence({&op, terminator})))
+        return failure();
+  }
+
+  // Count the tokens of each cycle where they are at the start of an
+  // iteration, rather than on arbitrary back edges of which a cycle may cross
+  // several.
+  auto sccs = computeSCCs(r);
+  for (auto &op : r.getOps())
+    for (auto &operand : op.getOpOperands())
+      if (unsigned numTokens = getNumInitialTokens(operand, sccs))
+        problem.setDistance(&operand, numTokens);
+
+  // A cycle without any token deadlocks. Assume a single token on it, rather
+  // than failing to model the function.
+  for (OpOperand *use : findBackEdges(
+           r, [](Operation *) { return false; },
+           [&](OpOperand &use) {
+             return problem.getDistance(&use).value_or(0) > 0;
+           }))
+    problem.setDistance(use, 1);
+
+  if (failed(problem.check()) || failed(scheduleSimplex(problem, terminator)))
+    return failure();
+  result.achievableII = *problem.getInitiationInterval();
+  int64_t ii = std::max(result.achievableII, targetII);
+
+  // The scheduler only minimizes the latency of the terminator. Compute the
+  // earliest start times at the chosen II instead, such that tokens wait no
+  // longer than necessary.
+  auto getLatency = [&](Operation *op) -> int64_t {
+    return *problem.getLatency(*problem.getLinkedOperatorType(op));
+  };
+  DenseMap<Operation *, int64_t> startTimes;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto &op : r.getOps()) {
+      for (auto dep : problem.getDependences(&op)) {
+        Operation *src = dep.getSource();
+        int64_t time = startTimes[src] + getLatency(src) -
+                       ii * problem.getDistance(dep).value_or(0);
+        if (time > startTimes[&op]) {
+          startTimes[&op] = time;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  SmallVector<std::pair<OpOperand *, unsigned>> slackBuffers;
+  for (auto &op : r.getOps()) {
+    if (&op == terminator)
+      continue;
+    for (auto &operand : op.getOpOperands()) {
+      Value value = operand.get();
+      Operation *src = value.getDefiningOp();
+      int64_t readyTime = 0;
+      unsigned distance = 0;
+      if (src) {
+        if (!isUnbufferedChannel(src, &op))
+          continue;
+        readyTime = startTimes[src] + getLatency(src);
+        distance = problem.getDistance(&operand).value_or(0);
+      } else if (!shouldBufferArgument(cast<BlockArgument>(value))) {
+        continue;
+      }
+      int64_t slack = startTimes[&op] + ii * distance - readyTime;
+      if (slack > 0)
+        slackBuffers.push_back(
+            {&operand, static_cast<unsigned>(llvm::divideCeil(slack, ii))});
+    }
+  }
+
+  for (auto [operand, numSlots] : slackBuffers) {
+    insertBufferOnOperand(*operand, builder, numSlots, BufferTypeEnum::fifo);
+    ++result.numSlackBuffers;
+    result.numSlackSlots += numSlots;
+  }
+  return result;
+}
+
 static LogicalResult bufferRegion(Region &r, OpBuilder &builder,
                                   StringRef strategy, unsigned bufferSize) {
   if (strategy == "cycles")
@@ -209,6 +491,25 @@ struct HandshakeInsertBuffersPass
 
     OpBuilder builder(f.getContext());
 
+    if (strategy == "throughput") {
+      auto result = bufferThroughputStrategy(f.getBody(), builder, targetII);
+      if (failed(result)) {
+        f.emitOpError() << "failed to model the throughput of the function";
+        return signalPassFailure();
+      }
+      numCycleBuffers += result->numCycleBuffers;
+      numSlackBuffers += result->numSlackBuffers;
+      numSlackSlots += result->numSlackSlots;
+      unsigned ii = std::max(result->achievableII, targetII.getValue());
+      if (result->achievableII > targetII)
+        ++numTargetIIMissed;
+      if (reportThroughput)
+        f.emitRemark() << "predicted initiation interval " << ii
+                       << " (achievable " << result->achievableII
+                       << ", target " << targetII.getValue() << ")";
+      return;
+    }
+
     if (failed(bufferRegion(f.getBody(), builder, strategy, bufferSize)))
       signalPassFailure();
   }
@@ -0,0 +1,1166 @@
+//===- Engine.cpp - Event-driven LLHD simulator ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The engine elaborates the instance hierarchy once and compiles every
+// operation into a closure that reads and writes dense per-instance slot
+// vectors, so that running a process boils down to calling a list of
+// closures per block instead of dispatching on operations and looking up
+// values in maps.
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Dialect/LLHD/Simulator/Engine.h"
+#include "circt/Dialect/Comb/CombOps.h"
+#include "circt/Dialect/HW/HWOps.h"
+#include "circt/Dialect/LLHD/IR/LLHDOps.h"
+#include "circt/Dialect/LLHD/Simulator/Trace.h"
+#include "circt/Dialect/Seq/SeqOps.h"
+#include "circt/Dialect/Sim/SimOps.h"
+#include "mlir/Analysis/TopologicalSortUtils.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/raw_ostream.h"
+#include <functional>
+#include <numeric>
+
+using namespace mlir;
+using namespace circt;
+using namespace llhd::sim;
+using llvm::APInt;
+
+namespace {
+
+/// A reference to a range of bits of a signal. A signal of `~0U` marks a
+/// reference that does not point anywhere, for example an out-of-bounds
+/// extract.
+struct SignalRef {
+  unsigned signal = ~0U;
+  unsigned offset = 0;
+  unsigned width = 0;
+};
+
+/// The kinds of runtime values, each stored in its own slot vector.
+enum class SlotKind { Value, Ref, Time, String };
+
+/// An elaborated instance of a module. It holds the runtime value of every SSA
+/// value defined in the module body and its processes.
+struct Instance {
+  unsigned index;
+  std::string path;
+  hw::HWModuleOp module;
+  Instance *parent = nullptr;
+  /// The results of the `hw.instance` op in the parent, if any.
+  SmallVector<unsigned> parentResultSlots;
+
+  SmallVector<APInt> values;
+  SmallVector<SignalRef> refs;
+  SmallVector<SimTime> times;
+  SmallVector<std::string> strings;
+  DenseMap<Value, unsigned> slots;
+
+  /// The signals carrying the data ports of the instance. Inout ports have no
+  /// signal of their own and are marked with `~0U`.
+  SmallVector<unsigned> inputSignals;
+  SmallVector<unsigned> outputSignals;
+  /// The instances created by the `hw.instance` ops in the module body.
+  DenseMap<Operation *, Instance *> children;
+  unsigned numUnnamedSignals = 0;
+};
+
+using Action = std::function<void()>;
+
+/// What a process does after executing a block.
+struct Control {
+  enum Kind { Branch, Suspend, Halt } kind;
+  unsigned block = 0;
+};
+
+struct CompiledBlock {
+  SmallVector<Action> actions;
+  std::function<Control()> terminator;
+};
+
+/// A unit of execution: the module-level logic of an instance, one of its
+/// `llhd.process` ops, or one of its `llhd.final` ops.
+struct Unit {
+  enum class Kind { Module, Process, Final };
+
+  Unit(Kind kind, Instance &inst) : kind(kind), inst(inst) {}
+
+  Kind kind;
+  Instance &inst;
+  SmallVector<CompiledBlock> blocks;
+  /// The block at which the unit resumes.
+  unsigned block = 0;
+  bool halted = false;
+  bool queued = false;
+  /// Incremented whenever the unit is woken up. Wakeups registered under an
+  /// older generation are stale and ignored.
+  uint64_t generation = 0;
+  /// The signals a module unit always reacts to, namely the data ports of its
+  /// instance and the outputs of its child instances.
+  SmallVector<unsigned> staticSensitivity;
+};
+
+/// A queued signal drive or, if `unit` is set, a process wakeup.
+struct Event {
+  Unit *unit = nullptr;
+  uint64_t generation = 0;
+  SignalRef ref;
+  APInt value;
+};
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// Engine implementation
+//===----------------------------------------------------------------------===//
+
+struct Engine::Impl {
+  Impl(ModuleOp module, StringRef root)
+      : module(module), root(root), symbolTable(module) {}
+
+  // Elaboration.
+  FailureOr<Instance *> instantiate(hw::HWModuleOp hwModule, StringRef path,
+                                    Instance *parent);
+  LogicalResult compileModuleUnit(Instance &inst);
+  LogicalResult compileRegion(Unit &unit, Region &region);
+  LogicalResult compileOp(Unit &unit, Operation *op,
+                          SmallVectorImpl<Action> &actions);
+  LogicalResult compileTerminator(Unit &unit, Operation *op,
+                                  const DenseMap<Block *, unsigned> &blocks,
+                                  CompiledBlock &compiled);
+  Action compileCopies(Instance &inst, ValueRange from, ValueRange to);
+  LogicalResult checkTypes(Operation *op);
+  unsigned getSlot(Instance &inst, Value value);
+  unsigned createSignal(Instance &inst, StringRef name, unsigned width,
+                        bool named);
+
+  // Simulation.
+  void schedule(SimTime delay, Event event);
+  void addWaiter(unsigned signal, Unit &unit);
+  void wake(Unit &unit, uint64_t generation);
+  void setSignal(SignalRef ref, const APInt &value);
+  void setPort(unsigned signal, const APInt &value) {
+    setSignal({signal, 0, signals[signal].value.getBitWidth()}, value);
+  }
+  void runUnit(Unit &unit);
+  void runReady();
+
+  ModuleOp module;
+  std::string root;
+  SymbolTable symbolTable;
+
+  std::vector<Signal> signals;
+  std::vector<bool> initialized;
+  std::vector<SmallVector<std::pair<Unit *, uint64_t>, 2>> waiters;
+  std::vector<std::unique_ptr<Instance>> instances;
+  std::vector<std::string> instancePaths;
+  std::vector<std::unique_ptr<Unit>> units;
+  /// The greatest common divisor of all constant real time delays.
+  uint64_t resolution = 0;
+
+  TimingWheel<Event> queue;
+  SimTime now;
+  std::vector<Unit *> ready;
+  /// The signals probed by the module unit currently running.
+  SmallVector<unsigned> probed;
+  /// The signals changed in the current step.
+  std::vector<unsigned> changed;
+  std::vector<bool> isChanged;
+};
+
+/// Return the kind of slot storing values of `type`, or `std::nullopt` if the
+/// simulator does not support the type.
+static std::optional<SlotKind> getSlotKind(Type type) {
+  if (isa<IntegerType, seq::ClockType>(type))
+    return SlotKind::Value;
+  if (auto inout = dyn_cast<hw::InOutType>(type))
+    return isa<IntegerType>(inout.getElementType())
+               ? std::optional(SlotKind::Ref)
+               : std::nullopt;
+  if (isa<llhd::TimeType>(type))
+    return SlotKind::Time;
+  if (isa<circt::sim::FormatStringType>(type))
+    return SlotKind::String;
+  return std::nullopt;
+}
+
+static unsigned getWidth(Type type) {
+  if (auto inout = dyn_cast<hw::InOutType>(type))
+    type = inout.getElementType();
+  if (isa<seq::ClockType>(type))
+    return 1;
+  return cast<IntegerType>(type).getWidth();
+}
+
+/// Convert a time attribute to femtoseconds, delta and epsilon steps.
+static SimTime getSimTime(llhd::TimeAttr attr) {
+  uint64_t scale = llvm::StringSwitch<uint64_t>(attr.getTimeUnit())
+                       .Case("fs", 1)
+                       .Case("ps", 1000)
+                       .Case("ns", 1000000)
+                       .Case("us", 1000000000)
+                       .Case("ms", 1000000000000)
+                       .Case("s", 1000000000000000)
+                       .Default(0);
+  return {attr.getTime() * scale, attr.getDelta(), attr.getEpsilon()};
+}
+
+LogicalResult Engine::Impl::checkTypes(Operation *op) {
+  for (auto types : {TypeRange(op->getOperandTypes()),
+                     TypeRange(op->getResultTypes())})
+    for (auto type : types)
+      if (!getSlotKind(type))
+        return op->emitError("values of type ")
+               << type << " are not supported by the simulator";
+  return success();
+}
+
+unsigned Engine::Impl::getSlot(Instance &inst, Value value) {
+  auto [it, inserted] = inst.slots.insert({value, 0});
+  if (!inserted)
+    return it->second;
+  switch (*getSlotKind(value.getType())) {
+  case SlotKind::Value:
+    it->second = inst.values.size();
+    inst.values.push_back(APInt(getWidth(value.getType()), 0));
+    break;
+  case SlotKind::Ref:
+    it->second = inst.refs.size();
+    inst.refs.push_back({});
+    break;
+  case SlotKind::Time:
+    it->second = inst.times.size();
+    inst.times.push_back({});
+    break;
+  case SlotKind::String:
+    it->second = inst.strings.size();
+    inst.strings.push_back({});
+    break;
+  }
+  return it->second;
+}
+
+unsigned Engine::Impl::createSignal(Instance &inst, StringRef name,
+                                    unsigned width, bool named) {
+  std::string leaf =
+      named ? name.str() : std::to_string(inst.numUnnamedSignals++);
+  signals.push_back(
+      {inst.path + "/" + leaf, leaf, inst.index, named, APInt(width, 0)});
+  initialized.push_back(false);
+  waiters.emplace_back();
+  return signals.size() - 1;
+}
+
+//===----------------------------------------------------------------------===//
+// Elaboration
+//===----------------------------------------------------------------------===//
+
+FailureOr<Instance *> Engine::Impl::instantiate(hw::HWModuleOp hwModule,
+                                                StringRef path,
+                                                Instance *parent) {
+  instances.push_back(std::make_unique<Instance>());
+  Instance &inst = *instances.back();
+  inst.index = instances.size() - 1;
+  inst.path = path.str();
+  inst.module = hwModule;
+  inst.parent = parent;
+  instancePaths.push_back(inst.path);
+
+  // Data ports are carried by signals of their own, such that the logic and
+  // processes reading them react to their changes.
+  auto *body = hwModule.getBodyBlock();
+  for (auto arg : body->getArguments()) {
+    if (!getSlotKind(arg.getType()))
+      return hwModule.emitError("port of type ")
+             << arg.getType() << " is not supported by the simulator";
+    getSlot(inst, arg);
+    if (isa<hw::InOutType>(arg.getType())) {
+      inst.inputSignals.push_back(~0U);
+      continue;
+    }
+    unsigned signal =
+        createSignal(inst, hwModule.getInputName(arg.getArgNumber()),
+                     getWidth(arg.getType()), true);
+    initialized[signal] = true;
+    inst.inputSignals.push_back(signal);
+  }
+  for (auto [index, type] :
+       llvm::enumerate(hwModule.getHWModuleType().getOutputTypes())) {
+    if (getSlotKind(type) != SlotKind::Value)
+      return hwModule.emitError("port of type ")
+             << type << " is not supported by the simulator";
+    unsigned signal = createSignal(inst, hwModule.getOutputName(index),
+                                   getWidth(type), true);
+    initialized[signal] = true;
+    inst.outputSignals.push_back(signal);
+  }
+
+  if (failed(compileModuleUnit(inst)))
+    return failure();
+
+  for (auto &op : *body) {
+    Unit::Kind kind;
+    if (isa<llhd::ProcessOp>(op))
+      kind = Unit::Kind::Process;
+    else if (isa<llhd::FinalOp>(op))
+      kind = Unit::Kind::Final;
+    else
+      continue;
+    units.push_back(std::make_unique<Unit>(kind, inst));
+    if (failed(compileRegion(*units.back(), op.getRegion(0))))
+      return failure();
+  }
+  return &inst;
+}
+
+LogicalResult Engine::Impl::compileModuleUnit(Instance &inst) {
+  units.push_back(std::make_unique<Unit>(Unit::Kind::Module, inst));
+  Unit &unit = *units.back();
+  for (auto signal : inst.inputSignals)
+    if (signal != ~0U)
+      unit.staticSensitivity.push_back(signal);
+
+  // Module bodies are graph regions, so bring the operations into an order in
+  // which every value is computed before it is used.
+  SmallVector<Operation *> ops;
+  for (auto &op : *inst.module.getBodyBlock())
+    if (!isa<llhd::ProcessOp, llhd::FinalOp>(op))
+      ops.push_back(&op);
+  if (!computeTopologicalSorting(ops))
+    return inst.module.emitError("combinational cycle in module body");
+
+  auto &block = unit.blocks.emplace_back();
+  for (auto *op : ops)
+    if (failed(compileOp(unit, op, block.actions)))
+      return failure();
+  return success();
+}
+
+LogicalResult Engine::Impl::compileRegion(Unit &unit, Region &region) {
+  DenseMap<Block *, unsigned> blockIndices;
+  for (auto &block : region)
+    blockIndices.insert({&block, blockIndices.size()});
+
+  unit.blocks.resize(blockIndices.size());
+  for (auto &block : region) {
+    auto &compiled = unit.blocks[blockIndices.lookup(&block)];
+    for (auto arg : block.getArguments())
+      if (!getSlotKind(arg.getType()))
+        return mlir::emitError(arg.getLoc(), "values of type ")
+               << arg.getType() << " are not supported by the simulator";
+    for (auto &op : block.without_terminator())
+      if (failed(compileOp(unit, &op, compiled.actions)))
+        return failure();
+    if (failed(compileTerminator(unit, block.getTerminator(), blockIndices,
+                                 compiled)))
+      return failure();
+  }
+  return success();
+}
+
+Action Engine::Impl::compileCopies(Instance &inst, ValueRange from,
+                                   ValueRange to) {
+  // Block arguments may be permuted on a back edge, so all sources are read
+  // before any destination is written.
+  SmallVector<std::pair<unsigned, unsigned>> values, refs, times, strings;
+  for (auto [src, dst] : llvm::zip(from, to)) {
+    std::pair<unsigned, unsigned> copy = {getSlot(inst, src),
+                                          getSlot(inst, dst)};
+    switch (*getSlotKind(src.getType())) {
+    case SlotKind::Value:
+      values.push_back(copy);
+      break;
+    case SlotKind::Ref:
+      refs.push_back(copy);
+      break;
+    case SlotKind::Time:
+      times.push_back(copy);
+      break;
+    case SlotKind::String:
+      strings.push_back(copy);
+      break;
+    }
+  }
+  if (values.empty() && refs.empty() && times.empty() && strings.empty())
+    return {};
+  auto copyAll = [](auto &slots, auto &copies) {
+    using T = std::decay_t<decltype(slots[0])>;
+    SmallVector<T> temps;
+    for (auto [src, dst] : copies)
+      temps.push_back(slots[src]);
+    for (auto [temp, copy] : llvm::zip(temps, copies))
+      slots[copy.second] = std::move(temp);
+  };
+  return [&inst, values, refs, times, strings, copyAll] {
+    copyAll(inst.values, values);
+    copyAll(inst.refs, refs);
+    copyAll(inst.times, times);
+    copyAll(inst.strings, strings);
+  };
+}
+
+/// Compile a variadic operation that folds its operands with `fn`.
+template <typename Fn>
+static Action compileFold(Instance &inst, ArrayRef<unsigned> operands,
+                          unsigned result, Fn fn) {
+  SmallVector<unsigned, 4> ops(operands);
+  return [&inst, ops, result, fn] {
+    APInt acc = inst.values[ops[0]];
+    for (auto slot : ArrayRef(ops).drop_front())
+      fn(acc, inst.values[slot]);
+    inst.values[result] = std::move(acc);
+  };
+}
+
+/// Compile a binary operation computing its result with `fn`.
+template <typename Fn>
+static Action compileBinary(Instance &inst, ArrayRef<unsigned> operands,
+                            unsigned result, Fn fn) {
+  unsigned lhs = operands[0], rhs = operands[1];
+  return [&inst, lhs, rhs, result, fn] {
+    inst.values[result] = fn(inst.values[lhs], inst.values[rhs]);
+  };
+}
+
+/// Evaluate a division or remainder, defining the result of a division by
+/// zero as zero.
+template <typename Fn>
+static Action compileDivision(Instance &inst, ArrayRef<unsigned> operands,
+                              unsigned result, Fn fn) {
+  return compileBinary(inst, operands, result,
+                       [fn](const APInt &lhs, const APInt &rhs) {
+                         if (rhs.isZero())
+                           return APInt(lhs.getBitWidth(), 0);
+                         return fn(lhs, rhs);
+                       });
+}
+
+static bool compare(comb::ICmpPredicate predicate, const APInt &lhs,
+                    const APInt &rhs) {
+  switch (predicate) {
+  case comb::ICmpPredicate::eq:
+  case comb::ICmpPredicate::ceq:
+  case comb::ICmpPredicate::weq:
+    return lhs == rhs;
+  case comb::ICmpPredicate::ne:
+  case comb::ICmpPredicate::cne:
+  case comb::ICmpPredicate::wne:
+    return lhs != rhs;
+  case comb::ICmpPredicate::ult:
+    return lhs.ult(rhs);
+  case comb::ICmpPredicate::ule:
+    return lhs.ule(rhs);
+  case comb::ICmpPredicate::ugt:
+    return lhs.ugt(rhs);
+  case comb::ICmpPredicate::uge:
+    return lhs.uge(rhs);
+  case comb::ICmpPredicate::slt:
+    return lhs.slt(rhs);
+  case comb::ICmpPredicate::sle:
+    return lhs.sle(rhs);
+  case comb::ICmpPredicate::sgt:
+    return lhs.sgt(rhs);
+  case comb::ICmpPredicate::sge:
+    return lhs.sge(rhs);
+  }
+  llvm_unreachable("unknown predicate");
+}
+
+/// Format an integer as `sim.fmt.hex`, `sim.fmt.bin`, and `sim.fmt.dec` do.
+static std::string formatInteger(const APInt &value, unsigned radix,
+                                 bool isSigned) {
+  unsigned width = value.getBitWidth();
+  if (width == 0)
+    return radix == 10 ? "0" : "";
+  SmallString<32> digits;
+  value.toString(digits, radix, isSigned, /*formatAsCLiteral=*/false,
+                 /*UpperCase=*/false);
+  unsigned padWidth;
+  char padChar = '0';
+  if (radix == 16) {
+    padWidth = (width + 3) / 4;
+  } else if (radix == 2) {
+    padWidth = width;
+  } else {
+    padWidth = circt::sim::FormatDecOp::getDecimalWidth(width, isSigned);
+    padChar = ' ';
+  }
+  std::string result;
+  if (padWidth > digits.size())
+    result.append(padWidth - digits.size(), padChar);
+  result.append(digits.begin(), digits.end());
+  return result;
+}
+
+LogicalResult Engine::Impl::compileOp(Unit &unit, Operation *op,
+                                      SmallVectorImpl<Action> &actions) {
+  Instance &inst = unit.inst;
+  bool atModuleLevel = unit.kind == Unit::Kind::Module;
+
+  // Instances and the module terminator carry values across the hierarchy.
+  if (auto instOp = dyn_cast<hw::InstanceOp>(op)) {
+    if (!atModuleLevel)
+      return op->emitError("instances in processes are not supported");
+    auto child = dyn_cast_or_null<hw::HWModuleOp>(
+        symbolTable.lookup(instOp.getReferencedModuleName()));
+    if (!child)
+      return op->emitError("instantiated module must be an 'hw.module'");
+    auto childInst = instantiate(
+        child, (Twine(inst.path) + "/" + instOp.getInstanceName()).str(), &inst);
+    if (failed(childInst))
+      return failure();
+    Instance &ci = **childInst;
+    inst.children.insert({op, &ci});
+    for (auto result : instOp.getResults())
+      ci.parentResultSlots.push_back(getSlot(inst, result));
+    llvm::append_range(unit.staticSensitivity, ci.outputSignals);
+
+    SmallVector<std::pair<unsigned, unsigned>> refs;
+    SmallVector<std::tuple<unsigned, unsigned, unsigned>> values;
+    for (auto [operand, arg] : llvm::zip(
+             instOp.getInputs(), ci.module.getBodyBlock()->getArguments())) {
+      unsigned src = getSlot(inst, operand), dst = ci.slots.lookup(arg);
+      unsigned signal = ci.inputSignals[arg.getArgNumber()];
+      if (signal == ~0U)
+        refs.push_back({src, dst});
+      else
+        values.push_back({src, dst, signal});
+    }
+    actions.push_back([this, &inst, &ci, refs, values] {
+      for (auto [src, dst] : refs)
+        ci.refs[dst] = inst.refs[src];
+      for (auto [src, dst, signal] : values) {
+        ci.values[dst] = inst.values[src];
+        setPort(signal, inst.values[src]);
+      }
+    });
+    return success();
+  }
+
+  if (auto outputOp = dyn_cast<hw::OutputOp>(op)) {
+    SmallVector<unsigned> slots;
+    for (auto operand : outputOp.getOperands())
+      slots.push_back(getSlot(inst, operand));
+    actions.push_back([this, &inst, slots] {
+      for (auto [index, slot] : llvm::enumerate(slots)) {
+        if (inst.parent)
+          inst.parent->values[inst.parentResultSlots[index]] =
+              inst.values[slot];
+        setPort(inst.outputSignals[index], inst.values[slot]);
+      }
+    });
+    return success();
+  }
+
+  if (failed(checkTypes(op)))
+    return failure();
+
+  SmallVector<unsigned, 4> operands;
+  for (auto operand : op->getOperands())
+    operands.push_back(getSlot(inst, operand));
+  unsigned result = op->getNumResults() == 1 ? getSlot(inst, op->getResult(0))
+                                             : ~0U;
+
+  // Constants are materialized once during elaboration.
+  if (auto constOp = dyn_cast<hw::ConstantOp>(op)) {
+    inst.values[result] = constOp.getValue();
+    return success();
+  }
+  if (auto timeOp = dyn_cast<llhd::ConstantTimeOp>(op)) {
+    auto time = getSimTime(timeOp.getValue());
+    inst.times[result] = time;
+    resolution = std::gcd(resolution, time.time);
+    return success();
+  }
+  if (auto litOp = dyn_cast<circt::sim::FormatLitOp>(op)) {
+    inst.strings[result] = litOp.getLiteral().str();
+    return success();
+  }
+
+  // Signals.
+  if (isa<llhd::SignalOp, llhd::OutputOp>(op)) {
+    if (!atModuleLevel)
+      return op->emitError("signals in processes are not supported");
+    auto nameAttr = op->getAttrOfType<StringAttr>("name");
+    bool named = nameAttr && !nameAttr.getValue().empty();
+    unsigned width = getWidth(op->getResult(0).getType());
+    unsigned signal =
+        createSignal(inst, named ? nameAttr.getValue() : "", width, named);
+    inst.refs[result] = {signal, 0, width};
+    unsigned init = operands[0];
+    actions.push_back([this, &inst, signal, init] {
+      if (initialized[signal])
+        return;
+      signals[signal].value = inst.values[init];
+      initialized[signal] = true;
+    });
+    // An output is a signal continuously driven by its initial value.
+    if (isa<llhd::OutputOp>(op)) {
+      unsigned time = operands[1];
+      actions.push_back([this, &inst, signal, width, init, time] {
+        schedule(inst.times[time],
+                 {nullptr, 0, {signal, 0, width}, inst.values[init]});
+      });
+    }
+    return success();
+  }
+
+  if (isa<llhd::PrbOp>(op)) {
+    unsigned ref = operands[0];
+    unsigned width = getWidth(op->getResult(0).getType());
+    actions.push_back([this, &inst, ref, result, width, atModuleLevel] {
+      auto signal = inst.refs[ref];
+      if (signal.signal == ~0U) {
+        inst.values[result] = APInt(width, 0);
+        return;
+      }
+      inst.values[result] =
+          signals[signal.signal].value.extractBits(signal.width,
+                                                   signal.offset);
+      if (atModuleLevel)
+        probed.push_back(signal.signal);
+    });
+    return success();
+  }
+
+  if (auto drvOp = dyn_cast<llhd::DrvOp>(op)) {
+    unsigned ref = operands[0], value = operands[1], time = operands[2];
+    unsigned enable = drvOp.getEnable() ? operands[3] : ~0U;
+    actions.push_back([this, &inst, ref, value, time, enable] {
+      if (enable != ~0U && inst.values[enable].isZero())
+        return;
+      auto signal = inst.refs[ref];
+      if (signal.signal == ~0U)
+        return;
+      schedule(inst.times[time], {nullptr, 0, signal, inst.values[value]});
+    });
+    return success();
+  }
+
+  if (isa<llhd::SigExtractOp>(op)) {
+    unsigned input = operands[0], lowBit = operands[1];
+    unsigned width = getWidth(op->getResult(0).getType());
+    actions.push_back([&inst, input, lowBit, result, width] {
+      auto base = inst.refs[input];
+      uint64_t offset = inst.values[lowBit].getLimitedValue();
+      if (base.signal == ~0U || offset + width > base.width) {
+        inst.refs[result] = {};
+        return;
+      }
+      inst.refs[result] = {base.signal, base.offset + unsigned(offset), width};
+    });
+    return success();
+  }
+
+  // Formatting and printing.
+  if (isa<circt::sim::FormatHexOp, circt::sim::FormatBinOp,
+          circt::sim::FormatDecOp>(op)) {
+    unsigned radix = isa<circt::sim::FormatHexOp>(op)   ? 16
+                     : isa<circt::sim::FormatBinOp>(op) ? 2
+                                                        : 10;
+    bool isSigned = false;
+    if (auto decOp = dyn_cast<circt::sim::FormatDecOp>(op))
+      isSigned = decOp.getIsSigned();
+    unsigned value = operands[0];
+    actions.push_back([&inst, value, result, radix, isSigned] {
+      inst.strings[result] =
+          formatInteger(inst.values[value], radix, isSigned);
+    });
+    return success();
+  }
+  if (isa<circt::sim::FormatCharOp>(op)) {
+    unsigned value = operands[0];
+    actions.push_back([&inst, value, result] {
+      inst.strings[result] =
+          std::string(1, char(inst.values[value].getLimitedValue() & 0xff));
+    });
+    return success();
+  }
+  if (isa<circt::sim::FormatStringConcatOp>(op)) {
+    actions.push_back([&inst, operands, result] {
+      std::string str;
+      for (auto slot : operands)
+        str += inst.strings[slot];
+      inst.strings[result] = std::move(str);
+    });
+    return success();
+  }
+  if (isa<circt::sim::PrintFormattedProcOp>(op)) {
+    unsigned input = operands[0];
+    actions.push_back([&inst, input] { llvm::outs() << inst.strings[input]; });
+    return success();
+  }
+
+  // Combinational logic.
+  auto action =
+      TypeSwitch<Operation *, Action>(op)
+          .Case<hw::WireOp, hw::BitcastOp, seq::ToClockOp, seq::FromClockOp>(
+              [&](auto) -> Action {
+                unsigned input = operands[0];
+                return [&inst, input, result] {
+                  inst.values[result] = inst.values[input];
+                };
+              })
+          .Case<comb::AndOp>([&](auto) {
+            return compileFold(inst, operands, result,
+                               [](APInt &acc, const APInt &x) { acc &= x; });
+          })
+          .Case<comb::OrOp>([&](auto) {
+            return compileFold(inst, operands, result,
+                               [](APInt &acc, const APInt &x) { acc |= x; });
+          })
+          .Case<comb::XorOp>([&](auto) {
+            return compileFold(inst, operands, result,
+                               [](APInt &acc, const APInt &x) { acc ^= x; });
+          })
+          .Case<comb::AddOp>([&](auto) {
+            return compileFold(inst, operands, result,
+                               [](APInt &acc, const APInt &x) { acc += x; });
+          })
+          .Case<comb::MulOp>([&](auto) {
+            return compileFold(inst, operands, result,
+                               [](APInt &acc, const APInt &x) { acc *= x; });
+          })
+          .Case<comb::SubOp>([&](auto) {
+            return compileBinary(
+                inst, operands, result,
+                [](const APInt &lhs, const APInt &rhs) { return lhs - rhs; });
+          })
+          .Case<comb::DivUOp>([&](auto) {
+            return compileDivision(
+                inst, operands, result,
+                [](const APInt &lhs, const APInt &rhs) { return lhs.udiv(rhs); });
+          })
+          .Case<comb::DivSOp>([&](auto) {
+            return compileDivision(
+                inst, operands, result,
+                [](const APInt &lhs, const APInt &rhs) { return lhs.sdiv(rhs); });
+          })
+          .Case<comb::ModUOp>([&](auto) {
+            return compileDivision(
+                inst, operands, result,
+                [](const APInt &lhs, const APInt &rhs) { return lhs.urem(rhs); });
+          })
+          .Case<comb::ModSOp>([&](auto) {
+            return compileDivision(
+                inst, operands, result,
+                [](const APInt &lhs, const APInt &rhs) { return lhs.srem(rhs); });
+          })
+          .Case<comb::ShlOp>([&](auto) {
+            return compileBinary(inst, operands, result,
+                                 [](const APInt &lhs, const APInt &rhs) {
+                                   unsigned width = lhs.getBitWidth();
+                                   return lhs.shl(rhs.getLimitedValue(width));
+                                 });
+          })
+          .Case<comb::ShrUOp>([&](auto) {
+            return compileBinary(inst, operands, result,
+                                 [](const APInt &lhs, const APInt &rhs) {
+                                   unsigned width = lhs.getBitWidth();
+                                   return lhs.lshr(rhs.getLimitedValue(width));
+                                 });
+          })
+          .Case<comb::ShrSOp>([&](auto) {
+            return compileBinary(inst, operands, result,
+                                 [](const APInt &lhs, const APInt &rhs) {
+                                   unsigned width = lhs.getBitWidth();
+                                   return lhs.ashr(rhs.getLimitedValue(width));
+                                 });
+          })
+          .Case<comb::ICmpOp>([&](auto icmpOp) {
+            auto predicate = icmpOp.getPredicate();
+            return compileBinary(inst, operands, result,
+                                 [predicate](const APInt &lhs, const APInt &rhs) {
+                                   return APInt(1, compare(predicate, lhs, rhs));
+                                 });
+          })
+          .Case<comb::MuxOp>([&](auto) -> Action {
+            unsigned cond = operands[0], trueValue = operands[1],
+                     falseValue = operands[2];
+            return [&inst, cond, trueValue, falseValue, result] {
+              inst.values[result] = inst.values[cond].isZero()
+                                        ? inst.values[falseValue]
+                                        : inst.values[trueValue];
+            };
+          })
+          .Case<comb::ConcatOp>([&](auto) -> Action {
+            // The first operand provides the most significant bits.
+            unsigned width = getWidth(op->getResult(0).getType());
+            return [&inst, operands, result, width] {
+              APInt value(width, 0);
+              unsigned offset = width;
+              for (auto slot : operands) {
+                offset -= inst.values[slot].getBitWidth();
+                value.insertBits(inst.values[slot], offset);
+              }
+              inst.values[result] = std::move(value);
+            };
+          })
+          .Case<comb::ExtractOp>([&](auto extractOp) -> Action {
+            unsigned input = operands[0], lowBit = extractOp.getLowBit();
+            unsigned width = getWidth(op->getResult(0).getType());
+            return [&inst, input, lowBit, width, result] {
+              inst.values[result] =
+                  inst.values[input].extractBits(width, lowBit);
+            };
+          })
+          .Case<comb::ReplicateOp>([&](auto) -> Action {
+            unsigned input = operands[0];
+            unsigned width = getWidth(op->getResult(0).getType());
+            return [&inst, input, width, result] {
+              const APInt &part = inst.values[input];
+              APInt value(width, 0);
+              for (unsigned offset = 0; offset < width;
+                   offset += part.getBitWidth())
+                value.insertBits(part, offset);
+              inst.values[result] = std::move(value);
+            };
+          })
+          .Case<comb::ParityOp>([&](auto) -> Action {
+            unsigned input = operands[0];
+            return [&inst, input, result] {
+              inst.values[result] = APInt(1, inst.values[input].popcount() & 1);
+            };
+          })
+          .Case<comb::TruthTableOp>([&](auto tableOp) -> Action {
+            // The first input selects the most significant bit of the table
+            // index.
+            SmallVector<bool> table;
+            for (auto entry : tableOp.getLookupTable())
+              table.push_back(cast<BoolAttr>(entry).getValue());
+            return [&inst, operands, table, result] {
+              size_t index = 0;
+              for (auto slot : operands)
+                index = index << 1 | !inst.values[slot].isZero();
+              inst.values[result] = APInt(1, table[index]);
+            };
+          })
+          .Default([](auto) { return Action(); });
+
+  if (!action)
+    return op->emitError("operation not supported by the simulator");
+  actions.push_back(std::move(action));
+  return success();
+}
+
+LogicalResult
+Engine::Impl::compileTerminator(Unit &unit, Operation *op,
+                                const DenseMap<Block *, unsigned> &blocks,
+                                CompiledBlock &compiled) {
+  Instance &inst = unit.inst;
+  if (failed(checkTypes(op)))
+    return failure();
+
+  if (isa<llhd::HaltOp>(op)) {
+    compiled.terminator = [] { return Control{Control::Halt}; };
+    return success();
+  }
+
+  if (auto brOp = dyn_cast<cf::BranchOp>(op)) {
+    auto copies = compileCopies(inst, brOp.getDestOperands(),
+                                brOp.getDest()->getArguments());
+    unsigned dest = blocks.lookup(brOp.getDest());
+    compiled.terminator = [copies, dest] {
+      if (copies)
+        copies();
+      return Control{Control::Branch, dest};
+    };
+    return success();
+  }
+
+  if (auto condBrOp = dyn_cast<cf::CondBranchOp>(op)) {
+    auto trueCopies =
+        compileCopies(inst, condBrOp.getTrueDestOperands(),
+                      condBrOp.getTrueDest()->getArguments());
+    auto falseCopies =
+        compileCopies(inst, condBrOp.getFalseDestOperands(),
+                      condBrOp.getFalseDest()->getArguments());
+    unsigned cond = getSlot(inst, condBrOp.getCondition());
+    unsigned trueDest = blocks.lookup(condBrOp.getTrueDest());
+    unsigned falseDest = blocks.lookup(condBrOp.getFalseDest());
+    compiled.terminator = [&inst, cond, trueCopies, falseCopies, trueDest,
+                           falseDest] {
+      if (!inst.values[cond].isZero()) {
+        if (trueCopies)
+          trueCopies();
+        return Control{Control::Branch, trueDest};
+      }
+      if (falseCopies)
+        falseCopies();
+      return Control{Control::Branch, falseDest};
+    };
+    return success();
+  }
+
+  if (auto waitOp = dyn_cast<llhd::WaitOp>(op)) {
+    // Find the signals the observed values are probed from. Probes yield
+    // references that are only known at runtime, while ports are backed by
+    // fixed signals.
+    SmallVector<unsigned> probedRefs, portSignals;
+    SmallVector<Value> worklist(waitOp.getObserved());
+    DenseSet<Value> seen;
+    while (!worklist.empty()) {
+      Value value = worklist.pop_back_val();
+      if (!seen.insert(value).second)
+        continue;
+      if (auto arg = dyn_cast<BlockArgument>(value)) {
+        if (arg.getOwner() == inst.module.getBodyBlock() &&
+            inst.inputSignals[arg.getArgNumber()] != ~0U)
+          portSignals.push_back(inst.inputSignals[arg.getArgNumber()]);
+        continue;
+      }
+      Operation *defOp = value.getDefiningOp();
+      if (auto prbOp = dyn_cast<llhd::PrbOp>(defOp)) {
+        probedRefs.push_back(getSlot(inst, prbOp.getSignal()));
+        continue;
+      }
+      if (auto *child = inst.children.lookup(defOp)) {
+        portSignals.push_back(
+            child->outputSignals[cast<OpResult>(value).getResultNumber()]);
+        continue;
+      }
+      for (auto operand : defOp->getOperands())
+        if (!isa<hw::InOutType>(operand.getType()))
+          worklist.push_back(operand);
+    }
+
+    auto copies = compileCopies(inst, waitOp.getDestOps(),
+                                waitOp.getDest()->getArguments());
+    unsigned time = waitOp.getTime() ? getSlot(inst, waitOp.getTime()) : ~0U;
+    unsigned dest = blocks.lookup(waitOp.getDest());
+    compiled.terminator = [this, &unit, &inst, probedRefs, portSignals, copies,
+                           time, dest] {
+      if (copies)
+        copies();
+      for (auto ref : probedRefs)
+        if (inst.refs[ref].signal != ~0U)
+          addWaiter(inst.refs[ref].signal, unit);
+      for (auto signal : portSignals)
+        addWaiter(signal, unit);
+      if (time != ~0U)
+        schedule(inst.times[time], {&unit, unit.generation, {}, {}});
+      return Control{Control::Suspend, dest};
+    };
+    return success();
+  }
+
+  return op->emitError("operation not supported by the simulator");
+}
+
+//===----------------------------------------------------------------------===//
+// Simulation
+//===----------------------------------------------------------------------===//
+
+void Engine::Impl::schedule(SimTime delay, Event event) {
+  // A drive or wait without any delay takes effect in the next delta step.
+  if (delay == SimTime())
+    delay.delta = 1;
+  queue.schedule(now + delay, std::move(event));
+}
+
+void Engine::Impl::addWaiter(unsigned signal, Unit &unit) {
+  auto &list = waiters[signal];
+  std::pair<Unit *, uint64_t> waiter = {&unit, unit.generation};
+  if (!list.empty() && list.back() == waiter)
+    return;
+  // Drop stale waiters before growing the list, such that signals that rarely
+  // change do not accumulate the wakeups of units that have long moved on.
+  if (list.size() >= 8 && list.size() == list.capacity())
+    llvm::erase_if(list, [](auto &entry) {
+      return entry.first->generation != entry.second;
+    });
+  list.push_back(waiter);
+}
+
+void Engine::Impl::wake(Unit &unit, uint64_t generation) {
+  if (unit.halted || unit.generation != generation)
+    return;
+  ++unit.generation;
+  if (!unit.queued) {
+    unit.queued = true;
+    ready.push_back(&unit);
+  }
+}
+
+void Engine::Impl::setSignal(SignalRef ref, const APInt &value) {
+  if (ref.signal == ~0U || ref.width == 0)
+    return;
+  auto &current = signals[ref.signal].value;
+  if (ref.offset == 0 && ref.width == current.getBitWidth()) {
+    if (current == value)
+      return;
+    current = value;
+  } else {
+    if (current.extractBits(ref.width, ref.offset) == value)
+      return;
+    current.insertBits(value, ref.offset);
+  }
+  if (!isChanged[ref.signal]) {
+    isChanged[ref.signal] = true;
+    changed.push_back(ref.signal);
+  }
+  auto list = std::move(waiters[ref.signal]);
+  waiters[ref.signal].clear();
+  for (auto [unit, generation] : list)
+    wake(*unit, generation);
+}
+
+void Engine::Impl::runUnit(Unit &unit) {
+  unit.queued = false;
+  if (unit.halted)
+    return;
+
+  // The module-level logic runs top to bottom and then waits for any of the
+  // signals it has read to change.
+  if (unit.kind == Unit::Kind::Module) {
+    probed.clear();
+    for (auto &action : unit.blocks[0].actions)
+      action();
+    for (auto signal : unit.staticSensitivity)
+      addWaiter(signal, unit);
+    for (auto signal : probed)
+      addWaiter(signal, unit);
+    return;
+  }
+
+  while (true) {
+    auto &block = unit.blocks[unit.block];
+    for (auto &action : block.actions)
+      action();
+    auto control = block.terminator();
+    if (control.kind == Control::Halt) {
+      unit.halted = true;
+      return;
+    }
+    unit.block = control.block;
+    if (control.kind == Control::Suspend)
+      return;
+  }
+}
+
+void Engine::Impl::runReady() {
+  // Running a unit may wake up further units in the same step.
+  for (size_t i = 0; i < ready.size(); ++i)
+    runUnit(*ready[i]);
+  ready.clear();
+}
+
+//===----------------------------------------------------------------------===//
+// Engine
+//===----------------------------------------------------------------------===//
+
+Engine::Engine(ModuleOp module, StringRef root)
+    : impl(std::make_unique<Impl>(module, root)) {}
+
+Engine::~Engine() = default;
+
+ArrayRef<Signal> Engine::getSignals() const { return impl->signals; }
+
+ArrayRef<std::string> Engine::getInstancePaths() const {
+  return impl->instancePaths;
+}
+
+LogicalResult Engine::elaborate() {
+  auto rootModule =
+      dyn_cast_or_null<hw::HWModuleOp>(impl->symbolTable.lookup(impl->root));
+  if (!rootModule)
+    return impl->module.emitError("root module '")
+           << impl->root << "' not found";
+  if (failed(impl->instantiate(rootModule, impl->root, nullptr)))
+    return failure();
+  impl->isChanged.assign(impl->signals.size(), false);
+  return success();
+}
+
+LogicalResult Engine::run(const EngineOptions &options,
+                          llvm::raw_ostream &traceOS,
+                          llvm::raw_ostream *vcdOS) {
+  auto &state = *impl;
+  // Size the slots of the timing wheel such that the constant delays of the
+  // design advance the wheel by whole slots.
+  state.queue = TimingWheel<Event>(state.resolution ? state.resolution : 1000);
+  state.now = {};
+
+  TraceWriter trace(traceOS, options.traceFormat, state.signals);
+  std::optional<VCDWriter> vcd;
+  if (vcdOS) {
+    vcd.emplace(*vcdOS, state.signals, state.instancePaths);
+    vcd->writeHeader();
+  }
+
+  // The initial step runs the logic of all instances, parents before their
+  // children, and then every process up to its first wait.
+  SmallVector<Unit *> finals;
+  for (auto &unit : state.units) {
+    if (unit->kind == Unit::Kind::Final) {
+      finals.push_back(unit.get());
+      continue;
+    }
+    unit->queued = true;
+    state.ready.push_back(unit.get());
+  }
+  state.runReady();
+  SmallVector<unsigned> all(llvm::seq<unsigned>(0, state.signals.size()));
+  trace.step(state.now, all);
+  if (vcd)
+    vcd->step(state.now, all);
+  for (auto signal : state.changed)
+    state.isChanged[signal] = false;
+  state.changed.clear();
+
+  uint64_t steps = 1;
+  uint64_t deltas = 0;
+  std::vector<Event> events;
+  while (!state.queue.empty()) {
+    if (options.maxSteps && steps >= options.maxSteps)
+      break;
+    SimTime next = state.queue.peekTime();
+    if (options.maxTime && next.time > options.maxTime)
+      break;
+    if (next.time == state.now.time) {
+      if (++deltas > options.maxDeltas)
+        return state.module.emitError("simulation exceeded ")
+               << options.maxDeltas << " delta steps at " << next.time
+               << "fs; the design may contain a combinational loop";
+    } else {
+      deltas = 0;
+    }
+
+    events.clear();
+    state.now = state.queue.popNext(events);
+    for (auto &event : events) {
+      if (event.unit)
+        state.wake(*event.unit, event.generation);
+      else
+        state.setSignal(event.ref, event.value);
+    }
+    state.runReady();
+
+    trace.step(state.now, state.changed);
+    if (vcd)
+      vcd->step(state.now, state.changed);
+    for (auto signal : state.changed)
+      state.isChanged[signal] = false;
+    state.changed.clear();
+    ++steps;
+  }
+
+  for (auto *unit : finals)
+    state.runUnit(*unit);
+
+  trace.finish();
+  if (vcd)
+    vcd->finish();
+  return success();
+}
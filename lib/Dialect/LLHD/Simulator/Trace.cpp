@@ -0,0 +1,210 @@
+//===- Trace.cpp - Signal traces of the LLHD simulator --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Dialect/LLHD/Simulator/Trace.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace circt;
+using namespace llhd::sim;
+using llvm::APInt;
+
+/// Print a value as a hexadecimal literal with two digits per started byte.
+static void printHex(llvm::raw_ostream &os, const APInt &value) {
+  SmallString<32> digits;
+  value.toString(digits, 16, /*Signed=*/false, /*formatAsCLiteral=*/false,
+                 /*UpperCase=*/false);
+  unsigned numDigits = 2 * ((value.getBitWidth() + 7) / 8);
+  os << "0x";
+  for (unsigned i = digits.size(); i < numDigits; ++i)
+    os << '0';
+  os << digits;
+}
+
+//===----------------------------------------------------------------------===//
+// TraceWriter
+//===----------------------------------------------------------------------===//
+
+TraceWriter::TraceWriter(llvm::raw_ostream &os, TraceFormat format,
+                         ArrayRef<Signal> signals)
+    : os(os), format(format), signals(signals), rank(signals.size()) {
+  SmallVector<unsigned> order(llvm::seq<unsigned>(0, signals.size()));
+  llvm::stable_sort(order, [&](unsigned a, unsigned b) {
+    return signals[a].path < signals[b].path;
+  });
+  for (auto [position, signal] : llvm::enumerate(order))
+    rank[signal] = position;
+}
+
+bool TraceWriter::isTraced(unsigned signal) const {
+  switch (format) {
+  case TraceFormat::Reduced:
+  case TraceFormat::MergedReduce:
+    return signals[signal].instance == 0;
+  case TraceFormat::NamedOnly:
+    return signals[signal].named;
+  case TraceFormat::None:
+    return false;
+  default:
+    return true;
+  }
+}
+
+void TraceWriter::sortByPath(SmallVectorImpl<unsigned> &indices) const {
+  llvm::sort(indices, [&](unsigned a, unsigned b) { return rank[a] < rank[b]; });
+}
+
+void TraceWriter::step(SimTime time, ArrayRef<unsigned> changed) {
+  if (format == TraceFormat::None)
+    return;
+
+  if (format == TraceFormat::Merged || format == TraceFormat::MergedReduce) {
+    if (mergedTime && *mergedTime != time.time)
+      flushMerged();
+    mergedTime = time.time;
+    for (auto signal : changed)
+      if (isTraced(signal))
+        mergedValues[signal] = signals[signal].value;
+    return;
+  }
+
+  SmallVector<unsigned> traced;
+  for (auto signal : changed)
+    if (isTraced(signal))
+      traced.push_back(signal);
+  sortByPath(traced);
+  for (auto signal : traced) {
+    os << time.time / 1000 << "ps " << time.delta << "d " << time.epsilon
+       << "e  " << signals[signal].path << "  ";
+    printHex(os, signals[signal].value);
+    os << "\n";
+  }
+}
+
+void TraceWriter::flushMerged() {
+  if (!mergedTime)
+    return;
+  SmallVector<unsigned> traced;
+  for (auto &[signal, value] : mergedValues)
+    traced.push_back(signal);
+  sortByPath(traced);
+  os << *mergedTime / 1000 << "ps\n";
+  for (auto signal : traced) {
+    os << "  " << signals[signal].path << "  ";
+    printHex(os, mergedValues[signal]);
+    os << "\n";
+  }
+  mergedValues.clear();
+  mergedTime.reset();
+}
+
+void TraceWriter::finish() { flushMerged(); }
+
+//===----------------------------------------------------------------------===//
+// VCDWriter
+//===----------------------------------------------------------------------===//
+
+VCDWriter::VCDWriter(llvm::raw_ostream &os, ArrayRef<Signal> signals,
+                     ArrayRef<std::string> instancePaths)
+    : os(os), signals(signals), instancePaths(instancePaths),
+      dumped(signals.size()) {
+  // Identifier codes are numbers in base 94, using the printable ASCII
+  // characters from `!` to `~`.
+  for (unsigned i = 0, e = signals.size(); i < e; ++i) {
+    std::string code;
+    unsigned n = i;
+    do {
+      code.push_back('!' + n % 94);
+      n /= 94;
+    } while (n);
+    codes.push_back(std::move(code));
+  }
+}
+
+/// Return the last component of a hierarchical name.
+static StringRef getLeafName(StringRef path) {
+  return path.substr(path.rfind('/') + 1);
+}
+
+/// Return the hierarchical name of the parent of an instance.
+static StringRef getParentPath(StringRef path) {
+  size_t pos = path.rfind('/');
+  return pos == StringRef::npos ? StringRef() : path.take_front(pos);
+}
+
+/// Replace the characters VCD does not allow in identifiers.
+static std::string sanitize(StringRef name) {
+  std::string result = name.str();
+  for (auto &c : result)
+    if (c == ' ' || c == '\t' || c == '\n')
+      c = '_';
+  return result;
+}
+
+void VCDWriter::writeScope(unsigned instance) {
+  StringRef path = instancePaths[instance];
+  os << "$scope module " << sanitize(getLeafName(path)) << " $end\n";
+  for (auto [index, signal] : llvm::enumerate(signals))
+    if (signal.instance == instance)
+      os << "$var wire " << signal.value.getBitWidth() << " " << codes[index]
+         << " " << sanitize(signal.name) << " $end\n";
+  for (unsigned child = 0, e = instancePaths.size(); child < e; ++child)
+    if (child != instance && getParentPath(instancePaths[child]) == path)
+      writeScope(child);
+  os << "$upscope $end\n";
+}
+
+void VCDWriter::writeHeader() {
+  os << "$version\n  llhd-sim\n$end\n";
+  os << "$timescale 1fs $end\n";
+  if (!instancePaths.empty())
+    writeScope(0);
+  os << "$enddefinitions $end\n";
+}
+
+void VCDWriter::step(SimTime time, ArrayRef<unsigned> changed) {
+  if (pendingTime && *pendingTime != time.time)
+    flush();
+  pendingTime = time.time;
+  for (auto signal : changed)
+    pendingValues[signal] = signals[signal].value;
+}
+
+void VCDWriter::flush() {
+  if (!pendingTime)
+    return;
+  bool first = !dumpedVars;
+  bool timeWritten = false;
+  for (auto &[signal, value] : pendingValues) {
+    if (dumped[signal] && *dumped[signal] == value)
+      continue;
+    if (!timeWritten) {
+      os << "#" << *pendingTime << "\n";
+      if (first)
+        os << "$dumpvars\n";
+      timeWritten = true;
+    }
+    if (value.getBitWidth() == 1) {
+      os << (value.isZero() ? '0' : '1') << codes[signal] << "\n";
+    } else {
+      SmallString<64> bits;
+      value.toString(bits, 2, /*Signed=*/false);
+      os << "b" << bits << " " << codes[signal] << "\n";
+    }
+    dumped[signal] = value;
+  }
+  if (first && timeWritten) {
+    os << "$end\n";
+    dumpedVars = true;
+  }
+  pendingValues.clear();
+  pendingTime.reset();
+}
+
+void VCDWriter::finish() { flush(); }
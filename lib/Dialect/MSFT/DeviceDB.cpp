@@ -42,8 +42,16 @@ LogicalResult PrimitiveDB::addPrimitive(PhysLocationAttr loc) {
 /// already placed at that location.
 /// Check to see if a primitive exists.
 bool PrimitiveDB::isValidLocation(PhysLocationAttr loc) {
-  DenseSet<PrimitiveType> primsAtLoc = getLeaf(loc);
-  return primsAtLoc.contains(loc.getPrimitiveType().getValue());
+  auto x = placements.find(loc.getX());
+  if (x == placements.end())
+    return false;
+  auto y = x->second.find(loc.getY());
+  if (y == x->second.end())
+    return false;
+  auto num = y->second.find(loc.getNum());
+  if (num == y->second.end())
+    return false;
+  return num->second.contains(loc.getPrimitiveType().getValue());
 }
 
 PrimitiveDB::DimPrimitiveType &PrimitiveDB::getLeaf(PhysLocationAttr loc) {
@@ -60,13 +68,22 @@ void PrimitiveDB::foreach (
                                          x.first, y.first, n.first));
 }
 
+void PrimitiveDB::foreachLocation(
+    function_ref<void(PrimitiveType, size_t, size_t, size_t)> callback) const {
+  for (const auto &x : placements)
+    for (const auto &y : x.second)
+      for (const auto &n : y.second)
+        for (auto p : n.second)
+          callback(p, x.first, y.first, n.first);
+}
+
 //===----------------------------------------------------------------------===//
 // PlacementDB.
 //===----------------------------------------------------------------------===//
-// NOTE: Nothing in this implementation is in any way the most optimal
-// implementation. We put off deciding what the correct data structure is until
-// we have a better handle of the operations it must accelerate. Performance is
-// not an immediate goal.
+// Placements are kept in ordered maps so that bounded and ordered walks only
+// touch the requested rectangle. A per-column index of the rows with free
+// cells of each primitive type answers nearest-free queries in logarithmic
+// time.
 //===----------------------------------------------------------------------===//
 
 PlacementDB::PlacementDB(mlir::ModuleOp topMod)
@@ -76,7 +93,8 @@ PlacementDB::PlacementDB(mlir::ModuleOp topMod)
 PlacementDB::PlacementDB(mlir::ModuleOp topMod, const PrimitiveDB &seed)
     : ctxt(topMod->getContext()), topMod(topMod), seeded(false) {
 
-  seed.foreach ([this](PhysLocationAttr loc) { (void)getLeaf(loc); });
+  seed.foreachLocation([this](PrimitiveType prim, size_t x, size_t y,
+                              size_t num) { (void)addLeaf(prim, x, y, num); });
   seeded = true;
   addDesignPlacements();
 }
@@ -125,7 +143,7 @@ LogicalResult PlacementDB::insertPlacement(DynInstDataOpInterface op,
            << loc << ". Position already occupied by "
            << cast<DynamicInstanceOp>(leaf->locOp->getParentOp()).getPath();
 
-  leaf->locOp = op;
+  setLeafOp(*leaf, loc, op);
   return success();
 }
 
@@ -250,10 +268,10 @@ LogicalResult PlacementDB::movePlacement(PDRegPhysLocationOp locOp,
 
 void PlacementDB::removePlacement(DynInstDataOpInterface op,
                                   PhysLocationAttr loc) {
-  PlacementCell *leaf = getLeaf(loc);
+  PlacementCell *leaf = findLeaf(loc);
   assert(leaf && "Could not find op at location specified by op");
   assert(leaf->locOp == op);
-  leaf->locOp = {};
+  setLeafOp(*leaf, loc, {});
 }
 
 LogicalResult PlacementDB::movePlacementCheck(DynInstDataOpInterface op,
@@ -262,8 +280,9 @@ LogicalResult PlacementDB::movePlacementCheck(DynInstDataOpInterface op,
   if (from == to)
     return success();
 
-  PlacementCell *oldLeaf = getLeaf(from);
+  // Look up the new leaf first, since creating it may move the old one.
   PlacementCell *newLeaf = getLeaf(to);
+  PlacementCell *oldLeaf = findLeaf(from);
 
   if (!oldLeaf || !newLeaf)
     return failure();
@@ -288,59 +307,102 @@ void PlacementDB::movePlacement(DynInstDataOpInterface op,
          "Call `movePlacementCheck` first to ensure that move is legal.");
   if (from == to)
     return;
-  PlacementCell *oldLeaf = getLeaf(from);
   PlacementCell *newLeaf = getLeaf(to);
-  newLeaf->locOp = op;
-  oldLeaf->locOp = {};
+  PlacementCell *oldLeaf = findLeaf(from);
+  setLeafOp(*newLeaf, to, op);
+  setLeafOp(*oldLeaf, from, {});
 }
 
 /// Lookup the instance at a particular location.
 DynInstDataOpInterface PlacementDB::getInstanceAt(PhysLocationAttr loc) {
-  auto innerMap = placements[loc.getX()][loc.getY()][loc.getNum()];
-  auto instF = innerMap.find(loc.getPrimitiveType().getValue());
-  if (instF == innerMap.end())
-    return {};
-  if (!instF->getSecond().locOp)
+  PlacementCell *leaf = findLeaf(loc);
+  if (!leaf)
     return {};
-  return instF->getSecond().locOp;
+  return leaf->locOp;
 }
 
 PhysLocationAttr PlacementDB::getNearestFreeInColumn(PrimitiveType prim,
                                                      uint64_t columnNum,
                                                      uint64_t nearestToY) {
-  // Simplest possible algorithm.
-  PhysLocationAttr nearest = {};
-  walkPlacements(
-      [&nearest, nearestToY](PhysLocationAttr loc, Operation *locOp) {
-        if (locOp)
-          return;
-        if (!nearest) {
-          nearest = loc;
-          return;
-        }
-        int64_t curDist =
-            std::abs((int64_t)nearestToY - (int64_t)nearest.getY());
-        int64_t replDist = std::abs((int64_t)nearestToY - (int64_t)loc.getY());
-        if (replDist < curDist)
-          nearest = loc;
-      },
-      std::make_tuple(columnNum, columnNum, -1, -1), prim);
-  return nearest;
+  auto rowsIt = freeRows.find({columnNum, prim});
+  if (rowsIt == freeRows.end() || rowsIt->second.empty())
+    return {};
+
+  // The nearest free row is either the first one at or after 'nearestToY' or
+  // the last one before it.
+  const FreeRows &rows = rowsIt->second;
+  auto after = rows.lower_bound(nearestToY);
+  size_t y;
+  if (after == rows.end())
+    y = std::prev(after)->first;
+  else if (after == rows.begin())
+    y = after->first;
+  else
+    y = after->first - nearestToY < nearestToY - std::prev(after)->first
+            ? after->first
+            : std::prev(after)->first;
+
+  // Pick the lowest free number in that row.
+  for (auto &[num, primitives] : placements[columnNum][y]) {
+    auto cell = primitives.find(prim);
+    if (cell != primitives.end() && !cell->second.locOp)
+      return PhysLocationAttr::get(ctxt, PrimitiveTypeAttr::get(ctxt, prim),
+                                   columnNum, y, num);
+  }
+  llvm_unreachable("free row index out of sync with the placements");
 }
 
 PlacementDB::PlacementCell *PlacementDB::getLeaf(PhysLocationAttr loc) {
-  PrimitiveType primType = loc.getPrimitiveType().getValue();
-
-  DimNumMap &nums = placements[loc.getX()][loc.getY()];
   if (!seeded)
-    return &nums[loc.getNum()][primType];
-  if (!nums.count(loc.getNum()))
-    return {};
+    return &addLeaf(loc.getPrimitiveType().getValue(), loc.getX(), loc.getY(),
+                    loc.getNum());
+  return findLeaf(loc);
+}
 
-  DimDevType &primitives = nums[loc.getNum()];
-  if (primitives.count(primType) == 0)
+PlacementDB::PlacementCell *PlacementDB::findLeaf(PhysLocationAttr loc) {
+  auto x = placements.find(loc.getX());
+  if (x == placements.end())
+    return {};
+  auto y = x->second.find(loc.getY());
+  if (y == x->second.end())
+    return {};
+  auto num = y->second.find(loc.getNum());
+  if (num == y->second.end())
     return {};
-  return &primitives[primType];
+  auto prim = num->second.find(loc.getPrimitiveType().getValue());
+  if (prim == num->second.end())
+    return {};
+  return &prim->second;
+}
+
+PlacementDB::PlacementCell &PlacementDB::addLeaf(PrimitiveType prim, size_t x,
+                                                 size_t y, size_t num) {
+  auto [cell, inserted] = placements[x][y][num].try_emplace(prim);
+  if (inserted)
+    updateFreeRows(prim, x, y, /*nowFree=*/true);
+  return cell->second;
+}
+
+void PlacementDB::setLeafOp(PlacementCell &leaf, PhysLocationAttr loc,
+                            DynInstDataOpInterface op) {
+  bool wasFree = !leaf.locOp;
+  leaf.locOp = op;
+  if (wasFree != !op)
+    updateFreeRows(loc.getPrimitiveType().getValue(), loc.getX(), loc.getY(),
+                   /*nowFree=*/!op);
+}
+
+void PlacementDB::updateFreeRows(PrimitiveType prim, size_t x, size_t y,
+                                 bool nowFree) {
+  FreeRows &rows = freeRows[{x, prim}];
+  if (nowFree) {
+    ++rows[y];
+    return;
+  }
+  auto row = rows.find(y);
+  assert(row != rows.end() && row->second > 0 && "row has no free cells");
+  if (--row->second == 0)
+    rows.erase(row);
 }
 
 /// Walker for placements.
@@ -355,57 +417,44 @@ void PlacementDB::walkPlacements(
   uint64_t ymax = std::get<3>(bounds) < 0 ? std::numeric_limits<uint64_t>::max()
                                           : (uint64_t)std::get<3>(bounds);
 
-  // TODO: Since the data structures we're using aren't sorted, the best we can
-  // do is iterate and filter. If a specific order is requested, we sort the
-  // keys by that as we go. Once we get to performance, we'll figure out the
-  // right data structure.
-
-  auto maybeSort = [](auto &container, auto direction) {
-    if (!direction.has_value())
+  // Visit the entries of an ordered map with keys in [min, max], in descending
+  // key order if requested and ascending order otherwise.
+  auto walkRange = [](auto &map, uint64_t min, uint64_t max,
+                      std::optional<Direction> direction, auto visit) {
+    if (min > max)
       return;
-    if (*direction == Direction::NONE)
+    auto begin = map.lower_bound(min);
+    auto end = map.upper_bound(max);
+    if (direction == Direction::DESC) {
+      for (auto it = end; it != begin;) {
+        --it;
+        visit(it->first, it->second);
+      }
       return;
-
-    llvm::sort(container, [direction](auto colA, auto colB) {
-      if (*direction == Direction::ASC)
-        return colA.first < colB.first;
-
-      return colA.first > colB.first;
-    });
+    }
+    for (auto it = begin; it != end; ++it)
+      visit(it->first, it->second);
   };
 
-  // X loop.
-  SmallVector<std::pair<size_t, DimYMap>> cols(placements.begin(),
-                                               placements.end());
-  maybeSort(cols, llvm::transformOptional(walkOrder,
-                                          [](auto wo) { return wo.columns; }));
-  for (const auto &colF : cols) {
-    size_t x = colF.first;
-    if (x < xmin || x > xmax)
-      continue;
-    DimYMap yMap = colF.second;
+  auto columnOrder =
+      llvm::transformOptional(walkOrder, [](auto wo) { return wo.columns; });
+  auto rowOrder =
+      llvm::transformOptional(walkOrder, [](auto wo) { return wo.rows; });
 
+  // X loop.
+  walkRange(placements, xmin, xmax, columnOrder, [&](size_t x, DimYMap &yMap) {
     // Y loop.
-    SmallVector<std::pair<size_t, DimNumMap>> rows(yMap.begin(), yMap.end());
-    maybeSort(rows, llvm::transformOptional(walkOrder,
-                                            [](auto wo) { return wo.rows; }));
-    for (const auto &rowF : rows) {
-      size_t y = rowF.first;
-      if (y < ymin || y > ymax)
-        continue;
-      DimNumMap numMap = rowF.second;
-
+    walkRange(yMap, ymin, ymax, rowOrder, [&](size_t y, DimNumMap &numMap) {
       // Num loop.
-      for (auto &numF : numMap) {
-        size_t num = numF.getFirst();
-        DimDevType devMap = numF.getSecond();
+      for (auto &[num, devMap] : numMap) {
+        // Copy the cells, since the callback may add placements to this map.
+        SmallVector<std::pair<PrimitiveType, PlacementCell>, 4> cells(
+            devMap.begin(), devMap.end());
 
         // DevType loop.
-        for (auto &devF : devMap) {
-          PrimitiveType devtype = devF.getFirst();
+        for (auto [devtype, inst] : cells) {
           if (primType && devtype != *primType)
             continue;
-          PlacementCell &inst = devF.getSecond();
 
           // Marshall and run the callback.
           PhysLocationAttr loc = PhysLocationAttr::get(
@@ -413,8 +462,8 @@ void PlacementDB::walkPlacements(
           callback(loc, inst.locOp);
         }
       }
-    }
-  }
+    });
+  });
 }
 
 /// Walk the region placement information.
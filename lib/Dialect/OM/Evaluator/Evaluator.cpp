@@ -23,7 +23,23 @@ using namespace mlir;
 using namespace circt::om;
 
 /// Construct an Evaluator with an IR module.
-circt::om::Evaluator::Evaluator(ModuleOp mod) : symbolTable(mod) {}
+circt::om::Evaluator::Evaluator(ModuleOp mod, EvaluatorOptions options)
+    : symbolTable(mod), options(options),
+      arena(std::make_shared<evaluator::ValueArena>()) {}
+
+/// Detach the lazily evaluated Objects that outlive the Evaluator. Reading an
+/// unevaluated field of one of them fails.
+circt::om::Evaluator::~Evaluator() {
+  auto detach = [](evaluator::EvaluatorValue *value) {
+    if (auto *object = dyn_cast_or_null<evaluator::ObjectValue>(value))
+      object->detachLazyEvaluator();
+  };
+  for (auto &[key, value] : objects)
+    detach(value.get());
+  for (auto &instance : lazyInstances)
+    if (auto value = instance.lock())
+      detach(value.get());
+}
 
 /// Get the Module this Evaluator is built from.
 ModuleOp circt::om::Evaluator::getModule() {
@@ -75,17 +91,17 @@ circt::om::Evaluator::getPartiallyEvaluatedValue(Type type, Location loc) {
   return TypeSwitch<mlir::Type, FailureOr<evaluator::EvaluatorValuePtr>>(type)
       .Case([&](circt::om::MapType type) {
         evaluator::EvaluatorValuePtr result =
-            std::make_shared<evaluator::MapValue>(type, loc);
+            allocate<evaluator::MapValue>(type, loc);
         return success(result);
       })
       .Case([&](circt::om::ListType type) {
         evaluator::EvaluatorValuePtr result =
-            std::make_shared<evaluator::ListValue>(type, loc);
+            allocate<evaluator::ListValue>(type, loc);
         return success(result);
       })
       .Case([&](mlir::TupleType type) {
         evaluator::EvaluatorValuePtr result =
-            std::make_shared<evaluator::TupleValue>(type, loc);
+            allocate<evaluator::TupleValue>(type, loc);
         return success(result);
       })
 
@@ -98,7 +114,7 @@ circt::om::Evaluator::getPartiallyEvaluatedValue(Type type, Location loc) {
                  << type.getClassName();
 
         evaluator::EvaluatorValuePtr result =
-            std::make_shared<evaluator::ObjectValue>(cls, loc);
+            allocate<evaluator::ObjectValue>(getObjectLayout(cls), loc);
 
         return success(result);
       })
@@ -132,7 +148,7 @@ FailureOr<evaluator::EvaluatorValuePtr> circt::om::Evaluator::getOrCreateValue(
                   // Create a partially evaluated AttributeValue of
                   // om::IntegerType in case we need to delay evaluation.
                   evaluator::EvaluatorValuePtr result =
-                      std::make_shared<evaluator::AttributeValue>(
+                      allocate<evaluator::AttributeValue>(
                           op.getResult().getType(), loc);
                   return success(result);
                 })
@@ -140,8 +156,7 @@ FailureOr<evaluator::EvaluatorValuePtr> circt::om::Evaluator::getOrCreateValue(
                   // Create a reference value since the value pointed by object
                   // field op is not created yet.
                   evaluator::EvaluatorValuePtr result =
-                      std::make_shared<evaluator::ReferenceValue>(
-                          value.getType(), loc);
+                      allocate<evaluator::ReferenceValue>(value.getType(), loc);
                   return success(result);
                 })
                 .Case<AnyCastOp>([&](AnyCastOp op) {
@@ -149,13 +164,12 @@ FailureOr<evaluator::EvaluatorValuePtr> circt::om::Evaluator::getOrCreateValue(
                 })
                 .Case<FrozenBasePathCreateOp>([&](FrozenBasePathCreateOp op) {
                   evaluator::EvaluatorValuePtr result =
-                      std::make_shared<evaluator::BasePathValue>(
-                          op.getPathAttr(), loc);
+                      allocate<evaluator::BasePathValue>(op.getPathAttr(), loc);
                   return success(result);
                 })
                 .Case<FrozenPathCreateOp>([&](FrozenPathCreateOp op) {
                   evaluator::EvaluatorValuePtr result =
-                      std::make_shared<evaluator::PathValue>(
+                      allocate<evaluator::PathValue>(
                           op.getTargetKindAttr(), op.getPathAttr(),
                           op.getModuleAttr(), op.getRefAttr(),
                           op.getFieldAttr(), loc);
@@ -163,7 +177,7 @@ FailureOr<evaluator::EvaluatorValuePtr> circt::om::Evaluator::getOrCreateValue(
                 })
                 .Case<FrozenEmptyPathOp>([&](FrozenEmptyPathOp op) {
                   evaluator::EvaluatorValuePtr result =
-                      std::make_shared<evaluator::PathValue>(
+                      allocate<evaluator::PathValue>(
                           evaluator::PathValue::getEmptyPath(loc));
                   return success(result);
                 })
@@ -187,6 +201,71 @@ FailureOr<evaluator::EvaluatorValuePtr> circt::om::Evaluator::getOrCreateValue(
   return result;
 }
 
+std::shared_ptr<const evaluator::ObjectLayout>
+circt::om::Evaluator::getObjectLayout(ClassOp cls) {
+  auto &layout = layouts[cls];
+  if (!layout)
+    layout = allocate<evaluator::ObjectLayout>(cls);
+  return layout;
+}
+
+/// Append the tokens identifying an actual parameter to an instance key.
+/// Attributes, lists, and tuples are compared by value, all other values by
+/// identity. Fails if the value is not evaluated far enough to be compared.
+static LogicalResult appendInstanceKey(evaluator::EvaluatorValue *value,
+                                       SmallVectorImpl<const void *> &key) {
+  using namespace evaluator;
+  llvm::SmallPtrSet<ReferenceValue *, 4> visited;
+  while (auto *ref = dyn_cast_or_null<ReferenceValue>(value)) {
+    if (!ref->isFullyEvaluated() || !visited.insert(ref).second)
+      return failure();
+    value = ref->getValue().get();
+  }
+  if (!value)
+    return failure();
+
+  if (auto *attr = dyn_cast<AttributeValue>(value)) {
+    if (!attr->isFullyEvaluated())
+      return failure();
+    key.push_back(attr->getAttr().getAsOpaquePointer());
+    return success();
+  }
+
+  // The type of a list is followed by its length, the type of a tuple implies
+  // its length.
+  ArrayRef<EvaluatorValuePtr> elements;
+  if (auto *list = dyn_cast<ListValue>(value)) {
+    if (!list->isFullyEvaluated())
+      return failure();
+    key.push_back(list->getListType().getAsOpaquePointer());
+    key.push_back(reinterpret_cast<const void *>(list->getElements().size()));
+    elements = list->getElements();
+  } else if (auto *tuple = dyn_cast<TupleValue>(value)) {
+    if (!tuple->isFullyEvaluated())
+      return failure();
+    key.push_back(tuple->getTupleType().getAsOpaquePointer());
+    elements = tuple->getElements();
+  } else {
+    key.push_back(value);
+    return success();
+  }
+
+  for (auto &element : elements)
+    if (failed(appendInstanceKey(element.get(), key)))
+      return failure();
+  return success();
+}
+
+LogicalResult
+circt::om::Evaluator::getInstanceKey(ClassOp cls, ActualParameters actualParams,
+                                     SmallVectorImpl<const void *> &key) {
+  key.push_back(cls.getOperation());
+  for (auto &param : *actualParams)
+    if (failed(appendInstanceKey(param.get(), key)))
+      return failure();
+  return success();
+}
+
 FailureOr<evaluator::EvaluatorValuePtr>
 circt::om::Evaluator::evaluateObjectInstance(StringAttr className,
                                              ActualParameters actualParams,
@@ -242,45 +321,174 @@ circt::om::Evaluator::evaluateObjectInstance(StringAttr className,
     }
   }
 
-  // Instantiate the fields.
-  evaluator::ObjectFields fields;
+  // Look for an earlier instantiation with the same parameters, if instances
+  // are memoized.
+  SmallVector<const void *> memoKey;
+  bool memoize = options.memoizeInstances &&
+                 succeeded(getInstanceKey(cls, actualParams, memoKey));
+  evaluator::EvaluatorValuePtr memoized;
+  if (memoize)
+    memoized = memoizedInstances.lookup(memoKey);
+
+  evaluator::EvaluatorValuePtr result;
+  if (options.lazy) {
+    // Defer the evaluation of the class body until one of the fields is read.
+    // An identical earlier instantiation lends its actual parameters, such
+    // that both Objects share the values of the class body.
+    if (memoized) {
+      ++numMemoizedInstances;
+      actualParams = llvm::cast<evaluator::ObjectValue>(memoized.get())
+                         ->getLazyParameters();
+    }
+    if (instanceKey.first) {
+      result =
+          getOrCreateValue(instanceKey.first, instanceKey.second, loc).value();
+    } else {
+      result = allocate<evaluator::ObjectValue>(getObjectLayout(cls), loc);
+      lazyInstances.push_back(result);
+    }
+    llvm::cast<evaluator::ObjectValue>(result.get())
+        ->setLazy(this, actualParams);
+  } else {
+    // Instantiate the fields.
+    evaluator::ObjectFields fields;
+
+    if (memoized) {
+      // Share the values of the earlier instantiation, which is either
+      // already evaluated or has its remaining values on the worklist.
+      ++numMemoizedInstances;
+      auto memoizedFields =
+          llvm::cast<evaluator::ObjectValue>(memoized.get())->getFields();
+      fields.assign(memoizedFields.begin(), memoizedFields.end());
+    } else {
+      auto *context = cls.getContext();
+      for (auto &op : cls.getOps())
+        for (auto result : op.getResults()) {
+          // Allocate the value, with unknown loc. It will be later set when
+          // evaluating the fields.
+          if (failed(getOrCreateValue(result, actualParams,
+                                      UnknownLoc::get(context))))
+            return failure();
+          // Add to the worklist.
+          worklist.push({result, actualParams});
+        }
+
+      // The fields are stored in the order of the field layout.
+      for (auto field : cls.getOps<ClassFieldOp>()) {
+        Value value = field.getValue();
+        FailureOr<evaluator::EvaluatorValuePtr> result =
+            evaluateValue(value, actualParams, field.getLoc());
+        if (failed(result))
+          return result;
+
+        fields.push_back(result.value());
+      }
+    }
+
+    if (instanceKey.first) {
+      // If the there is an instance, we must update the object value.
+      result =
+          getOrCreateValue(instanceKey.first, instanceKey.second, loc).value();
+      auto *object = llvm::cast<evaluator::ObjectValue>(result.get());
+      object->setFields(std::move(fields));
+    } else {
+      // If it's external call, just allocate new ObjectValue.
+      result = allocate<evaluator::ObjectValue>(getObjectLayout(cls),
+                                                std::move(fields), loc);
+    }
+  }
+
+  if (memoize && !memoized)
+    memoizedInstances.insert(
+        {ArrayRef<const void *>(memoKey).copy(instanceKeyAllocator), result});
+  return result;
+}
+
+LogicalResult
+circt::om::Evaluator::expandObject(evaluator::ObjectValue &object) {
+  if (object.isExpanded())
+    return success();
 
+  auto cls = object.getClassOp();
+  auto *actualParams = object.getLazyParameters();
+  if (failedParameters.contains(actualParams)) {
+    object.markLazyFailed();
+    return cls.emitError("cannot evaluate the fields of an instance of ")
+           << cls.getSymNameAttr() << ", its evaluation failed before";
+  }
+
+  expandedObjects.push_back(&object);
   auto *context = cls.getContext();
   for (auto &op : cls.getOps())
     for (auto result : op.getResults()) {
-      // Allocate the value, with unknown loc. It will be later set when
-      // evaluating the fields.
       if (failed(
               getOrCreateValue(result, actualParams, UnknownLoc::get(context))))
         return failure();
-      // Add to the worklist.
       worklist.push({result, actualParams});
     }
 
+  // The fields refer to the values of the class body, which the worklist
+  // evaluates later.
+  evaluator::ObjectFields fields;
   for (auto field : cls.getOps<ClassFieldOp>()) {
-    StringAttr name = field.getNameAttr();
-    Value value = field.getValue();
-    FailureOr<evaluator::EvaluatorValuePtr> result =
-        evaluateValue(value, actualParams, field.getLoc());
+    auto result =
+        getOrCreateValue(field.getValue(), actualParams, field.getLoc());
     if (failed(result))
-      return result;
-
-    fields[name] = result.value();
+      return failure();
+    fields.push_back(result.value());
   }
+  object.expand(std::move(fields));
+  return success();
+}
 
-  // If the there is an instance, we must update the object value.
-  if (instanceKey.first) {
-    auto result =
-        getOrCreateValue(instanceKey.first, instanceKey.second, loc).value();
-    auto *object = llvm::cast<evaluator::ObjectValue>(result.get());
-    object->setFields(std::move(fields));
-    return result;
+LogicalResult circt::om::Evaluator::evaluateWorklist(Location loc) {
+  while (!worklist.empty()) {
+    auto [value, args] = worklist.front();
+    worklist.pop();
+
+    auto result = evaluateValue(value, args, loc);
+
+    if (failed(result)) {
+      worklist = {};
+      memoizedInstances.clear();
+      return failure();
+    }
+
+    // It's possible that the value is not fully evaluated.
+    if (!result.value()->isFullyEvaluated())
+      worklist.push({value, args});
   }
+  return success();
+}
 
-  // If it's external call, just allocate new ObjectValue.
-  evaluator::EvaluatorValuePtr result =
-      std::make_shared<evaluator::ObjectValue>(cls, fields, loc);
-  return result;
+LogicalResult
+circt::om::Evaluator::forceObject(evaluator::ObjectValue &object) {
+  assert(object.getLazyEvaluator() == this && "object of another evaluator");
+  expandedObjects.clear();
+  if (failed(expandObject(object)) ||
+      failed(evaluateWorklist(object.getLoc()))) {
+    // Every Object expanded by this force may refer to values that will never
+    // be evaluated. Fail all later reads of them, including through other
+    // Objects sharing their actual parameters.
+    object.markLazyFailed();
+    for (auto *expanded : expandedObjects) {
+      expanded->markLazyFailed();
+      failedParameters.insert(expanded->getLazyParameters());
+    }
+    expandedObjects.clear();
+    return failure();
+  }
+  expandedObjects.clear();
+
+  // Strip the references in the fields, which are fully evaluated now.
+  if (failed(object.finalizeImpl())) {
+    object.markLazyFailed();
+    return object.getClassOp().emitError()
+           << "failed to finalize evaluation. Probably the class contains a "
+              "dataflow cycle";
+  }
+  object.detachLazyEvaluator();
+  return success();
 }
 
 /// Instantiate an Object with its class name and actual parameters.
@@ -301,31 +509,25 @@ circt::om::Evaluator::instantiate(
   auto result = evaluateObjectInstance(
       className, actualParametersBuffers.back().get(), loc);
 
-  if (failed(result))
+  if (failed(result)) {
+    memoizedInstances.clear();
     return failure();
+  }
 
   // `evaluateObjectInstance` has populated the worklist. Continue evaluations
-  // unless there is a partially evaluated value.
-  while (!worklist.empty()) {
-    auto [value, args] = worklist.front();
-    worklist.pop();
-
-    auto result = evaluateValue(value, args, loc);
-
-    if (failed(result))
-      return failure();
-
-    // It's possible that the value is not fully evaluated.
-    if (!result.value()->isFullyEvaluated())
-      worklist.push({value, args});
-  }
+  // unless there is a partially evaluated value. In lazy mode, the worklist
+  // is empty until a field is read.
+  if (failed(evaluateWorklist(loc)))
+    return failure();
 
   auto &object = result.value();
   // Finalize the value. This will eliminate intermidiate ReferenceValue used as
   // a placeholder in the initialization.
-  if (failed(object->finalize()))
+  if (failed(object->finalize())) {
+    memoizedInstances.clear();
     return cls.emitError() << "failed to finalize evaluation. Probably the "
                               "class contains a dataflow cycle";
+  }
   return object;
 }
 
@@ -405,8 +607,7 @@ FailureOr<circt::om::evaluator::EvaluatorValuePtr>
 circt::om::Evaluator::evaluateConstant(ConstantOp op,
                                        ActualParameters actualParams,
                                        Location loc) {
-  return success(std::make_shared<circt::om::evaluator::AttributeValue>(
-      op.getValue(), loc));
+  return success(allocate<evaluator::AttributeValue>(op.getValue(), loc));
 }
 
 // Evaluator dispatch function for integer binary arithmetic.
@@ -545,10 +746,18 @@ circt::om::Evaluator::evaluateObjectField(ObjectFieldOp op,
   evaluator::EvaluatorValuePtr finalField;
   for (auto field : op.getFieldPath().getAsRange<FlatSymbolRefAttr>()) {
     // `currentObject` might no be fully evaluated.
-    if (!currentObject->getFields().contains(field.getAttr()))
+    if (!currentObject->isFullyEvaluated())
       return objectFieldValue;
 
-    auto currentField = currentObject->getField(field.getAttr());
+    // The class body of a lazily evaluated Object is added to the worklist on
+    // the first access, and its fields may be partially evaluated.
+    if (currentObject->getLazyEvaluator() &&
+        failed(expandObject(*currentObject)))
+      return failure();
+
+    auto currentField = currentObject->lookupField(field.getAttr());
+    if (failed(currentField))
+      return failure();
     finalField = currentField.value();
     if (auto *nextObject =
             llvm::dyn_cast<evaluator::ObjectValue>(finalField.get()))
@@ -730,31 +939,63 @@ FailureOr<evaluator::EvaluatorValuePtr> circt::om::Evaluator::evaluateEmptyPath(
 // ObjectValue
 //===----------------------------------------------------------------------===//
 
+evaluator::ObjectLayout::ObjectLayout(ClassOp cls) : cls(cls) {
+  for (auto field : cls.getOps<ClassFieldOp>()) {
+    indices.insert({field.getNameAttr(), names.size()});
+    names.push_back(field.getNameAttr());
+  }
+
+  // Sort the names so there is always a stable order.
+  SmallVector<Attribute> sorted(names.begin(), names.end());
+  llvm::sort(sorted, [](Attribute a, Attribute b) {
+    return cast<StringAttr>(a).getValue() < cast<StringAttr>(b).getValue();
+  });
+  sortedNames = ArrayAttr::get(cls.getContext(), sorted);
+}
+
+std::optional<unsigned>
+evaluator::ObjectLayout::getFieldIndex(StringAttr name) const {
+  auto it = indices.find(name);
+  if (it == indices.end())
+    return std::nullopt;
+  return it->second;
+}
+
 /// Get a field of the Object by name.
 FailureOr<EvaluatorValuePtr>
 circt::om::evaluator::ObjectValue::getField(StringAttr name) {
-  auto field = fields.find(name);
-  if (field == fields.end())
-    return cls.emitError("field ") << name << " does not exist";
-  return success(fields[name]);
+  if (lazyFailed)
+    return getClassOp().emitError("cannot evaluate field ")
+           << name << ", the evaluation of the object failed before";
+  if (lazyEvaluator) {
+    if (failed(lazyEvaluator->forceObject(*this)))
+      return failure();
+  } else if (lazyParams && !isExpanded()) {
+    return getClassOp().emitError("cannot evaluate field ")
+           << name << " after the evaluator has been destroyed";
+  }
+  return lookupField(name);
 }
 
-/// Get an ArrayAttr with the names of the fields in the Object. Sort the fields
-/// so there is always a stable order.
-ArrayAttr circt::om::Object::getFieldNames() {
-  SmallVector<Attribute> fieldNames;
-  for (auto &f : fields)
-    fieldNames.push_back(f.first);
-
-  llvm::sort(fieldNames, [](Attribute a, Attribute b) {
-    return cast<StringAttr>(a).getValue() < cast<StringAttr>(b).getValue();
-  });
+/// Get a field of the Object by name, without evaluating it.
+FailureOr<EvaluatorValuePtr>
+circt::om::evaluator::ObjectValue::lookupField(StringAttr name) {
+  auto index = layout->getFieldIndex(name);
+  if (!index || *index >= fields.size())
+    return getClassOp().emitError("field ") << name << " does not exist";
+  return success(fields[*index]);
+}
 
-  return ArrayAttr::get(cls.getContext(), fieldNames);
+/// Get an ArrayAttr with the names of the fields in the Object, sorted so
+/// there is always a stable order.
+ArrayAttr circt::om::Object::getFieldNames() {
+  return layout->getSortedFieldNames();
 }
 
 LogicalResult circt::om::evaluator::ObjectValue::finalizeImpl() {
-  for (auto &&[e, value] : fields)
+  // The fields of a lazily evaluated Object that has not been accessed yet
+  // are finalized when they are forced.
+  for (auto &value : fields)
     if (failed(finalizeEvaluatorValue(value)))
       return failure();
 
@@ -34,22 +34,21 @@ using namespace mlir;
 using namespace llvm;
 
 namespace {
-// A map from a pair of enclosing module op and old symbol to a new symbol.
-using SymMappingTy =
-    llvm::DenseMap<std::pair<ModuleOp, StringAttr>, StringAttr>;
-
 struct ModuleInfo {
   ModuleInfo(mlir::ModuleOp module) : module(module) {}
 
   // Populate `symbolToClasses`.
   LogicalResult initialize();
 
-  // Update symbols based on the mapping and erase external classes.
-  void postProcess(const SymMappingTy &symMapping);
+  // Update symbols based on `renamedSymbols` and erase external classes.
+  void postProcess();
 
   // A map from symbols to classes.
   llvm::DenseMap<StringAttr, ClassLike> symbolToClasses;
 
+  // A map from old symbols to new symbols of the classes in this module.
+  llvm::DenseMap<StringAttr, StringAttr> renamedSymbols;
+
   // A target module.
   ModuleOp module;
 };
@@ -71,14 +70,22 @@ LogicalResult ModuleInfo::initialize() {
   return success();
 }
 
-void ModuleInfo::postProcess(const SymMappingTy &symMapping) {
+void ModuleInfo::postProcess() {
+  // Most modules have no symbol collisions. Only erase their external classes
+  // instead of walking all their types.
+  if (renamedSymbols.empty()) {
+    for (auto op : llvm::make_early_inc_range(module.getOps<ClassExternOp>()))
+      op.erase();
+    return;
+  }
+
   AttrTypeReplacer replacer;
   replacer.addReplacement(
       // Update class types when their symbols were renamed.
       [&](om::ClassType classType) -> std::pair<mlir::Type, WalkResult> {
-        auto it = symMapping.find({module, classType.getClassName().getAttr()});
+        auto it = renamedSymbols.find(classType.getClassName().getAttr());
         // No change.
-        if (it == symMapping.end())
+        if (it == renamedSymbols.end())
           return {classType, WalkResult::skip()};
         return {om::ClassType::get(classType.getContext(),
                                    FlatSymbolRefAttr::get(it->second)),
@@ -95,13 +102,13 @@ void ModuleInfo::postProcess(const SymMappingTy &symMapping) {
 
     if (auto classOp = dyn_cast<ClassOp>(op)) {
       // Update its class name if changed.
-      auto it = symMapping.find({module, classOp.getNameAttr()});
-      if (it != symMapping.end())
+      auto it = renamedSymbols.find(classOp.getNameAttr());
+      if (it != renamedSymbols.end())
         classOp.setSymNameAttr(it->second);
     } else if (auto objectOp = dyn_cast<ObjectOp>(op)) {
       // Update its class name if changed..
-      auto it = symMapping.find({module, objectOp.getClassNameAttr()});
-      if (it != symMapping.end())
+      auto it = renamedSymbols.find(objectOp.getClassNameAttr());
+      if (it != renamedSymbols.end())
         objectOp.setClassNameAttr(it->second);
     }
 
@@ -222,6 +229,7 @@ void LinkModulesPass::runOnOperation() {
   auto toplevelModule = getOperation();
   // 1. Initialize ModuleInfo.
   SmallVector<ModuleInfo> modules;
+  DenseMap<Operation *, ModuleInfo *> moduleInfos;
   size_t counter = 0;
   for (auto module : toplevelModule.getOps<ModuleOp>()) {
     auto name = module->getAttrOfType<StringAttr>("om.namespace");
@@ -232,6 +240,8 @@ void LinkModulesPass::runOnOperation() {
     }
     modules.emplace_back(module);
   }
+  for (auto &info : modules)
+    moduleInfos[info.module] = &info;
 
   if (failed(failableParallelForEach(&getContext(), modules, [](auto &info) {
         // Collect local information.
@@ -244,8 +254,6 @@ void LinkModulesPass::runOnOperation() {
 
   // Global namespace to get unique names to symbols.
   Namespace nameSpace;
-  // A map from a pair of enclosing module op and old symbol to a new symbol.
-  SymMappingTy symMapping;
 
   // Construct a global map from symbols to class operations.
   llvm::MapVector<StringAttr, SmallVector<ClassLike>> symbolToClasses;
@@ -260,36 +268,45 @@ void LinkModulesPass::runOnOperation() {
   // "public" thus we cannot rename such symbols when there is collision. We
   // require a public symbol to have exactly one definition so otherwise raise
   // an error.
-  for (auto &[name, classes] : symbolToClasses) {
-    // Check if it's legal to link classes. `resolveClasses` returns true if
-    // it's necessary to rename symbols.
-    auto result = resolveClasses(name, classes);
-    if (failed(result))
-      return signalPassFailure();
-
-    // We can resolve symbol collision for symbols not referred by external
-    // classes. Create a new name using `om.namespace` attributes as a
-    // suffix.
-    if (*result)
-      for (auto op : classes) {
-        auto enclosingModule = cast<mlir::ModuleOp>(op->getParentOp());
-        auto nameSpaceId =
-            enclosingModule->getAttrOfType<StringAttr>("om.namespace");
-        symMapping[{enclosingModule, name}] = StringAttr::get(
-            &getContext(),
-            nameSpace.newName(name.getValue(), nameSpaceId.getValue()));
-      }
+  //
+  // Check if it's legal to link classes in parallel. `resolveClasses` returns
+  // true if it's necessary to rename symbols. Every symbol is checked, and the
+  // diagnostics are reported in symbol order.
+  auto symbols = symbolToClasses.takeVector();
+  SmallVector<FailureOr<bool>> resolved(symbols.size(), failure());
+  parallelFor(&getContext(), 0, symbols.size(), [&](size_t i) {
+    resolved[i] = resolveClasses(symbols[i].first, symbols[i].second);
+  });
+  if (llvm::any_of(resolved, [](auto result) { return failed(result); }))
+    return signalPassFailure();
+
+  // We can resolve symbol collision for symbols not referred by external
+  // classes. Create a new name using `om.namespace` attributes as a suffix.
+  // New names are created sequentially to keep them deterministic.
+  for (auto [symbol, result] : llvm::zip(symbols, resolved)) {
+    if (!*result)
+      continue;
+    auto name = symbol.first;
+    for (auto op : symbol.second) {
+      auto *info = moduleInfos.lookup(op->getParentOp());
+      auto nameSpaceId =
+          info->module->getAttrOfType<StringAttr>("om.namespace");
+      info->renamedSymbols[name] = StringAttr::get(
+          &getContext(),
+          nameSpace.newName(name.getValue(), nameSpaceId.getValue()));
+    }
   }
 
   // 3. Post-processing. Update class names and erase external classes.
 
-  // Rename private symbols and remove external classes.
+  // Rename private symbols and remove external classes, for each module in
+  // parallel.
   parallelForEach(&getContext(), modules,
-                  [&](auto &info) { info.postProcess(symMapping); });
+                  [](auto &info) { info.postProcess(); });
 
   // Finally move operations to the toplevel module.
   auto *block = toplevelModule.getBody();
-  for (auto info : modules) {
+  for (auto &info : modules) {
     block->getOperations().splice(block->end(),
                                   info.module.getBody()->getOperations());
     // Erase the module.
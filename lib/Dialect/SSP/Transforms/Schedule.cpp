@@ -63,6 +63,11 @@ static std::optional<float> getCycleTime(StringRef options) {
   return std::nullopt;
 }
 
+// Determine whether the flag \p name is present in \p options.
+static bool hasOption(StringRef options, StringRef name) {
+  return llvm::is_contained(llvm::split(options, ','), name);
+}
+
 //===----------------------------------------------------------------------===//
 // ASAP scheduler
 //===----------------------------------------------------------------------===//
@@ -98,6 +103,45 @@ static InstanceOp scheduleProblemTWithSimplex(InstanceOp instOp,
   return saveProblem(prob, builder);
 }
 
+// Exercise the incremental simplex scheduler: Solve the problem without its
+// auxiliary dependences first, then re-insert them one at a time, and re-solve
+// after each step. Afterwards, temporarily remove each of them once more. The
+// final solution is the same as with the regular simplex scheduler.
+template <typename ProblemT>
+static InstanceOp scheduleProblemTWithIncrementalSimplex(InstanceOp instOp,
+                                                         Operation *lastOp,
+                                                         OpBuilder &builder) {
+  auto prob = loadProblem<ProblemT>(instOp);
+  if (failed(prob.check()))
+    return {};
+
+  SmallVector<Problem::Dependence> auxDeps;
+  for (auto *op : prob.getOperations())
+    for (auto dep : prob.getDependences(op))
+      if (dep.isAuxiliary())
+        auxDeps.push_back(dep);
+  for (auto dep : auxDeps)
+    (void)prob.eraseDependence(dep);
+
+  IncrementalSimplexScheduler scheduler(prob, lastOp);
+  if (failed(scheduler.schedule()))
+    return {};
+  for (auto dep : auxDeps)
+    if (failed(scheduler.insertDependence(dep)) ||
+        failed(scheduler.schedule()))
+      return {};
+  for (auto dep : auxDeps)
+    if (failed(scheduler.eraseDependence(dep)) ||
+        failed(scheduler.schedule()) ||
+        failed(scheduler.insertDependence(dep)) ||
+        failed(scheduler.schedule()))
+      return {};
+
+  if (failed(prob.verify()))
+    return {};
+  return saveProblem(prob, builder);
+}
+
 static InstanceOp scheduleChainingProblemWithSimplex(InstanceOp instOp,
                                                      Operation *lastOp,
                                                      float cycleTime,
@@ -134,6 +178,18 @@ static InstanceOp scheduleWithSimplex(InstanceOp instOp, StringRef options,
   }
 
   auto problemName = instOp.getProblemName();
+  if (hasOption(options, "incremental")) {
+    if (problemName == "Problem")
+      return scheduleProblemTWithIncrementalSimplex<Problem>(instOp, lastOp,
+                                                             builder);
+    if (problemName == "CyclicProblem")
+      return scheduleProblemTWithIncrementalSimplex<CyclicProblem>(
+          instOp, lastOp, builder);
+    llvm::errs() << "ssp-schedule: Unsupported problem '" << problemName
+                 << "' for incremental simplex scheduler\n";
+    return {};
+  }
+
   if (problemName == "Problem")
     return scheduleProblemTWithSimplex<Problem>(instOp, lastOp, builder);
   if (problemName == "CyclicProblem")
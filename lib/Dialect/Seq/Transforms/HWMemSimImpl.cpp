@@ -23,8 +23,11 @@
 #include "circt/Dialect/Seq/SeqPasses.h"
 #include "mlir/IR/ImplicitLocOpBuilder.h"
 #include "mlir/Pass/Pass.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/xxhash.h"
+#include <random>
 
 using namespace circt;
 using namespace hw;
@@ -49,6 +52,7 @@ class HWMemSimImpl {
   bool disableMemRandomization;
   bool disableRegRandomization;
   bool addVivadoRAMAddressConflictSynthesisBugWorkaround;
+  bool optimizeForSimulation;
 
   SmallVector<sv::RegOp> registers;
 
@@ -58,18 +62,27 @@ class HWMemSimImpl {
                           const Twine &name, Value gate = {});
   sv::AlwaysOp lastPipelineAlwaysOp;
 
+  /// The always block holding all writes on a clock, used when optimizing for
+  /// simulation.
+  DenseMap<Value, sv::AlwaysOp> writeAlwaysOps;
+  sv::AlwaysOp getWriteAlwaysOp(ImplicitLocOpBuilder &b, Value clock);
+
+  StringAttr createRandomInitFile(ImplicitLocOpBuilder &b, HWModuleOp op,
+                                  const FirMemory &mem);
+
 public:
   Namespace &mlirModuleNamespace;
 
   HWMemSimImpl(ReadEnableMode readEnableMode, bool addMuxPragmas,
                bool disableMemRandomization, bool disableRegRandomization,
                bool addVivadoRAMAddressConflictSynthesisBugWorkaround,
-               Namespace &mlirModuleNamespace)
+               bool optimizeForSimulation, Namespace &mlirModuleNamespace)
       : readEnableMode(readEnableMode), addMuxPragmas(addMuxPragmas),
         disableMemRandomization(disableMemRandomization),
         disableRegRandomization(disableRegRandomization),
         addVivadoRAMAddressConflictSynthesisBugWorkaround(
             addVivadoRAMAddressConflictSynthesisBugWorkaround),
+        optimizeForSimulation(optimizeForSimulation),
         mlirModuleNamespace(mlirModuleNamespace) {}
 
   void generateMemory(HWModuleOp op, FirMemory mem);
@@ -181,6 +194,81 @@ Value HWMemSimImpl::addPipelineStages(ImplicitLocOpBuilder &b,
   return data;
 }
 
+/// Return the always block that holds all writes clocked by `clock`, creating
+/// it if necessary. The block is moved to the current insertion point so that
+/// it follows the definitions of the values the next port writes.
+sv::AlwaysOp HWMemSimImpl::getWriteAlwaysOp(ImplicitLocOpBuilder &b,
+                                            Value clock) {
+  auto &alwaysOp = writeAlwaysOps[clock];
+  if (alwaysOp)
+    alwaysOp->moveBefore(b.getInsertionBlock(), b.getInsertionPoint());
+  else
+    alwaysOp = b.create<sv::AlwaysOp>(sv::EventControl::AtPosEdge, clock);
+  return alwaysOp;
+}
+
+/// Return the name of a file emitted next to the output file of `op`, or into
+/// its output directory.
+static StringAttr getSiblingFileName(HWModuleOp op, const Twine &name) {
+  Builder b(op.getContext());
+  if (auto fileAttr = op->getAttrOfType<OutputFileAttr>("output_file")) {
+    SmallString<128> path(fileAttr.getFilename().getValue());
+    if (!fileAttr.isDirectory())
+      llvm::sys::path::remove_filename(path);
+    llvm::sys::path::append(path, name);
+    return b.getStringAttr(path);
+  }
+  return b.getStringAttr(name);
+}
+
+/// Memories with more bits than this keep the procedural randomization loop
+/// instead of a generated init file, which would grow too large.
+static constexpr uint64_t maxRandomInitFileBits = uint64_t(1) << 26;
+
+/// Emit a file with one random hexadecimal word per memory entry, suitable for
+/// `$readmemh`, and return its name. The contents are derived from the module
+/// name so that they are stable across runs, which also means they do not
+/// change with the seed of the simulator. The name is relative to the output
+/// directory, and `$readmemh` resolves it against the working directory of the
+/// simulator. Returns a null attribute if the memory is too large for a file.
+StringAttr HWMemSimImpl::createRandomInitFile(ImplicitLocOpBuilder &b,
+                                              HWModuleOp op,
+                                              const FirMemory &mem) {
+  if (mem.dataWidth == 0 || mem.depth * mem.dataWidth > maxRandomInitFileBits)
+    return {};
+
+  std::mt19937_64 rng(llvm::xxh3_64bits(op.getName()));
+  size_t numDigits = llvm::divideCeil(mem.dataWidth, 4);
+  unsigned topDigitMask = (1u << (mem.dataWidth - 4 * (numDigits - 1))) - 1;
+  std::string contents;
+  contents.reserve(mem.depth * (numDigits + 1));
+  uint64_t bits = 0;
+  unsigned bitsLeft = 0;
+  for (uint64_t i = 0; i < mem.depth; ++i) {
+    for (size_t j = 0; j < numDigits; ++j) {
+      if (bitsLeft == 0) {
+        bits = rng();
+        bitsLeft = 64;
+      }
+      unsigned digit = bits & 0xf;
+      bits >>= 4;
+      bitsLeft -= 4;
+      if (j == 0)
+        digit &= topDigitMask;
+      contents.push_back(llvm::hexdigit(digit, /*LowerCase=*/true));
+    }
+    contents.push_back('\n');
+  }
+
+  OpBuilder::InsertionGuard guard(b);
+  auto filename = getSiblingFileName(op, op.getName() + "_random.hex");
+  b.setInsertionPointAfter(op);
+  b.create<emit::FileOp>(filename, [&] {
+    b.create<emit::VerbatimOp>(b.getStringAttr(contents));
+  });
+  return filename;
+}
+
 void HWMemSimImpl::generateMemory(HWModuleOp op, FirMemory mem) {
   ImplicitLocOpBuilder b(op.getLoc(), op.getBody());
 
@@ -374,28 +462,37 @@ void HWMemSimImpl::generateMemory(HWModuleOp op, FirMemory mem) {
     b.create<sv::AssignOp>(rWire, val);
 
     // Write logic gaurded by the corresponding mask bit.
-    for (auto wmask : llvm::enumerate(maskValues)) {
-      b.create<sv::AlwaysOp>(sv::EventControl::AtPosEdge, clock, [&]() {
-        auto wcond = b.createOrFold<comb::AndOp>(
-            writeEn,
-            b.createOrFold<comb::AndOp>(wmask.value(), writeWMode, false),
-            false);
-        b.create<sv::IfOp>(wcond, [&]() {
-          Value slotReg = b.create<sv::ArrayIndexInOutOp>(reg, writeAddr);
-          b.create<sv::PAssignOp>(
-              b.createOrFold<sv::IndexedPartSelectInOutOp>(
-                  slotReg,
-                  b.createOrFold<ConstantOp>(b.getIntegerType(32),
-                                             wmask.index() * mem.maskGran),
-                  mem.maskGran),
-              dataValues[wmask.index()]);
-        });
+    auto writeMaskLogic = [&](size_t index, Value wmask) {
+      auto wcond = b.createOrFold<comb::AndOp>(
+          writeEn, b.createOrFold<comb::AndOp>(wmask, writeWMode, false),
+          false);
+      b.create<sv::IfOp>(wcond, [&]() {
+        Value slotReg = b.create<sv::ArrayIndexInOutOp>(reg, writeAddr);
+        b.create<sv::PAssignOp>(
+            b.createOrFold<sv::IndexedPartSelectInOutOp>(
+                slotReg,
+                b.createOrFold<ConstantOp>(b.getIntegerType(32),
+                                           index * mem.maskGran),
+                mem.maskGran),
+            dataValues[index]);
       });
+    };
+    if (optimizeForSimulation) {
+      OpBuilder::InsertionGuard guard(b);
+      b.setInsertionPointToEnd(getWriteAlwaysOp(b, clock).getBodyBlock());
+      for (auto wmask : llvm::enumerate(maskValues))
+        writeMaskLogic(wmask.index(), wmask.value());
+    } else {
+      for (auto wmask : llvm::enumerate(maskValues))
+        b.create<sv::AlwaysOp>(sv::EventControl::AtPosEdge, clock, [&]() {
+          writeMaskLogic(wmask.index(), wmask.value());
+        });
     }
     outputs.push_back(rdata);
   }
 
   DenseMap<unsigned, Operation *> writeProcesses;
+  DenseMap<unsigned, Value> writeClocks;
   for (size_t i = 0; i < mem.numWritePorts; ++i) {
     auto numStages = mem.writeLatency - 1;
     Value addr = op.getBody().getArgument(inArg++);
@@ -450,6 +547,19 @@ void HWMemSimImpl::generateMemory(HWModuleOp op, FirMemory mem) {
       }
     };
 
+    // When optimizing for simulation, all writes on a clock share an always
+    // block. They are added in port order, which satisfies every write order.
+    // Ports with the same clock ID are driven by the same clock.
+    if (optimizeForSimulation) {
+      if (i < mem.writeClockIDs.size())
+        clock = writeClocks.try_emplace(mem.writeClockIDs[i], clock)
+                    .first->second;
+      OpBuilder::InsertionGuard guard(b);
+      b.setInsertionPointToEnd(getWriteAlwaysOp(b, clock).getBodyBlock());
+      writeLogic();
+      continue;
+    }
+
     // Build a new always block with write port logic.
     auto alwaysBlock = [&] {
       return b.create<sv::AlwaysOp>(sv::EventControl::AtPosEdge, clock,
@@ -505,19 +615,8 @@ void HWMemSimImpl::generateMemory(HWModuleOp op, FirMemory mem) {
           b.getStringAttr(mlirModuleNamespace.newName(op.getName() + "_init"));
 
       // Generate a name for the file containing the bound module and the bind.
-      StringAttr filename;
-      if (auto fileAttr = op->getAttrOfType<OutputFileAttr>("output_file")) {
-        if (!fileAttr.isDirectory()) {
-          SmallString<128> path(fileAttr.getFilename().getValue());
-          llvm::sys::path::remove_filename(path);
-          llvm::sys::path::append(path, boundModuleName.getValue() + ".sv");
-          filename = b.getStringAttr(path);
-        } else {
-          filename = fileAttr.getFilename();
-        }
-      } else {
-        filename = b.getStringAttr(boundModuleName.getValue() + ".sv");
-      }
+      StringAttr filename =
+          getSiblingFileName(op, boundModuleName.getValue() + ".sv");
 
       // Create a new module with the readmem op.
       b.setInsertionPointAfter(op);
@@ -563,6 +662,12 @@ void HWMemSimImpl::generateMemory(HWModuleOp op, FirMemory mem) {
   if (disableMemRandomization && disableRegRandomization)
     return;
 
+  // When optimizing for simulation, load random memory contents from a file
+  // instead of filling the memory word by word in a procedural loop.
+  StringAttr randomInitFile;
+  if (optimizeForSimulation && !disableMemRandomization)
+    randomInitFile = createRandomInitFile(b, op, mem);
+
   constexpr unsigned randomWidth = 32;
   b.create<sv::IfDefOp>("ENABLE_INITIAL_MEM_", [&]() {
     sv::RegOp randReg;
@@ -581,15 +686,22 @@ void HWMemSimImpl::generateMemory(HWModuleOp op, FirMemory mem) {
         }
       });
     }
-    auto randomMemReg = b.create<sv::RegOp>(
-        b.getIntegerType(llvm::divideCeil(mem.dataWidth, randomWidth) *
-                         randomWidth),
-        b.getStringAttr("_RANDOM_MEM"));
+    sv::RegOp randomMemReg;
+    if (!randomInitFile)
+      randomMemReg = b.create<sv::RegOp>(
+          b.getIntegerType(llvm::divideCeil(mem.dataWidth, randomWidth) *
+                           randomWidth),
+          b.getStringAttr("_RANDOM_MEM"));
     b.create<sv::InitialOp>([&]() {
       b.create<sv::VerbatimOp>("`INIT_RANDOM_PROLOG_");
 
       // Memory randomization logic.  The entire memory is randomized.
-      if (!disableMemRandomization) {
+      if (randomInitFile) {
+        b.create<sv::IfDefProceduralOp>("RANDOMIZE_MEM_INIT", [&]() {
+          b.create<sv::ReadMemOp>(reg, randomInitFile,
+                                  MemBaseTypeAttr::MemBaseHex);
+        });
+      } else if (!disableMemRandomization) {
         b.create<sv::IfDefProceduralOp>("RANDOMIZE_MEM_INIT", [&]() {
           auto outerLoopIndVarType =
               b.getIntegerType(llvm::Log2_64_Ceil(mem.depth + 1));
@@ -751,7 +863,7 @@ void HWMemSimImplPass::runOnOperation() {
         HWMemSimImpl(readEnableMode, addMuxPragmas, disableMemRandomization,
                      disableRegRandomization,
                      addVivadoRAMAddressConflictSynthesisBugWorkaround,
-                     mlirModuleNamespace)
+                     optimizeForSimulation, mlirModuleNamespace)
             .generateMemory(newModule, mem);
       }
 
@@ -312,7 +312,8 @@ LogicalResult firtool::populateHWToSV(mlir::PassManager &pm,
            : seq::ReadEnableMode::Undefined,
        /*addMuxPragmas=*/opt.shouldAddMuxPragmas(),
        /*addVivadoRAMAddressConflictSynthesisBugWorkaround=*/
-       opt.shouldAddVivadoRAMAddressConflictSynthesisBugWorkaround()}));
+       opt.shouldAddVivadoRAMAddressConflictSynthesisBugWorkaround(),
+       /*optimizeForSimulation=*/opt.shouldOptimizeMemoriesForSimulation()}));
 
   // If enabled, run the optimizer.
   if (!opt.shouldDisableOptimization()) {
@@ -673,6 +674,16 @@ struct FirtoolCmdOptions {
           "address conflict behavivor of combinational memories"),
       llvm::cl::init(false)};
 
+  llvm::cl::opt<bool> optimizeMemoriesForSimulation{
+      "optimize-memories-for-simulation",
+      llvm::cl::desc("Emit memory models that simulate faster, with shared "
+                     "write always blocks and random initial contents loaded "
+                     "from a generated file. The contents are fixed per "
+                     "memory module and ignore the simulator seed, and the "
+                     "file is looked up relative to the simulator's working "
+                     "directory"),
+      llvm::cl::init(false)};
+
   //===----------------------------------------------------------------------===
   // External Clock Gate Options
   //===----------------------------------------------------------------------===
@@ -755,8 +766,9 @@ circt::firtool::FirtoolOptions::FirtoolOptions()
       emitSeparateAlwaysBlocks(false), etcDisableInstanceExtraction(false),
       etcDisableRegisterExtraction(false), etcDisableModuleInlining(false),
       addVivadoRAMAddressConflictSynthesisBugWorkaround(false),
-      ckgModuleName("EICG_wrapper"), ckgInputName("in"), ckgOutputName("out"),
-      ckgEnableName("en"), ckgTestEnableName("test_en"), ckgInstName("ckg"),
+      optimizeMemoriesForSimulation(false), ckgModuleName("EICG_wrapper"),
+      ckgInputName("in"), ckgOutputName("out"), ckgEnableName("en"),
+      ckgTestEnableName("test_en"), ckgInstName("ckg"),
       exportModuleHierarchy(false), stripFirDebugInfo(true),
       stripDebugInfo(false), fixupEICGWrapper(false),
       addCompanionAssume(false) {
@@ -799,6 +811,7 @@ circt::firtool::FirtoolOptions::FirtoolOptions()
   etcDisableModuleInlining = clOptions->etcDisableModuleInlining;
   addVivadoRAMAddressConflictSynthesisBugWorkaround =
       clOptions->addVivadoRAMAddressConflictSynthesisBugWorkaround;
+  optimizeMemoriesForSimulation = clOptions->optimizeMemoriesForSimulation;
   ckgModuleName = clOptions->ckgModuleName;
   ckgInputName = clOptions->ckgInputName;
   ckgOutputName = clOptions->ckgOutputName;
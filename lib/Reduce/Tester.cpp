@@ -32,22 +32,20 @@ std::pair<bool, size_t> Tester::isInteresting(ModuleOp module) const {
   return std::make_pair(test.isInteresting(), test.getSize());
 }
 
-/// Runs the interestingness testing script on a MLIR test case file. Returns
-/// true if the interesting behavior is present in the test case or false
-/// otherwise.
-bool Tester::isInteresting(StringRef testCase) const {
-  // Assemble the arguments to the tester. Note that the first one has to be the
-  // name of the program.
+/// Assemble the arguments to the tester for the given test case file. Note that
+/// the first one has to be the name of the program.
+static SmallVector<StringRef> getTesterArgs(StringRef testScript,
+                                            ArrayRef<std::string> scriptArgs,
+                                            StringRef testCase) {
   SmallVector<StringRef> testerArgs;
   testerArgs.push_back(testScript);
-  testerArgs.append(testScriptArgs.begin(), testScriptArgs.end());
+  testerArgs.append(scriptArgs.begin(), scriptArgs.end());
   testerArgs.push_back(testCase);
+  return testerArgs;
+}
 
-  // Run the tester.
-  std::string errMsg;
-  int result = llvm::sys::ExecuteAndWait(
-      testScript, testerArgs, /*Env=*/std::nullopt, /*Redirects=*/std::nullopt,
-      /*SecondsToWait=*/0, /*MemoryLimit=*/0, &errMsg);
+/// Interpret the exit code of the tester.
+bool Tester::isInterestingResult(int result, StringRef errMsg) const {
   if (result < 0)
     llvm::report_fatal_error(
         Twine("Error running interestingness test: ") + errMsg, false);
@@ -58,6 +56,48 @@ bool Tester::isInteresting(StringRef testCase) const {
   return result == 0;
 }
 
+/// Runs the interestingness testing script on a MLIR test case file. Returns
+/// true if the interesting behavior is present in the test case or false
+/// otherwise.
+bool Tester::isInteresting(StringRef testCase) const {
+  auto testerArgs = getTesterArgs(testScript, testScriptArgs, testCase);
+
+  // Run the tester.
+  std::string errMsg;
+  int result = llvm::sys::ExecuteAndWait(
+      testScript, testerArgs, /*Env=*/std::nullopt, /*Redirects=*/std::nullopt,
+      /*SecondsToWait=*/0, /*MemoryLimit=*/0, &errMsg);
+  return isInterestingResult(result, errMsg);
+}
+
+/// Run the tester on multiple test cases concurrently. All tester processes are
+/// launched first, and then waited on in order.
+void Tester::testConcurrently(ArrayRef<TestCase *> testCases) const {
+  SmallVector<std::pair<TestCase *, llvm::sys::ProcessInfo>> running;
+  for (auto *test : testCases) {
+    if (test->interesting || !test->isValid())
+      continue;
+    test->ensureFileOnDisk();
+    auto testerArgs = getTesterArgs(testScript, testScriptArgs, test->filepath);
+    std::string errMsg;
+    auto info = llvm::sys::ExecuteNoWait(testScript, testerArgs,
+                                         /*Env=*/std::nullopt,
+                                         /*Redirects=*/{}, /*MemoryLimit=*/0,
+                                         &errMsg);
+    if (info.Pid == llvm::sys::ProcessInfo::InvalidPid)
+      llvm::report_fatal_error(
+          Twine("Error running interestingness test: ") + errMsg, false);
+    running.push_back({test, info});
+  }
+
+  for (auto &[test, info] : running) {
+    std::string errMsg;
+    auto result =
+        llvm::sys::Wait(info, /*SecondsToWait=*/std::nullopt, &errMsg);
+    test->interesting = isInterestingResult(result.ReturnCode, errMsg);
+  }
+}
+
 /// Create a new test case for the given `module`.
 TestCase Tester::get(mlir::ModuleOp module) const {
   return TestCase(*this, module);
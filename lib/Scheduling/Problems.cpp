@@ -44,6 +44,17 @@ LogicalResult Problem::insertDependence(Dependence dep) {
   return success();
 }
 
+LogicalResult Problem::eraseDependence(Dependence dep) {
+  if (!dep.isAuxiliary())
+    return failure();
+
+  auto it = auxDependences.find(dep.getDestination());
+  if (it == auxDependences.end() || !it->second.remove(dep.getSource()))
+    return failure();
+
+  return success();
+}
+
 Problem::OperatorType Problem::getOrInsertOperatorType(StringRef name) {
   auto opr = OperatorType::get(containingOp->getContext(), name);
   operatorTypes.insert(opr);
@@ -122,13 +122,20 @@ protected:
   /// them from being pivoted into basis again.
   DenseMap<unsigned, unsigned> frozenVariables;
 
+  /// Maps the problem's dependences to their slack variables. This allows
+  /// locating and updating a constraint after the tableau has been solved.
+  DenseMap<Problem::Dependence, unsigned> slackVariables;
+
+  /// Number of variables created so far, i.e. the next free variable ID.
+  unsigned nVariables = 0;
+
   /// Number of rows in the tableau = |obj| + |deps|.
-  unsigned nRows;
+  unsigned nRows = 0;
   /// Number of explicitly stored columns in the tableau = |params| + |ops|.
-  unsigned nColumns;
+  unsigned nColumns = 0;
 
   // Number of objective rows.
-  unsigned nObjectives;
+  unsigned nObjectives = 0;
   /// All other rows encode linear constraints.
   unsigned &firstConstraintRow = nObjectives;
 
@@ -147,6 +154,18 @@ protected:
   /// the input problem, but should be modeled in the linear problem.
   SmallVector<Problem::Dependence> additionalConstraints;
 
+  /// Set once the tableau has been built. Subsequent calls to `schedule()`
+  /// continue from the current basis instead of starting over.
+  bool tableauBuilt = false;
+
+  /// Number of pivot steps performed on the current tableau.
+  unsigned numPivots = 0;
+
+  /// Scratch vector holding the columns with non-zero entries in the current
+  /// pivot row. The constraint matrix is very sparse, so restricting the row
+  /// operations to these columns saves most of the work in `pivot`.
+  SmallVector<unsigned> pivotRowSupport;
+
   virtual Problem &getProblem() = 0;
   virtual LogicalResult checkLastOp();
   virtual bool fillObjectiveRow(SmallVector<int> &row, unsigned obj);
@@ -154,6 +173,8 @@ protected:
                                  Problem::Dependence dep);
   virtual void fillAdditionalConstraintRow(SmallVector<int> &row,
                                            Problem::Dependence dep);
+  void addStartTimeTerm(SmallVector<int> &row, unsigned startTimeVariable,
+                        int coeff);
   void buildTableau();
 
   int getParametricConstant(unsigned row);
@@ -164,7 +185,8 @@ protected:
   std::optional<unsigned> findPrimalPivotColumn();
   std::optional<unsigned> findPrimalPivotRow(unsigned pivotColumn);
   void multiplyRow(unsigned row, int factor);
-  void addMultipleOfRow(unsigned sourceRow, int factor, unsigned targetRow);
+  void addMultipleOfRow(unsigned sourceRow, int factor, unsigned targetRow,
+                        ArrayRef<unsigned> columns);
   void pivot(unsigned pivotRow, unsigned pivotColumn);
   LogicalResult solveTableau();
   LogicalResult restoreDualFeasibility();
@@ -174,6 +196,9 @@ protected:
   LogicalResult scheduleAt(unsigned startTimeVariable, unsigned timeStep);
   void moveBy(unsigned startTimeVariable, unsigned amount);
   unsigned getStartTime(unsigned startTimeVariable);
+  std::optional<unsigned> findRow(unsigned variable);
+  std::optional<unsigned> findColumn(unsigned variable);
+  void eraseRow(unsigned row);
 
   void dumpTableau();
 
@@ -181,6 +206,30 @@ public:
   explicit SimplexSchedulerBase(Operation *lastOp) : lastOp(lastOp) {}
   virtual ~SimplexSchedulerBase() = default;
   virtual LogicalResult schedule() = 0;
+
+  /// Return true if a tableau has been built, i.e. the next call to
+  /// `schedule()` will be warm-started.
+  bool hasTableau() { return tableauBuilt; }
+  /// Throw away the tableau, such that the next call to `schedule()` starts
+  /// from scratch.
+  void discardTableau();
+  /// Return the number of pivot steps performed on the current tableau.
+  unsigned getNumPivots() { return numPivots; }
+
+  /// Add a row modeling the precedence constraint of \p dep, which must
+  /// already be part of the problem, to the tableau. The row is expressed in
+  /// terms of the current basis, so dual feasibility is retained and the next
+  /// `schedule()` only has to perform the dual pivot steps required to make
+  /// the new constraint hold.
+  LogicalResult addDependenceConstraint(Problem::Dependence dep);
+  /// Remove the row modeling \p dep from the tableau and restore optimality.
+  /// Fails if the constraint cannot be removed in place, in which case the
+  /// tableau must be discarded.
+  LogicalResult removeDependenceConstraint(Problem::Dependence dep);
+  /// Shift the constant term of the constraints originating at operations
+  /// linked to \p opr by \p delta, i.e. account for a latency change of
+  /// \p opr.
+  void shiftDependenceConstraints(Problem::OperatorType opr, int delta);
 };
 
 /// This class solves the basic, acyclic `Problem`.
@@ -342,10 +391,10 @@ void SimplexSchedulerBase::fillConstraintRow(SmallVector<int> &row,
   Operation *src = dep.getSource();
   Operation *dst = dep.getDestination();
   unsigned latency = *prob.getLatency(*prob.getLinkedOperatorType(src));
-  row[parameter1Column] = -latency; // note the negation
+  row[parameter1Column] -= latency; // note the negation
   if (src != dst) { // note that these coefficients just zero out in self-arcs.
-    row[startTimeLocations[startTimeVariables[src]]] = 1;
-    row[startTimeLocations[startTimeVariables[dst]]] = -1;
+    addStartTimeTerm(row, startTimeVariables[src], 1);
+    addStartTimeTerm(row, startTimeVariables[dst], -1);
   }
 }
 
@@ -356,8 +405,28 @@ void SimplexSchedulerBase::fillAdditionalConstraintRow(
   (void)dep;
 }
 
+/// Add \p coeff times the given start time variable to \p row. In a freshly
+/// built tableau, all start time variables are non-basic, and this simply
+/// updates the variable's column. When adding rows to a solved tableau, a basic
+/// variable is substituted by the row it is currently defined by.
+void SimplexSchedulerBase::addStartTimeTerm(SmallVector<int> &row,
+                                            unsigned startTimeVariable,
+                                            int coeff) {
+  int loc = startTimeLocations[startTimeVariable];
+  if (loc >= (int)firstNonBasicVariableColumn) {
+    row[loc] += coeff;
+    return;
+  }
+
+  // The defining row reads `var + ~A[r] * x = ~B[r] * u`.
+  auto &defRow = tableau[-loc];
+  for (unsigned col = 0; col < nColumns; ++col)
+    row[col] -= coeff * defRow[col];
+}
+
 void SimplexSchedulerBase::buildTableau() {
   auto &prob = getProblem();
+  assert(!tableauBuilt && "tableau already built");
 
   // The initial tableau is constructed so that operations' start time variables
   // are out of basis, whereas all slack variables are in basis. We will number
@@ -396,6 +465,7 @@ void SimplexSchedulerBase::buildTableau() {
       auto &consRowVec = addRow();
       fillConstraintRow(consRowVec, dep);
       basicVariables.push_back(var);
+      slackVariables[dep] = var;
       ++var;
     }
   }
@@ -408,6 +478,22 @@ void SimplexSchedulerBase::buildTableau() {
 
   // one row per objective + one row per dependence
   nRows = tableau.size();
+  nVariables = var;
+  tableauBuilt = true;
+}
+
+void SimplexSchedulerBase::discardTableau() {
+  tableau.clear();
+  implicitBasicVariableColumnVector.clear();
+  nonBasicVariables.clear();
+  basicVariables.clear();
+  startTimeVariables.clear();
+  startTimeLocations.clear();
+  frozenVariables.clear();
+  slackVariables.clear();
+  nVariables = nRows = nColumns = nObjectives = 0;
+  numPivots = 0;
+  tableauBuilt = false;
 }
 
 int SimplexSchedulerBase::getParametricConstant(unsigned row) {
@@ -517,17 +603,25 @@ SimplexSchedulerBase::findPrimalPivotRow(unsigned pivotColumn) {
 
 void SimplexSchedulerBase::multiplyRow(unsigned row, int factor) {
   assert(factor != 0);
+  if (factor == 1)
+    return;
   for (unsigned col = 0; col < nColumns; ++col)
     tableau[row][col] *= factor;
   // Also multiply the corresponding entry in the temporary column vector.
   implicitBasicVariableColumnVector[row] *= factor;
 }
 
+/// Add \p factor times \p sourceRow to \p targetRow. Only the given \p columns
+/// are updated; these must include all columns in which \p sourceRow has a
+/// non-zero entry.
 void SimplexSchedulerBase::addMultipleOfRow(unsigned sourceRow, int factor,
-                                            unsigned targetRow) {
+                                            unsigned targetRow,
+                                            ArrayRef<unsigned> columns) {
   assert(factor != 0 && sourceRow != targetRow);
-  for (unsigned col = 0; col < nColumns; ++col)
-    tableau[targetRow][col] += tableau[sourceRow][col] * factor;
+  auto &sourceRowVec = tableau[sourceRow];
+  auto &targetRowVec = tableau[targetRow];
+  for (unsigned col : columns)
+    targetRowVec[col] += sourceRowVec[col] * factor;
   // Again, perform row operation on the temporary column vector as well.
   implicitBasicVariableColumnVector[targetRow] +=
       implicitBasicVariableColumnVector[sourceRow] * factor;
@@ -548,6 +642,14 @@ void SimplexSchedulerBase::pivot(unsigned pivotRow, unsigned pivotColumn) {
   // Make `tableau[pivotRow][pivotColumn]` := 1
   multiplyRow(pivotRow, 1 / pivotElem);
 
+  // Collect the pivot row's non-zero columns once, and only update these in
+  // the other rows.
+  pivotRowSupport.clear();
+  auto &pivotRowVec = tableau[pivotRow];
+  for (unsigned col = 0; col < nColumns; ++col)
+    if (pivotRowVec[col] != 0)
+      pivotRowSupport.push_back(col);
+
   for (unsigned row = 0; row < nRows; ++row) {
     if (row == pivotRow)
       continue;
@@ -557,7 +659,7 @@ void SimplexSchedulerBase::pivot(unsigned pivotRow, unsigned pivotColumn) {
       continue; // nothing to do
 
     // Make `tableau[row][pivotColumn]` := 0.
-    addMultipleOfRow(pivotRow, -elem, row);
+    addMultipleOfRow(pivotRow, -elem, row, pivotRowSupport);
   }
 
   // Swap the pivot column with the implicitly constructed column vector.
@@ -581,6 +683,7 @@ void SimplexSchedulerBase::pivot(unsigned pivotRow, unsigned pivotColumn) {
 
   // Record the swap in the variable lists.
   std::swap(nonBasicVar, basicVar);
+  ++numPivots;
 }
 
 LogicalResult SimplexSchedulerBase::solveTableau() {
@@ -772,6 +875,110 @@ unsigned SimplexSchedulerBase::getStartTime(unsigned startTimeVariable) {
   return getParametricConstant(-startTimeLocations[startTimeVariable]);
 }
 
+std::optional<unsigned> SimplexSchedulerBase::findRow(unsigned variable) {
+  auto *it = llvm::find(basicVariables, variable);
+  if (it == basicVariables.end())
+    return std::nullopt;
+  return firstConstraintRow + std::distance(basicVariables.begin(), it);
+}
+
+std::optional<unsigned> SimplexSchedulerBase::findColumn(unsigned variable) {
+  auto *it = llvm::find(nonBasicVariables, variable);
+  if (it == nonBasicVariables.end())
+    return std::nullopt;
+  return firstNonBasicVariableColumn +
+         std::distance(nonBasicVariables.begin(), it);
+}
+
+/// Remove a constraint row. The row's basic variable occurs in no other row,
+/// hence dropping it does not affect the rest of the tableau.
+void SimplexSchedulerBase::eraseRow(unsigned row) {
+  assert(row >= firstConstraintRow && row < nRows);
+  assert(basicVariables[row - firstConstraintRow] >=
+             startTimeLocations.size() &&
+         "cannot erase the row of a start time variable");
+
+  tableau.erase(tableau.begin() + row);
+  implicitBasicVariableColumnVector.erase(
+      implicitBasicVariableColumnVector.begin() + row);
+  basicVariables.erase(basicVariables.begin() + (row - firstConstraintRow));
+  --nRows;
+
+  // Start time variables in subsequent rows move up by one.
+  for (int &loc : startTimeLocations)
+    if (-loc > (int)row)
+      ++loc;
+}
+
+LogicalResult
+SimplexSchedulerBase::addDependenceConstraint(Problem::Dependence dep) {
+  assert(tableauBuilt);
+  if (!frozenVariables.empty() || !startTimeVariables.count(dep.getSource()) ||
+      !startTimeVariables.count(dep.getDestination()))
+    return failure();
+  if (slackVariables.count(dep))
+    return success();
+
+  SmallVector<int> row(nColumns, 0);
+  fillConstraintRow(row, dep);
+  tableau.push_back(std::move(row));
+  implicitBasicVariableColumnVector.push_back(0);
+  basicVariables.push_back(nVariables);
+  slackVariables[dep] = nVariables;
+  ++nVariables;
+  ++nRows;
+  return success();
+}
+
+LogicalResult
+SimplexSchedulerBase::removeDependenceConstraint(Problem::Dependence dep) {
+  assert(tableauBuilt);
+  if (!frozenVariables.empty())
+    return failure();
+  auto it = slackVariables.find(dep);
+  if (it == slackVariables.end())
+    return success();
+  unsigned slackVar = it->second;
+
+  // A tight constraint has its slack variable out of basis. Bring it into
+  // basis with a primal pivot step, which retains primal feasibility. If there
+  // is no suitable pivot row, the slack could grow without bound; give up in
+  // this case and let the caller rebuild the tableau.
+  if (auto col = findColumn(slackVar)) {
+    auto pivotRow = findPrimalPivotRow(*col);
+    if (!pivotRow)
+      return failure();
+    pivot(*pivotRow, *col);
+  }
+
+  eraseRow(*findRow(slackVar));
+  slackVariables.erase(it);
+
+  // Relaxing a constraint may allow the objective to improve further.
+  return restoreDualFeasibility();
+}
+
+void SimplexSchedulerBase::shiftDependenceConstraints(Problem::OperatorType opr,
+                                                      int delta) {
+  auto &prob = getProblem();
+  assert(tableauBuilt);
+  if (delta == 0)
+    return;
+
+  // Increasing the latency in `slack + t_src - t_dst = -latency` by `delta` is
+  // equivalent to substituting `slack := slack' + delta`.
+  for (auto [dep, slackVar] : slackVariables) {
+    if (*prob.getLinkedOperatorType(dep.getSource()) != opr)
+      continue;
+    if (auto row = findRow(slackVar)) {
+      tableau[*row][parameter1Column] -= delta;
+      continue;
+    }
+    translate(*findColumn(slackVar), /* factor1= */ delta, /* factorS= */ 0,
+              /* factorT= */ 0);
+  }
+}
+
 void SimplexSchedulerBase::dumpTableau() {
   for (unsigned j = 0; j < nColumns; ++j)
     dbgs() << "====";
@@ -812,9 +1019,11 @@ LogicalResult SimplexScheduler::schedule() {
   if (failed(checkLastOp()))
     return failure();
 
-  parameterS = 0;
-  parameterT = 0;
-  buildTableau();
+  if (!tableauBuilt) {
+    parameterS = 0;
+    parameterT = 0;
+    buildTableau();
+  }
 
   LLVM_DEBUG(dbgs() << "Initial tableau:\n"; dumpTableau());
 
@@ -841,16 +1050,18 @@ void CyclicSimplexScheduler::fillConstraintRow(SmallVector<int> &row,
                                                Problem::Dependence dep) {
   SimplexSchedulerBase::fillConstraintRow(row, dep);
   if (auto dist = prob.getDistance(dep))
-    row[parameterTColumn] = *dist;
+    row[parameterTColumn] += *dist;
 }
 
 LogicalResult CyclicSimplexScheduler::schedule() {
   if (failed(checkLastOp()))
     return failure();
 
-  parameterS = 0;
-  parameterT = 1;
-  buildTableau();
+  if (!tableauBuilt) {
+    parameterS = 0;
+    parameterT = 1;
+    buildTableau();
+  }
 
   LLVM_DEBUG(dbgs() << "Initial tableau:\n"; dumpTableau());
 
@@ -1365,3 +1576,89 @@ LogicalResult scheduling::scheduleSimplex(ChainingCyclicProblem &prob,
   ChainingCyclicSimplexScheduler simplex(prob, lastOp, cycleTime);
   return simplex.schedule();
 }
+
+//===----------------------------------------------------------------------===//
+// IncrementalSimplexScheduler
+//===----------------------------------------------------------------------===//
+
+class scheduling::IncrementalSimplexScheduler::Impl {
+public:
+  Impl(Problem &prob, std::unique_ptr<SimplexSchedulerBase> scheduler,
+       bool isCyclic)
+      : prob(prob), scheduler(std::move(scheduler)), isCyclic(isCyclic) {}
+
+  Problem &prob;
+  std::unique_ptr<SimplexSchedulerBase> scheduler;
+  /// The II is only ever increased while solving, so relaxing a cyclic problem
+  /// requires a rebuild to find the potentially smaller II.
+  bool isCyclic;
+  unsigned lastNumPivots = 0;
+};
+
+IncrementalSimplexScheduler::IncrementalSimplexScheduler(Problem &prob,
+                                                         Operation *lastOp)
+    : impl(std::make_unique<Impl>(
+          prob, std::make_unique<SimplexScheduler>(prob, lastOp),
+          /*isCyclic=*/false)) {}
+
+IncrementalSimplexScheduler::IncrementalSimplexScheduler(CyclicProblem &prob,
+                                                         Operation *lastOp)
+    : impl(std::make_unique<Impl>(
+          prob, std::make_unique<CyclicSimplexScheduler>(prob, lastOp),
+          /*isCyclic=*/true)) {}
+
+IncrementalSimplexScheduler::~IncrementalSimplexScheduler() = default;
+
+LogicalResult IncrementalSimplexScheduler::schedule() {
+  auto &scheduler = *impl->scheduler;
+  unsigned pivotsBefore = scheduler.hasTableau() ? scheduler.getNumPivots() : 0;
+  auto result = scheduler.schedule();
+  impl->lastNumPivots = scheduler.getNumPivots() - pivotsBefore;
+  // A failed solve leaves the tableau in an unusable state.
+  if (failed(result))
+    scheduler.discardTableau();
+  return result;
+}
+
+LogicalResult
+IncrementalSimplexScheduler::insertDependence(Problem::Dependence dep) {
+  auto &scheduler = *impl->scheduler;
+  if (failed(impl->prob.insertDependence(dep)))
+    return failure();
+  if (scheduler.hasTableau() &&
+      failed(scheduler.addDependenceConstraint(dep)))
+    scheduler.discardTableau();
+  return success();
+}
+
+LogicalResult
+IncrementalSimplexScheduler::eraseDependence(Problem::Dependence dep) {
+  auto &scheduler = *impl->scheduler;
+  if (failed(impl->prob.eraseDependence(dep)))
+    return failure();
+  if (scheduler.hasTableau() &&
+      (impl->isCyclic || failed(scheduler.removeDependenceConstraint(dep))))
+    scheduler.discardTableau();
+  return success();
+}
+
+void IncrementalSimplexScheduler::setLatency(Problem::OperatorType opr,
+                                             unsigned latency) {
+  auto &scheduler = *impl->scheduler;
+  auto oldLatency = impl->prob.getLatency(opr);
+  impl->prob.setLatency(opr, latency);
+  if (!scheduler.hasTableau())
+    return;
+
+  if (!oldLatency || (impl->isCyclic && latency < *oldLatency)) {
+    scheduler.discardTableau();
+    return;
+  }
+
+  // Only the constant terms change, which retains dual feasibility.
+  scheduler.shiftDependenceConstraints(opr, (int)latency - (int)*oldLatency);
+}
+
+unsigned IncrementalSimplexScheduler::getNumPivots() {
+  return impl->lastNumPivots;
+}
@@ -0,0 +1,259 @@
+//===- PassTelemetry.cpp - Machine-readable pass telemetry ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Support/PassTelemetry.h"
+#include "circt/Support/ResourceUsage.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/Pass/Pass.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+using namespace circt;
+using namespace mlir;
+using llvm::sys::TimePoint;
+
+//===----------------------------------------------------------------------===//
+// Instrumentation
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The instrumentation feeding a `PassTelemetry` collector. Passes and nested
+/// pipelines may execute concurrently on multiple threads, so all state is
+/// keyed by thread and guarded by a mutex.
+class PassTelemetryInstrumentation : public PassInstrumentation {
+public:
+  PassTelemetryInstrumentation(PassTelemetry &telemetry)
+      : telemetry(telemetry) {}
+
+  void runBeforePipeline(std::optional<OperationName> name,
+                         const PipelineParentInfo &parentInfo) override;
+  void runAfterPipeline(std::optional<OperationName> name,
+                        const PipelineParentInfo &parentInfo) override;
+  void runBeforePass(Pass *pass, Operation *op) override;
+  void runAfterPass(Pass *pass, Operation *op) override;
+  void runAfterPassFailed(Pass *pass, Operation *op) override;
+
+private:
+  void finishPass(Pass *pass, Operation *op, bool failed);
+
+  /// The time spent in nested pipelines spawned by a single pass execution.
+  struct ParallelRegion {
+    llvm::SmallDenseSet<uint64_t, 8> threads;
+    double busySeconds = 0.0;
+  };
+  using RegionKey = std::pair<uint64_t, Pass *>;
+
+  PassTelemetry &telemetry;
+  std::mutex mutex;
+  /// Stack of in-flight passes and pipelines per thread.
+  DenseMap<uint64_t, SmallVector<PassTelemetry::Event, 4>> stacks;
+  /// Nested pipeline activity, keyed by the parent's thread and pass.
+  DenseMap<RegionKey, ParallelRegion> regions;
+};
+} // namespace
+
+/// Count the operations nested under and including `op`.
+static size_t countOps(Operation *op) {
+  size_t count = 0;
+  op->walk([&](Operation *) { ++count; });
+  return count;
+}
+
+/// Return a short human-readable name for a pass. Pass adaptors have no
+/// argument and print their entire nested pipeline, so use the class name.
+static std::string getPassName(Pass *pass) {
+  if (!pass->getArgument().empty())
+    return pass->getArgument().str();
+  return pass->getName().str();
+}
+
+void PassTelemetryInstrumentation::runBeforePipeline(
+    std::optional<OperationName> name, const PipelineParentInfo &parentInfo) {
+  PassTelemetry::Event event;
+  event.name = name ? name->getStringRef().str() : "any";
+  event.category = "pipeline";
+  event.opName = event.name;
+  event.threadId = llvm::get_threadid();
+  event.start = TimePoint<>::clock::now();
+  std::lock_guard<std::mutex> lock(mutex);
+  stacks[event.threadId].push_back(std::move(event));
+}
+
+void PassTelemetryInstrumentation::runAfterPipeline(
+    std::optional<OperationName> name, const PipelineParentInfo &parentInfo) {
+  auto end = TimePoint<>::clock::now();
+  auto threadId = llvm::get_threadid();
+  PassTelemetry::Event event;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    event = stacks[threadId].pop_back_val();
+    auto &region = regions[{parentInfo.parentThreadID, parentInfo.parentPass}];
+    region.threads.insert(threadId);
+    region.busySeconds +=
+        std::chrono::duration<double>(end - event.start).count();
+  }
+  event.end = end;
+  telemetry.addEvent(std::move(event));
+}
+
+void PassTelemetryInstrumentation::runBeforePass(Pass *pass, Operation *op) {
+  PassTelemetry::Event event;
+  event.name = getPassName(pass);
+  event.category = "pass";
+  event.opName = op->getName().getStringRef().str();
+  event.threadId = llvm::get_threadid();
+  event.opsBefore = countOps(op);
+  event.mallocBefore = llvm::sys::Process::GetMallocUsage();
+  event.start = TimePoint<>::clock::now();
+  std::lock_guard<std::mutex> lock(mutex);
+  stacks[event.threadId].push_back(std::move(event));
+}
+
+void PassTelemetryInstrumentation::runAfterPass(Pass *pass, Operation *op) {
+  finishPass(pass, op, /*failed=*/false);
+}
+
+void PassTelemetryInstrumentation::runAfterPassFailed(Pass *pass,
+                                                      Operation *op) {
+  finishPass(pass, op, /*failed=*/true);
+}
+
+void PassTelemetryInstrumentation::finishPass(Pass *pass, Operation *op,
+                                              bool failed) {
+  auto end = TimePoint<>::clock::now();
+  auto threadId = llvm::get_threadid();
+  PassTelemetry::Event event;
+  std::optional<ParallelRegion> region;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    event = stacks[threadId].pop_back_val();
+    auto it = regions.find({threadId, pass});
+    if (it != regions.end()) {
+      region = std::move(it->second);
+      regions.erase(it);
+    }
+  }
+  event.end = end;
+  event.failed = failed;
+  // The IR may be in an invalid state after a failure, so don't walk it.
+  event.opsAfter = failed ? event.opsBefore : countOps(op);
+  event.mallocAfter = llvm::sys::Process::GetMallocUsage();
+  event.peakRSS = getPeakRSS();
+  if (region) {
+    auto wall = std::chrono::duration<double>(end - event.start).count();
+    event.numThreads = region->threads.size();
+    if (wall > 0)
+      event.utilization = region->busySeconds / (wall * event.numThreads);
+  }
+  telemetry.addEvent(std::move(event));
+}
+
+//===----------------------------------------------------------------------===//
+// Collector
+//===----------------------------------------------------------------------===//
+
+PassTelemetry::PassTelemetry() : origin(TimePoint::clock::now()) {}
+
+std::unique_ptr<PassInstrumentation> PassTelemetry::createInstrumentation() {
+  return std::make_unique<PassTelemetryInstrumentation>(*this);
+}
+
+void PassTelemetry::addEvent(Event event) {
+  std::lock_guard<std::mutex> lock(mutex);
+  threadNumbers.try_emplace(event.threadId, threadNumbers.size());
+  events.push_back(std::move(event));
+}
+
+void PassTelemetry::print(raw_ostream &os) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto micros = [&](TimePoint time) -> int64_t {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - origin)
+        .count();
+  };
+
+  llvm::json::OStream json(os, 2);
+  json.objectBegin();
+  json.attribute("displayTimeUnit", "ms");
+  json.attributeArray("traceEvents", [&] {
+    // Name the threads such that trace viewers show stable labels.
+    for (unsigned number = 0, e = threadNumbers.size(); number != e; ++number) {
+      json.object([&] {
+        json.attribute("name", "thread_name");
+        json.attribute("ph", "M");
+        json.attribute("pid", 1);
+        json.attribute("tid", number);
+        json.attributeObject("args", [&] {
+          json.attribute("name", "thread " + std::to_string(number));
+        });
+      });
+    }
+
+    for (auto &event : events) {
+      auto tid = threadNumbers.lookup(event.threadId);
+      json.object([&] {
+        json.attribute("name", event.name);
+        json.attribute("cat", event.category);
+        json.attribute("ph", "X");
+        json.attribute("pid", 1);
+        json.attribute("tid", tid);
+        json.attribute("ts", micros(event.start));
+        json.attribute("dur", micros(event.end) - micros(event.start));
+        json.attributeObject("args", [&] {
+          json.attribute("op", event.opName);
+          if (event.category != "pass")
+            return;
+          json.attribute("opsBefore", int64_t(event.opsBefore));
+          json.attribute("opsAfter", int64_t(event.opsAfter));
+          json.attribute("opsDelta",
+                         int64_t(event.opsAfter) - int64_t(event.opsBefore));
+          json.attribute("mallocDelta", int64_t(event.mallocAfter) -
+                                            int64_t(event.mallocBefore));
+          json.attribute("peakRSS", int64_t(event.peakRSS));
+          if (event.numThreads > 0) {
+            json.attribute("threads", event.numThreads);
+            json.attribute("utilization", event.utilization);
+          }
+          if (event.failed)
+            json.attribute("failed", true);
+        });
+      });
+
+      // Emit a counter sample such that memory shows up as a graph.
+      if (event.category != "pass")
+        continue;
+      json.object([&] {
+        json.attribute("name", "memory");
+        json.attribute("ph", "C");
+        json.attribute("pid", 1);
+        json.attribute("ts", micros(event.end));
+        json.attributeObject("args", [&] {
+          json.attribute("malloc", int64_t(event.mallocAfter));
+          json.attribute("peakRSS", int64_t(event.peakRSS));
+        });
+      });
+    }
+  });
+  json.objectEnd();
+  os << "\n";
+}
+
+LogicalResult PassTelemetry::writeToFile(StringRef path) const {
+  std::error_code ec;
+  llvm::ToolOutputFile outputFile(path, ec, llvm::sys::fs::OF_None);
+  if (ec) {
+    llvm::errs() << "unable to open pass telemetry file '" << path
+                 << "': " << ec.message() << "\n";
+    return failure();
+  }
+  print(outputFile.os());
+  outputFile.keep();
+  return success();
+}
@@ -14,12 +14,18 @@
 // memory O(linewidth).
 //
 // This has been adjusted from the paper:
-// * Deque for tokens instead of ringbuffer + left/right cursors.
+// * Growable buffer for tokens instead of ringbuffer + left/right cursors.
 //   This is simpler to reason about and allows us to easily grow the buffer
 //   to accommodate longer widths when needed (and not reserve 3*linewidth).
+//   Tokens are bump-allocated at the end of the buffer, and the buffer is
+//   reset once all of its tokens have been printed.
 //   Since scanStack references buffered tokens by index, we track an offset
 //   that we increase when dropping off the front.
 //   When the scan stack is cleared the buffer is reset, including this offset.
+// * Fast path for groups that fit: as soon as the sizes of all buffered tokens
+//   are known, they are printed instead of waiting for the buffer to fill a
+//   line. Groups known to fit on the current line are printed in one go,
+//   without tracking any of their nested groups on the print stack.
 // * Indentation tracked from left not relative to margin (linewidth).
 // * Indentation emitted lazily, avoid trailing whitespace.
 // * Group indentation styles: Visual and Block, set on 'begin' tokens.
@@ -75,6 +81,18 @@ namespace pretty {
 /// Destructor, anchor.
 PrettyPrinter::Listener::~Listener() = default;
 
+/// Drop the printed tokens from the front of the token buffer once there are
+/// at least this many, and they make up at least half of the buffer.
+static constexpr uint32_t compactThreshold = 1024;
+
+/// Return the width of a token when printed without breaking.
+static int32_t getTokenWidth(const Token &t) {
+  return llvm::TypeSwitch<const Token *, int32_t>(&t)
+      .Case([&](const BreakToken *b) { return b->spaces(); })
+      .Case([&](const StringToken *s) { return s->text().size(); })
+      .Default([](const auto *) { return 0; });
+}
+
 /// Add token for printing.  In Oppen, this is "scan".
 void PrettyPrinter::add(Token t) {
   // Add token to tokens, and add its index to scanStack.
@@ -97,10 +115,15 @@ void PrettyPrinter::add(Token t) {
         checkStream();
       })
       .Case([&](BreakToken *b) {
-        if (scanStack.empty())
-          clear();
-        else
+        if (!scanStack.empty())
           checkStack();
+        // Once the sizes of all buffered tokens are known, print them right
+        // away. This keeps the buffer short and lets it be reset often.
+        if (scanStack.empty()) {
+          if (firstToken != tokens.size())
+            advanceLeft();
+          clear();
+        }
         addScanToken(-rightTotal);
         rightTotal += b->spaces();
         assert(rightTotal > 0);
@@ -130,7 +153,7 @@ void PrettyPrinter::rebaseIfNeeded() {
   // Check for too-large totals, reset.
   // This can happen if we have an open group and emit
   // many tokens, especially newlines which have artificial size.
-  if (tokens.empty())
+  if (firstToken == tokens.size())
     return;
   assert(leftTotal >= 0);
   assert(rightTotal >= 0);
@@ -167,9 +190,10 @@ void PrettyPrinter::eof() {
 
 void PrettyPrinter::clear() {
   assert(scanStack.empty() && "clearing tokens while still on scan stack");
-  assert(tokens.empty());
+  assert(firstToken == tokens.size());
   leftTotal = rightTotal = 1;
   tokens.clear();
+  firstToken = 0;
   tokenOffset = 0;
   if (listener && !donotClear)
     listener->clear();
@@ -205,15 +229,15 @@ void PrettyPrinter::checkStack() {
 /// If scan size is wider than line, it's infinity.
 void PrettyPrinter::checkStream() {
   // While buffer needs more than 1 line to print, print and consume.
-  assert(!tokens.empty());
+  assert(firstToken != tokens.size());
   assert(leftTotal >= 0);
   assert(rightTotal >= 0);
-  while (rightTotal - leftTotal > space && !tokens.empty()) {
+  while (rightTotal - leftTotal > space && firstToken != tokens.size()) {
 
     // Ran out of space, set size to infinity and take off scan stack.
     // No need to keep track as we know enough to know this won't fit.
-    if (!scanStack.empty() && tokenOffset == scanStack.front()) {
-      tokens.front().size = kInfinity;
+    if (!scanStack.empty() && tokenOffset + firstToken == scanStack.front()) {
+      tokens[firstToken].size = kInfinity;
       scanStack.pop_front();
     }
     advanceLeft();
@@ -222,19 +246,67 @@ void PrettyPrinter::checkStream() {
 
 /// Print out tokens we know sizes for, and drop from token buffer.
 void PrettyPrinter::advanceLeft() {
-  assert(!tokens.empty());
+  assert(firstToken != tokens.size());
 
-  while (!tokens.empty() && tokens.front().size >= 0) {
-    const auto &f = tokens.front();
+  while (firstToken != tokens.size() && tokens[firstToken].size >= 0) {
+    const auto &f = tokens[firstToken];
+    // A group whose size is known to fit never breaks. Its end token is
+    // buffered, since the size of a group is only known after its end.
+    if (isa<BeginToken>(&f.token) && f.size <= space) {
+      printFittingGroup();
+      continue;
+    }
     print(f);
-    leftTotal +=
-        llvm::TypeSwitch<const Token *, int32_t>(&f.token)
-            .Case([&](const BreakToken *b) { return b->spaces(); })
-            .Case([&](const StringToken *s) { return s->text().size(); })
-            .Default([](const auto *) { return 0; });
-    tokens.pop_front();
-    ++tokenOffset;
+    leftTotal += getTokenWidth(f.token);
+    popFrontToken();
+  }
+}
+
+/// Print a group that fits on the current line. None of its breaks, including
+/// those of nested groups, are broken, which is what printing the group token
+/// by token would do as well. Nested groups don't need a print stack entry.
+void PrettyPrinter::printFittingGroup() {
+  unsigned depth = 0;
+  do {
+    assert(firstToken != tokens.size() && "fitting group without end");
+    const auto &f = tokens[firstToken];
+    if (isa<BeginToken>(&f.token)) {
+      ++depth;
+    } else if (isa<EndToken>(&f.token)) {
+      --depth;
+    } else if (auto *b = dyn_cast<BreakToken>(&f.token)) {
+      space -= b->spaces();
+      pendingIndentation += b->spaces();
+    } else {
+      print(f);
+    }
+    leftTotal += getTokenWidth(f.token);
+    popFrontToken();
+  } while (depth);
+
+  // Leaving the group restores the indentation of the enclosing group, like
+  // printing the end token does.
+  auto &frame = getPrintFrame();
+  if (frame.breaks != PrintBreaks::Fits &&
+      frame.breaks != PrintBreaks::AlwaysFits)
+    indent = frame.offset;
+}
+
+void PrettyPrinter::popFrontToken() {
+  ++firstToken;
+  // Reset the buffer once all tokens have been printed. If it does not drain
+  // for a long time, drop the printed tokens from the front instead, such that
+  // the buffer does not grow with the tokens printed so far.
+  if (firstToken == tokens.size()) {
+    tokens.clear();
+  } else if (firstToken >= compactThreshold &&
+             2 * firstToken >= tokens.size()) {
+    tokens.erase(tokens.begin(), tokens.begin() + firstToken);
+  } else {
+    return;
   }
+  tokenOffset += firstToken;
+  firstToken = 0;
 }
 
 /// Compute indentation w/o overflow, clamp to [0,maxStartingIndent].
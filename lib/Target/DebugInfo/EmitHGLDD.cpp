@@ -32,9 +32,6 @@ using namespace debug;
 using llvm::MapVector;
 using llvm::SmallMapVector;
 
-using JValue = llvm::json::Value;
-using JArray = llvm::json::Array;
-using JObject = llvm::json::Object;
 using JOStream = llvm::json::OStream;
 
 /// Walk the given `loc` and collect file-line-column locations that we want to
@@ -98,22 +95,40 @@ static FileLineColLoc findBestLocation(Location loc, bool emitted,
   return {};
 }
 
-// Allow `json::Value`s to be used as map keys for the purpose of struct
-// definition uniquification. This abuses the `null` and `[null]` JSON values as
-// markers, and uses a very inefficient hashing of the value's JSON string.
-namespace llvm {
-template <>
-struct DenseMapInfo<JValue> {
-  static JValue getEmptyKey() { return nullptr; }
-  static JValue getTombstoneKey() { return JArray({nullptr}); }
-  static unsigned getHashValue(const JValue &x) {
-    SmallString<128> buffer;
-    llvm::raw_svector_ostream(buffer) << x;
-    return hash_value(buffer);
+/// Serialize the JSON value written by `fn` in compact form.
+static std::string emitCompactJSON(llvm::function_ref<void(JOStream &)> fn) {
+  std::string buffer;
+  {
+    llvm::raw_string_ostream os(buffer);
+    JOStream json(os);
+    fn(json);
   }
-  static bool isEqual(const JValue &a, const JValue &b) { return a == b; }
-};
-} // namespace llvm
+  return buffer;
+}
+
+/// Serialize the JSON object written by `fn`, indented such that it lines up
+/// with the elements of the "objects" array of an HGLDD file. The object is
+/// nested within two dummy arrays to achieve this, which `emitRawObject`
+/// strips again.
+static std::string emitIndentedObject(llvm::function_ref<void(JOStream &)> fn) {
+  std::string buffer;
+  {
+    llvm::raw_string_ostream os(buffer);
+    JOStream json(os, 2);
+    json.arrayBegin(); // dummy for indentation
+    json.arrayBegin(); // dummy for indentation
+    fn(json);
+    json.arrayEnd(); // dummy for indentation
+    json.arrayEnd(); // dummy for indentation
+  }
+  return buffer;
+}
+
+/// A marker around the index of a struct definition in the JSON emitted for a
+/// module. Struct definitions only receive their final name once all modules
+/// have been emitted, at which point the marked indices are replaced with the
+/// names. Emitted JSON strings never contain this character unescaped.
+static constexpr char structIndexMarker = '\x01';
 
 /// Make the given `path` relative to the `relativeTo` path and store the result
 /// in `relativePath`. Returns whether the conversion was successful. Fails if
@@ -195,7 +210,9 @@ struct GlobalState {
   /// A uniquified name for each emitted DI module.
   SmallDenseMap<DIModule *, StringRef> moduleNames;
   /// A namespace used to deduplicate the names of HGLDD "objects" during
-  /// emission. This includes modules and struct type declarations.
+  /// emission. This includes modules and struct type declarations. It only
+  /// contains module names while the files are emitted concurrently, and is
+  /// extended with the struct names afterwards.
   llvm::StringMap<size_t> objectNamespace;
 
   GlobalState(Operation *op, const EmitHGLDDOptions &options)
@@ -208,6 +225,10 @@ struct GlobalState {
 /// An emitted type.
 struct EmittedType {
   StringRef name;
+  /// The index of the struct definition this type refers to, within the
+  /// struct definitions of the file being emitted. The definition's name is
+  /// only known after all files have been emitted.
+  std::optional<unsigned> structDef;
   SmallVector<int64_t, 1> packedDims;
   SmallVector<int64_t, 1> unpackedDims;
 
@@ -226,34 +247,62 @@ struct EmittedType {
   void addPackedDim(int64_t dim) { packedDims.push_back(dim); }
   void addUnpackedDim(int64_t dim) { unpackedDims.push_back(dim); }
 
-  operator bool() const { return !name.empty(); }
+  operator bool() const { return !name.empty() || structDef; }
 
-  static JArray emitDims(ArrayRef<int64_t> dims, bool skipFirstLen1Dim) {
-    JArray json;
+  /// Emit the dimensions as a `field` of the current JSON object, unless there
+  /// are none.
+  static void emitDims(JOStream &json, StringRef field, ArrayRef<int64_t> dims,
+                       bool skipFirstLen1Dim) {
     if (skipFirstLen1Dim && !dims.empty() && dims[0] == 1)
       dims = dims.drop_front();
-    for (auto dim : llvm::reverse(dims)) {
-      json.push_back(dim - 1);
-      json.push_back(0);
-    }
-    return json;
+    if (dims.empty())
+      return;
+    json.attributeArray(field, [&] {
+      for (auto dim : llvm::reverse(dims)) {
+        json.value(dim - 1);
+        json.value(0);
+      }
+    });
+  }
+  void emitPackedDims(JOStream &json) const {
+    emitDims(json, "packed_range", packedDims, true);
+  }
+  void emitUnpackedDims(JOStream &json) const {
+    emitDims(json, "unpacked_range", unpackedDims, false);
   }
-  JArray emitPackedDims() const { return emitDims(packedDims, true); }
-  JArray emitUnpackedDims() const { return emitDims(unpackedDims, false); }
 };
 
-/// An emitted expression and its type.
+/// An emitted expression and its type. The expression is kept as compact JSON
+/// text.
 struct EmittedExpr {
-  JValue expr = nullptr;
+  std::string expr;
   EmittedType type;
-  operator bool() const { return expr != nullptr && type; }
+  operator bool() const { return !expr.empty() && type; }
+};
+
+/// A struct type definition collected while emitting the modules of a file.
+/// The definitions of all files are deduplicated and named once all modules
+/// have been emitted.
+struct StructDef {
+  struct Field {
+    std::string name;
+    EmittedType type;
+    Location loc;
+  };
+  /// The name from which the definition's final name is derived.
+  std::string nameHint;
+  Location loc;
+  SmallVector<Field, 4> fields;
 };
 
 [[maybe_unused]] static llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
                                                       const EmittedType &type) {
   if (!type)
     return os << "<null>";
-  os << type.name;
+  if (type.structDef)
+    os << "struct#" << *type.structDef;
+  else
+    os << type.name;
   for (auto dim : type.packedDims)
     os << '[' << dim << ']';
   if (!type.unpackedDims.empty()) {
@@ -284,13 +333,33 @@ struct FileEmitter {
   SmallString<64> outputFileName;
 
   llvm::StringMap<size_t> moduleNamespace;
+  llvm::StringMap<size_t> scratchNamespace;
   SmallMapVector<StringAttr, std::pair<StringAttr, unsigned>, 8> sourceFiles;
-  SmallMapVector<JValue, StringRef, 8> structDefs;
   SmallString<128> structNameHint;
 
+  /// The JSON objects of the modules, with marked struct definition indices.
+  SmallVector<std::string, 0> rawObjects;
+  /// The struct definitions used by the modules, and their final names.
+  SmallVector<StructDef, 0> structDefs;
+  SmallVector<StringRef, 0> structNames;
+
+  /// A struct definition emitted into this file, along with its final name
+  /// and the final names of the definitions of the file that collected it.
+  struct OwnedStructDef {
+    const StructDef *def;
+    StringRef name;
+    ArrayRef<StringRef> structNames;
+  };
+  SmallVector<OwnedStructDef, 0> ownedStructDefs;
+
+  void emitModules();
   void emit(llvm::raw_ostream &os);
   void emit(JOStream &json);
-  JValue emitLoc(FileLineColLoc loc, FileLineColLoc endLoc, bool emitted);
+  void emitRawObject(JOStream &json, StringRef rawObject);
+  void emitLoc(JOStream &json, FileLineColLoc loc, FileLineColLoc endLoc,
+               bool emitted);
+  void emitStructDef(JOStream &json, const OwnedStructDef &owned);
+  void emitTypeName(JOStream &json, const EmittedType &type);
   void emitModule(JOStream &json, DIModule *module);
   void emitModuleBody(JOStream &json, DIModule *module);
   void emitInstance(JOStream &json, DIInstance *instance);
@@ -307,8 +376,11 @@ struct FileEmitter {
   /// `fieldName`.
   void findAndEmitLoc(JOStream &json, StringRef fieldName, Location loc,
                       bool emitted) {
-    if (auto fileLoc = findBestLocation(loc, emitted))
-      json.attribute(fieldName, emitLoc(fileLoc, {}, emitted));
+    if (auto fileLoc = findBestLocation(loc, emitted)) {
+      json.attributeBegin(fieldName);
+      emitLoc(json, fileLoc, {}, emitted);
+      json.attributeEnd();
+    }
   }
 
   /// Find the best location and, if one is found, emit it under the given
@@ -317,7 +389,9 @@ struct FileEmitter {
   void findAndEmitLocOrGuess(JOStream &json, StringRef fieldName, Operation *op,
                              bool emitted) {
     if (auto fileLoc = findBestLocation(op->getLoc(), emitted)) {
-      json.attribute(fieldName, emitLoc(fileLoc, {}, emitted));
+      json.attributeBegin(fieldName);
+      emitLoc(json, fileLoc, {}, emitted);
+      json.attributeEnd();
       return;
     }
 
@@ -366,16 +440,16 @@ struct FileEmitter {
       return false;
     });
 
-    json.attribute(fieldName, emitLoc(locs.front(), locs.back(), emitted));
+    json.attributeBegin(fieldName);
+    emitLoc(json, locs.front(), locs.back(), emitted);
+    json.attributeEnd();
   }
 
-  /// Find the best locations to report for HGL and HDL and set them as fields
-  /// on the `into` JSON object.
-  void findAndSetLocs(JObject &into, Location loc) {
-    if (auto fileLoc = findBestLocation(loc, false))
-      into["hgl_loc"] = emitLoc(fileLoc, {}, false);
-    if (auto fileLoc = findBestLocation(loc, true))
-      into["hdl_loc"] = emitLoc(fileLoc, {}, true);
+  /// Find the best locations to report for HGL and HDL and emit them as fields
+  /// of the current JSON object.
+  void findAndEmitLocs(JOStream &json, Location loc) {
+    findAndEmitLoc(json, "hgl_loc", loc, false);
+    findAndEmitLoc(json, "hdl_loc", loc, true);
   }
 
   /// Return the legalized and uniquified name of a DI module. Asserts that the
@@ -387,9 +461,7 @@ struct FileEmitter {
     return name;
   }
 
-  StringRef legalizeInModuleNamespace(StringRef name) {
-    return legalizeName(name, moduleNamespace);
-  }
+  StringRef legalizeInModuleNamespace(StringRef name);
 };
 
 } // namespace
@@ -470,6 +542,64 @@ unsigned FileEmitter::getSourceFile(StringAttr sourceFile, bool emitted) {
   return slot.second;
 }
 
+/// Legalize and uniquify a name within the current module. Names within a
+/// module must not collide with the names of objects either. This behaves as
+/// if `moduleNamespace` started out as a copy of the object namespace, but
+/// only pulls in the entries of the object namespace that the uniquification
+/// looks at. Copying the object namespace for every module would take time
+/// quadratic in the number of modules.
+StringRef FileEmitter::legalizeInModuleNamespace(StringRef name) {
+  // Determine the legal base name that is going to be uniquified. Names that
+  // collide with a keyword leave an entry for the base name next to the
+  // uniquified result.
+  scratchNamespace.clear();
+  StringRef legalized = legalizeName(name, scratchNamespace);
+  StringRef base = legalized;
+  bool isKeyword = false;
+  for (auto &entry : scratchNamespace) {
+    if (entry.getKey() != legalized) {
+      base = entry.getKey();
+      isKeyword = true;
+    }
+  }
+
+  auto lookup = [&](StringRef key) -> size_t * {
+    auto it = moduleNamespace.find(key);
+    if (it != moduleNamespace.end())
+      return &it->second;
+    auto objectIt = state.objectNamespace.find(key);
+    if (objectIt == state.objectNamespace.end())
+      return nullptr;
+    return &moduleNamespace.try_emplace(key, objectIt->second).first->second;
+  };
+
+  // Use the base name if it is available, or uniquify it with a numeric suffix
+  // like `sv::resolveKeywordConflict`.
+  size_t *nextID = lookup(base);
+  if (!nextID) {
+    auto &entry = *moduleNamespace.try_emplace(base, 0).first;
+    if (!isKeyword)
+      return entry.getKey();
+    nextID = &entry.second;
+  }
+  SmallString<32> candidate;
+  while (true) {
+    candidate = base;
+    candidate += '_';
+    candidate += llvm::utostr((*nextID)++);
+    if (!lookup(candidate))
+      return moduleNamespace.try_emplace(candidate, 0).first->getKey();
+  }
+}
+
+/// Emit the modules of this file into `rawObjects`, and collect the struct
+/// definitions they use.
+void FileEmitter::emitModules() {
+  for (auto *module : modules)
+    rawObjects.push_back(emitIndentedObject(
+        [&](JOStream &json) { emitModule(json, module); }));
+}
+
 void FileEmitter::emit(llvm::raw_ostream &os) {
   JOStream json(os, 2);
   emit(json);
@@ -478,18 +608,13 @@ void FileEmitter::emit(llvm::raw_ostream &os) {
 
 void FileEmitter::emit(JOStream &json) {
   // The "HGLDD" header field needs to be the first in the JSON file (which
-  // violates the JSON spec, but what can you do). But we only know after module
-  // emission what the contents of the header will be.
-  SmallVector<std::string, 16> rawObjects;
-  for (auto *module : modules) {
-    llvm::raw_string_ostream objectOS(rawObjects.emplace_back());
-    JOStream objectJson(objectOS, 2);
-    objectJson.arrayBegin(); // dummy for indentation
-    objectJson.arrayBegin(); // dummy for indentation
-    emitModule(objectJson, module);
-    objectJson.arrayEnd(); // dummy for indentation
-    objectJson.arrayEnd(); // dummy for indentation
-  }
+  // violates the JSON spec, but what can you do). But we only know after the
+  // modules and struct definitions have been emitted what the contents of the
+  // header will be.
+  SmallVector<std::string, 8> rawStructDefs;
+  for (auto &owned : ownedStructDefs)
+    rawStructDefs.push_back(emitIndentedObject(
+        [&](JOStream &json) { emitStructDef(json, owned); }));
 
   std::optional<unsigned> hdlFileIndex;
   if (hdlFile)
@@ -506,50 +631,108 @@ void FileEmitter::emit(JOStream &json) {
       json.attribute("hdl_file_index", *hdlFileIndex);
   });
   json.attributeArray("objects", [&] {
-    for (auto &[structDef, name] : structDefs)
-      json.value(structDef);
-    for (auto &rawObject : rawObjects) {
-      // The "rawObject" is nested within two dummy arrays (`[[<stuff>]]`) to
-      // make the indentation of the actual object JSON inside line up with the
-      // current scope (`{"objects":[<stuff>]}`). This is a bit of a hack, but
-      // allows us to use the JSON `OStream` API when constructing the modules
-      // above, creating a simple string buffer, instead of building up a
-      // potentially huge in-memory hierarchy of JSON objects for every module
-      // first. To remove the two dummy arrays, we drop the `[` and `]` at the
-      // front and back twice, and trim the remaining whitespace after each
-      // (since the actual string looks a lot more like
-      // `[\n  [\n    <stuff>\n  ]\n]`).
-      json.rawValue(StringRef(rawObject)
-                        .drop_front()
-                        .drop_back()
-                        .trim()
-                        .drop_front()
-                        .drop_back()
-                        .trim());
-    }
+    for (auto &rawObject : rawStructDefs)
+      emitRawObject(json, rawObject);
+    for (auto &rawObject : rawObjects)
+      emitRawObject(json, rawObject);
   });
   json.objectEnd();
 }
 
-JValue FileEmitter::emitLoc(FileLineColLoc loc, FileLineColLoc endLoc,
-                            bool emitted) {
-  JObject obj;
-  obj["file"] = getSourceFile(loc.getFilename(), emitted);
-  if (loc.getLine()) {
-    obj["begin_line"] = loc.getLine();
-    obj["end_line"] = loc.getLine();
-  }
-  if (loc.getColumn()) {
-    obj["begin_column"] = loc.getColumn();
-    obj["end_column"] = loc.getColumn();
-  }
+/// Emit an object produced by `emitIndentedObject` and replace the struct
+/// definition indices marked in it with the definitions' final names.
+void FileEmitter::emitRawObject(JOStream &json, StringRef rawObject) {
+  // The "rawObject" is nested within two dummy arrays (`[[<stuff>]]`) to make
+  // the indentation of the actual object JSON inside line up with the current
+  // scope (`{"objects":[<stuff>]}`). This is a bit of a hack, but allows us to
+  // use the JSON `OStream` API when constructing the objects, creating a
+  // simple string buffer, instead of building up a potentially huge in-memory
+  // hierarchy of JSON objects for every module first. To remove the two dummy
+  // arrays, we drop the `[` and `]` at the front and back twice, and trim the
+  // remaining whitespace after each (since the actual string looks a lot more
+  // like `[\n  [\n    <stuff>\n  ]\n]`).
+  rawObject =
+      rawObject.drop_front().drop_back().trim().drop_front().drop_back().trim();
+  json.rawValue([&](llvm::raw_ostream &os) {
+    while (!rawObject.empty()) {
+      auto pos = rawObject.find(structIndexMarker);
+      os << rawObject.take_front(pos);
+      if (pos == StringRef::npos)
+        break;
+      rawObject = rawObject.drop_front(pos + 1);
+      auto end = rawObject.find(structIndexMarker);
+      unsigned index = 0;
+      rawObject.take_front(end).getAsInteger(10, index);
+      os << structNames[index];
+      rawObject = rawObject.drop_front(end + 1);
+    }
+  });
+}
+
+void FileEmitter::emitLoc(JOStream &json, FileLineColLoc loc,
+                          FileLineColLoc endLoc, bool emitted) {
+  unsigned beginLine = loc.getLine();
+  unsigned beginColumn = loc.getColumn();
+  unsigned endLine = beginLine;
+  unsigned endColumn = beginColumn;
   if (endLoc) {
     if (endLoc.getLine())
-      obj["end_line"] = endLoc.getLine();
+      endLine = endLoc.getLine();
     if (endLoc.getColumn())
-      obj["end_column"] = endLoc.getColumn();
+      endColumn = endLoc.getColumn();
   }
-  return obj;
+
+  // Emit the fields in alphabetical order, like a `json::Object` would.
+  auto file = getSourceFile(loc.getFilename(), emitted);
+  json.objectBegin();
+  if (beginColumn)
+    json.attribute("begin_column", beginColumn);
+  if (beginLine)
+    json.attribute("begin_line", beginLine);
+  if (endColumn)
+    json.attribute("end_column", endColumn);
+  if (endLine)
+    json.attribute("end_line", endLine);
+  json.attribute("file", file);
+  json.objectEnd();
+}
+
+/// Emit a struct definition. Its fields are laid out like variables.
+void FileEmitter::emitStructDef(JOStream &json, const OwnedStructDef &owned) {
+  json.objectBegin();
+  json.attribute("kind", "struct");
+  json.attribute("obj_name", owned.name);
+  findAndEmitLocs(json, owned.def->loc);
+  json.attributeArray("port_vars", [&] {
+    for (auto &field : owned.def->fields) {
+      json.objectBegin();
+      json.attribute("var_name", field.name);
+      findAndEmitLocs(json, field.loc);
+      if (field.type.structDef)
+        json.attribute("type_name", owned.structNames[*field.type.structDef]);
+      else
+        json.attribute("type_name", field.type.name);
+      field.type.emitPackedDims(json);
+      field.type.emitUnpackedDims(json);
+      json.objectEnd();
+    }
+  });
+  json.objectEnd();
+}
+
+/// Emit the name of a type as the `type_name` field of the current JSON
+/// object. Struct types are emitted as marked indices of their definition.
+void FileEmitter::emitTypeName(JOStream &json, const EmittedType &type) {
+  if (!type.structDef) {
+    json.attribute("type_name", type.name);
+    return;
+  }
+  json.attributeBegin("type_name");
+  json.rawValue([&](llvm::raw_ostream &os) {
+    os << '"' << structIndexMarker << *type.structDef << structIndexMarker
+       << '"';
+  });
+  json.attributeEnd();
 }
 
 StringAttr getVerilogModuleName(DIModule &module) {
@@ -568,7 +751,7 @@ StringAttr getVerilogInstanceName(DIInstance &inst) {
 
 /// Emit the debug info for a `DIModule`.
 void FileEmitter::emitModule(JOStream &json, DIModule *module) {
-  moduleNamespace = state.objectNamespace;
+  moduleNamespace.clear();
   structNameHint = module->name.getValue();
   json.objectBegin();
   json.attribute("kind", "module");
@@ -659,11 +842,9 @@ void FileEmitter::emitVariable(JOStream &json, DIVariable *variable) {
     json.attributeBegin("value");
     json.rawValue([&](auto &os) { os << emitted.expr; });
     json.attributeEnd();
-    json.attribute("type_name", emitted.type.name);
-    if (auto dims = emitted.type.emitPackedDims(); !dims.empty())
-      json.attribute("packed_range", std::move(dims));
-    if (auto dims = emitted.type.emitUnpackedDims(); !dims.empty())
-      json.attribute("unpacked_range", std::move(dims));
+    emitTypeName(json, emitted.type);
+    emitted.type.emitPackedDims(json);
+    emitted.type.emitUnpackedDims(json);
   }
 
   json.objectEnd();
@@ -673,17 +854,31 @@ void FileEmitter::emitVariable(JOStream &json, DIVariable *variable) {
 EmittedExpr FileEmitter::emitExpression(Value value) {
   // A few helpers to simplify creating the various JSON operator and expression
   // snippets.
-  auto hglddSigName = [](StringRef sigName) -> JObject {
-    return JObject{{"sig_name", sigName}};
+  auto hglddSigName = [](StringRef sigName) {
+    return emitCompactJSON([&](JOStream &json) {
+      json.object([&] { json.attribute("sig_name", sigName); });
+    });
   };
-  auto hglddOperator = [](StringRef opcode, JValue args) -> JObject {
-    return JObject{
-        {"opcode", opcode},
-        {"operands", std::move(args)},
-    };
+  auto hglddOperator = [](StringRef opcode, ArrayRef<std::string> args) {
+    return emitCompactJSON([&](JOStream &json) {
+      json.object([&] {
+        json.attribute("opcode", opcode);
+        json.attributeArray("operands", [&] {
+          for (auto &arg : args)
+            json.rawValue(arg);
+        });
+      });
+    });
   };
-  auto hglddInt32 = [](uint32_t value) -> JObject {
-    return JObject({{"integer_num", value}});
+  auto hglddInt32 = [](uint32_t value) {
+    return emitCompactJSON([&](JOStream &json) {
+      json.object([&] { json.attribute("integer_num", value); });
+    });
+  };
+  auto hglddBitVector = [](StringRef bits) {
+    return emitCompactJSON([&](JOStream &json) {
+      json.object([&] { json.attribute("bit_vector", bits); });
+    });
   };
 
   if (auto blockArg = dyn_cast<BlockArgument>(value)) {
@@ -718,8 +913,7 @@ EmittedExpr FileEmitter::emitExpression(Value value) {
     // proper Verilog-compatible value as a result. Expressions like
     // concatenation should instead skip zero-width values.
     if (width < 1)
-      return {JObject({{"bit_vector", "0"}}),
-              IntegerType::get(op->getContext(), 1)};
+      return {hglddBitVector("0"), IntegerType::get(op->getContext(), 1)};
 
     // Serialize the constant as a base-2 binary string.
     SmallString<64> buffer;
@@ -735,7 +929,7 @@ EmittedExpr FileEmitter::emitExpression(Value value) {
     std::reverse(buffer.begin(), buffer.end());
     assert(buffer.size() == (size_t)width);
 
-    return {JObject({{"bit_vector", buffer}}), type};
+    return {hglddBitVector(buffer), type};
   }
 
   // Emit structs as assignment patterns and generate corresponding struct
@@ -743,7 +937,7 @@ EmittedExpr FileEmitter::emitExpression(Value value) {
   if (auto structOp = dyn_cast<debug::StructOp>(op)) {
     // Collect field names, expressions, and types.
     auto structNameHintLen = structNameHint.size();
-    std::vector<JValue> values;
+    SmallVector<std::string> values;
     SmallVector<std::tuple<EmittedType, StringAttr, Location>> types;
     for (auto [nameAttr, field] :
          llvm::zip(structOp.getNamesAttr(), structOp.getFields())) {
@@ -761,37 +955,24 @@ EmittedExpr FileEmitter::emitExpression(Value value) {
     if (values.empty())
       return {hglddInt32(0), EmittedType("bit")};
 
-    // Assemble the struct type definition.
-    JArray fieldDefs;
+    // Assemble the struct type definition. Its name is only determined once
+    // the definitions of all files have been deduplicated.
+    StructDef structDef{std::string(structNameHint), structOp.getLoc(), {}};
     llvm::StringMap<size_t> structNamespace;
-    for (auto [type, name, loc] : types) {
-      JObject fieldDef;
-      fieldDef["var_name"] =
-          std::string(legalizeName(name.getValue(), structNamespace));
-      fieldDef["type_name"] = type.name;
-      if (auto dims = type.emitPackedDims(); !dims.empty())
-        fieldDef["packed_range"] = std::move(dims);
-      if (auto dims = type.emitUnpackedDims(); !dims.empty())
-        fieldDef["unpacked_range"] = std::move(dims);
-      findAndSetLocs(fieldDef, loc);
-      fieldDefs.push_back(std::move(fieldDef));
-    }
-    auto structName = legalizeName(structNameHint, state.objectNamespace);
-    JObject structDef;
-    structDef["kind"] = "struct";
-    structDef["obj_name"] = structName;
-    structDef["port_vars"] = std::move(fieldDefs);
-    findAndSetLocs(structDef, structOp.getLoc());
-
-    StringRef structNameFinal =
-        structDefs.insert({std::move(structDef), structName}).first->second;
+    for (auto [type, name, loc] : types)
+      structDef.fields.push_back(
+          {std::string(legalizeName(name.getValue(), structNamespace)), type,
+           loc});
+    EmittedType type;
+    type.structDef = structDefs.size();
+    structDefs.push_back(std::move(structDef));
 
-    return {hglddOperator("'{", values), EmittedType(structNameFinal)};
+    return {hglddOperator("'{", values), type};
   }
 
   // Emit arrays as assignment patterns.
   if (auto arrayOp = dyn_cast<debug::ArrayOp>(op)) {
-    std::vector<JValue> values;
+    SmallVector<std::string> values;
     EmittedType type;
     for (auto element : arrayOp.getElements()) {
       if (auto value = emitExpression(element)) {
@@ -823,7 +1004,7 @@ EmittedExpr FileEmitter::emitExpression(Value value) {
     auto arg = emitExpression(op->getOperand(0));
     if (!arg)
       return {};
-    return {hglddOperator(unaryOpcode, JArray{arg.expr}), result.getType()};
+    return {hglddOperator(unaryOpcode, arg.expr), result.getType()};
   }
 
   StringRef binaryOpcode =
@@ -884,7 +1065,7 @@ EmittedExpr FileEmitter::emitExpression(Value value) {
 
   // Special handling for concatenation.
   if (auto concatOp = dyn_cast<comb::ConcatOp>(op)) {
-    std::vector<JValue> args;
+    SmallVector<std::string> args;
     for (auto operand : concatOp.getOperands()) {
       auto value = emitExpression(operand);
       if (!value)
@@ -975,6 +1156,10 @@ struct Emitter {
   GlobalState state;
   SmallVector<FileEmitter, 0> files;
   Emitter(Operation *module, const EmitHGLDDOptions &options);
+
+private:
+  void setOutputFileName(FileEmitter &emitter);
+  void resolveStructDefs();
 };
 
 } // namespace
@@ -999,20 +1184,19 @@ Emitter::Emitter(Operation *module, const EmitHGLDDOptions &options)
   }
 
   // Determine the output file names and move the emitters into the `files`
-  // member.
-  files.reserve(groups.size());
+  // member. Leave room for a "global.dd" file for shared struct definitions.
+  files.reserve(groups.size() + 1);
   for (auto &[hdlFile, emitter] : groups) {
-    emitter.outputFileName = options.outputDirectory;
-    StringRef fileName = hdlFile ? hdlFile.getValue() : "global";
-    if (llvm::sys::path::is_absolute(fileName))
-      emitter.outputFileName = fileName;
-    else
-      llvm::sys::path::append(emitter.outputFileName, fileName);
-    llvm::sys::path::replace_extension(emitter.outputFileName, "dd");
-    llvm::sys::path::remove_dots(emitter.outputFileName, true);
+    setOutputFileName(emitter);
     files.push_back(std::move(emitter));
   }
 
+  // Emit the modules of all files concurrently. This only reads the shared
+  // state, and collects the struct definitions of each file separately.
+  mlir::parallelForEach(module->getContext(), files,
+                        [](auto &fileEmitter) { fileEmitter.emitModules(); });
+  resolveStructDefs();
+
   // Dump some information about the files to be created.
   LLVM_DEBUG({
     llvm::dbgs() << "HGLDD files:\n";
@@ -1025,6 +1209,92 @@ Emitter::Emitter(Operation *module, const EmitHGLDDOptions &options)
   });
 }
 
+/// Determine the name of the HGLDD file emitted for an HDL file.
+void Emitter::setOutputFileName(FileEmitter &emitter) {
+  emitter.outputFileName = state.options.outputDirectory;
+  StringRef fileName = emitter.hdlFile ? emitter.hdlFile.getValue() : "global";
+  if (llvm::sys::path::is_absolute(fileName))
+    emitter.outputFileName = fileName;
+  else
+    llvm::sys::path::append(emitter.outputFileName, fileName);
+  llvm::sys::path::replace_extension(emitter.outputFileName, "dd");
+  llvm::sys::path::remove_dots(emitter.outputFileName, true);
+}
+
+/// Deduplicate the struct definitions collected by all files, assign their
+/// final names, and decide which file each definition is emitted into. Two
+/// definitions are considered equal if their fields have the same names and
+/// types, regardless of the locations they were created at. A definition used
+/// by a single file is emitted into that file, and one used by multiple files
+/// into the "global.dd" file. Names are assigned in file order, which keeps the
+/// output independent of the order in which the files were emitted.
+void Emitter::resolveStructDefs() {
+  struct UniqueDef {
+    FileEmitter *file;
+    unsigned index;
+    StringRef name;
+    bool shared = false;
+  };
+  SmallVector<UniqueDef, 0> uniqueDefs;
+  llvm::StringMap<unsigned> uniqueIndices;
+  SmallVector<unsigned, 0> fileUniqueIndices;
+  std::string key;
+  for (auto &file : files) {
+    fileUniqueIndices.clear();
+    for (auto [index, def] : llvm::enumerate(file.structDefs)) {
+      // Nested struct definitions are always collected before the struct they
+      // are used in, such that their unique index is already known.
+      key.clear();
+      llvm::raw_string_ostream keyOS(key);
+      for (auto &field : def.fields) {
+        keyOS << field.name << ':';
+        if (field.type.structDef)
+          keyOS << '#' << fileUniqueIndices[*field.type.structDef];
+        else
+          keyOS << field.type.name;
+        for (auto dim : field.type.packedDims)
+          keyOS << '[' << dim << ']';
+        keyOS << '$';
+        for (auto dim : field.type.unpackedDims)
+          keyOS << '[' << dim << ']';
+        keyOS << ';';
+      }
+
+      auto [it, inserted] =
+          uniqueIndices.try_emplace(keyOS.str(), uniqueDefs.size());
+      if (inserted) {
+        auto name = legalizeName(def.nameHint, state.objectNamespace);
+        uniqueDefs.push_back({&file, unsigned(index), name});
+      } else if (uniqueDefs[it->second].file != &file) {
+        uniqueDefs[it->second].shared = true;
+      }
+      fileUniqueIndices.push_back(it->second);
+      file.structNames.push_back(uniqueDefs[it->second].name);
+    }
+  }
+
+  // Shared struct definitions go into the "global.dd" file, which only exists
+  // if some modules have no emitted file path.
+  FileEmitter *globalFile = nullptr;
+  for (auto &def : uniqueDefs) {
+    auto *owner = def.file;
+    if (def.shared) {
+      if (!globalFile) {
+        auto *it = llvm::find_if(
+            files, [](auto &fileEmitter) { return !fileEmitter.hdlFile; });
+        if (it == files.end()) {
+          setOutputFileName(files.emplace_back(state, StringAttr{}));
+          it = &files.back();
+        }
+        globalFile = it;
+      }
+      owner = globalFile;
+    }
+    owner->ownedStructDefs.push_back(
+        {&def.file->structDefs[def.index], def.name, def.file->structNames});
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Emission Entry Points
 //===----------------------------------------------------------------------===//
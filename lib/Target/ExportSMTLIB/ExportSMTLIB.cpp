@@ -19,6 +19,7 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/Support/IndentedOstream.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/ScopedHashTable.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Format.h"
@@ -487,6 +488,21 @@ struct ExpressionVisitor
     return success();
   }
 
+  /// Print the operation defining 'value' itself rather than a let-binding for
+  /// it, preceded by let-bindings for the operands that are not available yet.
+  LogicalResult printTerm(Value value, VisitorInfo &info) {
+    Operation *defOp = value.getDefiningOp();
+    SmallVector<Value> worklist;
+    for (Value operand : defOp->getOperands())
+      if (!info.valueMap.count(operand))
+        worklist.push_back(operand);
+
+    if (failed(printExpression(worklist, info)))
+      return failure();
+
+    return Base::dispatchSMTOpVisitor(defOp, info);
+  }
+
 private:
   // A reference to the emission options for easy use in the visitor methods.
   [[maybe_unused]] const SMTEmissionOptions &options;
@@ -502,9 +518,10 @@ struct StatementVisitor
   using smt::SMTOpVisitor<StatementVisitor, LogicalResult,
                           mlir::raw_indented_ostream &, ValueMap &>::visitSMTOp;
 
-  StatementVisitor(const SMTEmissionOptions &options, Namespace &names)
+  StatementVisitor(const SMTEmissionOptions &options, Namespace &names,
+                   const DenseSet<Value> &sharedTerms)
       : options(options), typeVisitor(options), names(names),
-        exprVisitor(options, names) {}
+        exprVisitor(options, names), sharedTerms(sharedTerms) {}
 
   LogicalResult visitSMTOp(BVConstantOp op, mlir::raw_indented_ostream &stream,
                            ValueMap &valueMap) {
@@ -544,6 +561,10 @@ struct StatementVisitor
   LogicalResult visitSMTOp(AssertOp op, mlir::raw_indented_ostream &stream,
                            ValueMap &valueMap) {
     llvm::ScopedHashTableScope<Value, std::string> scope1(valueMap);
+    if (options.defineSharedTerms &&
+        failed(defineSharedTerms(op.getInput(), stream, valueMap)))
+      return failure();
+
     SmallVector<Value> worklist;
     worklist.push_back(op.getInput());
     stream << "(assert ";
@@ -574,6 +595,27 @@ struct StatementVisitor
     return success();
   }
 
+  LogicalResult visitSMTOp(PushOp op, mlir::raw_indented_ostream &stream,
+                           ValueMap &valueMap) {
+    stream << "(push " << op.getCount() << ")\n";
+    definitionsPerLevel.resize(definitionsPerLevel.size() + op.getCount());
+    return success();
+  }
+
+  LogicalResult visitSMTOp(PopOp op, mlir::raw_indented_ostream &stream,
+                           ValueMap &valueMap) {
+    stream << "(pop " << op.getCount() << ")\n";
+
+    // The definitions made in the popped assertion levels are gone and have
+    // to be emitted again when needed.
+    unsigned count = std::min<unsigned>(op.getCount(),
+                                        definitionsPerLevel.size() - 1);
+    for (unsigned i = 0; i < count; ++i)
+      for (Value value : definitionsPerLevel.pop_back_val())
+        definitions.erase(value);
+    return success();
+  }
+
   LogicalResult visitUnhandledSMTOp(Operation *op,
                                     mlir::raw_indented_ostream &stream,
                                     ValueMap &valueMap) {
@@ -582,11 +624,88 @@ struct StatementVisitor
   }
 
 private:
+  /// Emit a 'define-fun' for every shared subterm 'root' depends on that is
+  /// not defined at the current assertion level yet, in topological order.
+  /// The names of all shared subterms 'root' depends on are added to the
+  /// current scope of the value map.
+  LogicalResult defineSharedTerms(Value root,
+                                  mlir::raw_indented_ostream &stream,
+                                  ValueMap &valueMap) {
+    // Pairs of a value and whether its operands have been taken care of.
+    SmallVector<std::pair<Value, bool>> worklist;
+    DenseSet<Value> visited;
+    worklist.push_back({root, false});
+    while (!worklist.empty()) {
+      auto [value, operandsDone] = worklist.pop_back_val();
+      if (operandsDone) {
+        if (failed(defineTerm(value, stream, valueMap)))
+          return failure();
+        continue;
+      }
+
+      if (valueMap.count(value) || !visited.insert(value).second)
+        continue;
+
+      if (sharedTerms.contains(value)) {
+        if (auto it = definitions.find(value); it != definitions.end()) {
+          valueMap.insert(value, it->second);
+          continue;
+        }
+        worklist.push_back({value, true});
+      }
+
+      // Only descend through subterms printed as part of an assertion or a
+      // definition, which includes the values quantifier bodies capture.
+      Operation *defOp = value.getDefiningOp();
+      for (Value operand : defOp->getOperands())
+        worklist.push_back({operand, false});
+      defOp->walk([&](Operation *nestedOp) {
+        if (nestedOp == defOp)
+          return;
+        for (Value operand : nestedOp->getOperands())
+          if (!defOp->isAncestor(operand.getParentRegion()->getParentOp()))
+            worklist.push_back({operand, false});
+      });
+    }
+    return success();
+  }
+
+  /// Emit a 'define-fun' for a shared subterm whose shared operands are
+  /// available already.
+  LogicalResult defineTerm(Value value, mlir::raw_indented_ostream &stream,
+                           ValueMap &valueMap) {
+    StringRef name = names.newName("tmp");
+    {
+      llvm::ScopedHashTableScope<Value, std::string> scope(valueMap);
+      stream << "(define-fun " << name << " () ";
+      typeVisitor.dispatchSMTTypeVisitor(value.getType(), stream);
+      stream << " ";
+      VisitorInfo info(stream, valueMap, 12, 0);
+      if (failed(exprVisitor.printTerm(value, info)))
+        return failure();
+      for (unsigned i = 0; i < info.openParens + 1; ++i)
+        stream << ")";
+      stream << "\n";
+      stream.indent(0);
+    }
+
+    valueMap.insert(value, name.str());
+    definitions[value] = name.str();
+    definitionsPerLevel.back().push_back(value);
+    return success();
+  }
+
   // A reference to the emission options for easy use in the visitor methods.
   [[maybe_unused]] const SMTEmissionOptions &options;
   TypeVisitor typeVisitor;
   Namespace &names;
   ExpressionVisitor exprVisitor;
+  // The subterms needed by more than one assertion.
+  const DenseSet<Value> &sharedTerms;
+  // The names of the shared subterms defined so far.
+  DenseMap<Value, std::string> definitions;
+  // The shared subterms defined at each assertion level.
+  SmallVector<SmallVector<Value>> definitionsPerLevel{1};
 };
 
 } // namespace
@@ -595,6 +714,45 @@ private:
 // Unified Emitter implementation
 //===----------------------------------------------------------------------===//
 
+/// Find the subterms in 'block' that are needed by more than one assertion,
+/// either directly or through other such subterms. Every other subterm is
+/// needed by exactly one assertion or shared subterm and is printed as part
+/// of it. Constants and declarations are always referred to by name.
+static DenseSet<Value> findSharedTerms(Block *block) {
+  DenseSet<Value> sharedTerms;
+  // The assertion or shared subterm each other subterm is printed as part of.
+  DenseMap<Operation *, Operation *> owners;
+
+  // Visit the users of each subterm before the subterm itself.
+  for (Operation &op : llvm::reverse(*block)) {
+    if (op.getNumResults() != 1 ||
+        isa<BVConstantOp, BoolConstantOp, IntConstantOp, DeclareFunOp>(op))
+      continue;
+
+    Value result = op.getResult(0);
+    Operation *owner = nullptr;
+    bool shared = false;
+    for (Operation *user : result.getUsers()) {
+      Operation *userOp = block->findAncestorOpInBlock(*user);
+      Operation *userOwner = owners.lookup(userOp);
+      if (!userOwner)
+        userOwner = userOp;
+      if (owner && owner != userOwner) {
+        shared = true;
+        break;
+      }
+      owner = userOwner;
+    }
+
+    if (shared)
+      sharedTerms.insert(result);
+    else
+      owners[&op] = owner;
+  }
+
+  return sharedTerms;
+}
+
 /// Emit the SMT operations in the given 'solver' to the 'stream'.
 static LogicalResult emit(SolverOp solver, const SMTEmissionOptions &options,
                           mlir::raw_indented_ostream &stream) {
@@ -604,6 +762,11 @@ static LogicalResult emit(SolverOp solver, const SMTEmissionOptions &options,
 
   Block *block = solver.getBody();
 
+  // In an incremental session, everything the solver scope declares or
+  // asserts is dropped again at its end.
+  if (options.incremental)
+    stream << "(push 1)\n";
+
   // Declare uninterpreted sorts.
   DenseMap<StringAttr, unsigned> declaredSorts;
   auto result = block->walk([&](Operation *op) -> WalkResult {
@@ -634,10 +797,14 @@ static LogicalResult emit(SolverOp solver, const SMTEmissionOptions &options,
   if (result.wasInterrupted())
     return failure();
 
+  DenseSet<Value> sharedTerms;
+  if (options.defineSharedTerms)
+    sharedTerms = findSharedTerms(block);
+
   ValueMap valueMap;
   llvm::ScopedHashTableScope<Value, std::string> scope0(valueMap);
   Namespace names;
-  StatementVisitor visitor(options, names);
+  StatementVisitor visitor(options, names, sharedTerms);
 
   // Collect all statement operations (ops with no result value).
   // Declare constants and then only refer to them by identifier later on.
@@ -649,7 +816,7 @@ static LogicalResult emit(SolverOp solver, const SMTEmissionOptions &options,
   if (result.wasInterrupted())
     return failure();
 
-  stream << "(reset)\n";
+  stream << (options.incremental ? "(pop 1)\n" : "(reset)\n");
   return success();
 }
 
@@ -685,9 +852,23 @@ void ExportSMTLIB::registerExportSMTLIBTranslation() {
                      "generating a let-binding"),
       llvm::cl::init(false));
 
+  static llvm::cl::opt<bool> defineSharedTerms(
+      "smtlibexport-define-shared-terms",
+      llvm::cl::desc("Emit subterms needed by more than one assertion once as "
+                     "a 'define-fun' rather than in every assertion"),
+      llvm::cl::init(false));
+
+  static llvm::cl::opt<bool> incremental(
+      "smtlibexport-incremental",
+      llvm::cl::desc("Emit all solver scopes into one incremental session "
+                     "separated by 'push' and 'pop' rather than 'reset'"),
+      llvm::cl::init(false));
+
   auto getOptions = [] {
     SMTEmissionOptions opts;
     opts.inlineSingleUseValues = inlineSingleUseValues;
+    opts.defineSharedTerms = defineSharedTerms;
+    opts.incremental = incremental;
     return opts;
   };
 
@@ -0,0 +1,1127 @@
+//===- FIRRTLServer.cpp - FIRRTL Language Server --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A .fir document is kept as a list of chunks: a header holding the version
+// and circuit lines, followed by one chunk per top-level declaration. Edits
+// only rescan the chunks they touch. Diagnostics are computed per chunk by
+// parsing the chunk together with the header, the global declarations (layers,
+// type aliases and options), and the declaration lines and ports of the
+// modules it instantiates. Changes to the header or to a global declaration
+// fall back to parsing the whole document.
+//
+//===----------------------------------------------------------------------===//
+
+#include "FIRRTLServer.h"
+#include "circt/Dialect/FIRRTL/FIRParser.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Location.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Support/Timing.h"
+#include "mlir/Tools/lsp-server-support/Protocol.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/xxhash.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace circt;
+
+//===----------------------------------------------------------------------===//
+// Line Scanning
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The kind of top-level declaration a chunk holds.
+enum class DeclKind {
+  Header,
+  Module,
+  ExtModule,
+  IntModule,
+  Class,
+  ExtClass,
+  Formal,
+  Layer,
+  Type,
+  Option
+};
+
+/// A word on a line, along with the column it starts at.
+struct Word {
+  StringRef text;
+  unsigned col;
+};
+} // namespace
+
+static std::optional<DeclKind> getDeclKind(StringRef keyword) {
+  return llvm::StringSwitch<std::optional<DeclKind>>(keyword)
+      .Case("module", DeclKind::Module)
+      .Case("extmodule", DeclKind::ExtModule)
+      .Case("intmodule", DeclKind::IntModule)
+      .Case("class", DeclKind::Class)
+      .Case("extclass", DeclKind::ExtClass)
+      .Case("formal", DeclKind::Formal)
+      .Cases("layer", "declgroup", DeclKind::Layer)
+      .Case("type", DeclKind::Type)
+      .Case("option", DeclKind::Option)
+      .Default(std::nullopt);
+}
+
+static StringRef getDeclKindName(DeclKind kind) {
+  switch (kind) {
+  case DeclKind::Header:
+    return "circuit";
+  case DeclKind::Module:
+    return "module";
+  case DeclKind::ExtModule:
+    return "extmodule";
+  case DeclKind::IntModule:
+    return "intmodule";
+  case DeclKind::Class:
+    return "class";
+  case DeclKind::ExtClass:
+    return "extclass";
+  case DeclKind::Formal:
+    return "formal";
+  case DeclKind::Layer:
+    return "layer";
+  case DeclKind::Type:
+    return "type";
+  case DeclKind::Option:
+    return "option";
+  }
+  llvm_unreachable("unknown declaration kind");
+}
+
+/// Return true for declarations that every other declaration may depend on,
+/// and which are therefore part of every per-chunk parse.
+static bool isGlobalDecl(DeclKind kind) {
+  return kind == DeclKind::Layer || kind == DeclKind::Type ||
+         kind == DeclKind::Option;
+}
+
+static bool isIdChar(char c) {
+  return llvm::isAlnum(c) || c == '_' || c == '$';
+}
+
+/// Split the start of `line` into identifiers and punctuation, stopping at the
+/// first comment, string, info locator, or annotation.
+static void lexWords(StringRef line, SmallVectorImpl<Word> &words,
+                     unsigned maxWords) {
+  size_t i = 0, e = line.size();
+  while (i < e && words.size() < maxWords) {
+    char c = line[i];
+    if (c == ' ' || c == '\t' || c == '\r') {
+      ++i;
+      continue;
+    }
+    if (c == ';' || c == '"' || c == '@' || c == '%')
+      return;
+    if (c == '`') {
+      size_t end = line.find('`', i + 1);
+      if (end == StringRef::npos)
+        return;
+      words.push_back({line.slice(i + 1, end), unsigned(i + 1)});
+      i = end + 1;
+      continue;
+    }
+    size_t start = i;
+    if (isIdChar(c)) {
+      while (i < e && isIdChar(line[i]))
+        ++i;
+    } else if (line.substr(i).starts_with("=>")) {
+      i += 2;
+    } else {
+      ++i;
+    }
+    words.push_back({line.slice(start, i), unsigned(start)});
+  }
+}
+
+static unsigned getIndentation(StringRef line) {
+  return line.size() - line.ltrim(" \t").size();
+}
+
+/// Return the byte offset of the UTF-16 column `col` within `line`, clamped
+/// to the end of the line.
+static size_t getByteOffset(StringRef line, int col) {
+  size_t i = 0;
+  for (int units = 0; i < line.size() && units < col; ++units) {
+    unsigned char c = line[i];
+    size_t len = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    // Code points outside the BMP take two UTF-16 code units.
+    if (len == 4)
+      ++units;
+    i += len;
+  }
+  return std::min(i, line.size());
+}
+
+static void appendLine(std::string &buffer, StringRef text) {
+  buffer += text;
+  if (!text.ends_with("\n"))
+    buffer += '\n';
+}
+
+//===----------------------------------------------------------------------===//
+// ChunkInfo
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// A reference from one declaration to another, such as `inst foo of Bar`.
+struct SymbolUse {
+  /// The name of the referenced declaration.
+  std::string target;
+  /// The name of the instance, or empty for uses without one.
+  std::string name;
+  /// The line of the use relative to the start of its chunk.
+  unsigned line;
+  /// The columns of the instance name and the referenced name.
+  unsigned nameCol, targetCol;
+};
+
+/// What scanning the text of a chunk finds out about it. This only depends on
+/// the text, so it is shared between the chunks and the symbol index, and
+/// reused as long as the text does not change.
+struct ChunkInfo {
+  DeclKind kind = DeclKind::Header;
+  /// The name of the declaration and its column on the first line.
+  std::string name;
+  unsigned nameCol = 0;
+  /// The column of the declaration keyword on the first line.
+  unsigned keywordCol = 0;
+  /// The declaration line and ports of modules and classes, or the whole text
+  /// of other declarations. This stands in for the declaration when parsing
+  /// the chunks that refer to it.
+  std::string signature;
+  uint64_t signatureHash = 0;
+  /// The instances and other references to declarations in this chunk.
+  std::vector<SymbolUse> uses;
+};
+} // namespace
+
+static std::shared_ptr<const ChunkInfo> scanChunk(StringRef text,
+                                                  bool isHeader) {
+  auto info = std::make_shared<ChunkInfo>();
+  if (isHeader)
+    return info;
+
+  SmallVector<Word, 8> words;
+  bool inPorts = true;
+  unsigned lineNo = 0;
+  for (StringRef rest = text; !rest.empty(); ++lineNo) {
+    StringRef line;
+    std::tie(line, rest) = rest.split('\n');
+    words.clear();
+    lexWords(line, words, 8);
+
+    // The first line names the declaration.
+    if (lineNo == 0) {
+      unsigned idx = !words.empty() && words[0].text == "public";
+      if (idx < words.size()) {
+        info->kind = getDeclKind(words[idx].text).value_or(DeclKind::Module);
+        info->keywordCol = words[idx].col;
+      }
+      if (idx + 1 < words.size()) {
+        info->name = words[idx + 1].text.str();
+        info->nameCol = words[idx + 1].col;
+      }
+      // `formal name of Module` refers to the module it checks.
+      if (info->kind == DeclKind::Formal && idx + 3 < words.size() &&
+          words[idx + 2].text == "of")
+        info->uses.push_back({words[idx + 3].text.str(), "", lineNo, 0,
+                              words[idx + 3].col});
+      appendLine(info->signature, line);
+      continue;
+    }
+
+    // The ports of modules and classes are part of their signature.
+    if (inPorts &&
+        (info->kind == DeclKind::Module || info->kind == DeclKind::Class)) {
+      if (words.empty())
+        continue;
+      if (words[0].text == "input" || words[0].text == "output")
+        appendLine(info->signature, line);
+      else
+        inPorts = false;
+    }
+
+    // Record instances, objects, and the alternatives of instance choices.
+    if (words.size() >= 4 &&
+        (words[0].text == "inst" || words[0].text == "object" ||
+         words[0].text == "instchoice") &&
+        words[2].text == "of")
+      info->uses.push_back({words[3].text.str(), words[1].text.str(), lineNo,
+                            words[1].col, words[3].col});
+    for (unsigned i = 0, e = words.size(); i + 1 < e; ++i)
+      if (words[i].text == "=>")
+        info->uses.push_back(
+            {words[i + 1].text.str(), "", lineNo, 0, words[i + 1].col});
+  }
+
+  if (info->kind != DeclKind::Module && info->kind != DeclKind::Class)
+    info->signature = text.str();
+  info->signatureHash = llvm::xxh3_64bits(info->signature);
+  return info;
+}
+
+//===----------------------------------------------------------------------===//
+// Diagnostics
+//===----------------------------------------------------------------------===//
+
+static std::optional<mlir::lsp::Range> getRange(mlir::Location loc) {
+  auto fileLoc = loc->findInstanceOf<FileLineColLoc>();
+  if (!fileLoc)
+    return std::nullopt;
+  mlir::lsp::Position pos(std::max(0, int(fileLoc.getLine()) - 1),
+                          std::max(0, int(fileLoc.getColumn()) - 1));
+  return mlir::lsp::Range(pos);
+}
+
+static std::optional<lsp::Diagnostic>
+getLspDiagnostic(mlir::Diagnostic &diag, const lsp::URIForFile &uri) {
+  auto range = getRange(diag.getLocation());
+  if (!range)
+    return std::nullopt;
+
+  lsp::Diagnostic lspDiag;
+  lspDiag.source = "firrtl";
+  lspDiag.range = *range;
+  switch (diag.getSeverity()) {
+  case mlir::DiagnosticSeverity::Note:
+  case mlir::DiagnosticSeverity::Remark:
+    lspDiag.severity = mlir::lsp::DiagnosticSeverity::Information;
+    break;
+  case mlir::DiagnosticSeverity::Warning:
+    lspDiag.severity = mlir::lsp::DiagnosticSeverity::Warning;
+    break;
+  case mlir::DiagnosticSeverity::Error:
+    lspDiag.severity = mlir::lsp::DiagnosticSeverity::Error;
+    break;
+  }
+  lspDiag.message = diag.str();
+
+  for (mlir::Diagnostic &note : diag.getNotes()) {
+    auto noteRange = getRange(note.getLocation());
+    if (!noteRange)
+      continue;
+    if (!lspDiag.relatedInformation)
+      lspDiag.relatedInformation.emplace();
+    lspDiag.relatedInformation->emplace_back(lsp::Location(uri, *noteRange),
+                                             note.str());
+  }
+  return lspDiag;
+}
+
+/// Parse `buffer` as a .fir file and return the diagnostics produced while
+/// parsing and verifying it. The lines in the diagnostics are lines of
+/// `buffer`.
+static std::vector<lsp::Diagnostic> parseFIRRTL(const std::string &buffer,
+                                                const lsp::URIForFile &uri,
+                                                bool enableThreading) {
+  MLIRContext context(enableThreading ? MLIRContext::Threading::ENABLED
+                                      : MLIRContext::Threading::DISABLED);
+  std::vector<lsp::Diagnostic> diagnostics;
+  mlir::ScopedDiagnosticHandler handler(&context, [&](mlir::Diagnostic &diag) {
+    if (auto lspDiag = getLspDiagnostic(diag, uri))
+      diagnostics.push_back(std::move(*lspDiag));
+    return success();
+  });
+
+  llvm::SourceMgr sourceMgr;
+  sourceMgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBuffer(buffer),
+                               llvm::SMLoc());
+  firrtl::FIRParserOptions options;
+  options.infoLocatorHandling =
+      firrtl::FIRParserOptions::InfoLocHandling::IgnoreInfo;
+  options.numAnnotationFiles = 0;
+  mlir::TimingScope ts;
+  (void)firrtl::importFIRFile(sourceMgr, &context, ts, options);
+  return diagnostics;
+}
+
+/// Move a diagnostic and its related information by `delta` lines.
+static void shiftLines(lsp::Diagnostic &diag, int delta) {
+  diag.range.start.line += delta;
+  diag.range.end.line += delta;
+  if (diag.relatedInformation)
+    for (auto &info : *diag.relatedInformation) {
+      info.location.range.start.line += delta;
+      info.location.range.end.line += delta;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// SymbolIndex
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The position and scan results of a chunk, as captured for the index.
+struct ChunkRef {
+  unsigned startLine, numLines;
+  std::shared_ptr<const ChunkInfo> info;
+};
+
+/// The declarations of a document and the uses of them, sorted by position.
+/// Indices are built on a background thread after each change and answer all
+/// queries about the document.
+struct SymbolIndex {
+  struct Decl {
+    const ChunkInfo *info;
+    unsigned startLine, numLines;
+  };
+
+  /// A name at some position in the document.
+  struct Occurrence {
+    mlir::lsp::Range range;
+    /// The name of the declaration this occurrence refers to.
+    StringRef symbol;
+    /// The instance this occurrence is the name of, if any.
+    const SymbolUse *instance = nullptr;
+  };
+
+  static std::shared_ptr<const SymbolIndex> build(ArrayRef<ChunkRef> chunks);
+
+  /// Return the occurrence at the given position, or null if there is none.
+  const Occurrence *lookup(const lsp::Position &pos) const;
+
+  /// Return the declaration with the given name, or null if there is none.
+  const Decl *lookupDecl(StringRef name) const {
+    auto it = declsByName.find(name);
+    return it == declsByName.end() ? nullptr : &decls[it->second];
+  }
+
+  /// The chunk infos the rest of the index points into.
+  std::vector<std::shared_ptr<const ChunkInfo>> infos;
+  std::vector<Decl> decls;
+  llvm::StringMap<unsigned> declsByName;
+  llvm::StringMap<std::vector<mlir::lsp::Range>> uses;
+  std::vector<Occurrence> occurrences;
+};
+} // namespace
+
+static mlir::lsp::Range getNameRange(unsigned line, unsigned col,
+                                     StringRef name) {
+  return mlir::lsp::Range(mlir::lsp::Position(line, col),
+                          mlir::lsp::Position(line, col + name.size()));
+}
+
+static mlir::lsp::Range getDeclNameRange(const SymbolIndex::Decl &decl) {
+  return getNameRange(decl.startLine, decl.info->nameCol, decl.info->name);
+}
+
+std::shared_ptr<const SymbolIndex>
+SymbolIndex::build(ArrayRef<ChunkRef> chunks) {
+  auto index = std::make_shared<SymbolIndex>();
+  for (const auto &chunk : chunks) {
+    const ChunkInfo &info = *chunk.info;
+    if (info.kind == DeclKind::Header)
+      continue;
+    index->infos.push_back(chunk.info);
+
+    if (!info.name.empty()) {
+      index->declsByName.try_emplace(info.name, index->decls.size());
+      index->decls.push_back({&info, chunk.startLine, chunk.numLines});
+      index->occurrences.push_back(
+          {getNameRange(chunk.startLine, info.nameCol, info.name), info.name});
+    }
+    for (const auto &use : info.uses) {
+      unsigned line = chunk.startLine + use.line;
+      if (!use.name.empty())
+        index->occurrences.push_back(
+            {getNameRange(line, use.nameCol, use.name), use.target, &use});
+      auto range = getNameRange(line, use.targetCol, use.target);
+      index->occurrences.push_back({range, use.target});
+      index->uses[use.target].push_back(range);
+    }
+  }
+
+  llvm::sort(index->occurrences, [](const auto &lhs, const auto &rhs) {
+    return std::make_pair(lhs.range.start.line, lhs.range.start.character) <
+           std::make_pair(rhs.range.start.line, rhs.range.start.character);
+  });
+  return index;
+}
+
+const SymbolIndex::Occurrence *
+SymbolIndex::lookup(const lsp::Position &pos) const {
+  auto it = llvm::partition_point(occurrences, [&](const Occurrence &occ) {
+    return std::make_pair(occ.range.end.line, occ.range.end.character) <
+           std::make_pair(pos.line, pos.character);
+  });
+  if (it == occurrences.end() || it->range.start.line != pos.line ||
+      it->range.start.character > pos.character)
+    return nullptr;
+  return &*it;
+}
+
+//===----------------------------------------------------------------------===//
+// FIRRTLDocument
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// A range of lines of a document holding one top-level declaration, or the
+/// header before the first declaration.
+struct Chunk {
+  /// The byte range of the chunk within the document.
+  size_t offset = 0, size = 0;
+  /// The first line of the chunk and the number of lines it spans.
+  unsigned startLine = 0, numLines = 0;
+  /// The hash of the chunk text, used to recognize unchanged chunks.
+  uint64_t hash = 0;
+  std::shared_ptr<const ChunkInfo> info;
+  /// The diagnostics within this chunk, with lines relative to `startLine`.
+  std::vector<lsp::Diagnostic> diagnostics;
+  /// Whether the diagnostics need to be recomputed.
+  bool dirty = true;
+
+  bool containsLine(int line) const {
+    return line >= int(startLine) && line < int(startLine + numLines);
+  }
+};
+
+/// A .fir document open in the editor.
+class FIRRTLDocument {
+public:
+  FIRRTLDocument(const lsp::URIForFile &uri, StringRef contents,
+                 int64_t version, std::vector<lsp::Diagnostic> &diagnostics);
+
+  void update(ArrayRef<lsp::TextDocumentContentChangeEvent> changes,
+              int64_t newVersion, std::vector<lsp::Diagnostic> &diagnostics);
+
+  int64_t getVersion() const { return version; }
+
+  void getLocationsOf(const lsp::Position &defPos,
+                      std::vector<lsp::Location> &locations);
+  void findReferencesOf(const lsp::Position &pos,
+                        std::vector<lsp::Location> &references);
+  std::optional<lsp::Hover> findHover(const lsp::Position &hoverPos);
+  void findDocumentSymbols(std::vector<lsp::DocumentSymbol> &symbols);
+
+private:
+  StringRef getText(const Chunk &chunk) const {
+    return StringRef(contents).substr(chunk.offset, chunk.size);
+  }
+  StringRef getLineAt(size_t offset) const {
+    return StringRef(contents).substr(offset).take_until(
+        [](char c) { return c == '\n'; });
+  }
+  bool isDeclStart(StringRef line) const;
+  unsigned findChunk(int line) const;
+  size_t getOffset(const lsp::Position &pos) const;
+
+  /// Split the whole document into chunks and scan them.
+  void splitDocument();
+  /// Split the bytes in `[begin, end)`, starting at line `startLine`, into
+  /// chunks. The range must start at a chunk boundary.
+  void splitRange(size_t begin, size_t end, unsigned startLine,
+                  std::vector<Chunk> &result) const;
+  /// Apply an edit to the contents and rescan the chunks it touches. Returns
+  /// false if the edit touched the header or a global declaration, in which
+  /// case the document has to be split and parsed again as a whole.
+  bool applyChange(const lsp::TextDocumentContentChangeEvent &change,
+                   llvm::StringMap<uint64_t> &oldSignatures,
+                   llvm::StringSet<> &touched);
+  /// Mark the chunks referring to a declaration whose signature changed as
+  /// needing a new parse.
+  void markDependents(const llvm::StringMap<uint64_t> &oldSignatures,
+                      const llvm::StringSet<> &touched);
+
+  /// Parse the whole document and distribute the diagnostics over the chunks.
+  void parseAll();
+  /// Parse the chunks marked dirty.
+  void parseDirtyChunks();
+  /// Parse a single chunk. Returns false if the parse failed outside of the
+  /// chunk, in which case the diagnostics of the chunk are incomplete.
+  bool parseChunk(unsigned index, StringRef prelude,
+                  const llvm::StringMap<unsigned> &decls);
+
+  void getDiagnostics(std::vector<lsp::Diagnostic> &diagnostics) const;
+
+  /// Start building a new symbol index on a background thread.
+  void buildIndex();
+
+  lsp::URIForFile uri;
+  std::string contents;
+  int64_t version;
+
+  /// The name of the circuit, and the indentation of the top-level
+  /// declarations if the document has any.
+  std::string circuitName;
+  std::optional<unsigned> declIndent;
+
+  std::vector<Chunk> chunks;
+  std::shared_future<std::shared_ptr<const SymbolIndex>> index;
+};
+} // namespace
+
+FIRRTLDocument::FIRRTLDocument(const lsp::URIForFile &uri, StringRef contents,
+                               int64_t version,
+                               std::vector<lsp::Diagnostic> &diagnostics)
+    : uri(uri), contents(contents.str()), version(version) {
+  splitDocument();
+  parseAll();
+  getDiagnostics(diagnostics);
+  buildIndex();
+}
+
+bool FIRRTLDocument::isDeclStart(StringRef line) const {
+  if (!declIndent || getIndentation(line) != *declIndent)
+    return false;
+  SmallVector<Word, 1> words;
+  lexWords(line, words, 1);
+  return !words.empty() &&
+         (words[0].text == "public" || getDeclKind(words[0].text));
+}
+
+unsigned FIRRTLDocument::findChunk(int line) const {
+  auto it = llvm::partition_point(
+      chunks, [&](const Chunk &chunk) { return int(chunk.startLine) <= line; });
+  return it == chunks.begin() ? 0 : std::distance(chunks.begin(), it) - 1;
+}
+
+size_t FIRRTLDocument::getOffset(const lsp::Position &pos) const {
+  const Chunk &chunk = chunks[findChunk(pos.line)];
+  StringRef text(contents);
+  size_t offset = chunk.offset;
+  for (int line = chunk.startLine; line < pos.line; ++line) {
+    size_t eol = text.find('\n', offset);
+    if (eol == StringRef::npos)
+      return text.size();
+    offset = eol + 1;
+  }
+  return offset + getByteOffset(getLineAt(offset), pos.character);
+}
+
+void FIRRTLDocument::splitDocument() {
+  circuitName.clear();
+  declIndent.reset();
+
+  // Find the circuit line and the indentation of the first declaration below
+  // it.
+  std::optional<unsigned> circuitIndent;
+  SmallVector<Word, 2> words;
+  StringRef text(contents);
+  for (size_t pos = 0; pos < text.size();) {
+    StringRef line = getLineAt(pos);
+    pos += line.size() + 1;
+    words.clear();
+    lexWords(line, words, 2);
+    if (words.empty())
+      continue;
+    unsigned indent = getIndentation(line);
+    if (!circuitIndent) {
+      if (words[0].text == "circuit") {
+        circuitIndent = indent;
+        if (words.size() > 1)
+          circuitName = words[1].text.str();
+      }
+      continue;
+    }
+    if (indent > *circuitIndent &&
+        (words[0].text == "public" || getDeclKind(words[0].text))) {
+      declIndent = indent;
+      break;
+    }
+  }
+
+  chunks.clear();
+  splitRange(0, contents.size(), 0, chunks);
+  if (chunks.empty())
+    chunks.emplace_back();
+  llvm::parallelFor(0, chunks.size(), [&](size_t i) {
+    chunks[i].info = scanChunk(getText(chunks[i]), i == 0);
+  });
+}
+
+void FIRRTLDocument::splitRange(size_t begin, size_t end, unsigned startLine,
+                                std::vector<Chunk> &result) const {
+  size_t firstChunk = result.size();
+  unsigned line = startLine;
+  for (size_t pos = begin; pos < end; ++line) {
+    StringRef lineText = getLineAt(pos);
+    if (pos == begin || isDeclStart(lineText)) {
+      Chunk chunk;
+      chunk.offset = pos;
+      chunk.startLine = line;
+      result.push_back(std::move(chunk));
+    }
+    pos += lineText.size() + 1;
+  }
+
+  for (size_t i = firstChunk, e = result.size(); i != e; ++i) {
+    Chunk &chunk = result[i];
+    chunk.size = (i + 1 == e ? end : result[i + 1].offset) - chunk.offset;
+    StringRef text = getText(chunk);
+    chunk.numLines = text.count('\n') + !text.ends_with("\n");
+    chunk.hash = llvm::xxh3_64bits(text);
+  }
+}
+
+bool FIRRTLDocument::applyChange(
+    const lsp::TextDocumentContentChangeEvent &change,
+    llvm::StringMap<uint64_t> &oldSignatures, llvm::StringSet<> &touched) {
+  const auto &range = *change.range;
+  unsigned first = findChunk(range.start.line);
+  unsigned last = std::max(first, findChunk(range.end.line));
+  size_t startOffset = getOffset(range.start);
+  size_t endOffset = std::max(startOffset, getOffset(range.end));
+
+  StringRef replaced = StringRef(contents).slice(startOffset, endOffset);
+  int lineDelta = int(StringRef(change.text).count('\n')) -
+                  int(replaced.count('\n'));
+  ptrdiff_t byteDelta =
+      ptrdiff_t(change.text.size()) - ptrdiff_t(replaced.size());
+  contents.replace(startOffset, endOffset - startOffset, change.text);
+
+  // If the edit removed the line that started the first chunk, its remaining
+  // lines belong to the chunk before it.
+  size_t regionEnd = chunks[last].offset + chunks[last].size + byteDelta;
+  while (first > 0 && chunks[first].offset < regionEnd &&
+         !isDeclStart(getLineAt(chunks[first].offset)))
+    --first;
+  if (first == 0)
+    return false;
+
+  std::vector<Chunk> newChunks;
+  splitRange(chunks[first].offset, regionEnd, chunks[first].startLine,
+             newChunks);
+
+  // Reuse what is known about chunks whose text did not change, such as when
+  // a declaration only moved.
+  llvm::SmallDenseMap<uint64_t, unsigned> oldChunks;
+  bool touchedGlobal = false;
+  for (unsigned i = first; i <= last; ++i) {
+    const ChunkInfo &info = *chunks[i].info;
+    oldChunks.try_emplace(chunks[i].hash, i);
+    touchedGlobal |= isGlobalDecl(info.kind);
+    if (!info.name.empty())
+      oldSignatures.try_emplace(info.name, info.signatureHash);
+  }
+  for (auto &chunk : newChunks) {
+    auto it = oldChunks.find(chunk.hash);
+    if (it != oldChunks.end()) {
+      const Chunk &old = chunks[it->second];
+      chunk.info = old.info;
+      chunk.diagnostics = old.diagnostics;
+      chunk.dirty = old.dirty;
+    } else {
+      chunk.info = scanChunk(getText(chunk), /*isHeader=*/false);
+    }
+    touchedGlobal |= isGlobalDecl(chunk.info->kind);
+    if (!chunk.info->name.empty())
+      touched.insert(chunk.info->name);
+  }
+
+  for (unsigned i = last + 1, e = chunks.size(); i != e; ++i) {
+    chunks[i].offset += byteDelta;
+    chunks[i].startLine += lineDelta;
+  }
+  chunks.erase(chunks.begin() + first, chunks.begin() + last + 1);
+  chunks.insert(chunks.begin() + first,
+                std::make_move_iterator(newChunks.begin()),
+                std::make_move_iterator(newChunks.end()));
+  return !touchedGlobal;
+}
+
+void FIRRTLDocument::markDependents(
+    const llvm::StringMap<uint64_t> &oldSignatures,
+    const llvm::StringSet<> &touched) {
+  llvm::StringMap<uint64_t> newSignatures;
+  for (const auto &chunk : chunks) {
+    const ChunkInfo &info = *chunk.info;
+    if (touched.contains(info.name))
+      newSignatures.try_emplace(info.name, info.signatureHash);
+  }
+
+  // A declaration changed if it was added, removed, or its signature differs.
+  llvm::StringSet<> changed;
+  auto check = [&](StringRef name) {
+    auto oldIt = oldSignatures.find(name);
+    auto newIt = newSignatures.find(name);
+    if (oldIt == oldSignatures.end() || newIt == newSignatures.end() ||
+        oldIt->second != newIt->second)
+      changed.insert(name);
+  };
+  for (const auto &entry : oldSignatures)
+    check(entry.getKey());
+  for (const auto &entry : touched)
+    check(entry.getKey());
+  if (changed.empty())
+    return;
+
+  for (auto &chunk : chunks)
+    if (llvm::any_of(chunk.info->uses, [&](const SymbolUse &use) {
+          return changed.contains(use.target);
+        }))
+      chunk.dirty = true;
+}
+
+void FIRRTLDocument::update(
+    ArrayRef<lsp::TextDocumentContentChangeEvent> changes, int64_t newVersion,
+    std::vector<lsp::Diagnostic> &diagnostics) {
+  version = newVersion;
+
+  bool fullParse = false;
+  llvm::StringMap<uint64_t> oldSignatures;
+  llvm::StringSet<> touched;
+  for (const auto &change : changes) {
+    if (!change.range) {
+      contents = change.text;
+      splitDocument();
+      fullParse = true;
+    } else if (!applyChange(change, oldSignatures, touched)) {
+      splitDocument();
+      fullParse = true;
+    }
+  }
+
+  if (fullParse) {
+    parseAll();
+  } else {
+    markDependents(oldSignatures, touched);
+    parseDirtyChunks();
+  }
+  getDiagnostics(diagnostics);
+  buildIndex();
+}
+
+void FIRRTLDocument::parseAll() {
+  for (auto &chunk : chunks) {
+    chunk.diagnostics.clear();
+    chunk.dirty = false;
+  }
+  for (auto &diag : parseFIRRTL(contents, uri, /*enableThreading=*/true)) {
+    Chunk &chunk = chunks[findChunk(diag.range.start.line)];
+    // Chunk diagnostics are moved around with their chunk, so only keep the
+    // related information that lives in the same chunk.
+    if (diag.relatedInformation)
+      llvm::erase_if(*diag.relatedInformation, [&](const auto &info) {
+        return !chunk.containsLine(info.location.range.start.line);
+      });
+    shiftLines(diag, -int(chunk.startLine));
+    chunk.diagnostics.push_back(std::move(diag));
+  }
+}
+
+void FIRRTLDocument::parseDirtyChunks() {
+  // Collect the names the dirty chunks need stubs for.
+  const unsigned noChunk = ~0u;
+  SmallVector<unsigned> dirty;
+  llvm::StringMap<unsigned> decls;
+  if (!circuitName.empty())
+    decls.try_emplace(circuitName, noChunk);
+  for (unsigned i = 0, e = chunks.size(); i != e; ++i) {
+    const Chunk &chunk = chunks[i];
+    if (!chunk.dirty)
+      continue;
+    dirty.push_back(i);
+    if (!chunk.info->name.empty())
+      decls.try_emplace(chunk.info->name, noChunk);
+    for (const auto &use : chunk.info->uses)
+      decls.try_emplace(use.target, noChunk);
+  }
+  if (dirty.empty())
+    return;
+
+  // Find the first definition of each of these names, and gather the header
+  // and global declarations every chunk is parsed with.
+  std::string prelude;
+  appendLine(prelude, getText(chunks[0]));
+  for (unsigned i = 1, e = chunks.size(); i != e; ++i) {
+    const ChunkInfo &info = *chunks[i].info;
+    if (isGlobalDecl(info.kind))
+      appendLine(prelude, getText(chunks[i]));
+    auto it = decls.find(info.name);
+    if (it != decls.end() && it->second == noChunk)
+      it->second = i;
+  }
+
+  std::atomic<bool> needsFullParse(false);
+  llvm::parallelFor(0, dirty.size(), [&](size_t i) {
+    if (!parseChunk(dirty[i], prelude, decls))
+      needsFullParse = true;
+  });
+  if (needsFullParse)
+    parseAll();
+}
+
+bool FIRRTLDocument::parseChunk(unsigned index, StringRef prelude,
+                                const llvm::StringMap<unsigned> &decls) {
+  Chunk &chunk = chunks[index];
+  const ChunkInfo &info = *chunk.info;
+
+  // Stand in for the declarations this chunk refers to with their
+  // signatures. Classes are stubbed out as external classes, since a class
+  // without a body would not verify.
+  std::string buffer = prelude.str();
+  llvm::SmallDenseSet<unsigned> stubbed;
+  auto addStub = [&](StringRef name, bool onlyBefore) {
+    auto it = decls.find(name);
+    if (it == decls.end() || it->second >= chunks.size() ||
+        it->second == index || (onlyBefore && it->second > index) ||
+        !stubbed.insert(it->second).second)
+      return;
+    const ChunkInfo &stub = *chunks[it->second].info;
+    StringRef signature = stub.signature;
+    if (stub.kind == DeclKind::Class) {
+      buffer += signature.take_front(stub.keywordCol);
+      buffer += "ext";
+      signature = signature.drop_front(stub.keywordCol);
+    }
+    appendLine(buffer, signature);
+  };
+  // The circuit has to contain its main module, and an earlier declaration
+  // with the same name makes this one a redefinition.
+  addStub(circuitName, /*onlyBefore=*/false);
+  addStub(info.name, /*onlyBefore=*/true);
+  for (const auto &use : info.uses)
+    addStub(use.target, /*onlyBefore=*/false);
+
+  int chunkLine = StringRef(buffer).count('\n');
+  appendLine(buffer, getText(chunk));
+
+  chunk.diagnostics.clear();
+  chunk.dirty = false;
+  bool failedInChunk = false, failedOutside = false;
+  for (auto &diag : parseFIRRTL(buffer, uri, /*enableThreading=*/false)) {
+    bool isError = diag.severity == mlir::lsp::DiagnosticSeverity::Error;
+    int line = diag.range.start.line - chunkLine;
+    if (line < 0 || line >= int(chunk.numLines)) {
+      failedOutside |= isError;
+      continue;
+    }
+    failedInChunk |= isError;
+    shiftLines(diag, -chunkLine);
+    if (diag.relatedInformation)
+      llvm::erase_if(*diag.relatedInformation, [&](const auto &info) {
+        int noteLine = info.location.range.start.line;
+        return noteLine < 0 || noteLine >= int(chunk.numLines);
+      });
+    chunk.diagnostics.push_back(std::move(diag));
+  }
+  return failedInChunk || !failedOutside;
+}
+
+void FIRRTLDocument::getDiagnostics(
+    std::vector<lsp::Diagnostic> &diagnostics) const {
+  for (const auto &chunk : chunks) {
+    for (auto diag : chunk.diagnostics) {
+      shiftLines(diag, chunk.startLine);
+      diagnostics.push_back(std::move(diag));
+    }
+  }
+}
+
+void FIRRTLDocument::buildIndex() {
+  std::vector<ChunkRef> snapshot;
+  snapshot.reserve(chunks.size());
+  for (const auto &chunk : chunks)
+    snapshot.push_back({chunk.startLine, chunk.numLines, chunk.info});
+
+  // Queries wait on the future, so they are answered from the index of the
+  // latest version once it is done.
+  std::packaged_task<std::shared_ptr<const SymbolIndex>()> task(
+      [snapshot = std::move(snapshot)] {
+        return SymbolIndex::build(snapshot);
+      });
+  index = task.get_future().share();
+  std::thread(std::move(task)).detach();
+}
+
+//===----------------------------------------------------------------------===//
+// FIRRTLDocument: Queries
+//===----------------------------------------------------------------------===//
+
+void FIRRTLDocument::getLocationsOf(const lsp::Position &defPos,
+                                    std::vector<lsp::Location> &locations) {
+  auto symbols = index.get();
+  const auto *occ = symbols->lookup(defPos);
+  if (!occ)
+    return;
+  if (const auto *decl = symbols->lookupDecl(occ->symbol))
+    locations.emplace_back(uri, getDeclNameRange(*decl));
+}
+
+void FIRRTLDocument::findReferencesOf(const lsp::Position &pos,
+                                      std::vector<lsp::Location> &references) {
+  auto symbols = index.get();
+  const auto *occ = symbols->lookup(pos);
+  if (!occ)
+    return;
+  if (const auto *decl = symbols->lookupDecl(occ->symbol))
+    references.emplace_back(uri, getDeclNameRange(*decl));
+  auto it = symbols->uses.find(occ->symbol);
+  if (it == symbols->uses.end())
+    return;
+  for (const auto &range : it->second)
+    references.emplace_back(uri, range);
+}
+
+std::optional<lsp::Hover>
+FIRRTLDocument::findHover(const lsp::Position &hoverPos) {
+  auto symbols = index.get();
+  const auto *occ = symbols->lookup(hoverPos);
+  if (!occ)
+    return std::nullopt;
+  const auto *decl = symbols->lookupDecl(occ->symbol);
+
+  lsp::Hover hover(occ->range);
+  hover.contents.kind = mlir::lsp::MarkupKind::Markdown;
+  llvm::raw_string_ostream os(hover.contents.value);
+  if (occ->instance)
+    os << "**instance** `" << occ->instance->name << "` of `"
+       << occ->instance->target << "`\n";
+  else if (decl)
+    os << "**" << getDeclKindName(decl->info->kind) << "** `"
+       << decl->info->name << "`\n";
+  else
+    os << "unknown declaration `" << occ->symbol << "`\n";
+
+  // Show the signature of the declaration and how often it is used.
+  if (decl) {
+    os << "\n```firrtl\n"
+       << StringRef(decl->info->signature).rtrim() << "\n```\n";
+    auto it = symbols->uses.find(decl->info->name);
+    size_t numUses = it == symbols->uses.end() ? 0 : it->second.size();
+    os << "\n" << numUses << (numUses == 1 ? " use" : " uses") << "\n";
+  }
+  os.flush();
+  return hover;
+}
+
+void FIRRTLDocument::findDocumentSymbols(
+    std::vector<lsp::DocumentSymbol> &symbols) {
+  auto symbolIndex = index.get();
+  for (const auto &decl : symbolIndex->decls) {
+    const ChunkInfo &info = *decl.info;
+    mlir::lsp::SymbolKind kind;
+    switch (info.kind) {
+    case DeclKind::Class:
+    case DeclKind::ExtClass:
+      kind = mlir::lsp::SymbolKind::Class;
+      break;
+    case DeclKind::Formal:
+      kind = mlir::lsp::SymbolKind::Function;
+      break;
+    case DeclKind::Layer:
+      kind = mlir::lsp::SymbolKind::Namespace;
+      break;
+    case DeclKind::Type:
+      kind = mlir::lsp::SymbolKind::TypeParameter;
+      break;
+    case DeclKind::Option:
+      kind = mlir::lsp::SymbolKind::Enum;
+      break;
+    default:
+      kind = mlir::lsp::SymbolKind::Module;
+      break;
+    }
+
+    mlir::lsp::Range range(mlir::lsp::Position(decl.startLine, 0),
+                           mlir::lsp::Position(decl.startLine + decl.numLines,
+                                               0));
+    symbols.emplace_back(info.name, kind, range, getDeclNameRange(decl));
+    auto &symbol = symbols.back();
+    symbol.detail = getDeclKindName(info.kind).str();
+
+    for (const auto &use : info.uses) {
+      if (use.name.empty())
+        continue;
+      unsigned line = decl.startLine + use.line;
+      mlir::lsp::Range useRange(mlir::lsp::Position(line, 0),
+                                mlir::lsp::Position(line + 1, 0));
+      symbol.children.emplace_back(use.name, mlir::lsp::SymbolKind::Object,
+                                   useRange,
+                                   getNameRange(line, use.nameCol, use.name));
+      symbol.children.back().detail = use.target;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// FIRRTLServer::Impl
+//===----------------------------------------------------------------------===//
+
+struct lsp::FIRRTLServer::Impl {
+  /// The documents held by the server, mapped by their file path.
+  llvm::StringMap<std::unique_ptr<FIRRTLDocument>> files;
+};
+
+//===----------------------------------------------------------------------===//
+// FIRRTLServer
+//===----------------------------------------------------------------------===//
+
+lsp::FIRRTLServer::FIRRTLServer() : impl(std::make_unique<Impl>()) {}
+lsp::FIRRTLServer::~FIRRTLServer() = default;
+
+void lsp::FIRRTLServer::addDocument(const URIForFile &uri, StringRef contents,
+                                    int64_t version,
+                                    std::vector<Diagnostic> &diagnostics) {
+  impl->files[uri.file()] =
+      std::make_unique<FIRRTLDocument>(uri, contents, version, diagnostics);
+}
+
+void lsp::FIRRTLServer::updateDocument(
+    const URIForFile &uri, ArrayRef<TextDocumentContentChangeEvent> changes,
+    int64_t version, std::vector<Diagnostic> &diagnostics) {
+  auto it = impl->files.find(uri.file());
+  if (it == impl->files.end())
+    return;
+  it->second->update(changes, version, diagnostics);
+}
+
+std::optional<int64_t>
+lsp::FIRRTLServer::removeDocument(const URIForFile &uri) {
+  auto it = impl->files.find(uri.file());
+  if (it == impl->files.end())
+    return std::nullopt;
+
+  int64_t version = it->second->getVersion();
+  impl->files.erase(it);
+  return version;
+}
+
+void lsp::FIRRTLServer::getLocationsOf(const URIForFile &uri,
+                                       const Position &defPos,
+                                       std::vector<Location> &locations) {
+  auto fileIt = impl->files.find(uri.file());
+  if (fileIt != impl->files.end())
+    fileIt->second->getLocationsOf(defPos, locations);
+}
+
+void lsp::FIRRTLServer::findReferencesOf(const URIForFile &uri,
+                                         const Position &pos,
+                                         std::vector<Location> &references) {
+  auto fileIt = impl->files.find(uri.file());
+  if (fileIt != impl->files.end())
+    fileIt->second->findReferencesOf(pos, references);
+}
+
+std::optional<lsp::Hover>
+lsp::FIRRTLServer::findHover(const URIForFile &uri, const Position &hoverPos) {
+  auto fileIt = impl->files.find(uri.file());
+  if (fileIt != impl->files.end())
+    return fileIt->second->findHover(hoverPos);
+  return std::nullopt;
+}
+
+void lsp::FIRRTLServer::findDocumentSymbols(
+    const URIForFile &uri, std::vector<DocumentSymbol> &symbols) {
+  auto fileIt = impl->files.find(uri.file());
+  if (fileIt != impl->files.end())
+    fileIt->second->findDocumentSymbols(symbols);
+}
@@ -0,0 +1,98 @@
+//===- FIRRTLServer.h - FIRRTL Language Server ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the FIRRTLServer, which keeps track of the .fir
+// documents open in the editor and answers language queries about them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIB_TOOLS_CIRCT_FIRRTL_LSP_SERVER_FIRRTLSERVER_H
+#define LIB_TOOLS_CIRCT_FIRRTL_LSP_SERVER_FIRRTLSERVER_H
+
+#include "circt/Support/LLVM.h"
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace mlir {
+namespace lsp {
+struct Diagnostic;
+struct DocumentSymbol;
+struct Hover;
+struct Location;
+struct Position;
+struct TextDocumentContentChangeEvent;
+class URIForFile;
+} // namespace lsp
+} // namespace mlir
+
+namespace circt {
+namespace lsp {
+using Diagnostic = mlir::lsp::Diagnostic;
+using DocumentSymbol = mlir::lsp::DocumentSymbol;
+using Hover = mlir::lsp::Hover;
+using Location = mlir::lsp::Location;
+using Position = mlir::lsp::Position;
+using TextDocumentContentChangeEvent =
+    mlir::lsp::TextDocumentContentChangeEvent;
+using URIForFile = mlir::lsp::URIForFile;
+
+/// This class implements all of the FIRRTL related functionality necessary
+/// for a language server.
+///
+/// Documents are split into chunks, one per top-level declaration, so that an
+/// edit only rescans and reparses the declarations it touches. The symbol and
+/// instance index used to answer queries is rebuilt on a background thread
+/// after each change.
+class FIRRTLServer {
+public:
+  FIRRTLServer();
+  ~FIRRTLServer();
+
+  /// Add the document, with the provided `version`, at the given URI. Any
+  /// diagnostics emitted for this document should be added to `diagnostics`.
+  void addDocument(const URIForFile &uri, StringRef contents, int64_t version,
+                   std::vector<Diagnostic> &diagnostics);
+
+  /// Update the document, with the provided `version`, at the given URI. Any
+  /// diagnostics emitted for this document should be added to `diagnostics`.
+  void updateDocument(const URIForFile &uri,
+                      ArrayRef<TextDocumentContentChangeEvent> changes,
+                      int64_t version, std::vector<Diagnostic> &diagnostics);
+
+  /// Remove the document with the given URI. Returns the version of the
+  /// removed document, or std::nullopt if the uri did not have a
+  /// corresponding document within the server.
+  std::optional<int64_t> removeDocument(const URIForFile &uri);
+
+  /// Return the locations of the object pointed at by the given position.
+  void getLocationsOf(const URIForFile &uri, const Position &defPos,
+                      std::vector<Location> &locations);
+
+  /// Find all references of the object pointed at by the given position.
+  void findReferencesOf(const URIForFile &uri, const Position &pos,
+                        std::vector<Location> &references);
+
+  /// Find a hover description for the given hover position, or std::nullopt
+  /// if one couldn't be found.
+  std::optional<Hover> findHover(const URIForFile &uri,
+                                 const Position &hoverPos);
+
+  /// Find all of the document symbols within the given file.
+  void findDocumentSymbols(const URIForFile &uri,
+                           std::vector<DocumentSymbol> &symbols);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl;
+};
+
+} // namespace lsp
+} // namespace circt
+
+#endif // LIB_TOOLS_CIRCT_FIRRTL_LSP_SERVER_FIRRTLSERVER_H
@@ -0,0 +1,32 @@
+//===- LSPServer.h - FIRRTL LSP Server --------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIB_TOOLS_CIRCT_FIRRTL_LSP_SERVER_LSPSERVER_H
+#define LIB_TOOLS_CIRCT_FIRRTL_LSP_SERVER_LSPSERVER_H
+
+#include "circt/Support/LLVM.h"
+
+namespace mlir {
+namespace lsp {
+class JSONTransport;
+} // namespace lsp
+} // namespace mlir
+
+namespace circt {
+namespace lsp {
+class FIRRTLServer;
+
+/// Run the main loop of the LSP server using the given FIRRTL server and
+/// transport.
+LogicalResult runFIRRTLLSPServer(FIRRTLServer &server,
+                                 mlir::lsp::JSONTransport &transport);
+
+} // namespace lsp
+} // namespace circt
+
+#endif // LIB_TOOLS_CIRCT_FIRRTL_LSP_SERVER_LSPSERVER_H
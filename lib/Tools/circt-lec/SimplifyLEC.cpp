@@ -0,0 +1,586 @@
+//===- SimplifyLEC.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass reduces the work the SMT solver has to do for a `verif.lec`
+// operation. The two circuits are merged into a single structurally hashed
+// graph, outputs computed by identical logic are discharged right away, random
+// simulation refutes non-equivalent outputs and proposes equivalent internal
+// signals, and the remaining outputs are checked one at a time on their cone of
+// influence only.
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Analysis/BitParallelSimulation.h"
+#include "circt/Dialect/Comb/CombOps.h"
+#include "circt/Dialect/HW/HWOps.h"
+#include "circt/Dialect/Verif/VerifOps.h"
+#include "circt/Tools/circt-lec/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Debug.h"
+#include <random>
+
+#define DEBUG_TYPE "simplify-lec"
+
+using namespace mlir;
+using namespace circt;
+using namespace circt::analysis;
+
+namespace circt {
+#define GEN_PASS_DEF_SIMPLIFYLEC
+#include "circt/Tools/circt-lec/Passes.h.inc"
+} // namespace circt
+
+//===----------------------------------------------------------------------===//
+// Miter graph
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// A node in the structurally hashed miter of the two circuits. The first
+/// nodes are the shared inputs; every other node is a result of an operation
+/// in one of the circuits. Operations with the same name, attributes, and
+/// operand nodes map to the same node, such that logic present in both
+/// circuits is represented only once.
+struct Node {
+  /// The operation computing this node, null for inputs.
+  Operation *op = nullptr;
+  /// The result number of `op`, or the index of the input.
+  unsigned index = 0;
+  Type type;
+  /// The operand nodes of `op`, in operand order.
+  SmallVector<unsigned, 2> operands;
+  /// The length of the longest path from any input to this node.
+  unsigned level = 0;
+};
+
+/// A pair of nodes in the first and second circuit that random simulation
+/// could not distinguish. Once proven equal, the two nodes can be replaced by
+/// a shared free variable when checking logic in their fan-out.
+struct Candidate {
+  unsigned first, second;
+};
+
+class LECSimplifier {
+public:
+  LECSimplifier(verif::LogicEquivalenceCheckingOp lec,
+                SymbolTable &symbolTable, unsigned numPatterns, uint64_t seed,
+                bool sweep, unsigned maxCandidates)
+      : lec(lec), symbolTable(symbolTable), numPatterns(numPatterns),
+        seed(seed), sweep(sweep), maxCandidates(maxCandidates) {}
+
+  /// Build the miter graph. Fails if the circuits contain operations that
+  /// cannot be split into cones of logic, in which case the `verif.lec` has to
+  /// be left untouched.
+  LogicalResult build();
+
+  /// Replace the `verif.lec` with the simplified checks.
+  void simplify();
+
+private:
+  LogicalResult addCircuit(Block &block, SmallVectorImpl<unsigned> &outputs);
+  unsigned lookupOrCreateNode(Operation *op, unsigned resultNumber,
+                              ArrayRef<unsigned> operands);
+
+  void simulate();
+  Value getValue(unsigned node) const;
+  bool isKnown(unsigned node) const { return known[node]; }
+  ArrayRef<uint64_t> getPatterns(unsigned node) const;
+  void findCandidates();
+
+  BitVector getCone(unsigned root) const;
+  Value cloneCone(OpBuilder &builder, unsigned root,
+                  DenseMap<unsigned, Value> &mapping) const;
+  Value buildCheck(OpBuilder &builder, unsigned firstRoot, unsigned secondRoot,
+                   ArrayRef<unsigned> cuts) const;
+  func::FuncOp buildOutputCheck(unsigned output);
+
+  verif::LogicEquivalenceCheckingOp lec;
+  SymbolTable &symbolTable;
+  unsigned numPatterns;
+  uint64_t seed;
+  bool sweep;
+  unsigned maxCandidates;
+
+  unsigned numInputs = 0;
+  SmallVector<Node> nodes;
+  DenseMap<Value, unsigned> nodeOf;
+  DenseMap<ArrayRef<uintptr_t>, unsigned> hashTable;
+  llvm::BumpPtrAllocator keyAllocator;
+  SmallVector<unsigned> firstOutputs, secondOutputs;
+
+  /// The simulations of the two circuits on the same input patterns. The
+  /// patterns of a node are valid only if the node's bit in `known` is set.
+  std::optional<BitParallelSimulator> firstSim, secondSim;
+  BitVector known;
+
+  /// Candidate equivalences, ordered such that the nodes of a candidate only
+  /// depend on the nodes of earlier candidates.
+  SmallVector<Candidate> candidates;
+};
+} // namespace
+
+LogicalResult LECSimplifier::build() {
+  Block &first = lec.getFirstCircuit().front();
+  Block &second = lec.getSecondCircuit().front();
+  numInputs = first.getNumArguments();
+  for (unsigned i = 0; i < numInputs; ++i) {
+    Node &node = nodes.emplace_back();
+    node.index = i;
+    node.type = first.getArgument(i).getType();
+    nodeOf[first.getArgument(i)] = i;
+    nodeOf[second.getArgument(i)] = i;
+  }
+  if (failed(addCircuit(first, firstOutputs)) ||
+      failed(addCircuit(second, secondOutputs)))
+    return failure();
+  return success(firstOutputs.size() == secondOutputs.size());
+}
+
+LogicalResult LECSimplifier::addCircuit(Block &block,
+                                        SmallVectorImpl<unsigned> &outputs) {
+  SmallVector<unsigned> operands;
+  for (auto &op : block) {
+    // Only the logic in the cone of an output is kept, so anything that has an
+    // effect beyond computing its results prevents the decomposition.
+    if (op.getNumRegions() != 0 ||
+        (!isMemoryEffectFree(&op) && !isa<hw::InstanceOp>(op) &&
+         !op.hasTrait<OpTrait::IsTerminator>()))
+      return failure();
+
+    operands.clear();
+    for (auto operand : op.getOperands()) {
+      auto it = nodeOf.find(operand);
+      if (it == nodeOf.end())
+        return failure();
+      operands.push_back(it->second);
+    }
+    if (op.hasTrait<OpTrait::IsTerminator>()) {
+      outputs.append(operands);
+      continue;
+    }
+    for (auto result : op.getResults())
+      nodeOf[result] =
+          lookupOrCreateNode(&op, result.getResultNumber(), operands);
+  }
+  return success();
+}
+
+unsigned LECSimplifier::lookupOrCreateNode(Operation *op, unsigned resultNumber,
+                                           ArrayRef<unsigned> operands) {
+  auto createNode = [&] {
+    Node &node = nodes.emplace_back();
+    node.op = op;
+    node.index = resultNumber;
+    node.type = op->getResult(resultNumber).getType();
+    node.operands.assign(operands.begin(), operands.end());
+    for (auto operand : operands)
+      node.level = std::max(node.level, nodes[operand].level + 1);
+    return nodes.size() - 1;
+  };
+
+  // Instances are treated as opaque.
+  if (isa<hw::InstanceOp>(op))
+    return createNode();
+
+  // Inherent attributes live in the properties; discardable attributes such
+  // as name hints must not prevent merging.
+  SmallVector<uintptr_t, 8> key;
+  key.push_back(
+      reinterpret_cast<uintptr_t>(op->getName().getAsOpaquePointer()));
+  key.push_back(reinterpret_cast<uintptr_t>(
+      op->getPropertiesAsAttribute().getAsOpaquePointer()));
+  if (op->getPropertiesStorageSize() == 0)
+    key.push_back(reinterpret_cast<uintptr_t>(
+        op->getRawDictionaryAttrs().getAsOpaquePointer()));
+  key.push_back(reinterpret_cast<uintptr_t>(
+      op->getResult(resultNumber).getType().getAsOpaquePointer()));
+  key.push_back(resultNumber);
+  size_t operandsBegin = key.size();
+  key.append(operands.begin(), operands.end());
+  if (op->hasTrait<OpTrait::IsCommutative>())
+    llvm::sort(key.begin() + operandsBegin, key.end());
+
+  auto it = hashTable.find(ArrayRef<uintptr_t>(key));
+  if (it != hashTable.end())
+    return it->second;
+  auto *storage = keyAllocator.Allocate<uintptr_t>(key.size());
+  llvm::copy(key, storage);
+  unsigned node = createNode();
+  hashTable.insert({ArrayRef<uintptr_t>(storage, key.size()), node});
+  return node;
+}
+
+//===----------------------------------------------------------------------===//
+// Random simulation
+//===----------------------------------------------------------------------===//
+
+void LECSimplifier::simulate() {
+  Block &first = lec.getFirstCircuit().front();
+  Block &second = lec.getSecondCircuit().front();
+  unsigned numWords = llvm::divideCeil(numPatterns, 64);
+  firstSim.emplace(numWords);
+  secondSim.emplace(numWords);
+  // Operations the simulator does not support simply leave their nodes
+  // unknown.
+  (void)firstSim->compile(first, /*allowUnknown=*/true);
+  (void)secondSim->compile(second, /*allowUnknown=*/true);
+
+  // The first two patterns are all zeros and all ones, which catch a lot of
+  // corner cases; the remaining ones are uniformly random.
+  std::mt19937_64 rng(seed);
+  firstSim->randomizeInputs(rng);
+  for (unsigned i = 0; i < numInputs; ++i) {
+    if (!firstSim->isKnown(first.getArgument(i)))
+      continue;
+    auto words = firstSim->getInputWords(i);
+    for (unsigned k = 0, e = words.size(); k < e; k += numWords)
+      words[k] = (words[k] & ~3ULL) | 2;
+    llvm::copy(words, secondSim->getInputWords(i).begin());
+  }
+  firstSim->evaluate();
+  secondSim->evaluate();
+
+  known.resize(nodes.size());
+  for (unsigned i = 0, e = nodes.size(); i < e; ++i) {
+    Value value = getValue(i);
+    auto &sim = value.getParentBlock() == &first ? *firstSim : *secondSim;
+    if (sim.isKnown(value) && sim.isDefined(value))
+      known.set(i);
+  }
+}
+
+Value LECSimplifier::getValue(unsigned node) const {
+  if (node < numInputs)
+    return lec.getFirstCircuit().getArgument(node);
+  return nodes[node].op->getResult(nodes[node].index);
+}
+
+ArrayRef<uint64_t> LECSimplifier::getPatterns(unsigned node) const {
+  Value value = getValue(node);
+  if (value.getParentBlock() == &lec.getFirstCircuit().front())
+    return firstSim->getWords(value);
+  return secondSim->getWords(value);
+}
+
+void LECSimplifier::findCandidates() {
+  // Determine which nodes are used by only one of the two circuits.
+  BitVector inFirst(nodes.size()), inSecond(nodes.size());
+  for (auto output : firstOutputs)
+    inFirst |= getCone(output);
+  for (auto output : secondOutputs)
+    inSecond |= getCone(output);
+
+  // Bucket the nodes only used by the first circuit by their simulated values.
+  DenseMap<llvm::hash_code, SmallVector<unsigned, 1>> buckets;
+  auto hashPatterns = [&](unsigned node) {
+    return llvm::hash_combine(
+        nodes[node].type.getAsOpaquePointer(),
+        llvm::hash_combine_range(getPatterns(node).begin(),
+                                 getPatterns(node).end()));
+  };
+  for (unsigned i = numInputs, e = nodes.size(); i < e; ++i)
+    if (inFirst[i] && !inSecond[i] && isKnown(i))
+      buckets[hashPatterns(i)].push_back(i);
+
+  // Pair every node only used by the second circuit with the shallowest
+  // indistinguishable node of the first circuit.
+  for (unsigned i = numInputs, e = nodes.size(); i < e; ++i) {
+    if (!inSecond[i] || inFirst[i] || !isKnown(i))
+      continue;
+    auto it = buckets.find(hashPatterns(i));
+    if (it == buckets.end())
+      continue;
+    for (auto first : it->second) {
+      if (nodes[first].type != nodes[i].type ||
+          getPatterns(first) != getPatterns(i))
+        continue;
+      candidates.push_back({first, i});
+      break;
+    }
+  }
+
+  // Order the candidates such that the nodes of a candidate are only in the
+  // fan-out of earlier candidates' nodes. Keep the shallowest ones if there
+  // are too many.
+  llvm::stable_sort(candidates, [&](auto &a, auto &b) {
+    return nodes[a.first].level + nodes[a.second].level <
+           nodes[b.first].level + nodes[b.second].level;
+  });
+  if (candidates.size() > maxCandidates)
+    candidates.resize(maxCandidates);
+  LLVM_DEBUG(llvm::dbgs() << "Found " << candidates.size()
+                          << " candidate equivalences\n");
+}
+
+//===----------------------------------------------------------------------===//
+// Check construction
+//===----------------------------------------------------------------------===//
+
+BitVector LECSimplifier::getCone(unsigned root) const {
+  BitVector cone(nodes.size());
+  SmallVector<unsigned> worklist{root};
+  cone.set(root);
+  while (!worklist.empty())
+    for (auto operand : nodes[worklist.pop_back_val()].operands)
+      if (!cone[operand]) {
+        cone.set(operand);
+        worklist.push_back(operand);
+      }
+  return cone;
+}
+
+Value LECSimplifier::cloneCone(OpBuilder &builder, unsigned root,
+                               DenseMap<unsigned, Value> &mapping) const {
+  // Collect the nodes not yet materialized, stopping at cut points.
+  SmallVector<unsigned> worklist{root}, cone;
+  DenseSet<unsigned> visited;
+  while (!worklist.empty()) {
+    unsigned node = worklist.pop_back_val();
+    if (mapping.count(node) || !visited.insert(node).second)
+      continue;
+    cone.push_back(node);
+    worklist.append(nodes[node].operands.begin(), nodes[node].operands.end());
+  }
+
+  // Node indices are in topological order.
+  llvm::sort(cone);
+  IRMapping irMapping;
+  for (auto node : cone) {
+    if (mapping.count(node))
+      continue;
+    Operation *op = nodes[node].op;
+    for (auto [operand, operandNode] :
+         llvm::zip(op->getOperands(), nodes[node].operands))
+      irMapping.map(operand, mapping.lookup(operandNode));
+    Operation *clone = builder.clone(*op, irMapping);
+    // Register all results of the clone, since they may be used by later
+    // nodes as well.
+    for (auto result : op->getResults())
+      mapping.try_emplace(nodeOf.lookup(result),
+                          clone->getResult(result.getResultNumber()));
+  }
+  return mapping.lookup(root);
+}
+
+Value LECSimplifier::buildCheck(OpBuilder &builder, unsigned firstRoot,
+                                unsigned secondRoot,
+                                ArrayRef<unsigned> cuts) const {
+  Location loc = lec.getLoc();
+  SmallVector<Type> argTypes;
+  for (unsigned i = 0; i < numInputs; ++i)
+    argTypes.push_back(nodes[i].type);
+  for (auto cut : cuts)
+    argTypes.push_back(nodes[candidates[cut].first].type);
+  SmallVector<Location> argLocs(argTypes.size(), loc);
+
+  auto check = builder.create<verif::LogicEquivalenceCheckingOp>(loc);
+  OpBuilder::InsertionGuard guard(builder);
+  for (auto [region, root] : {std::make_pair(&check.getFirstCircuit(),
+                                             firstRoot),
+                              std::make_pair(&check.getSecondCircuit(),
+                                             secondRoot)}) {
+    Block *block = builder.createBlock(region, {}, argTypes, argLocs);
+    DenseMap<unsigned, Value> mapping;
+    for (unsigned i = 0; i < numInputs; ++i)
+      mapping[i] = block->getArgument(i);
+    // Each cut replaces both nodes of the candidate with the same variable.
+    // Only one of them can be in the cone of either circuit.
+    for (auto [i, cut] : llvm::enumerate(cuts)) {
+      auto arg = block->getArgument(numInputs + i);
+      mapping[candidates[cut].first] = arg;
+      mapping[candidates[cut].second] = arg;
+    }
+    Value output = cloneCone(builder, root, mapping);
+    builder.create<verif::YieldOp>(loc, output);
+  }
+  return check.getAreEquivalent();
+}
+
+/// Build an `scf.if` which yields the value built by `thenBuilder` if `cond`
+/// holds, and the one built by `elseBuilder` otherwise.
+static Value
+buildIf(OpBuilder &builder, Location loc, Value cond,
+        llvm::function_ref<Value(OpBuilder &)> thenBuilder,
+        llvm::function_ref<Value(OpBuilder &)> elseBuilder) {
+  auto ifOp = builder.create<scf::IfOp>(
+      loc, cond,
+      [&](OpBuilder &builder, Location loc) {
+        builder.create<scf::YieldOp>(loc, thenBuilder(builder));
+      },
+      [&](OpBuilder &builder, Location loc) {
+        builder.create<scf::YieldOp>(loc, elseBuilder(builder));
+      });
+  return ifOp.getResult(0);
+}
+
+static Value buildBool(OpBuilder &builder, Location loc, bool value) {
+  return builder.create<arith::ConstantOp>(loc, builder.getBoolAttr(value));
+}
+
+func::FuncOp LECSimplifier::buildOutputCheck(unsigned output) {
+  Location loc = lec.getLoc();
+  auto parent = lec->getParentOfType<func::FuncOp>();
+  OpBuilder builder(lec.getContext());
+  auto func = func::FuncOp::create(
+      loc, (parent.getSymName() + "_output_" + Twine(output)).str(),
+      builder.getFunctionType({}, builder.getI1Type()));
+  func.setPrivate();
+  func->setAttr("circt.lec.output", builder.getI32IntegerAttr(output));
+  symbolTable.insert(func, Block::iterator(parent));
+  builder.setInsertionPointToStart(func.addEntryBlock());
+
+  unsigned firstRoot = firstOutputs[output];
+  unsigned secondRoot = secondOutputs[output];
+  auto buildFullCheck = [&](OpBuilder &builder) {
+    return buildCheck(builder, firstRoot, secondRoot, {});
+  };
+
+  // Only use the candidates whose nodes are both in the cone of the output.
+  BitVector firstCone = getCone(firstRoot), secondCone = getCone(secondRoot);
+  SmallVector<unsigned> cuts;
+  for (auto [i, candidate] : llvm::enumerate(candidates))
+    if (firstCone[candidate.first] && secondCone[candidate.second])
+      cuts.push_back(i);
+
+  if (cuts.empty()) {
+    builder.create<func::ReturnOp>(loc, buildFullCheck(builder));
+    return func;
+  }
+
+  // Prove the candidates in order. Each proof may assume the earlier
+  // candidates in its fan-in to hold, which keeps the individual checks small.
+  Value lemmasHold;
+  for (auto [i, cut] : llvm::enumerate(cuts)) {
+    auto &candidate = candidates[cut];
+    BitVector first = getCone(candidate.first);
+    BitVector second = getCone(candidate.second);
+    SmallVector<unsigned> innerCuts;
+    for (auto earlier : ArrayRef(cuts).take_front(i)) {
+      auto &inner = candidates[earlier];
+      if (inner.first != candidate.first && inner.second != candidate.second &&
+          first[inner.first] && second[inner.second])
+        innerCuts.push_back(earlier);
+    }
+    auto buildLemma = [&](OpBuilder &builder) {
+      return buildCheck(builder, candidate.first, candidate.second, innerCuts);
+    };
+    if (!lemmasHold)
+      lemmasHold = buildLemma(builder);
+    else
+      lemmasHold = buildIf(builder, loc, lemmasHold, buildLemma,
+                           [&](OpBuilder &builder) {
+                             return buildBool(builder, loc, false);
+                           });
+  }
+
+  // If all candidates hold, check the output with all of them cut. The cuts
+  // over-approximate the circuits, so fall back to the full check if this
+  // fails or any candidate does not hold.
+  Value result = buildIf(
+      builder, loc, lemmasHold,
+      [&](OpBuilder &builder) {
+        Value cutCheck = buildCheck(builder, firstRoot, secondRoot, cuts);
+        return buildIf(
+            builder, loc, cutCheck,
+            [&](OpBuilder &builder) { return buildBool(builder, loc, true); },
+            buildFullCheck);
+      },
+      buildFullCheck);
+  builder.create<func::ReturnOp>(loc, result);
+  return func;
+}
+
+void LECSimplifier::simplify() {
+  Location loc = lec.getLoc();
+  unsigned numOutputs = firstOutputs.size();
+
+  if (numPatterns > 0)
+    simulate();
+
+  SmallVector<unsigned> remaining;
+  bool refuted = false;
+  for (unsigned i = 0; i < numOutputs; ++i) {
+    unsigned first = firstOutputs[i], second = secondOutputs[i];
+    if (first == second) {
+      LLVM_DEBUG(llvm::dbgs() << "Output " << i << " structurally equal\n");
+      continue;
+    }
+    if (numPatterns > 0 && isKnown(first) && isKnown(second) &&
+        getPatterns(first) != getPatterns(second)) {
+      LLVM_DEBUG(llvm::dbgs() << "Output " << i << " refuted by simulation\n");
+      refuted = true;
+      break;
+    }
+    remaining.push_back(i);
+  }
+
+  OpBuilder builder(lec);
+  Value result;
+  if (refuted) {
+    result = buildBool(builder, loc, false);
+  } else {
+    if (sweep && numPatterns > 0 && !remaining.empty())
+      findCandidates();
+
+    // Check the outputs one after the other, stopping at the first one that
+    // differs.
+    for (auto output : remaining) {
+      auto func = buildOutputCheck(output);
+      auto buildCall = [&](OpBuilder &builder) {
+        return builder.create<func::CallOp>(loc, func).getResult(0);
+      };
+      if (!result)
+        result = buildCall(builder);
+      else
+        result = buildIf(builder, loc, result, buildCall,
+                         [&](OpBuilder &builder) {
+                           return buildBool(builder, loc, false);
+                         });
+    }
+    if (!result)
+      result = buildBool(builder, loc, true);
+  }
+
+  lec.getAreEquivalent().replaceAllUsesWith(result);
+  lec.erase();
+}
+
+//===----------------------------------------------------------------------===//
+// SimplifyLEC pass
+//===----------------------------------------------------------------------===//
+
+namespace {
+struct SimplifyLECPass
+    : public circt::impl::SimplifyLECBase<SimplifyLECPass> {
+  using circt::impl::SimplifyLECBase<SimplifyLECPass>::SimplifyLECBase;
+  void runOnOperation() override;
+};
+} // namespace
+
+void SimplifyLECPass::runOnOperation() {
+  SymbolTable symbolTable(getOperation());
+  SmallVector<verif::LogicEquivalenceCheckingOp> lecs;
+  getOperation().walk([&](verif::LogicEquivalenceCheckingOp op) {
+    if (op->getParentOfType<func::FuncOp>())
+      lecs.push_back(op);
+  });
+
+  for (auto lec : lecs) {
+    LECSimplifier simplifier(lec, symbolTable, numPatterns, seed, sweep,
+                             maxCandidates);
+    if (failed(simplifier.build()))
+      continue;
+    simplifier.simplify();
+  }
+}
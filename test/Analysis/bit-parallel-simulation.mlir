@@ -0,0 +1,72 @@
+// RUN: circt-opt %s --test-bit-parallel-simulation | FileCheck %s
+// RUN: circt-opt %s --test-bit-parallel-simulation="cycles=3" | FileCheck %s --check-prefix=CYCLES
+
+// Input `i` holds `p + i` in pattern `p`, so %a = 0, 1, 2, 3 and
+// %b = 1, 2, 3, 4.
+
+// CHECK-LABEL: hw.module @Comb
+hw.module @Comb(in %a: i8, in %b: i8, out x: i8, out y: i8) {
+  %c1_i8 = hw.constant 1 : i8
+  %c-128_i8 = hw.constant -128 : i8
+
+  // CHECK: comb.add {{.*}} {sim.values = [1 : i8, 3 : i8, 5 : i8, 7 : i8]}
+  %add = comb.add %a, %b : i8
+  // CHECK: comb.sub {{.*}} {sim.values = [-1 : i8, -1 : i8, -1 : i8, -1 : i8]}
+  %sub = comb.sub %a, %b : i8
+  // CHECK: comb.mul {{.*}} {sim.values = [0 : i8, 2 : i8, 6 : i8, 12 : i8]}
+  %mul = comb.mul %a, %b : i8
+  // CHECK: comb.divu {{.*}} {sim.values = ["x", 2 : i8, 1 : i8, 1 : i8]}
+  %divu = comb.divu %b, %a : i8
+  // CHECK: comb.mods {{.*}} {sim.values = [0 : i8, 1 : i8, 2 : i8, 3 : i8]}
+  %mods = comb.mods %a, %b : i8
+  // CHECK: comb.shl {{.*}} {sim.values = [1 : i8, 4 : i8, 12 : i8, 32 : i8]}
+  %shl = comb.shl %b, %a : i8
+  // CHECK: comb.shrs {{.*}} {sim.values = [-128 : i8, -64 : i8, -32 : i8, -16 : i8]}
+  %shrs = comb.shrs %c-128_i8, %a : i8
+  // CHECK: comb.icmp {{.*}} {sim.values = [false, false, true, true]}
+  %ugt = comb.icmp ugt %a, %c1_i8 : i8
+  // CHECK: comb.icmp {{.*}} {sim.values = [true, true, true, true]}
+  %slt = comb.icmp slt %sub, %a : i8
+  // CHECK: comb.mux {{.*}} {sim.values = [1 : i8, 2 : i8, 2 : i8, 3 : i8]}
+  %mux = comb.mux %ugt, %a, %b : i8
+  // CHECK: comb.extract {{.*}} {sim.values = [0 : i4, 1 : i4, 2 : i4, 3 : i4]}
+  %a4 = comb.extract %a from 0 : (i8) -> i4
+  // CHECK: comb.extract {{.*}} {sim.values = [1 : i4, 2 : i4, 3 : i4, 4 : i4]}
+  %b4 = comb.extract %b from 0 : (i8) -> i4
+  // CHECK: comb.concat {{.*}} {sim.values = [1 : i8, 18 : i8, 35 : i8, 52 : i8]}
+  %concat = comb.concat %a4, %b4 : i4, i4
+  // CHECK: comb.extract {{.*}} {sim.values = [0 : i2, 0 : i2, 1 : i2, 1 : i2]}
+  %a2 = comb.extract %a from 1 : (i8) -> i2
+  // CHECK: comb.replicate {{.*}} {sim.values = [0 : i4, 0 : i4, 5 : i4, 5 : i4]}
+  %replicate = comb.replicate %a2 : (i2) -> i4
+  // CHECK: comb.parity {{.*}} {sim.values = [true, true, false, true]}
+  %parity = comb.parity %b : i8
+  %a0 = comb.extract %a from 0 : (i8) -> i1
+  %b0 = comb.extract %b from 0 : (i8) -> i1
+  // CHECK: comb.truth_table {{.*}} {sim.values = [true, false, true, false]}
+  %table = comb.truth_table %a0, %b0 -> [false, true, false, false]
+
+  // Undefined values propagate.
+  // CHECK: comb.add {{.*}} {sim.values = ["x", 3 : i8, 3 : i8, 4 : i8]}
+  %undef = comb.add %divu, %a : i8
+
+  // CHECK: hw.output {sim.outputs = {{\[}}[1 : i8, 3 : i8, 5 : i8, 7 : i8], ["x", 3 : i8, 3 : i8, 4 : i8]]}
+  hw.output %add, %undef : i8, i8
+}
+
+// Registers start at their preset value, or zero. %rst = 1, 0, 1, 0 and
+// %clk = 0, 1, 0, 1.
+
+// CYCLES-LABEL: hw.module @Counter
+// CYCLES: hw.output {sim.outputs = {{\[}}[0 : i4, 3 : i4, 0 : i4, 3 : i4], [-8 : i4, -8 : i4, -8 : i4, -8 : i4], [3 : i4, 0 : i4, 3 : i4, 0 : i4]]}
+hw.module @Counter(in %clk: !seq.clock, in %rst: i1, out a: i4, out b: i4, out c: i4) {
+  %c0_i4 = hw.constant 0 : i4
+  %c1_i4 = hw.constant 1 : i4
+  %a = seq.compreg %a_next, %clk reset %rst, %c0_i4 : i4
+  %a_next = comb.add %a, %c1_i4 : i4
+  %b = seq.firreg %b_next clock %clk preset 5 : i4
+  %b_next = comb.add %b, %c1_i4 : i4
+  %c = seq.compreg.ce %c_next, %clk, %rst : i4
+  %c_next = comb.add %c, %c1_i4 : i4
+  hw.output %a, %b, %c : i4, i4, i4
+}
@@ -175,3 +175,49 @@ func.func @test9(%arg0: memref<?xi32>, %arg1 : memref<?xi32>, %arg2 : memref<?xi
   }
   return
 }
+
+// CHECK-LABEL: func @test10
+func.func @test10(%arg0: memref<?xi32>, %arg1: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+  scf.for %arg2 = %c0 to %c10 step %c1 {
+    // CHECK: memref.load %arg0[%arg2] {dependences = []}
+    %0 = memref.load %arg0[%arg2] : memref<?xi32>
+    // CHECK{LITERAL}: memref.store %0, %arg0[%arg2] {dependences = [[[0, 0]], [[1, 1]]]}
+    memref.store %0, %arg0[%arg2] : memref<?xi32>
+    // CHECK{LITERAL}: memref.load %arg0[%arg1] {dependences = [[[0, 0]]]}
+    %1 = memref.load %arg0[%arg1] : memref<?xi32>
+  }
+  return
+}
+
+// CHECK-LABEL: func @test11
+func.func @test11(%arg0: memref<?xi32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+  scf.for %arg2 = %c0 to %c10 step %c1 {
+    // CHECK{LITERAL}: affine.load %arg0[0] {dependences = [[[1, 1]]]}
+    %0 = affine.load %arg0[0] : memref<?xi32>
+    // CHECK{LITERAL}: affine.store %0, %arg0[0] {dependences = [[[0, 0]]]}
+    affine.store %0, %arg0[0] : memref<?xi32>
+  }
+  return
+}
+
+// CHECK-LABEL: func @test12
+func.func @test12(%arg0: memref<?xi32>, %arg1: i1) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+  scf.for %arg2 = %c0 to %c10 step %c1 {
+    scf.if %arg1 {
+      // CHECK: memref.load %arg0[%arg2] {dependences = []}
+      %0 = memref.load %arg0[%arg2] : memref<?xi32>
+      // CHECK{LITERAL}: memref.store %0, %arg0[%arg2] {dependences = [[[0, 0]]]}
+      memref.store %0, %arg0[%arg2] : memref<?xi32>
+    }
+  }
+  return
+}
@@ -175,3 +175,18 @@ func.func @test10(%arg0: memref<5xi32>) {
   }
   return
 }
+
+// CHECK-LABEL: func @test11
+func.func @test11(%arg0: memref<?xi32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+  scf.for %arg1 = %c0 to %c10 step %c1 {
+    // CHECK: memref.load %arg0[%c0] {dependence}
+    %0 = memref.load %arg0[%c0] : memref<?xi32>
+    %1 = arith.addi %0, %0 : i32
+    // CHECK: memref.store %1, %arg0[%c0] {dependence}
+    memref.store %1, %arg0[%c0] : memref<?xi32>
+  }
+  return
+}
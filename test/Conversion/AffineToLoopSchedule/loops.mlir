@@ -178,3 +178,75 @@ func.func @dot_shared_mem(%arg0: memref<128xi32>) -> i32 {
 
   return %0 : i32
 }
+
+// CHECK-LABEL: func @scf_dot
+func.func @scf_dot(%arg0: memref<64xi32>, %arg1: memref<64xi32>) -> i32 {
+  // The bounds of the scf.for loop are used as they are.
+  // CHECK: loopschedule.pipeline II = 1 trip_count = 64 iter_args(%[[ITER_ARG:[^ ]+]] = %c0, %{{[^ ]+}} = %c0_i32)
+  // CHECK: arith.cmpi slt, %[[ITER_ARG]], %c64
+
+  // First stage.
+  // CHECK: %[[STAGE0:.+]]:3 = loopschedule.pipeline.stage
+  // CHECK-DAG: %[[STAGE0_0:.+]] = memref.load %arg0[%arg2]
+  // CHECK-DAG: %[[STAGE0_1:.+]] = memref.load %arg1[%arg2]
+  // CHECK-DAG: %[[STAGE0_2:.+]] = arith.addi %arg2, %c1
+  // CHECK: loopschedule.register %[[STAGE0_0]], %[[STAGE0_1]], %[[STAGE0_2]]
+
+  // Second stage.
+  // CHECK: %[[STAGE1:.+]] = loopschedule.pipeline.stage
+  // CHECK-DAG: arith.muli %[[STAGE0]]#0, %[[STAGE0]]#1 : i32
+
+  // Third stage.
+  // CHECK: %[[STAGE2:.+]] = loopschedule.pipeline.stage
+  // CHECK-DAG: arith.addi %arg3, %[[STAGE1]]
+
+  // LoopSchedule Pipeline terminator.
+  // CHECK: loopschedule.terminator iter_args(%[[STAGE0]]#2, %[[STAGE2]]), results(%[[STAGE2]])
+
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  %c0_i32 = arith.constant 0 : i32
+  %0 = scf.for %arg2 = %c0 to %c64 step %c1 iter_args(%arg3 = %c0_i32) -> (i32) {
+    %1 = memref.load %arg0[%arg2] : memref<64xi32>
+    %2 = memref.load %arg1[%arg2] : memref<64xi32>
+    %3 = arith.muli %1, %2 : i32
+    %4 = arith.addi %arg3, %3 : i32
+    scf.yield %4 : i32
+  }
+
+  return %0 : i32
+}
+
+// A store feeding a load of the next iteration limits the II.
+// CHECK-LABEL: func @scf_recurrence
+// CHECK: loopschedule.pipeline II = 2
+func.func @scf_recurrence(%arg0: memref<1xi32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  scf.for %arg1 = %c0 to %c8 step %c1 {
+    %0 = memref.load %arg0[%c0] : memref<1xi32>
+    %1 = arith.addi %0, %0 : i32
+    memref.store %1, %arg0[%c0] : memref<1xi32>
+  }
+  return
+}
+
+// Loops with operations outside the operator library are left to the
+// sequential lowering.
+// CHECK-LABEL: func @scf_unsupported
+// CHECK-NOT: loopschedule.pipeline
+// CHECK: scf.for
+// CHECK: arith.subi
+func.func @scf_unsupported(%arg0: memref<8xi32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  scf.for %arg1 = %c0 to %c8 step %c1 {
+    %0 = memref.load %arg0[%arg1] : memref<8xi32>
+    %1 = arith.subi %0, %0 : i32
+    memref.store %1, %arg0[%arg1] : memref<8xi32>
+  }
+  return
+}
@@ -0,0 +1,26 @@
+// RUN: circt-opt %s --convert-hw-to-btor2 -o tmp.mlir | FileCheck %s
+
+module {
+  //CHECK:    [[NID0:[0-9]+]] sort bitvec 8
+  //CHECK:    [[NID1:[0-9]+]] input [[NID0]] in
+  hw.module @Folded(in %clock : !seq.clock, in %in : i8) {
+    // Initializers computed from constants are folded into a single constant
+    //CHECK:    [[NID2:[0-9]+]] state [[NID0]] reg
+    //CHECK:    [[NID3:[0-9]+]] constd [[NID0]] 42
+    //CHECK:    [[NID4:[0-9]+]] init [[NID0]] [[NID2]] [[NID3]]
+    %init = seq.initial() {
+      %c40_i8 = hw.constant 40 : i8
+      %c2_i8 = hw.constant 2 : i8
+      %0 = comb.add %c40_i8, %c2_i8 : i8
+      seq.yield %0 : i8
+    } : () -> !seq.immutable<i8>
+    %reg = seq.compreg %in, %clock initial %init : i8
+
+    // Presets are emitted as initial values
+    //CHECK:    [[NID5:[0-9]+]] state [[NID0]] preset
+    //CHECK:    [[NID6:[0-9]+]] constd [[NID0]] -1
+    //CHECK:    [[NID7:[0-9]+]] init [[NID0]] [[NID5]] [[NID6]]
+    %preset = seq.firreg %in clock %clock preset 255 : i8
+    hw.output
+  }
+}
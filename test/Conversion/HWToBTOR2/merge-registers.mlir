@@ -0,0 +1,48 @@
+// RUN: circt-opt %s --convert-hw-to-btor2="merge-registers=true" -o tmp.mlir | FileCheck %s
+
+module {
+  hw.module @Merge(in %clock : !seq.clock) {
+    %c1_i32 = hw.constant 1 : i32
+    %c10_i32 = hw.constant 10 : i32
+
+    // Two counters with the same initial value and next state logic always
+    // hold the same value.
+    %count0 = seq.firreg %next0 clock %clock preset 0 : i32
+    %count1 = seq.firreg %next1 clock %clock preset 0 : i32
+    %next0 = comb.add %count0, %c1_i32 : i32
+    %next1 = comb.add %c1_i32, %count1 : i32
+
+    // A counter that starts out with a different value.
+    %count2 = seq.firreg %next2 clock %clock preset 1 : i32
+    %next2 = comb.add %count2, %c1_i32 : i32
+
+    // Two counters without an initial value may differ from the start.
+    %count3 = seq.firreg %next3 clock %clock : i32
+    %count4 = seq.firreg %next4 clock %clock : i32
+    %next3 = comb.add %count3, %c1_i32 : i32
+    %next4 = comb.add %count4, %c1_i32 : i32
+
+    %lt0 = comb.icmp ult %count0, %c10_i32 : i32
+    %lt1 = comb.icmp ult %count1, %c10_i32 : i32
+    %lt2 = comb.icmp ult %count2, %c10_i32 : i32
+    %eq = comb.icmp eq %count3, %count4 : i32
+    %ok = comb.and %lt0, %lt1, %lt2, %eq : i1
+    verif.assert %ok : i1
+    hw.output
+  }
+}
+
+// CHECK:     [[I32:[0-9]+]] sort bitvec 32
+// CHECK:     [[COUNT0:[0-9]+]] state [[I32]] count0
+// CHECK-NOT: state [[I32]] count1
+// CHECK:     [[COUNT2:[0-9]+]] state [[I32]] count2
+// CHECK:     [[COUNT3:[0-9]+]] state [[I32]] count3
+// CHECK:     [[COUNT4:[0-9]+]] state [[I32]] count4
+// CHECK:     ult {{[0-9]+}} [[COUNT0]]
+// CHECK:     ult {{[0-9]+}} [[COUNT0]]
+// CHECK:     ult {{[0-9]+}} [[COUNT2]]
+// CHECK:     eq {{[0-9]+}} [[COUNT3]] [[COUNT4]]
+// CHECK:     next [[I32]] [[COUNT0]]
+// CHECK:     next [[I32]] [[COUNT2]]
+// CHECK:     next [[I32]] [[COUNT3]]
+// CHECK:     next [[I32]] [[COUNT4]]
@@ -0,0 +1,148 @@
+// RUN: circt-opt %s --convert-hw-to-btor2="cone-of-influence=true" -o tmp.mlir | FileCheck %s --check-prefix=COI
+// RUN: circt-opt %s --convert-hw-to-btor2="share-expressions=true" -o tmp.mlir | FileCheck %s --check-prefix=SHARE
+// RUN: circt-opt %s --convert-hw-to-btor2="merge-registers=true" -o tmp.mlir | FileCheck %s --check-prefix=MERGE
+// RUN: circt-opt %s --convert-hw-to-btor2="cone-of-influence=true share-expressions=true merge-registers=true" -o tmp.mlir | FileCheck %s --check-prefix=ALL
+
+module {
+  hw.module @Reduce(in %clock : !seq.clock, in %reset : i1, in %a : i32, in %b : i32, in %unused : i32) {
+    %c0_i32 = hw.constant 0 : i32
+    %c1_i32 = hw.constant 1 : i32
+    %c10_i32 = hw.constant 10 : i32
+
+    // Two counters with the same next state logic but no initial value. They
+    // start out with arbitrary values and must not be merged.
+    %count0 = seq.compreg %next0, %clock reset %reset, %c0_i32 : i32
+    %count1 = seq.compreg %next1, %clock reset %reset, %c0_i32 : i32
+    %next0 = comb.add %count0, %c1_i32 : i32
+    %next1 = comb.add %c1_i32, %count1 : i32
+
+    // A register that no property depends on
+    %dead = seq.compreg %sum, %clock : i32
+    %sum = comb.add %a, %unused : i32
+
+    // Structurally identical expressions
+    %x0 = comb.xor %a, %b : i32
+    %x1 = comb.xor %a, %b : i32
+    %eq = comb.icmp eq %x0, %x1 : i32
+    %lt0 = comb.icmp ult %count0, %c10_i32 : i32
+    %lt1 = comb.icmp ult %count1, %c10_i32 : i32
+    %lt = comb.and %lt0, %lt1 : i1
+    %ok = comb.and %lt, %eq : i1
+    verif.assert %ok : i1
+    hw.output
+  }
+}
+
+// COI:      [[I1:[0-9]+]] sort bitvec 1
+// COI-NEXT: [[RESET:[0-9]+]] input [[I1]] reset
+// COI-NEXT: [[I32:[0-9]+]] sort bitvec 32
+// COI-NEXT: [[A:[0-9]+]] input [[I32]] a
+// COI-NEXT: [[B:[0-9]+]] input [[I32]] b
+// COI-NEXT: [[COUNT0:[0-9]+]] state [[I32]] count0
+// COI-NEXT: [[COUNT1:[0-9]+]] state [[I32]] count1
+// COI-NEXT: [[C0:[0-9]+]] constd [[I32]] 0
+// COI-NEXT: [[C1:[0-9]+]] constd [[I32]] 1
+// COI-NEXT: [[C10:[0-9]+]] constd [[I32]] 10
+// COI-NEXT: [[NEXT0:[0-9]+]] add [[I32]] [[COUNT0]] [[C1]]
+// COI-NEXT: [[NEXT1:[0-9]+]] add [[I32]] [[C1]] [[COUNT1]]
+// COI-NEXT: [[X0:[0-9]+]] xor [[I32]] [[A]] [[B]]
+// COI-NEXT: [[X1:[0-9]+]] xor [[I32]] [[A]] [[B]]
+// COI-NEXT: [[EQ:[0-9]+]] eq [[I1]] [[X0]] [[X1]]
+// COI-NEXT: [[LT0:[0-9]+]] ult [[I1]] [[COUNT0]] [[C10]]
+// COI-NEXT: [[LT1:[0-9]+]] ult [[I1]] [[COUNT1]] [[C10]]
+// COI-NEXT: [[LT:[0-9]+]] and [[I1]] [[LT0]] [[LT1]]
+// COI-NEXT: [[OK:[0-9]+]] and [[I1]] [[LT]] [[EQ]]
+// COI-NEXT: [[NOT:[0-9]+]] not [[I1]] [[OK]]
+// COI-NEXT: {{[0-9]+}} bad [[NOT]]
+// COI-NEXT: [[ITE0:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT0]]
+// COI-NEXT: {{[0-9]+}} next [[I32]] [[COUNT0]] [[ITE0]]
+// COI-NEXT: [[ITE1:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT1]]
+// COI-NEXT: {{[0-9]+}} next [[I32]] [[COUNT1]] [[ITE1]]
+// COI-NOT: {{.}}
+
+// SHARE:      [[I1:[0-9]+]] sort bitvec 1
+// SHARE-NEXT: [[RESET:[0-9]+]] input [[I1]] reset
+// SHARE-NEXT: [[I32:[0-9]+]] sort bitvec 32
+// SHARE-NEXT: [[A:[0-9]+]] input [[I32]] a
+// SHARE-NEXT: [[B:[0-9]+]] input [[I32]] b
+// SHARE-NEXT: [[UNUSED:[0-9]+]] input [[I32]] unused
+// SHARE-NEXT: [[COUNT0:[0-9]+]] state [[I32]] count0
+// SHARE-NEXT: [[COUNT1:[0-9]+]] state [[I32]] count1
+// SHARE-NEXT: [[DEAD:[0-9]+]] state [[I32]] dead
+// SHARE-NEXT: [[C0:[0-9]+]] constd [[I32]] 0
+// SHARE-NEXT: [[C1:[0-9]+]] constd [[I32]] 1
+// SHARE-NEXT: [[C10:[0-9]+]] constd [[I32]] 10
+// SHARE-NEXT: [[NEXT0:[0-9]+]] add [[I32]] [[COUNT0]] [[C1]]
+// SHARE-NEXT: [[NEXT1:[0-9]+]] add [[I32]] [[COUNT1]] [[C1]]
+// SHARE-NEXT: [[SUM:[0-9]+]] add [[I32]] [[A]] [[UNUSED]]
+// SHARE-NEXT: [[X:[0-9]+]] xor [[I32]] [[A]] [[B]]
+// SHARE-NEXT: [[EQ:[0-9]+]] eq [[I1]] [[X]] [[X]]
+// SHARE-NEXT: [[LT0:[0-9]+]] ult [[I1]] [[COUNT0]] [[C10]]
+// SHARE-NEXT: [[LT1:[0-9]+]] ult [[I1]] [[COUNT1]] [[C10]]
+// SHARE-NEXT: [[LT:[0-9]+]] and [[I1]] [[LT0]] [[LT1]]
+// SHARE-NEXT: [[OK:[0-9]+]] and [[I1]] [[EQ]] [[LT]]
+// SHARE-NEXT: [[NOT:[0-9]+]] not [[I1]] [[OK]]
+// SHARE-NEXT: {{[0-9]+}} bad [[NOT]]
+// SHARE-NEXT: [[ITE0:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT0]]
+// SHARE-NEXT: {{[0-9]+}} next [[I32]] [[COUNT0]] [[ITE0]]
+// SHARE-NEXT: [[ITE1:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT1]]
+// SHARE-NEXT: {{[0-9]+}} next [[I32]] [[COUNT1]] [[ITE1]]
+// SHARE-NEXT: {{[0-9]+}} next [[I32]] [[DEAD]] [[SUM]]
+// SHARE-NOT: {{.}}
+
+// MERGE:      [[I1:[0-9]+]] sort bitvec 1
+// MERGE-NEXT: [[RESET:[0-9]+]] input [[I1]] reset
+// MERGE-NEXT: [[I32:[0-9]+]] sort bitvec 32
+// MERGE-NEXT: [[A:[0-9]+]] input [[I32]] a
+// MERGE-NEXT: [[B:[0-9]+]] input [[I32]] b
+// MERGE-NEXT: [[UNUSED:[0-9]+]] input [[I32]] unused
+// MERGE-NEXT: [[COUNT0:[0-9]+]] state [[I32]] count0
+// MERGE-NEXT: [[COUNT1:[0-9]+]] state [[I32]] count1
+// MERGE-NEXT: [[DEAD:[0-9]+]] state [[I32]] dead
+// MERGE-NEXT: [[C0:[0-9]+]] constd [[I32]] 0
+// MERGE-NEXT: [[C1:[0-9]+]] constd [[I32]] 1
+// MERGE-NEXT: [[C10:[0-9]+]] constd [[I32]] 10
+// MERGE-NEXT: [[NEXT0:[0-9]+]] add [[I32]] [[COUNT0]] [[C1]]
+// MERGE-NEXT: [[NEXT1:[0-9]+]] add [[I32]] [[C1]] [[COUNT1]]
+// MERGE-NEXT: [[SUM:[0-9]+]] add [[I32]] [[A]] [[UNUSED]]
+// MERGE-NEXT: [[X0:[0-9]+]] xor [[I32]] [[A]] [[B]]
+// MERGE-NEXT: [[X1:[0-9]+]] xor [[I32]] [[A]] [[B]]
+// MERGE-NEXT: [[EQ:[0-9]+]] eq [[I1]] [[X0]] [[X1]]
+// MERGE-NEXT: [[LT0:[0-9]+]] ult [[I1]] [[COUNT0]] [[C10]]
+// MERGE-NEXT: [[LT1:[0-9]+]] ult [[I1]] [[COUNT1]] [[C10]]
+// MERGE-NEXT: [[LT:[0-9]+]] and [[I1]] [[LT0]] [[LT1]]
+// MERGE-NEXT: [[OK:[0-9]+]] and [[I1]] [[LT]] [[EQ]]
+// MERGE-NEXT: [[NOT:[0-9]+]] not [[I1]] [[OK]]
+// MERGE-NEXT: {{[0-9]+}} bad [[NOT]]
+// MERGE-NEXT: [[ITE0:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT0]]
+// MERGE-NEXT: {{[0-9]+}} next [[I32]] [[COUNT0]] [[ITE0]]
+// MERGE-NEXT: [[ITE1:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT1]]
+// MERGE-NEXT: {{[0-9]+}} next [[I32]] [[COUNT1]] [[ITE1]]
+// MERGE-NEXT: {{[0-9]+}} next [[I32]] [[DEAD]] [[SUM]]
+// MERGE-NOT: {{.}}
+
+// ALL:      [[I1:[0-9]+]] sort bitvec 1
+// ALL-NEXT: [[RESET:[0-9]+]] input [[I1]] reset
+// ALL-NEXT: [[I32:[0-9]+]] sort bitvec 32
+// ALL-NEXT: [[A:[0-9]+]] input [[I32]] a
+// ALL-NEXT: [[B:[0-9]+]] input [[I32]] b
+// ALL-NEXT: [[COUNT0:[0-9]+]] state [[I32]] count0
+// ALL-NEXT: [[COUNT1:[0-9]+]] state [[I32]] count1
+// ALL-NEXT: [[C0:[0-9]+]] constd [[I32]] 0
+// ALL-NEXT: [[C1:[0-9]+]] constd [[I32]] 1
+// ALL-NEXT: [[C10:[0-9]+]] constd [[I32]] 10
+// ALL-NEXT: [[NEXT0:[0-9]+]] add [[I32]] [[COUNT0]] [[C1]]
+// ALL-NEXT: [[NEXT1:[0-9]+]] add [[I32]] [[COUNT1]] [[C1]]
+// ALL-NEXT: [[X:[0-9]+]] xor [[I32]] [[A]] [[B]]
+// ALL-NEXT: [[EQ:[0-9]+]] eq [[I1]] [[X]] [[X]]
+// ALL-NEXT: [[LT0:[0-9]+]] ult [[I1]] [[COUNT0]] [[C10]]
+// ALL-NEXT: [[LT1:[0-9]+]] ult [[I1]] [[COUNT1]] [[C10]]
+// ALL-NEXT: [[LT:[0-9]+]] and [[I1]] [[LT0]] [[LT1]]
+// ALL-NEXT: [[OK:[0-9]+]] and [[I1]] [[EQ]] [[LT]]
+// ALL-NEXT: [[NOT:[0-9]+]] not [[I1]] [[OK]]
+// ALL-NEXT: {{[0-9]+}} bad [[NOT]]
+// ALL-NEXT: [[ITE0:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT0]]
+// ALL-NEXT: {{[0-9]+}} next [[I32]] [[COUNT0]] [[ITE0]]
+// ALL-NEXT: [[ITE1:[0-9]+]] ite [[I32]] [[RESET]] [[C0]] [[NEXT1]]
+// ALL-NEXT: {{[0-9]+}} next [[I32]] [[COUNT1]] [[ITE1]]
+// ALL-NOT: {{.}}
@@ -0,0 +1,46 @@
+// RUN: circt-verilog --ir-moore %s | FileCheck %s
+// RUN: circt-verilog --ir-moore --parallel-module-bodies %s | FileCheck %s
+// RUN: circt-verilog --ir-moore --parallel-module-bodies --mlir-disable-threading %s | FileCheck %s
+// RUN: circt-verilog --ir-moore --print-memory-usage %s 2>&1 >/dev/null | FileCheck %s --check-prefix=CHECK-MEMORY
+// REQUIRES: slang
+
+// Internal issue in Slang v3 about jump depending on uninitialised value.
+// UNSUPPORTED: valgrind
+
+// Module bodies may be converted concurrently, but symbol names are assigned in
+// the order of a breadth-first walk of the hierarchy, with or without threads.
+
+// CHECK-LABEL: moore.module @Top()
+// CHECK:         moore.instance "a0" @Leaf(
+// CHECK:         moore.instance "a1" @Leaf_0(
+// CHECK:         moore.instance "b0" @Mid(
+// CHECK:         moore.instance "b1" @Mid_1(
+module Top;
+  Leaf #(1) a0();
+  Leaf #(2) a1();
+  Mid #(3) b0();
+  Mid #(4) b1();
+endmodule
+
+// CHECK-LABEL: moore.module private @Mid()
+// CHECK:         moore.instance "c" @Leaf_2(
+// CHECK-LABEL: moore.module private @Mid_1()
+// CHECK:         moore.instance "c" @Leaf_3(
+module Mid #(parameter int P);
+  Leaf #(P * 10) c();
+endmodule
+
+// CHECK-LABEL: moore.module private @Leaf()
+// CHECK:         moore.variable
+// CHECK-LABEL: moore.module private @Leaf_0()
+// CHECK-LABEL: moore.module private @Leaf_2()
+// CHECK-LABEL: moore.module private @Leaf_3()
+// CHECK:         moore.variable
+module Leaf #(parameter int P);
+  int x = P;
+endmodule
+
+// CHECK-MEMORY: ===- Verilog frontend memory usage -===
+// CHECK-MEMORY: Verilog parser
+// CHECK-MEMORY: Verilog elaboration
+// CHECK-MEMORY: Verilog to dialect mapping
@@ -188,6 +188,55 @@ func.func @dot(%arg0: memref<64xi32>, %arg1: memref<64xi32>) -> i32 {
 
 // -----
 
+// A pipeline created from an scf.for loop compares the induction variable with
+// a signed predicate, and runs the steady state for all but the prologue and
+// epilogue iterations.
+
+// CHECK:     module attributes {calyx.entrypoint = "scf_dot"} {
+// CHECK:       calyx.component @scf_dot
+// CHECK-DAG:     %[[C64:.+]] = hw.constant 64 : i32
+// CHECK-DAG:     %[[SLT_LEFT:.+]], %[[SLT_RIGHT:.+]], %[[SLT_OUT:.+]] = calyx.std_slt
+// CHECK-DAG:     {{.+}}, {{.+}}, {{.+}}, {{.+}}, %[[ITER_ARG0_OUT:.+]], {{.+}} = calyx.register @while_0_arg0_reg
+// CHECK:         calyx.wires
+// CHECK-DAG:       calyx.comb_group @[[COND_GROUP:.+]]  {
+// CHECK-DAG:         calyx.assign %[[SLT_LEFT]] = %[[ITER_ARG0_OUT]]
+// CHECK-DAG:         calyx.assign %[[SLT_RIGHT]] = %[[C64]]
+// CHECK:         calyx.control
+// CHECK:           calyx.while %[[SLT_OUT]] with @[[COND_GROUP]]  {
+// CHECK-NEXT:        calyx.par  {
+// CHECK-COUNT-5:       calyx.enable
+// CHECK-NEXT:        }
+// CHECK-NEXT:      } {bound = 62 : i64}
+func.func @scf_dot(%arg0: memref<64xi32>, %arg1: memref<64xi32>) -> i32 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  %c0_i32 = arith.constant 0 : i32
+  %0 = loopschedule.pipeline II =  1 trip_count = 64 iter_args(%arg2 = %c0, %arg3 = %c0_i32) : (index, i32) -> i32 {
+    %1 = arith.cmpi slt, %arg2, %c64 : index
+    loopschedule.register %1 : i1
+  } do {
+    %1:3 = loopschedule.pipeline.stage start = 0  {
+      %4 = memref.load %arg0[%arg2] : memref<64xi32>
+      %5 = memref.load %arg1[%arg2] : memref<64xi32>
+      %6 = arith.addi %arg2, %c1 : index
+      loopschedule.register %4, %5, %6 : i32, i32, index
+    } : i32, i32, index
+    %2 = loopschedule.pipeline.stage start = 1  {
+      %4 = arith.muli %1#0, %1#1 : i32
+      loopschedule.register %4 : i32
+    } : i32
+    %3 = loopschedule.pipeline.stage start = 4  {
+      %4 = arith.addi %arg3, %2 : i32
+      loopschedule.register %4 : i32
+    } : i32
+    loopschedule.terminator iter_args(%1#2, %3), results(%3) : (index, i32) -> i32
+  }
+  return %0 : i32
+}
+
+// -----
+
 // Verify that independent store operations are still pipelined.
 // See: https://github.com/llvm/circt/issues/3112
 
@@ -1,5 +1,6 @@
 // RUN: circt-opt %s --lower-smt-to-z3-llvm | FileCheck %s
 // RUN: circt-opt %s --lower-smt-to-z3-llvm=debug=true | FileCheck %s --check-prefix=CHECK-DEBUG
+// RUN: circt-opt %s --lower-smt-to-z3-llvm=z3-params=smt.random_seed=42,smt.relevancy=0 | FileCheck %s --check-prefix=CHECK-PARAMS
 
 // CHECK-LABEL: llvm.mlir.global internal @ctx_0()
 // CHECK-NEXT:   llvm.mlir.zero : !llvm.ptr
@@ -21,6 +22,15 @@ llvm.mlir.global internal @solver() {alignment = 8 : i64} : !llvm.ptr {
 
 
 // CHECK-LABEL: llvm.func @test
+// CHECK-NOT: Z3_global_param_set
+// CHECK-PARAMS-LABEL: llvm.func @test
+// CHECK-PARAMS: [[KEY0:%.+]] = llvm.mlir.addressof @str{{.*}} : !llvm.ptr
+// CHECK-PARAMS: [[VALUE0:%.+]] = llvm.mlir.addressof @str{{.*}} : !llvm.ptr
+// CHECK-PARAMS: llvm.call @Z3_global_param_set([[KEY0]], [[VALUE0]]) : (!llvm.ptr, !llvm.ptr) -> ()
+// CHECK-PARAMS: [[KEY1:%.+]] = llvm.mlir.addressof @str{{.*}} : !llvm.ptr
+// CHECK-PARAMS: [[VALUE1:%.+]] = llvm.mlir.addressof @str{{.*}} : !llvm.ptr
+// CHECK-PARAMS: llvm.call @Z3_global_param_set([[KEY1]], [[VALUE1]]) : (!llvm.ptr, !llvm.ptr) -> ()
+// CHECK-PARAMS: llvm.call @Z3_mk_config()
 // CHECK:   [[CONFIG:%.+]] = llvm.call @Z3_mk_config() : () -> !llvm.ptr
 // CHECK-DEBUG: [[PROOF_STR:%.+]] = llvm.mlir.addressof @str{{.*}} : !llvm.ptr
 // CHECK-DEBUG: [[TRUE_STR:%.+]] = llvm.mlir.addressof @str{{.*}} : !llvm.ptr
@@ -187,6 +197,15 @@ func.func @test(%arg0: i32) {
       smt.yield %c-1 : i32
     } -> i32
 
+    // CHECK: llvm.call @Z3_solver_push({{.*}}, {{.*}}) : (!llvm.ptr, !llvm.ptr) -> ()
+    // CHECK: llvm.call @Z3_solver_push({{.*}}, {{.*}}) : (!llvm.ptr, !llvm.ptr) -> ()
+    smt.push 2
+    // CHECK: [[C3:%.+]] = llvm.mlir.constant(3 : i32) : i32
+    // CHECK: llvm.call @Z3_solver_pop({{.*}}, {{.*}}, [[C3]]) : (!llvm.ptr, !llvm.ptr, i32) -> ()
+    smt.pop 3
+    // CHECK-NOT: Z3_solver_pop
+    smt.pop 0
+
     // CHECK: [[TRUE:%.+]] = llvm.call @Z3_mk_true({{%[0-9a-zA-Z_]+}}) : (!llvm.ptr) -> !llvm.ptr
     %true = smt.constant true
     // CHECK-NEXT: [[FALSE:%.+]] = llvm.call @Z3_mk_false({{%[0-9a-zA-Z_]+}}) : (!llvm.ptr) -> !llvm.ptr
@@ -98,3 +98,23 @@ hw.module @TwoAssertions(in %x: i1, in %y: i1) {
   verif.assert %x : i1
   verif.assert %y : i1
 }
+
+// -----
+
+func.func @nested_assertion_with_assumptions_bmc() -> (i1) {
+  // expected-error @below {{bounded model checking problems with assumptions require the assertion to be in the checked module - instead, you can flatten the design first}}
+  %bmc = verif.bmc bound 10 num_regs 0
+  init {}
+  loop {}
+  circuit {
+  ^bb0(%arg0: i1):
+    verif.assume %arg0 : i1
+    hw.instance "" @Asserting(x: %arg0: i1) -> ()
+    verif.yield %arg0 : i1
+  }
+  func.return %bmc : i1
+}
+
+hw.module @Asserting(in %x: i1) {
+  verif.assert %x : i1
+}
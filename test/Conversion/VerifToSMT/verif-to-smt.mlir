@@ -1,4 +1,5 @@
 // RUN: circt-opt %s --convert-verif-to-smt --reconcile-unrealized-casts -allow-unregistered-dialect | FileCheck %s
+// RUN: circt-opt %s --convert-verif-to-smt=report-bound-func=report_bound --reconcile-unrealized-casts -allow-unregistered-dialect | FileCheck %s --check-prefix=REPORT
 
 // CHECK: func.func @lower_assert([[ARG0:%.+]]: i1)
 // CHECK:   [[CAST:%.+]] = builtin.unrealized_conversion_cast [[ARG0]] : i1 to !smt.bv<1>
@@ -98,6 +99,7 @@ func.func @test_lec(%arg0: !smt.bv<1>) -> (i1, i1, i1) {
 // CHECK:      [[FALSE:%.+]] = arith.constant false
 // CHECK:      [[TRUE:%.+]] = arith.constant true
 // CHECK:      [[FOR:%.+]]:5 = scf.for [[ARG0:%.+]] = [[C0_I32]] to [[C10_I32]] step [[C1_I32]] iter_args([[ARG1:%.+]] = [[INIT]]#0, [[ARG2:%.+]] = [[F0]], [[ARG3:%.+]] = [[F1]], [[ARG4:%.+]] = [[INIT]]#1, [[ARG5:%.+]] = [[FALSE]])
+// CHECK:        smt.push 1
 // CHECK:        [[CIRCUIT:%.+]]:2 = func.call @bmc_circuit([[ARG1]], [[ARG2]], [[ARG3]])
 // CHECK:        [[SMTCHECK:%.+]] = smt.check sat {
 // CHECK:          smt.yield [[TRUE]]
@@ -106,6 +108,8 @@ func.func @test_lec(%arg0: !smt.bv<1>) -> (i1, i1, i1) {
 // CHECK:        } unsat {
 // CHECK:          smt.yield [[FALSE]]
 // CHECK:        }
+// CHECK:        smt.pop 1
+// CHECK-NOT:    func.call @report_bound
 // CHECK:        [[ORI:%.+]] = arith.ori [[SMTCHECK]], [[ARG5]]
 // CHECK:        [[LOOP:%.+]]:2 = func.call @bmc_loop([[ARG1]], [[ARG4]])
 // CHECK:        [[F2:%.+]] = smt.declare_fun : !smt.bv<32>
@@ -146,6 +150,13 @@ func.func @test_lec(%arg0: !smt.bv<1>) -> (i1, i1, i1) {
 // CHECK:    return [[C9]], [[C10]]
 // CHECK:  }
 
+// REPORT-LABEL: func.func @test_bmc
+// REPORT:         scf.for [[I:%.+]] =
+// REPORT:           [[RES:%.+]] = smt.check
+// REPORT:           smt.pop 1
+// REPORT-NEXT:      func.call @report_bound([[I]], [[RES]]) : (i32, i1) -> ()
+// REPORT:       func.func private @report_bound(i32, i1)
+
 func.func @test_bmc() -> (i1) {
   %bmc = verif.bmc bound 10 num_regs 1
   init {
@@ -172,3 +183,40 @@ func.func @test_bmc() -> (i1) {
   }
   func.return %bmc : i1
 }
+
+// The property is returned by the circuit, such that the assumptions in the
+// circuit are asserted outside of the assertion scope of each bound.
+// CHECK-LABEL: func.func @test_bmc_assume
+// CHECK:         scf.for
+// CHECK:           [[CIRCUIT:%.+]]:2 = func.call @[[CIRCUIT_FUNC:bmc_circuit[_0-9]*]](
+// CHECK-NEXT:      smt.push 1
+// CHECK-NEXT:      [[C1:%.+]] = smt.bv.constant #smt.bv<-1>
+// CHECK-NEXT:      [[PROP:%.+]] = smt.eq [[CIRCUIT]]#1, [[C1]]
+// CHECK-NEXT:      [[NPROP:%.+]] = smt.not [[PROP]]
+// CHECK-NEXT:      smt.assert [[NPROP]]
+// CHECK-NEXT:      smt.check
+// CHECK:           smt.pop 1
+// CHECK:       func.func @[[CIRCUIT_FUNC]]({{.*}}) -> (!smt.bv<1>, !smt.bv<1>)
+// CHECK:         [[EQ:%.+]] = smt.eq
+// CHECK-NEXT:    smt.assert [[EQ]]
+// CHECK-NOT:     smt.not
+// CHECK:         return
+func.func @test_bmc_assume() -> (i1) {
+  %bmc = verif.bmc bound 10 num_regs 0
+  init {
+    %c0_i1 = hw.constant 0 : i1
+    %clk = seq.to_clock %c0_i1
+    verif.yield %clk : !seq.clock
+  }
+  loop {
+    ^bb0(%clk: !seq.clock):
+    verif.yield %clk : !seq.clock
+  }
+  circuit {
+  ^bb0(%clk: !seq.clock, %arg0: i1):
+    verif.assume %arg0 : i1
+    verif.assert %arg0 : i1
+    verif.yield %arg0 : i1
+  }
+  func.return %bmc : i1
+}
@@ -1131,3 +1131,33 @@ firrtl.circuit "DPI"   {
     firrtl.matchingconnect %out_0, %0 : !firrtl.uint<8>
   }
 }
+
+// -----
+
+// Loop through the port summaries of a multi-level hierarchy.
+// CHECK-NOT: firrtl.circuit "DeepHierarchy"
+firrtl.circuit "DeepHierarchy" {
+  firrtl.module private @Leaf(in %in: !firrtl.uint<1>, out %out: !firrtl.uint<1>) {
+    firrtl.matchingconnect %out, %in : !firrtl.uint<1>
+  }
+  firrtl.module private @Mid(in %in: !firrtl.uint<1>, out %out: !firrtl.uint<1>) {
+    %leaf_in, %leaf_out = firrtl.instance leaf @Leaf(in in: !firrtl.uint<1>, out out: !firrtl.uint<1>)
+    firrtl.matchingconnect %leaf_in, %in : !firrtl.uint<1>
+    firrtl.matchingconnect %out, %leaf_out : !firrtl.uint<1>
+  }
+  firrtl.module private @Other(in %in: !firrtl.uint<1>, out %out: !firrtl.uint<1>) {
+    %leaf_in, %leaf_out = firrtl.instance leaf @Leaf(in in: !firrtl.uint<1>, out out: !firrtl.uint<1>)
+    firrtl.matchingconnect %leaf_in, %in : !firrtl.uint<1>
+    firrtl.matchingconnect %out, %in : !firrtl.uint<1>
+  }
+  // expected-error @below {{detected combinational cycle in a FIRRTL module, sample path: DeepHierarchy.{m1.in <- m2.out <- m2.in <- m1.out <- m1.in}}}
+  firrtl.module @DeepHierarchy(in %a: !firrtl.uint<1>, out %b: !firrtl.uint<1>) {
+    %m1_in, %m1_out = firrtl.instance m1 @Mid(in in: !firrtl.uint<1>, out out: !firrtl.uint<1>)
+    %m2_in, %m2_out = firrtl.instance m2 @Mid(in in: !firrtl.uint<1>, out out: !firrtl.uint<1>)
+    %o_in, %o_out = firrtl.instance o @Other(in in: !firrtl.uint<1>, out out: !firrtl.uint<1>)
+    firrtl.matchingconnect %o_in, %a : !firrtl.uint<1>
+    firrtl.matchingconnect %m1_in, %m2_out : !firrtl.uint<1>
+    firrtl.matchingconnect %m2_in, %m1_out : !firrtl.uint<1>
+    firrtl.matchingconnect %b, %o_out : !firrtl.uint<1>
+  }
+}
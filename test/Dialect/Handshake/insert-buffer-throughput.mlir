@@ -0,0 +1,72 @@
+// RUN: circt-opt -handshake-insert-buffers=strategy=throughput %s | FileCheck %s
+// RUN: circt-opt -handshake-insert-buffers="strategy=throughput target-ii=2" %s | FileCheck %s --check-prefix=II2
+// RUN: circt-opt -handshake-insert-buffers="strategy=throughput report-throughput=true" %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=REMARK
+
+// A single sequential buffer breaks the cycle, and the token circulating
+// through it sustains an II of one.
+
+// CHECK-LABEL: handshake.func @accumulate(
+// CHECK:         %[[MERGE:.*]] = merge %arg0, %[[BUF:.*]] : i32
+// CHECK:         %[[LHS:.*]]:2 = fork [2] %[[MERGE]] : i32
+// CHECK:         %[[RES:.*]]:2 = fork [2] %[[ADD:.*]] : i32
+// CHECK:         %[[BUF]] = buffer [1] seq %[[RES]]#0 : i32
+// CHECK-NOT:     buffer
+// CHECK:         %[[ADD]] = arith.addi %[[LHS]]#0, %[[LHS]]#1 : i32
+// CHECK:         return %[[RES]]#1, %arg1 : i32, none
+
+// REMARK: remark: predicted initiation interval 1 (achievable 1, target 1)
+handshake.func @accumulate(%arg0: i32, %arg1: none, ...) -> (i32, none) {
+  %0 = merge %arg0, %2#0 : i32
+  %1:2 = fork [2] %0 : i32
+  %2:2 = fork [2] %3 : i32
+  %3 = arith.addi %1#0, %1#1 : i32
+  return %2#1, %arg1 : i32, none
+}
+
+// The short path of the reconvergent fork needs to hold as many tokens as
+// enter the long path while the first one traverses it.
+
+// CHECK-LABEL: handshake.func @reconvergent(
+// CHECK:         %[[FORK:.*]]:2 = fork [2] %arg0 : i32
+// CHECK-DAG:     %[[FIFO:.*]] = buffer [2] fifo %[[FORK]]#1 : i32
+// CHECK-DAG:     %[[SEQ:.*]] = buffer [2] seq %[[FORK]]#0 : i32
+// CHECK:         arith.addi %[[SEQ]], %[[FIFO]] : i32
+
+// II2-LABEL: handshake.func @reconvergent(
+// II2:         %[[FORK:.*]]:2 = fork [2] %arg0 : i32
+// II2-DAG:     %[[FIFO:.*]] = buffer [1] fifo %[[FORK]]#1 : i32
+// II2-DAG:     %[[SEQ:.*]] = buffer [2] seq %[[FORK]]#0 : i32
+// II2:         arith.addi %[[SEQ]], %[[FIFO]] : i32
+
+// REMARK: remark: predicted initiation interval 1 (achievable 1, target 1)
+handshake.func @reconvergent(%arg0: i32, %arg1: none, ...) -> (i32, none) {
+  %0:2 = fork [2] %arg0 : i32
+  %1 = buffer [2] seq %0#0 : i32
+  %2 = arith.addi %1, %0#1 : i32
+  return %2, %arg1 : i32, none
+}
+
+// A loop headed by a control_merge and a mux. Each cycle carries the token
+// entering it through the data inputs of the merge-like operations, while the
+// mux select carries none. The two-slot buffer on the data cycle bounds the II
+// to two, and the existing sequential buffers leave no slack to fill.
+
+// CHECK-LABEL: handshake.func @branch_loop(
+// CHECK-NOT:     fifo
+// CHECK:         return
+
+// REMARK: remark: predicted initiation interval 2 (achievable 2, target 1)
+handshake.func @branch_loop(%arg0: i32, %arg1: none, ...) -> (i32, none) {
+  %result, %index = control_merge %arg1, %9 : none, index
+  %0 = mux %index [%arg0, %8] : index, i32
+  %1:3 = fork [3] %0 : i32
+  %2 = arith.cmpi slt, %1#0, %1#1 : i32
+  %3:2 = fork [2] %2 : i1
+  %trueResult, %falseResult = cond_br %3#0, %1#2 : i32
+  %trueResult_0, %falseResult_1 = cond_br %3#1, %result : none
+  %4:2 = fork [2] %trueResult : i32
+  %5 = arith.addi %4#0, %4#1 : i32
+  %8 = buffer [2] seq %5 : i32
+  %9 = buffer [1] seq %trueResult_0 : none
+  return %falseResult, %falseResult_1 : i32, none
+}
@@ -1,5 +1,4 @@
-// REQUIRES: llhd-sim
-// RUN: llhd-sim %s -shared-libs=%shlibdir/libcirct-llhd-signals-runtime-wrappers%shlibext | FileCheck %s
+// RUN: llhd-sim %s | FileCheck %s
 
 // This test checks correct simulation of the following operations and ensures
 // that the endianess semantics as described in the rationale are followed.
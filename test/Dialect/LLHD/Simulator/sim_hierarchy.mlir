@@ -0,0 +1,112 @@
+// RUN: llhd-sim %s -T 4000 | FileCheck %s
+// RUN: llhd-sim %s -T 4000 --trace-format=merged-reduce | FileCheck %s --check-prefix=MERGED
+// RUN: llhd-sim %s -T 4000 --trace-format=none --vcd=%t.vcd
+// RUN: FileCheck %s --check-prefix=VCD < %t.vcd
+
+// This test checks that processes wake up on the signals their observed values
+// are probed from and on expiring timeouts, and that values propagate through
+// the ports of instances.
+
+// CHECK:      0ps 0d 0e  root/clk  0x00
+// CHECK-NEXT: 0ps 0d 0e  root/count  0x00
+// CHECK-NEXT: 0ps 0d 0e  root/counter/clk  0x00
+// CHECK-NEXT: 0ps 0d 0e  root/counter/count  0x00
+// CHECK-NEXT: 0ps 0d 0e  root/counter/q  0x00
+// CHECK-NEXT: 1000ps 0d 0e  root/clk  0x01
+// CHECK-NEXT: 1000ps 0d 0e  root/counter/clk  0x01
+// CHECK-NEXT: 1000ps 1d 0e  root/counter/count  0x01
+// CHECK-NEXT: 1000ps 1d 0e  root/counter/q  0x01
+// CHECK-NEXT: 1000ps 1d 1e  root/count  0x01
+// CHECK-NEXT: 2000ps 0d 0e  root/clk  0x00
+// CHECK-NEXT: 2000ps 0d 0e  root/counter/clk  0x00
+// CHECK-NEXT: 3000ps 0d 0e  root/clk  0x01
+// CHECK-NEXT: 3000ps 0d 0e  root/counter/clk  0x01
+// CHECK-NEXT: 3000ps 1d 0e  root/counter/count  0x02
+// CHECK-NEXT: 3000ps 1d 0e  root/counter/q  0x02
+// CHECK-NEXT: 3000ps 1d 1e  root/count  0x02
+// CHECK-NEXT: 4000ps 0d 0e  root/clk  0x00
+// CHECK-NEXT: 4000ps 0d 0e  root/counter/clk  0x00
+// CHECK-NOT:  ps
+
+// MERGED:      0ps
+// MERGED-NEXT:   root/clk  0x00
+// MERGED-NEXT:   root/count  0x00
+// MERGED-NEXT: 1000ps
+// MERGED-NEXT:   root/clk  0x01
+// MERGED-NEXT:   root/count  0x01
+// MERGED-NEXT: 2000ps
+// MERGED-NEXT:   root/clk  0x00
+// MERGED-NEXT: 3000ps
+// MERGED-NEXT:   root/clk  0x01
+// MERGED-NEXT:   root/count  0x02
+// MERGED-NEXT: 4000ps
+// MERGED-NEXT:   root/clk  0x00
+
+// VCD:      $timescale 1fs $end
+// VCD-NEXT: $scope module root $end
+// VCD-NEXT: $var wire 1 ! clk $end
+// VCD-NEXT: $var wire 8 % count $end
+// VCD-NEXT: $scope module counter $end
+// VCD-NEXT: $var wire 1 " clk $end
+// VCD-NEXT: $var wire 8 # count $end
+// VCD-NEXT: $var wire 8 $ q $end
+// VCD-NEXT: $upscope $end
+// VCD-NEXT: $upscope $end
+// VCD-NEXT: $enddefinitions $end
+// VCD-NEXT: #0
+// VCD-NEXT: $dumpvars
+// VCD:      $end
+// VCD-NEXT: #1000000
+// VCD-NEXT: 1!
+// VCD-NEXT: 1"
+// VCD-NEXT: b1 $
+// VCD-NEXT: b1 #
+// VCD-NEXT: b1 %
+// VCD-NEXT: #2000000
+// VCD-NEXT: 0!
+// VCD-NEXT: 0"
+// VCD-NEXT: #3000000
+// VCD:      #4000000
+
+hw.module @Counter(in %clk : i1, out count : i8) {
+  %c0_i8 = hw.constant 0 : i8
+  %c1_i8 = hw.constant 1 : i8
+  %delta = llhd.constant_time #llhd.time<0ns, 1d, 0e>
+  %q = llhd.sig %c0_i8 : i8
+  llhd.process {
+    cf.br ^bb1(%clk : i1)
+  ^bb1(%last: i1):
+    llhd.wait (%clk : i1), ^bb2(%last : i1)
+  ^bb2(%prev: i1):
+    %rising = comb.icmp ult %prev, %clk : i1
+    cf.cond_br %rising, ^bb3, ^bb1(%clk : i1)
+  ^bb3:
+    %0 = llhd.prb %q : !hw.inout<i8>
+    %1 = comb.add %0, %c1_i8 : i8
+    llhd.drv %q, %1 after %delta : !hw.inout<i8>
+    cf.br ^bb1(%clk : i1)
+  }
+  %2 = llhd.prb %q : !hw.inout<i8>
+  hw.output %2 : i8
+}
+
+hw.module @root() {
+  %false = hw.constant false
+  %true = hw.constant true
+  %c0_i8 = hw.constant 0 : i8
+  %half = llhd.constant_time #llhd.time<1ns, 0d, 0e>
+  %eps = llhd.constant_time #llhd.time<0ns, 0d, 1e>
+  %clk = llhd.sig %false : i1
+  llhd.process {
+    cf.br ^bb1
+  ^bb1:
+    %0 = llhd.prb %clk : !hw.inout<i1>
+    %1 = comb.xor %0, %true : i1
+    llhd.drv %clk, %1 after %half : !hw.inout<i1>
+    llhd.wait for %half, ^bb1
+  }
+  %2 = llhd.prb %clk : !hw.inout<i1>
+  %counter.count = hw.instance "counter" @Counter(clk: %2 : i1) -> (count: i8)
+  %count = llhd.sig %c0_i8 : i8
+  llhd.drv %count, %counter.count after %eps : !hw.inout<i8>
+}
@@ -0,0 +1,47 @@
+// RUN: llhd-sim %s --trace-format=none | FileCheck %s
+
+// CHECK:      tick    0 at 0x00
+// CHECK-NEXT: tick    1 at 0x01
+// CHECK-NEXT: tick    2 at 0x02
+// CHECK-NEXT: tick   -3 at 0x03
+// CHECK-NEXT: done: 00000100
+// CHECK-NOT:  tick
+
+hw.module @root() {
+  %c0_i8 = hw.constant 0 : i8
+  %c1_i8 = hw.constant 1 : i8
+  %c3_i8 = hw.constant 3 : i8
+  %delay = llhd.constant_time #llhd.time<1ns, 0d, 0e>
+  %count = llhd.sig %c0_i8 : i8
+  llhd.process {
+    cf.br ^bb1(%c0_i8 : i8)
+  ^bb1(%i: i8):
+    %tick = sim.fmt.lit "tick "
+    %at = sim.fmt.lit " at 0x"
+    %nl = sim.fmt.lit "\0A"
+    %neg = comb.sub %c0_i8, %i : i8
+    %last = comb.icmp eq %i, %c3_i8 : i8
+    %shown = comb.mux %last, %neg, %i : i8
+    %dec = sim.fmt.dec signed %shown : i8
+    %0 = llhd.prb %count : !hw.inout<i8>
+    %hex = sim.fmt.hex %0 : i8
+    %msg = sim.fmt.concat (%tick, %dec, %at, %hex, %nl)
+    sim.proc.print %msg
+    %next = comb.add %i, %c1_i8 : i8
+    llhd.drv %count, %next after %delay : !hw.inout<i8>
+    cf.cond_br %last, ^bb2, ^bb3
+  ^bb2:
+    llhd.halt
+  ^bb3:
+    llhd.wait for %delay, ^bb1(%next : i8)
+  }
+  llhd.final {
+    %done = sim.fmt.lit "done: "
+    %nl = sim.fmt.lit "\0A"
+    %0 = llhd.prb %count : !hw.inout<i8>
+    %bin = sim.fmt.bin %0 : i8
+    %msg = sim.fmt.concat (%done, %bin, %nl)
+    sim.proc.print %msg
+    llhd.halt
+  }
+}
@@ -1,4 +1,5 @@
 // REQUIRES: llhd-sim
+// llhd-sim does not support llhd.reg yet.
 // REQUIRES: llhd-sim-fixed
 // RUN: llhd-sim %s -n 10 -shared-libs=%shlibdir/libcirct-llhd-signals-runtime-wrappers%shlibext | FileCheck %s
 
@@ -1,5 +1,4 @@
-// REQUIRES: llhd-sim
-// RUN: llhd-sim %s -shared-libs=%shlibdir/libcirct-llhd-signals-runtime-wrappers%shlibext | FileCheck %s
+// RUN: llhd-sim %s | FileCheck %s
 
 // CHECK: 0ps 0d 0e  root/shl  0x01
 // CHECK-NEXT: 0ps 0d 0e  root/shrs  0x08
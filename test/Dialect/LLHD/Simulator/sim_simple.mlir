@@ -1,5 +1,4 @@
-// REQUIRES: llhd-sim
-// RUN: llhd-sim %s -n 10 -r Foo -shared-libs=%shlibdir/libcirct-llhd-signals-runtime-wrappers%shlibext | FileCheck %s
+// RUN: llhd-sim %s -n 10 -r Foo | FileCheck %s
 
 // CHECK: 0ps 0d 0e  Foo/toggle  0x00
 // CHECK-NEXT: 1000ps 0d 0e  Foo/toggle  0x01
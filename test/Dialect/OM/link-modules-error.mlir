@@ -105,3 +105,19 @@ module {
     }
   }
 }
+
+// -----
+
+module {
+  // Report every symbol that fails to resolve, not only the first one.
+  module {
+    // expected-error @+1 {{class "A" is declared as an external class but there is no definition}}
+    om.class.extern @A() {}
+    // expected-error @+1 {{failed to link class "B" since declaration doesn't match the definition: the number of arguments is not equal, 0 vs 1}}
+    om.class.extern @B(%arg: i1) {}
+  }
+  module {
+    // expected-note @+1 {{definition is here}}
+    om.class @B() {}
+  }
+}
@@ -62,6 +62,11 @@ func.func @core(%in: i8) {
   // CHECK-NEXT: }
   smt.check sat { } unknown { } unsat { }
 
+  // CHECK: smt.push 1 {smt.some_attr}
+  smt.push 1 {smt.some_attr}
+  // CHECK: smt.pop 2 {smt.some_attr}
+  smt.pop 2 {smt.some_attr}
+
   // CHECK: %{{.*}} = smt.eq %{{.*}}, %{{.*}} {smt.some_attr} : !smt.bv<32>
   %1 = smt.eq %b, %b {smt.some_attr} : !smt.bv<32>
   // CHECK: %{{.*}} = smt.distinct %{{.*}}, %{{.*}} {smt.some_attr} : !smt.bv<32>
@@ -0,0 +1,60 @@
+// RUN: circt-opt -pass-pipeline="builtin.module(hw-memory-sim{optimize-for-simulation})" %s | FileCheck %s
+// RUN: circt-opt -pass-pipeline="builtin.module(hw-memory-sim{optimize-for-simulation disable-mem-randomization})" %s | FileCheck %s --check-prefix=NORAND
+
+hw.generator.schema @FIRRTLMem, "FIRRTL_Memory", ["depth", "numReadPorts", "numWritePorts", "numReadWritePorts", "readLatency", "writeLatency", "width", "readUnderWrite", "writeUnderWrite", "writeClockIDs", "initFilename", "initIsBinary", "initIsInline"]
+
+sv.macro.decl @RANDOM
+sv.macro.decl @ENABLE_INITIAL_MEM_
+sv.macro.decl @RANDOMIZE_REG_INIT
+sv.macro.decl @RANDOMIZE_MEM_INIT
+
+// All writes of the read-write port share one always block, and so do the
+// writes of both write ports, which use the same clock ID.
+
+// CHECK-LABEL: hw.module private @Mem(
+// CHECK:         %Memory = sv.reg
+// CHECK:         sv.always posedge %rw_clock_0 {
+// CHECK:           sv.passign %_RW0_raddr_d0, %rw_addr_0
+// CHECK:         sv.always posedge %rw_clock_0 {
+// CHECK-COUNT-2:   sv.if
+// CHECK:         sv.always posedge %wo_clock_0 {
+// CHECK-COUNT-4:   sv.if
+// CHECK-NOT:     sv.always
+// CHECK:         sv.ifdef @ENABLE_INITIAL_MEM_ {
+// CHECK-NOT:       %_RANDOM_MEM
+// CHECK:           sv.initial {
+// CHECK-NEXT:        sv.verbatim "`INIT_RANDOM_PROLOG_"
+// CHECK-NEXT:        sv.ifdef.procedural @RANDOMIZE_MEM_INIT {
+// CHECK-NEXT:          sv.readmem %Memory, "Mem_random.hex", MemBaseHex
+// CHECK-NEXT:        }
+// CHECK-NOT:         sv.for
+// CHECK:       }
+hw.module.generated @Mem, @FIRRTLMem(in %rw_addr_0: i2, in %rw_en_0: i1, in %rw_clock_0: i1, in %rw_wmode_0: i1, in %rw_wdata_0: i8, in %rw_wmask_0: i2, in %wo_addr_0: i2, in %wo_en_0: i1, in %wo_clock_0: i1, in %wo_data_0: i8, in %wo_mask_0: i2, in %wo_addr_1: i2, in %wo_en_1: i1, in %wo_clock_1: i1, in %wo_data_1: i8, in %wo_mask_1: i2, out rw_rdata_0: i8) attributes {depth = 4 : i64, numReadPorts = 0 : ui32, numReadWritePorts = 1 : ui32, maskGran = 4 : ui32, numWritePorts = 2 : ui32, readLatency = 1 : ui32, readUnderWrite = 0 : i32, width = 8 : ui32, writeClockIDs = [0 : i32, 0 : i32], writeLatency = 1 : ui32, writeUnderWrite = 0 : i32, initFilename = "", initIsBinary = false, initIsInline = false}
+
+// The random initial contents hold one word per memory entry.
+// CHECK-LABEL: emit.file "Mem_random.hex" {
+// CHECK-NEXT:    emit.verbatim "{{([0-9a-f][0-9a-f]\\0A){4}}}"
+// CHECK-NEXT:  }
+
+// The random initial contents of a memory with an output directory or file
+// are placed next to its output.
+// CHECK-LABEL: hw.module private @MemDir(
+// CHECK:         sv.readmem %Memory, "mems{{/|\\\\}}MemDir_random.hex", MemBaseHex
+// CHECK-LABEL: emit.file "mems{{/|\\\\}}MemDir_random.hex" {
+hw.module.generated @MemDir, @FIRRTLMem(in %wo_addr_0: i1, in %wo_en_0: i1, in %wo_clock_0: i1, in %wo_data_0: i8) attributes {depth = 2 : i64, numReadPorts = 0 : ui32, numReadWritePorts = 0 : ui32, numWritePorts = 1 : ui32, readLatency = 1 : ui32, readUnderWrite = 0 : i32, width = 8 : ui32, writeClockIDs = [], writeLatency = 1 : ui32, writeUnderWrite = 1 : i32, initFilename = "", initIsBinary = false, initIsInline = false, output_file = #hw.output_file<"mems/">}
+
+// CHECK-LABEL: hw.module private @MemFile(
+// CHECK:         sv.readmem %Memory, "mems{{/|\\\\}}MemFile_random.hex", MemBaseHex
+// CHECK-LABEL: emit.file "mems{{/|\\\\}}MemFile_random.hex" {
+hw.module.generated @MemFile, @FIRRTLMem(in %wo_addr_0: i1, in %wo_en_0: i1, in %wo_clock_0: i1, in %wo_data_0: i8) attributes {depth = 2 : i64, numReadPorts = 0 : ui32, numReadWritePorts = 0 : ui32, numWritePorts = 1 : ui32, readLatency = 1 : ui32, readUnderWrite = 0 : i32, width = 8 : ui32, writeClockIDs = [], writeLatency = 1 : ui32, writeUnderWrite = 1 : i32, initFilename = "", initIsBinary = false, initIsInline = false, output_file = #hw.output_file<"mems/MemFile.sv">}
+
+// Without memory randomization, no init file is generated or loaded.
+// NORAND-LABEL: hw.module private @Mem(
+// NORAND-NOT:     sv.readmem
+// NORAND:         hw.output
+// NORAND-NOT:   emit.file
+
+hw.module @Top(in %clock: i1, in %addr: i2, in %en: i1, in %mode: i1, in %data: i8, in %mask: i2, out rdata: i8) {
+  %mem.rw_rdata_0 = hw.instance "mem" @Mem(rw_addr_0: %addr: i2, rw_en_0: %en: i1, rw_clock_0: %clock: i1, rw_wmode_0: %mode: i1, rw_wdata_0: %data: i8, rw_wmask_0: %mask: i2, wo_addr_0: %addr: i2, wo_en_0: %en: i1, wo_clock_0: %clock: i1, wo_data_0: %data: i8, wo_mask_0: %mask: i2, wo_addr_1: %addr: i2, wo_en_1: %en: i1, wo_clock_1: %clock: i1, wo_data_1: %data: i8, wo_mask_1: %mask: i2) -> (rw_rdata_0: i8)
+  hw.output %mem.rw_rdata_0 : i8
+}
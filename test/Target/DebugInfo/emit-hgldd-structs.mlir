@@ -0,0 +1,57 @@
+// RUN: circt-translate %s --emit-hgldd | FileCheck %s
+
+#loc1 = loc("A.sv":1:1)
+#loc2 = loc("B.sv":1:1)
+#loc3 = loc("C.sv":1:1)
+
+// Struct definitions used by multiple files are deduplicated into "global.dd",
+// while definitions used by a single file are emitted into that file.
+
+// CHECK-LABEL: FILE "A.dd"
+// CHECK-NOT:   "kind": "struct"
+// CHECK:       "obj_name": "A"
+// CHECK:         "var_name": "data"
+// CHECK:         "type_name": "A_data"
+// CHECK:         "var_name": "same"
+// CHECK:         "type_name": "A_data"
+hw.module @A(in %a: i32, in %b: i8) {
+  %0 = dbg.struct {"x": %a, "y": %b} : i32, i8
+  %1 = dbg.struct {"x": %a, "y": %b} : i32, i8
+  dbg.variable "data", %0 : !dbg.struct
+  dbg.variable "same", %1 : !dbg.struct
+} loc(fused[#loc1, "emitted"(#loc1)])
+
+// CHECK-LABEL: FILE "B.dd"
+// CHECK-NOT:   "kind": "struct"
+// CHECK:       "obj_name": "B"
+// CHECK:         "var_name": "data"
+// CHECK:         "type_name": "A_data"
+hw.module @B(in %c: i32, in %d: i8) {
+  %0 = dbg.struct {"x": %c, "y": %d} : i32, i8
+  dbg.variable "data", %0 : !dbg.struct
+} loc(fused[#loc2, "emitted"(#loc2)])
+
+// Different field names or types yield different definitions.
+// CHECK-LABEL: FILE "C.dd"
+// CHECK:       "kind": "struct"
+// CHECK-NEXT:  "obj_name": "C_data"
+// CHECK:       "kind": "struct"
+// CHECK-NEXT:  "obj_name": "C_other"
+// CHECK:       "obj_name": "C"
+// CHECK:         "type_name": "C_data"
+// CHECK:         "type_name": "C_other"
+hw.module @C(in %a: i32, in %b: i16) {
+  %0 = dbg.struct {"x": %a, "z": %b} : i32, i16
+  %1 = dbg.struct {"x": %a, "y": %b} : i32, i16
+  dbg.variable "data", %0 : !dbg.struct
+  dbg.variable "other", %1 : !dbg.struct
+} loc(fused[#loc3, "emitted"(#loc3)])
+
+// CHECK-LABEL: FILE "global.dd"
+// CHECK:       "kind": "struct"
+// CHECK-NEXT:  "obj_name": "A_data"
+// CHECK:         "var_name": "x"
+// CHECK:         "type_name": "logic"
+// CHECK:         "var_name": "y"
+// CHECK:         "type_name": "logic"
+// CHECK-NOT:   "kind": "struct"
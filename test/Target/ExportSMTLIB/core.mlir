@@ -112,9 +112,15 @@ smt.solver () : () -> () {
   %6 = smt.and %3, %5
   smt.assert %6
 
+  // CHECK: (push 1)
+  // CHECK-INLINED: (push 1)
+  smt.push 1
   // CHECK: (check-sat)
   // CHECK-INLINED: (check-sat)
   smt.check sat {} unknown {} unsat {}
+  // CHECK: (pop 1)
+  // CHECK-INLINED: (pop 1)
+  smt.pop 1
 
   // CHECK: (reset)
   // CHECK-INLINED: (reset)
@@ -0,0 +1,55 @@
+// RUN: circt-translate --export-smtlib --smtlibexport-define-shared-terms %s | FileCheck %s
+// RUN: circt-translate --export-smtlib --smtlibexport-incremental %s | FileCheck %s --check-prefix=CHECK-INCREMENTAL
+
+// CHECK-LABEL: ; solver scope 0
+// CHECK-INCREMENTAL-LABEL: ; solver scope 0
+// CHECK-INCREMENTAL-NEXT:  (push 1)
+smt.solver () : () -> () {
+  // CHECK: (declare-const a (_ BitVec 8))
+  // CHECK: (declare-const b (_ BitVec 8))
+  %a = smt.declare_fun "a" : !smt.bv<8>
+  %b = smt.declare_fun "b" : !smt.bv<8>
+
+  // The product is needed by two assertions, the sum only by the product.
+  // CHECK-NEXT: (define-fun [[MUL:tmp[_0-9]*]] () (_ BitVec 8) (let (([[ADD:.+]] (bvadd a b)))
+  // CHECK-NEXT:   (bvmul [[ADD]] a)))
+  // CHECK-NEXT: (assert (let (([[V0:.+]] (= [[MUL]] a)))
+  // CHECK-NEXT:   [[V0]]))
+  %0 = smt.bv.add %a, %b : !smt.bv<8>
+  %1 = smt.bv.mul %0, %a : !smt.bv<8>
+  %2 = smt.eq %1, %a : !smt.bv<8>
+  smt.assert %2
+
+  // Definitions made in an assertion level are emitted again after it is
+  // popped.
+  // CHECK-NEXT: (push 1)
+  // CHECK-NEXT: (define-fun [[NOT0:tmp[_0-9]*]] () (_ BitVec 8) (bvnot b))
+  // CHECK-NEXT: (assert (let (([[V1:.+]] (= [[MUL]] [[NOT0]])))
+  // CHECK-NEXT:   [[V1]]))
+  // CHECK-NEXT: (check-sat)
+  // CHECK-NEXT: (pop 1)
+  // CHECK-NEXT: (define-fun [[NOT1:tmp[_0-9]*]] () (_ BitVec 8) (bvnot b))
+  // CHECK-NEXT: (assert (let (([[V2:.+]] (distinct [[MUL]] [[NOT1]])))
+  // CHECK-NEXT:   [[V2]]))
+  smt.push 1
+  %3 = smt.bv.not %b : !smt.bv<8>
+  %4 = smt.eq %1, %3 : !smt.bv<8>
+  smt.assert %4
+  smt.check sat {} unknown {} unsat {}
+  smt.pop 1
+  %5 = smt.distinct %1, %3 : !smt.bv<8>
+  smt.assert %5
+
+  // CHECK-NEXT: (reset)
+  // CHECK-INCREMENTAL:      (assert (let (({{.+}} (distinct
+  // CHECK-INCREMENTAL-NEXT:   tmp
+  // CHECK-INCREMENTAL-NEXT: (pop 1)
+}
+
+// CHECK-INCREMENTAL-LABEL: ; solver scope 1
+// CHECK-INCREMENTAL-NEXT:  (push 1)
+// CHECK-INCREMENTAL-NEXT:  (check-sat)
+// CHECK-INCREMENTAL-NEXT:  (pop 1)
+smt.solver () : () -> () {
+  smt.check sat {} unknown {} unsat {}
+}
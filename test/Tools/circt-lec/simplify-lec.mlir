@@ -0,0 +1,152 @@
+// RUN: circt-opt --simplify-lec=sweep=false %s | FileCheck %s
+// RUN: circt-opt --simplify-lec %s | FileCheck %s --check-prefix=SWEEP
+
+// Commuted operands are merged by structural hashing.
+// CHECK-LABEL: func.func @structural
+// CHECK-NEXT:    [[TRUE:%.+]] = arith.constant true
+// CHECK-NEXT:    return [[TRUE]]
+func.func @structural() -> i1 {
+  %0 = verif.lec first {
+  ^bb0(%a: i8, %b: i8):
+    %0 = comb.add %a, %b : i8
+    verif.yield %0 : i8
+  } second {
+  ^bb0(%a: i8, %b: i8):
+    %0 = comb.add %b, %a : i8
+    verif.yield %0 : i8
+  }
+  return %0 : i1
+}
+
+// The all-ones pattern distinguishes the outputs.
+// CHECK-LABEL: func.func @refuted
+// CHECK-NEXT:    [[FALSE:%.+]] = arith.constant false
+// CHECK-NEXT:    return [[FALSE]]
+func.func @refuted() -> i1 {
+  %0 = verif.lec first {
+  ^bb0(%a: i8, %b: i8):
+    %0 = comb.add %a, %b : i8
+    verif.yield %0 : i8
+  } second {
+  ^bb0(%a: i8, %b: i8):
+    %0 = comb.sub %a, %b : i8
+    verif.yield %0 : i8
+  }
+  return %0 : i1
+}
+
+// Only the second output needs a solver, and only its cone is kept.
+// CHECK-LABEL: func.func private @decompose_output_1() -> i1
+// CHECK-SAME:      attributes {circt.lec.output = 1 : i32}
+// CHECK-NEXT:    [[EQ:%.+]] = verif.lec first {
+// CHECK-NEXT:    ^bb0([[A:%.+]]: i8, [[B:%.+]]: i8):
+// CHECK-NEXT:      [[C2:%.+]] = hw.constant 2 : i8
+// CHECK-NEXT:      [[MUL:%.+]] = comb.mul [[B]], [[C2]] : i8
+// CHECK-NEXT:      verif.yield [[MUL]] : i8
+// CHECK-NEXT:    } second {
+// CHECK-NEXT:    ^bb0([[A:%.+]]: i8, [[B:%.+]]: i8):
+// CHECK-NEXT:      [[C1:%.+]] = hw.constant 1 : i8
+// CHECK-NEXT:      [[SHL:%.+]] = comb.shl [[B]], [[C1]] : i8
+// CHECK-NEXT:      verif.yield [[SHL]] : i8
+// CHECK-NEXT:    }
+// CHECK-NEXT:    return [[EQ]]
+// CHECK-LABEL: func.func @decompose
+// CHECK-NEXT:    [[EQ:%.+]] = call @decompose_output_1()
+// CHECK-NEXT:    return [[EQ]]
+func.func @decompose() -> i1 {
+  %0 = verif.lec first {
+  ^bb0(%a: i8, %b: i8):
+    %0 = comb.and %a, %b : i8
+    %c2 = hw.constant 2 : i8
+    %1 = comb.mul %b, %c2 : i8
+    verif.yield %0, %1 : i8, i8
+  } second {
+  ^bb0(%a: i8, %b: i8):
+    %0 = comb.and %a, %b : i8
+    %c1 = hw.constant 1 : i8
+    %1 = comb.shl %b, %c1 : i8
+    verif.yield %0, %1 : i8, i8
+  }
+  return %0 : i1
+}
+
+// Internal signals simulation cannot tell apart are proven equivalent first
+// and then cut. The full check remains as a fallback.
+// SWEEP-LABEL: func.func private @sweep_output_0() -> i1
+// SWEEP:         [[L0:%.+]] = verif.lec first {
+// SWEEP:           comb.mul
+// SWEEP:         } second {
+// SWEEP:           comb.shl
+// SWEEP:         }
+// SWEEP-NEXT:    [[L1:%.+]] = scf.if [[L0]] -> (i1) {
+// SWEEP-NEXT:      [[L:%.+]] = verif.lec first {
+// SWEEP-NEXT:      ^bb0({{%.+}}: i8, [[B:%.+]]: i8, [[V:%.+]]: i8):
+// SWEEP-NEXT:        [[X:%.+]] = comb.xor [[V]], [[B]] : i8
+// SWEEP-NEXT:        verif.yield [[X]] : i8
+// SWEEP-NEXT:      } second {
+// SWEEP-NEXT:      ^bb0({{%.+}}: i8, [[B:%.+]]: i8, [[V:%.+]]: i8):
+// SWEEP-NEXT:        [[X:%.+]] = comb.xor [[B]], [[V]] : i8
+// SWEEP-NEXT:        verif.yield [[X]] : i8
+// SWEEP-NEXT:      }
+// SWEEP-NEXT:      scf.yield [[L]]
+// SWEEP-NEXT:    } else {
+// SWEEP-NEXT:      [[FALSE:%.+]] = arith.constant false
+// SWEEP-NEXT:      scf.yield [[FALSE]]
+// SWEEP-NEXT:    }
+// SWEEP-NEXT:    [[R:%.+]] = scf.if [[L1]] -> (i1) {
+// SWEEP-NEXT:      [[CUT:%.+]] = verif.lec first {
+// SWEEP-NEXT:      ^bb0({{%.+}}: i8, {{%.+}}: i8, {{%.+}}: i8, [[V:%.+]]: i8):
+// SWEEP-NEXT:        verif.yield [[V]] : i8
+// SWEEP-NEXT:      } second {
+// SWEEP-NEXT:      ^bb0({{%.+}}: i8, {{%.+}}: i8, {{%.+}}: i8, [[V:%.+]]: i8):
+// SWEEP-NEXT:        verif.yield [[V]] : i8
+// SWEEP-NEXT:      }
+// SWEEP-NEXT:      [[CUTRES:%.+]] = scf.if [[CUT]] -> (i1) {
+// SWEEP-NEXT:        [[TRUE:%.+]] = arith.constant true
+// SWEEP-NEXT:        scf.yield [[TRUE]]
+// SWEEP-NEXT:      } else {
+// SWEEP-NEXT:        [[FULL:%.+]] = verif.lec first {
+// SWEEP:             }
+// SWEEP-NEXT:        scf.yield [[FULL]]
+// SWEEP-NEXT:      }
+// SWEEP-NEXT:      scf.yield [[CUTRES]]
+// SWEEP-NEXT:    } else {
+// SWEEP-NEXT:      [[FULL:%.+]] = verif.lec first {
+// SWEEP:           }
+// SWEEP-NEXT:      scf.yield [[FULL]]
+// SWEEP-NEXT:    }
+// SWEEP-NEXT:    return [[R]]
+// SWEEP-LABEL: func.func @sweep
+// SWEEP-NEXT:    [[EQ:%.+]] = call @sweep_output_0()
+// SWEEP-NEXT:    return [[EQ]]
+func.func @sweep() -> i1 {
+  %0 = verif.lec first {
+  ^bb0(%a: i8, %b: i8):
+    %c2 = hw.constant 2 : i8
+    %0 = comb.mul %a, %c2 : i8
+    %1 = comb.xor %0, %b : i8
+    verif.yield %1 : i8
+  } second {
+  ^bb0(%a: i8, %b: i8):
+    %c1 = hw.constant 1 : i8
+    %0 = comb.shl %a, %c1 : i8
+    %1 = comb.xor %b, %0 : i8
+    verif.yield %1 : i8
+  }
+  return %0 : i1
+}
+
+// Circuits with side effects are left alone.
+// CHECK-LABEL: func.func @side_effects
+// CHECK-NEXT:    verif.lec
+func.func @side_effects() -> i1 {
+  %0 = verif.lec first {
+  ^bb0(%a: i1):
+    verif.assert %a : i1
+    verif.yield %a : i1
+  } second {
+  ^bb0(%a: i1):
+    verif.yield %a : i1
+  }
+  return %0 : i1
+}
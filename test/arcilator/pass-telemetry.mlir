@@ -0,0 +1,11 @@
+// RUN: arcilator %s --pass-telemetry=%t.json > /dev/null
+// RUN: FileCheck %s < %t.json
+
+// CHECK: "traceEvents": [
+// CHECK: "name": "arc-lower-state"
+// CHECK: "name": "lower-arc-to-llvm"
+
+hw.module @Foo(in %a: i4, in %b: i4, out c: i4) {
+  %0 = comb.add %a, %b : i4
+  hw.output %0 : i4
+}
@@ -0,0 +1,24 @@
+// UNSUPPORTED: system-windows
+//   See https://github.com/llvm/circt/issues/4129
+// RUN: circt-reduce %s --test /usr/bin/env --test-arg grep --test-arg -q --test-arg "hw.module @Foo" --keep-best=0 --include operation-pruner -j 4 | FileCheck %s
+// RUN: circt-reduce %s --test /usr/bin/env --test-arg grep --test-arg -q --test-arg "hw.module @Foo" --keep-best=0 --include operation-pruner -j 1 | FileCheck %s
+
+// CHECK-NOT: hw.module @Bar
+hw.module @Bar(in %arg0: i32, out out: i32) {
+  hw.output %arg0 : i32
+}
+
+// CHECK-NOT: hw.module @Baz
+hw.module @Baz(in %arg0: i32, out out: i32) {
+  hw.output %arg0 : i32
+}
+
+// CHECK-LABEL: hw.module @Foo
+hw.module @Foo(in %arg0: i32, out out: i32) {
+  hw.output %arg0 : i32
+}
+
+// CHECK-NOT: hw.module @Qux
+hw.module @Qux(in %arg0: i32, out out: i32) {
+  hw.output %arg0 : i32
+}
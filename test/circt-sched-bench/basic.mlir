@@ -0,0 +1,56 @@
+// RUN: circt-sched-bench %s --schedulers=asap,simplex --format=json | FileCheck %s
+// RUN: circt-sched-bench %s --schedulers=simplex | FileCheck %s --check-prefix=TABLE
+
+// CHECK-LABEL: "instance": "chain",
+// CHECK-NEXT:  "problem": "Problem",
+// CHECK-NEXT:  "scheduler": "asap",
+// CHECK-NEXT:  "status": "ok",
+// CHECK-NEXT:  "operations": 4,
+// CHECK-NEXT:  "dependences": 3,
+// CHECK-NEXT:  "operatorTypes": 2,
+// CHECK:       "lastOpStartTime": 4,
+// CHECK-NEXT:  "makespan": 5
+// CHECK:       "instance": "chain",
+// CHECK-NEXT:  "problem": "Problem",
+// CHECK-NEXT:  "scheduler": "simplex",
+// CHECK-NEXT:  "status": "ok",
+// CHECK:       "lastOpStartTime": 4,
+// CHECK-NEXT:  "makespan": 5
+
+// TABLE:      instance problem ops deps sched status
+// TABLE-NEXT: chain    Problem 4   3    simplex ok
+// TABLE-NEXT: cyclic   CyclicProblem 6 7 simplex ok {{.*}} 2 3
+ssp.instance @chain of "Problem" {
+  library {
+    operator_type @_1 [latency<1>]
+    operator_type @_3 [latency<3>]
+  }
+  graph {
+    %0 = operation<@_1>()
+    %1 = operation<@_3>(%0)
+    %2 = operation<@_1>(%0)
+    operation<@_1> @last(%1, %2)
+  }
+}
+
+// CHECK-LABEL: "instance": "cyclic",
+// CHECK-NEXT:  "problem": "CyclicProblem",
+// CHECK-NEXT:  "scheduler": "simplex",
+// CHECK-NEXT:  "status": "ok",
+// CHECK:       "initiationInterval": 2,
+// CHECK-NEXT:  "lastOpStartTime": 3,
+ssp.instance @cyclic of "CyclicProblem" {
+  library {
+    operator_type @_0 [latency<0>]
+    operator_type @_1 [latency<1>]
+    operator_type @_2 [latency<2>]
+  }
+  graph {
+    %0 = operation<@_1>()
+    %1 = operation<@_0>(@op4 [dist<1>])
+    %2 = operation<@_2>(@op4 [dist<2>])
+    %3 = operation<@_1>(%1, %2)
+    %4 = operation<@_1> @op4(%2, %0)
+    operation<@_1> @last(%4)
+  }
+}
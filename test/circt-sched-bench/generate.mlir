@@ -0,0 +1,17 @@
+// RUN: circt-sched-bench --generate --problem=CyclicProblem --num-ops=100,200 --emit-instances | circt-opt -ssp-roundtrip=check | FileCheck %s
+// RUN: circt-sched-bench --generate --problem=CyclicProblem --num-ops=500 --format=json | FileCheck %s --check-prefix=BENCH
+// RUN: not circt-sched-bench --generate --problem=Foo 2>&1 | FileCheck %s --check-prefix=ERR
+
+// CHECK: ssp.instance @CyclicProblem_100_0 of "CyclicProblem"
+// CHECK: operation<@t0> @last(
+// CHECK: ssp.instance @CyclicProblem_200_1 of "CyclicProblem"
+// CHECK: operation<@t0> @last(
+
+// BENCH:      "instance": "CyclicProblem_500_0",
+// BENCH-NEXT: "problem": "CyclicProblem",
+// BENCH-NEXT: "scheduler": "simplex",
+// BENCH-NEXT: "status": "ok",
+// BENCH-NEXT: "operations": 501,
+// BENCH:      "initiationInterval":
+
+// ERR: error: cannot generate instances of unknown problem 'Foo'
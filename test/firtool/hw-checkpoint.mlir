@@ -0,0 +1,28 @@
+// RUN: firtool %s --format=mlir --ir-hw --output-hw-checkpoint=%t.mlirbc | FileCheck %s --check-prefix=HW
+// RUN: circt-opt %t.mlirbc | FileCheck %s --check-prefix=HW
+// RUN: firtool %t.mlirbc --resume-from-hw --verilog | FileCheck %s --check-prefix=VERILOG
+// RUN: not firtool %s --format=mlir --resume-from-hw 2>&1 | FileCheck %s --check-prefix=ERROR
+// RUN: not firtool %s --format=mlir --ir-fir --output-hw-checkpoint=%t.mlirbc 2>&1 | FileCheck %s --check-prefix=ERROR-FIR
+
+firrtl.circuit "Top" {
+  firrtl.module @Top(in %in : !firrtl.uint<8>,
+                     out %out : !firrtl.uint<8>) {
+    firrtl.connect %out, %in : !firrtl.uint<8>, !firrtl.uint<8>
+  }
+}
+
+// HW-LABEL: hw.module @Top(in %in : i8, out out : i8) {
+// HW-NEXT:    hw.output %in : i8
+// HW-NEXT:  }
+
+// VERILOG-LABEL: module Top(
+// VERILOG-NEXT:    input  [7:0] in,
+// VERILOG-NEXT:    output [7:0] out
+// VERILOG-NEXT:  );
+// VERILOG-EMPTY:
+// VERILOG-NEXT:    assign out = in;
+// VERILOG-NEXT:  endmodule
+
+// ERROR: input contains FIRRTL: --resume-from-hw expects IR saved with --output-hw-checkpoint
+
+// ERROR-FIR: --resume-from-hw and --output-hw-checkpoint require lowering to HW
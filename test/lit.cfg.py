@@ -22,7 +22,7 @@ config.name = 'CIRCT'
 config.test_format = lit.formats.ShTest(not llvm_config.use_lit_shell)
 
 # suffixes: A list of file extensions to treat as test files.
-config.suffixes = ['.td', '.mlir', '.ll', '.fir', '.sv']
+config.suffixes = ['.td', '.mlir', '.ll', '.fir', '.sv', '.test']
 
 # test_source_root: The root path where tests are located.
 config.test_source_root = os.path.dirname(__file__)
@@ -60,8 +60,9 @@ tool_dirs = [
 tools = [
     'arcilator', 'circt-as', 'circt-capi-ir-test', 'circt-capi-om-test',
     'circt-capi-firrtl-test', 'circt-capi-firtool-test', 'circt-dis',
-    'circt-lec', 'circt-reduce', 'circt-test', 'circt-translate', 'firtool',
-    'hlstool', 'om-linker', 'ibistool'
+    'circt-firrtl-lsp-server', 'circt-lec', 'circt-reduce', 'circt-sched-bench', 'circt-test',
+    'circt-translate', 'firtool', 'hlstool', 'om-linker', 'ibistool',
+    'llhd-sim'
 ]
 
 if "CIRCT_OPT_CHECK_IR_ROUNDTRIP" in os.environ:
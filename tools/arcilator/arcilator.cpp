@@ -31,6 +31,7 @@
 #include "circt/Dialect/Sim/SimDialect.h"
 #include "circt/Dialect/Sim/SimPasses.h"
 #include "circt/Dialect/Verif/VerifDialect.h"
+#include "circt/Support/PassTelemetry.h"
 #include "circt/Support/Passes.h"
 #include "circt/Support/Version.h"
 #include "mlir/Bytecode/BytecodeReader.h"
@@ -172,6 +173,13 @@ static llvm::cl::opt<bool> verbosePassExecutions(
     llvm::cl::desc("Log executions of toplevel module passes"),
     llvm::cl::init(false), llvm::cl::cat(mainCategory));
 
+static llvm::cl::opt<std::string> passTelemetryFile(
+    "pass-telemetry",
+    llvm::cl::desc("Write per-pass time, memory, and op count telemetry as a "
+                   "Chrome trace-event JSON file"),
+    llvm::cl::init(""), llvm::cl::value_desc("filename"),
+    llvm::cl::cat(mainCategory));
+
 static llvm::cl::opt<bool> splitInputFile(
     "split-input-file",
     llvm::cl::desc("Split the input file into pieces and process each "
@@ -379,12 +387,24 @@ static LogicalResult processBuffer(
   if (!module)
     return failure();
 
+  // Collect telemetry across both pass managers into a single trace, and write
+  // it out regardless of whether the pipelines succeed.
+  std::optional<PassTelemetry> telemetry;
+  if (!passTelemetryFile.empty())
+    telemetry.emplace();
+  auto writeTelemetry = llvm::make_scope_exit([&] {
+    if (telemetry)
+      (void)telemetry->writeToFile(passTelemetryFile);
+  });
+
   // Lower HwModule to Arc model.
   PassManager pmArc(&context);
   pmArc.enableVerifier(verifyPasses);
   pmArc.enableTiming(ts);
   if (failed(applyPassManagerCLOptions(pmArc)))
     return failure();
+  if (telemetry)
+    pmArc.addInstrumentation(telemetry->createInstrumentation());
   populateHwModuleToArcPipeline(pmArc);
 
   if (failed(pmArc.run(module.get())))
@@ -417,6 +437,8 @@ static LogicalResult processBuffer(
     pmLlvm.addInstrumentation(
         std::make_unique<VerbosePassInstrumentation<mlir::ModuleOp>>(
             "arcilator"));
+  if (telemetry)
+    pmLlvm.addInstrumentation(telemetry->createInstrumentation());
   populateArcToLLVMPipeline(pmLlvm);
 
   if (printDebugInfo && outputFormat == OutputLLVM)
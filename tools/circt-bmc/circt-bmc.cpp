@@ -16,9 +16,11 @@
 #include "circt/Conversion/VerifToSMT.h"
 #include "circt/Dialect/Comb/CombDialect.h"
 #include "circt/Dialect/HW/HWDialect.h"
+#include "circt/Dialect/HW/HWOps.h"
 #include "circt/Dialect/SMT/SMTDialect.h"
 #include "circt/Dialect/Seq/SeqDialect.h"
 #include "circt/Dialect/Verif/VerifDialect.h"
+#include "circt/Dialect/Verif/VerifOps.h"
 #include "circt/Support/Passes.h"
 #include "circt/Support/Version.h"
 #include "circt/Tools/circt-bmc/Passes.h"
@@ -40,10 +42,21 @@
 #include "mlir/Transforms/Passes.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Program.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include <chrono>
+#include <thread>
+
+#ifdef LLVM_ON_UNIX
+#include <csignal>
+#endif
 
 #ifdef CIRCT_BMC_ENABLE_JIT
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
@@ -107,6 +120,35 @@ static cl::list<std::string> sharedLibs{
     "shared-libs", llvm::cl::desc("Libraries to link dynamically"),
     cl::MiscFlags::CommaSeparated, llvm::cl::cat(mainCategory)};
 
+static cl::opt<bool> printBoundTimes(
+    "print-bound-times",
+    cl::desc("Print the result and solving time of each bound to stderr"),
+    cl::init(false), cl::cat(mainCategory));
+
+static cl::opt<unsigned> portfolioSize(
+    "portfolio",
+    cl::desc("Run the given number of differently configured solvers in "
+             "parallel and report the first answer"),
+    cl::init(1), cl::cat(mainCategory));
+
+static cl::opt<bool> splitProperties(
+    "split-properties",
+    cl::desc("Check each assertion of the top module in a separate solver"),
+    cl::init(false), cl::cat(mainCategory));
+
+static cl::opt<unsigned>
+    numJobs("j",
+            cl::desc("Maximum number of solver processes to run in parallel "
+                     "(default: number of hardware threads)"),
+            cl::init(0), cl::cat(mainCategory));
+static cl::alias numJobsLong("jobs", cl::desc("Alias for -j"),
+                             cl::aliasopt(numJobs), cl::cat(mainCategory));
+
+static cl::opt<bool> workerMode(
+    "bmc-worker",
+    cl::desc("Run as a worker of a parallel or portfolio model check"),
+    cl::init(false), cl::Hidden, cl::cat(mainCategory));
+
 #else
 
 enum OutputFormat { OutputMLIR, OutputLLVM, OutputSMTLIB };
@@ -119,6 +161,306 @@ static cl::opt<OutputFormat> outputFormat(
 
 #endif
 
+static cl::list<std::string> z3Params(
+    "z3-param",
+    cl::desc("Global Z3 parameter to set before solving, in key=value format "
+             "(e.g. smt.random_seed=42)"),
+    cl::value_desc("key=value"), cl::cat(mainCategory));
+
+static cl::opt<int> propertyIndex(
+    "property",
+    cl::desc("Only check the assertion with the given index in the top module"),
+    cl::init(-1), cl::Hidden, cl::cat(mainCategory));
+
+//===----------------------------------------------------------------------===//
+// Property selection
+//===----------------------------------------------------------------------===//
+
+/// Collect the assertions in the top module. Fails if assertions are nested
+/// in instantiated modules, since these cannot be checked individually.
+static LogicalResult collectProperties(ModuleOp module,
+                                       SmallVectorImpl<Operation *> &asserts) {
+  auto top = module.lookupSymbol<hw::HWModuleOp>(moduleName);
+  if (!top) {
+    llvm::errs() << "no hw.module named '" << moduleName << "' found\n";
+    return failure();
+  }
+  top.walk([&](verif::AssertOp op) { asserts.push_back(op); });
+
+  SmallVector<Operation *> worklist;
+  DenseSet<Operation *> visited;
+  worklist.push_back(top);
+  while (!worklist.empty()) {
+    auto *op = worklist.pop_back_val();
+    auto result = op->walk([&](Operation *nested) {
+      if (op != top && isa<verif::AssertOp>(nested))
+        return WalkResult::interrupt();
+      if (auto inst = dyn_cast<hw::InstanceOp>(nested))
+        if (auto *child = module.lookupSymbol(inst.getModuleNameAttr()))
+          if (visited.insert(child).second)
+            worklist.push_back(child);
+      return WalkResult::advance();
+    });
+    if (result.wasInterrupted()) {
+      llvm::errs() << "properties can only be checked individually if all "
+                      "assertions are in the top module\n";
+      return failure();
+    }
+  }
+  return success();
+}
+
+/// Erase all assertions in the top module but the one at `index`.
+static LogicalResult selectProperty(ModuleOp module, unsigned index) {
+  SmallVector<Operation *> asserts;
+  if (failed(collectProperties(module, asserts)))
+    return failure();
+  if (index >= asserts.size()) {
+    llvm::errs() << "property index " << index << " out of range, module '"
+                 << moduleName << "' has " << asserts.size()
+                 << " assertions\n";
+    return failure();
+  }
+  for (auto [i, op] : llvm::enumerate(asserts))
+    if (i != index)
+      op->erase();
+  return success();
+}
+
+#ifdef CIRCT_BMC_ENABLE_JIT
+
+//===----------------------------------------------------------------------===//
+// Per-bound reporting
+//===----------------------------------------------------------------------===//
+
+/// The function the lowered model check calls after each bound if
+/// `--print-bound-times` is set.
+static constexpr StringLiteral reportBoundFuncName = "circt_bmc_report_bound";
+static std::chrono::steady_clock::time_point boundStartTime;
+static std::chrono::steady_clock::time_point checkStartTime;
+
+extern "C" void circtBMCReportBound(int32_t bound, uint8_t violated) {
+  auto now = std::chrono::steady_clock::now();
+  auto seconds = [](auto duration) {
+    return std::chrono::duration<double>(duration).count();
+  };
+  llvm::errs() << "bound " << bound << ": "
+               << ((violated & 1) ? "violated" : "no violation") << " ("
+               << llvm::format("%.3f", seconds(now - boundStartTime))
+               << "s, total "
+               << llvm::format("%.3f", seconds(now - checkStartTime))
+               << "s)\n";
+  boundStartTime = now;
+}
+
+//===----------------------------------------------------------------------===//
+// Parallel and portfolio execution
+//===----------------------------------------------------------------------===//
+
+/// Return the global Z3 parameters of the portfolio configuration `config`.
+/// Configuration 0 is Z3's default; the others vary the random seeds and
+/// alternate between different case splitting heuristics.
+static SmallVector<std::string> getPortfolioParams(unsigned config) {
+  SmallVector<std::string> params;
+  if (config == 0)
+    return params;
+  params.push_back("smt.random_seed=" + std::to_string(config));
+  params.push_back("sat.random_seed=" + std::to_string(config));
+  if (config % 3 == 1)
+    params.push_back("smt.relevancy=0");
+  else if (config % 3 == 2)
+    params.push_back("smt.phase_selection=5");
+  return params;
+}
+
+namespace {
+/// A worker process checking one property with one solver configuration.
+struct Worker {
+  unsigned property;
+  unsigned config;
+  llvm::sys::ProcessInfo process;
+  SmallString<128> stdoutPath, stderrPath;
+  std::chrono::steady_clock::time_point start;
+};
+
+/// The outcome of checking a single property.
+struct PropertyResult {
+  /// The result message printed by the winning worker, empty if undecided.
+  std::string message;
+  unsigned config = 0;
+  double seconds = 0;
+  std::string log;
+};
+} // namespace
+
+static std::string readFile(StringRef path) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer)
+    return {};
+  return (*buffer)->getBuffer().str();
+}
+
+static void stopWorker(Worker &worker) {
+#ifdef LLVM_ON_UNIX
+  ::kill(worker.process.Pid, SIGKILL);
+#endif
+  llvm::sys::Wait(worker.process, std::nullopt);
+  llvm::sys::fs::remove(worker.stdoutPath);
+  llvm::sys::fs::remove(worker.stderrPath);
+}
+
+/// Check the properties of the input in parallel worker processes, running
+/// `portfolioSize` differently configured solvers on each of them. The first
+/// answer for a property wins and the remaining workers on it are terminated.
+static LogicalResult executeParallelBMC(MLIRContext &context,
+                                        ArrayRef<const char *> args) {
+  unsigned numProperties = 1;
+  if (splitProperties) {
+    auto module = parseSourceFile<ModuleOp>(inputFilename, &context);
+    if (!module)
+      return failure();
+    SmallVector<Operation *> asserts;
+    if (failed(collectProperties(*module, asserts)))
+      return failure();
+    numProperties = asserts.size();
+    if (numProperties == 0) {
+      llvm::outs() << "Bound reached with no violations!\n";
+      return success();
+    }
+  }
+
+  std::string executable =
+      llvm::sys::fs::getMainExecutable(args[0], (void *)&executeParallelBMC);
+  unsigned maxWorkers =
+      numJobs ? numJobs : llvm::hardware_concurrency().compute_thread_count();
+
+  SmallVector<PropertyResult> results(numProperties);
+  SmallVector<std::pair<unsigned, unsigned>> pending;
+  for (unsigned property = 0; property < numProperties; ++property)
+    for (unsigned config = 0; config < portfolioSize; ++config)
+      pending.push_back({property, config});
+  std::reverse(pending.begin(), pending.end());
+
+  std::vector<Worker> running;
+  bool spawnFailed = false;
+  while (!spawnFailed && (!pending.empty() || !running.empty())) {
+    // Launch new workers for undecided properties.
+    while (running.size() < maxWorkers && !pending.empty()) {
+      auto [property, config] = pending.pop_back_val();
+      if (!results[property].message.empty())
+        continue;
+      Worker worker{property, config, {}, {}, {}, {}};
+      if (llvm::sys::fs::createTemporaryFile("circt-bmc", "out",
+                                             worker.stdoutPath) ||
+          llvm::sys::fs::createTemporaryFile("circt-bmc", "err",
+                                             worker.stderrPath)) {
+        llvm::errs() << "unable to create temporary files for workers\n";
+        spawnFailed = true;
+        break;
+      }
+
+      SmallVector<std::string> workerArgs(args.begin(), args.end());
+      workerArgs.push_back("--bmc-worker");
+      if (splitProperties)
+        workerArgs.push_back("--property=" + std::to_string(property));
+      for (auto &param : getPortfolioParams(config))
+        workerArgs.push_back("--z3-param=" + param);
+      SmallVector<StringRef> argRefs(workerArgs.begin(), workerArgs.end());
+      std::optional<StringRef> redirects[] = {
+          StringRef(""), StringRef(worker.stdoutPath),
+          StringRef(worker.stderrPath)};
+
+      std::string errMsg;
+      worker.start = std::chrono::steady_clock::now();
+      worker.process = llvm::sys::ExecuteNoWait(
+          executable, argRefs, std::nullopt, redirects, 0, &errMsg);
+      if (worker.process.Pid == llvm::sys::ProcessInfo::InvalidPid) {
+        llvm::errs() << "unable to launch worker: " << errMsg << "\n";
+        spawnFailed = true;
+        break;
+      }
+      running.push_back(std::move(worker));
+    }
+
+    // Collect the results of finished workers.
+    bool anyFinished = false;
+    for (auto &worker : running) {
+      if (worker.process.Pid == llvm::sys::ProcessInfo::InvalidPid)
+        continue;
+      auto status = llvm::sys::Wait(worker.process, /*SecondsToWait=*/0,
+                                    nullptr, nullptr, /*Polling=*/true);
+      if (status.Pid == 0)
+        continue;
+      anyFinished = true;
+      auto &result = results[worker.property];
+      auto output = readFile(worker.stdoutPath);
+      auto log = readFile(worker.stderrPath);
+      llvm::sys::fs::remove(worker.stdoutPath);
+      llvm::sys::fs::remove(worker.stderrPath);
+      worker.process.Pid = llvm::sys::ProcessInfo::InvalidPid;
+
+      StringRef message;
+      for (StringRef candidate :
+           {"Bound reached with no violations!", "Assertion can be violated!"})
+        if (StringRef(output).contains(candidate))
+          message = candidate;
+      if (!result.message.empty())
+        continue;
+      if (message.empty() || status.ReturnCode != 0) {
+        // Keep the log of the last failing configuration for diagnosis.
+        result.log = log;
+        continue;
+      }
+      result.message = message.str();
+      result.config = worker.config;
+      result.seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - worker.start)
+                           .count();
+      result.log = log;
+
+      // Stop the other solvers working on the same property.
+      for (auto &other : running)
+        if (other.property == worker.property &&
+            other.process.Pid != llvm::sys::ProcessInfo::InvalidPid) {
+          stopWorker(other);
+          other.process.Pid = llvm::sys::ProcessInfo::InvalidPid;
+        }
+    }
+    llvm::erase_if(running, [](auto &worker) {
+      return worker.process.Pid == llvm::sys::ProcessInfo::InvalidPid;
+    });
+    if (!anyFinished)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (auto &worker : running)
+    stopWorker(worker);
+  if (spawnFailed)
+    return failure();
+
+  bool allDecided = true;
+  for (auto [property, result] : llvm::enumerate(results)) {
+    if (result.message.empty()) {
+      allDecided = false;
+      llvm::errs() << result.log;
+      llvm::errs() << "all solvers failed";
+      if (splitProperties)
+        llvm::errs() << " on property " << property;
+      llvm::errs() << "\n";
+      continue;
+    }
+    if (splitProperties)
+      llvm::outs() << "Property " << property << ": ";
+    llvm::outs() << result.message << "\n";
+    llvm::errs() << result.log;
+    if (portfolioSize > 1)
+      llvm::errs() << "Solved by portfolio configuration " << result.config
+                   << " in " << llvm::format("%.3f", result.seconds) << "s\n";
+  }
+  return success(allDecided);
+}
+
+#endif
+
 //===----------------------------------------------------------------------===//
 // Tool implementation
 //===----------------------------------------------------------------------===//
@@ -140,6 +482,9 @@ static LogicalResult executeBMC(MLIRContext &context) {
   if (!module)
     return failure();
 
+  if (propertyIndex >= 0 && failed(selectProperty(*module, propertyIndex)))
+    return failure();
+
   // Create the output directory or output file depending on our mode.
   std::optional<std::unique_ptr<llvm::ToolOutputFile>> outputFile;
   std::string errorMessage;
@@ -168,11 +513,17 @@ static LogicalResult executeBMC(MLIRContext &context) {
   pm.addPass(createLowerToBMC(lowerToBMCOptions));
   pm.addPass(createConvertHWToSMT());
   pm.addPass(createConvertCombToSMT());
-  pm.addPass(createConvertVerifToSMT());
+  ConvertVerifToSMTOptions verifToSMTOptions;
+#ifdef CIRCT_BMC_ENABLE_JIT
+  if (printBoundTimes && outputFormat == OutputRunJIT)
+    verifToSMTOptions.reportBoundFunc = reportBoundFuncName.str();
+#endif
+  pm.addPass(createConvertVerifToSMT(verifToSMTOptions));
   pm.addPass(createSimpleCanonicalizerPass());
 
   if (outputFormat != OutputMLIR && outputFormat != OutputSMTLIB) {
     LowerSMTToZ3LLVMOptions options;
+    options.z3Params.assign(z3Params.begin(), z3Params.end());
     pm.addPass(createLowerSMTToZ3LLVM(options));
     pm.addPass(createCSEPass());
     pm.addPass(createSimpleCanonicalizerPass());
@@ -254,9 +605,18 @@ static LogicalResult executeBMC(MLIRContext &context) {
       return handleErr(expectedEngine.takeError());
 
     engine = std::move(*expectedEngine);
+    if (printBoundTimes)
+      engine->registerSymbols([](llvm::orc::MangleAndInterner interner) {
+        llvm::orc::SymbolMap symbols;
+        symbols[interner(reportBoundFuncName)] = {
+            llvm::orc::ExecutorAddr::fromPtr(&circtBMCReportBound),
+            llvm::JITSymbolFlags::Exported};
+        return symbols;
+      });
   }
 
   auto timer = ts.nest("JIT Execution");
+  checkStartTime = boundStartTime = std::chrono::steady_clock::now();
   if (auto err = engine->invokePacked(moduleName))
     return handleErr(std::move(err));
 
@@ -315,6 +675,18 @@ int main(int argc, char **argv) {
   // Avoid printing a superfluous note on diagnostic emission.
   context.printOpOnDiagnostic(false);
 
+#ifdef CIRCT_BMC_ENABLE_JIT
+  // Distribute the work across worker processes running this tool.
+  if (!workerMode && (portfolioSize > 1 || splitProperties)) {
+    if (outputFormat != OutputRunJIT) {
+      llvm::errs() << "--portfolio and --split-properties require --run\n";
+      exit(1);
+    }
+    SmallVector<const char *> args(argv, argv + argc);
+    exit(failed(executeParallelBMC(context, args)));
+  }
+#endif
+
   // Perform the logical equivalence checking; using `exit` to avoid the slow
   // teardown of the MLIR context.
   exit(failed(executeBMC(context)));
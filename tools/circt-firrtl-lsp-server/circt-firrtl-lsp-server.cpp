@@ -0,0 +1,19 @@
+//===- circt-firrtl-lsp-server.cpp - FIRRTL Language Server ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Support/Version.h"
+#include "circt/Tools/circt-firrtl-lsp-server/CirctFIRRTLLspServerMain.h"
+#include "llvm/Support/PrettyStackTrace.h"
+
+int main(int argc, char **argv) {
+  // Set the bug report message to indicate users should file issues on
+  // llvm/circt and not llvm/llvm-project.
+  llvm::setBugReportMsg(circt::circtBugReportMsg);
+
+  return failed(circt::CirctFIRRTLLspServerMain(argc, argv));
+}
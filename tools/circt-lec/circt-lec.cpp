@@ -48,6 +48,9 @@
 #include "mlir/ExecutionEngine/OptUtils.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
+#include <atomic>
+#include <thread>
 #endif
 
 namespace cl = llvm::cl;
@@ -90,6 +93,17 @@ static cl::opt<bool>
                           cl::desc("Log executions of toplevel module passes"),
                           cl::init(false), cl::cat(mainCategory));
 
+static cl::opt<bool> simplify(
+    "simplify",
+    cl::desc("Structurally hash and simulate the circuits, and check each "
+             "output on its cone of influence only"),
+    cl::init(false), cl::cat(mainCategory));
+
+static cl::opt<unsigned> simPatterns(
+    "sim-patterns",
+    cl::desc("Number of random patterns to simulate with --simplify"),
+    cl::init(64), cl::cat(mainCategory));
+
 #ifdef CIRCT_LEC_ENABLE_JIT
 
 enum OutputFormat { OutputMLIR, OutputLLVM, OutputSMTLIB, OutputRunJIT };
@@ -106,6 +120,12 @@ static cl::list<std::string> sharedLibs{
     "shared-libs", llvm::cl::desc("Libraries to link dynamically"),
     cl::MiscFlags::CommaSeparated, llvm::cl::cat(mainCategory)};
 
+static cl::opt<unsigned> numJobs(
+    "j",
+    cl::desc("Number of outputs to check in parallel with --simplify "
+             "(0: number of hardware threads)"),
+    cl::init(1), cl::cat(mainCategory));
+
 #else
 
 enum OutputFormat { OutputMLIR, OutputLLVM, OutputSMTLIB };
@@ -181,6 +201,159 @@ parseAndMergeModules(MLIRContext &context, TimingScope &ts) {
   return module;
 }
 
+/// Add the passes lowering the LEC problem to SMT and, depending on the output
+/// format, further down to LLVM.
+static void addLoweringPasses(PassManager &pm) {
+  pm.addPass(createConvertHWToSMT());
+  pm.addPass(createConvertCombToSMT());
+  pm.addPass(createConvertVerifToSMT());
+  pm.addPass(createSimpleCanonicalizerPass());
+
+  if (outputFormat != OutputMLIR && outputFormat != OutputSMTLIB) {
+    pm.addPass(createLowerSMTToZ3LLVM());
+    pm.addPass(createCSEPass());
+    pm.addPass(createSimpleCanonicalizerPass());
+    pm.addPass(LLVM::createDIScopeForLLVMFuncOpPass());
+  }
+}
+
+#ifdef CIRCT_LEC_ENABLE_JIT
+
+static LogicalResult handleErr(llvm::Error error) {
+  llvm::handleAllErrors(std::move(error), [](const llvm::ErrorInfoBase &info) {
+    llvm::errs() << "Error: ";
+    info.log(llvm::errs());
+    llvm::errs() << '\n';
+  });
+  return failure();
+}
+
+/// Create a JIT for `module` and check that it has a valid entry point.
+static FailureOr<std::unique_ptr<mlir::ExecutionEngine>>
+createJIT(ModuleOp module, StringRef entryName) {
+  auto entryPoint =
+      dyn_cast_or_null<LLVM::LLVMFuncOp>(module.lookupSymbol(entryName));
+  if (!entryPoint || entryPoint.empty()) {
+    llvm::errs() << "no valid entry point found, expected 'llvm.func' named '"
+                 << entryName << "'\n";
+    return failure();
+  }
+
+  if (entryPoint.getNumArguments() != 0) {
+    llvm::errs() << "entry point '" << entryName << "' must have no arguments";
+    return failure();
+  }
+
+  SmallVector<StringRef, 4> sharedLibraries(sharedLibs.begin(),
+                                            sharedLibs.end());
+  mlir::ExecutionEngineOptions engineOptions;
+  engineOptions.transformer = mlir::makeOptimizingTransformer(
+      /*optLevel*/ 3, /*sizeLevel=*/0, /*targetMachine=*/nullptr);
+  engineOptions.jitCodeGenOptLevel = llvm::CodeGenOptLevel::Aggressive;
+  engineOptions.sharedLibPaths = sharedLibraries;
+  engineOptions.enableObjectDump = true;
+
+  auto expectedEngine = mlir::ExecutionEngine::create(module, engineOptions);
+  if (!expectedEngine)
+    return handleErr(expectedEngine.takeError());
+  return std::move(*expectedEngine);
+}
+
+/// Check the outputs split off by the SimplifyLEC pass in parallel. Each check
+/// is moved into a separate module with its own JIT and solver context, such
+/// that the checks share no state. Returns `std::nullopt` if there are less
+/// than two output checks, which are then better run sequentially.
+///
+/// The modules are lowered and JIT-compiled on the main thread, since they
+/// share the MLIR context and the lowering loads dialects into it on demand.
+/// Only the solver runs, which touch no MLIR state, are spread across threads.
+static std::optional<LogicalResult> executeParallelLEC(ModuleOp module,
+                                                       TimingScope &ts) {
+  SmallVector<StringAttr> outputFuncs;
+  for (auto func : module.getOps<func::FuncOp>())
+    if (func->hasAttr("circt.lec.output"))
+      outputFuncs.push_back(func.getSymNameAttr());
+  if (outputFuncs.size() < 2)
+    return std::nullopt;
+
+  SmallVector<OwningOpRef<ModuleOp>> modules;
+  for (auto name : outputFuncs) {
+    OwningOpRef<ModuleOp> clone = module.clone();
+    for (auto func : llvm::make_early_inc_range(clone->getOps<func::FuncOp>()))
+      if (func.getSymNameAttr() == name)
+        func.setPublic();
+      else if (func.getSymName() == firstModuleName ||
+               func->hasAttr("circt.lec.output"))
+        func.erase();
+    modules.push_back(std::move(clone));
+  }
+
+  SmallVector<std::unique_ptr<mlir::ExecutionEngine>> engines;
+  {
+    auto timer = ts.nest("Lower and set up the output checks");
+    PassManager pm(module.getContext());
+    pm.enableVerifier(verifyPasses);
+    addLoweringPasses(pm);
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    for (auto [clone, name] : llvm::zip(modules, outputFuncs)) {
+      if (failed(pm.run(*clone)))
+        return failure();
+      auto engine = createJIT(*clone, name);
+      if (failed(engine))
+        return failure();
+      engines.push_back(std::move(*engine));
+    }
+  }
+
+  auto timer = ts.nest("Parallel output checks");
+
+  // Stop at the first output that differs or fails to be checked. Errors are
+  // collected per check and reported in output order once all threads are
+  // done, rather than interleaved on stderr.
+  SmallVector<std::string> errors(engines.size());
+  std::atomic<unsigned> nextCheck(0);
+  std::atomic<bool> differs(false), anyFailed(false);
+  auto worker = [&] {
+    while (!differs && !anyFailed) {
+      unsigned i = nextCheck++;
+      if (i >= engines.size())
+        return;
+      bool equivalent = false;
+      if (auto err = engines[i]->invoke(
+              outputFuncs[i].getValue(),
+              mlir::ExecutionEngine::result(equivalent))) {
+        errors[i] = llvm::toString(std::move(err));
+        anyFailed = true;
+      } else if (!equivalent) {
+        differs = true;
+      }
+    }
+  };
+
+  unsigned numThreads =
+      numJobs ? numJobs : llvm::hardware_concurrency().compute_thread_count();
+  numThreads = std::min<unsigned>(numThreads, engines.size());
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < numThreads; ++i)
+    threads.emplace_back(worker);
+  for (auto &thread : threads)
+    thread.join();
+
+  if (anyFailed) {
+    for (auto &error : errors)
+      if (!error.empty())
+        llvm::errs() << "Error: " << error << '\n';
+    return failure();
+  }
+  llvm::outs() << (differs ? "c1 != c2\n" : "c1 == c2\n");
+  return success();
+}
+
+#endif
+
 /// This functions initializes the various components of the tool and
 /// orchestrates the work to be done.
 static LogicalResult executeLEC(MLIRContext &context) {
@@ -220,18 +393,25 @@ static LogicalResult executeLEC(MLIRContext &context) {
   constructLECOptions.firstModule = firstModuleName;
   constructLECOptions.secondModule = secondModuleName;
   pm.addPass(createConstructLEC(constructLECOptions));
-  pm.addPass(createConvertHWToSMT());
-  pm.addPass(createConvertCombToSMT());
-  pm.addPass(createConvertVerifToSMT());
-  pm.addPass(createSimpleCanonicalizerPass());
+  if (simplify) {
+    SimplifyLECOptions simplifyLECOptions;
+    simplifyLECOptions.numPatterns = simPatterns;
+    pm.addPass(createSimplifyLEC(simplifyLECOptions));
+  }
 
-  if (outputFormat != OutputMLIR && outputFormat != OutputSMTLIB) {
-    pm.addPass(createLowerSMTToZ3LLVM());
-    pm.addPass(createCSEPass());
-    pm.addPass(createSimpleCanonicalizerPass());
-    pm.addPass(LLVM::createDIScopeForLLVMFuncOpPass());
+#ifdef CIRCT_LEC_ENABLE_JIT
+  // Solve the outputs in parallel if requested. This requires the checks to be
+  // split off before they are lowered.
+  if (simplify && numJobs != 1 && outputFormat == OutputRunJIT) {
+    if (failed(pm.run(module.get())))
+      return failure();
+    if (auto result = executeParallelLEC(module.get(), ts))
+      return *result;
+    pm.clear();
   }
+#endif
 
+  addLoweringPasses(pm);
   if (failed(pm.run(module.get())))
     return failure();
 
@@ -262,51 +442,16 @@ static LogicalResult executeLEC(MLIRContext &context) {
 
 #ifdef CIRCT_LEC_ENABLE_JIT
 
-  auto handleErr = [](llvm::Error error) -> LogicalResult {
-    llvm::handleAllErrors(std::move(error),
-                          [](const llvm::ErrorInfoBase &info) {
-                            llvm::errs() << "Error: ";
-                            info.log(llvm::errs());
-                            llvm::errs() << '\n';
-                          });
-    return failure();
-  };
-
   std::unique_ptr<mlir::ExecutionEngine> engine;
   {
     auto timer = ts.nest("Setting up the JIT");
-    auto entryPoint = dyn_cast_or_null<LLVM::LLVMFuncOp>(
-        module->lookupSymbol(firstModuleName));
-    if (!entryPoint || entryPoint.empty()) {
-      llvm::errs() << "no valid entry point found, expected 'llvm.func' named '"
-                   << firstModuleName << "'\n";
-      return failure();
-    }
-
-    if (entryPoint.getNumArguments() != 0) {
-      llvm::errs() << "entry point '" << firstModuleName
-                   << "' must have no arguments";
-      return failure();
-    }
-
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
 
-    SmallVector<StringRef, 4> sharedLibraries(sharedLibs.begin(),
-                                              sharedLibs.end());
-    mlir::ExecutionEngineOptions engineOptions;
-    engineOptions.transformer = mlir::makeOptimizingTransformer(
-        /*optLevel*/ 3, /*sizeLevel=*/0, /*targetMachine=*/nullptr);
-    engineOptions.jitCodeGenOptLevel = llvm::CodeGenOptLevel::Aggressive;
-    engineOptions.sharedLibPaths = sharedLibraries;
-    engineOptions.enableObjectDump = true;
-
-    auto expectedEngine =
-        mlir::ExecutionEngine::create(module.get(), engineOptions);
-    if (!expectedEngine)
-      return handleErr(expectedEngine.takeError());
-
-    engine = std::move(*expectedEngine);
+    auto createdEngine = createJIT(module.get(), firstModuleName);
+    if (failed(createdEngine))
+      return failure();
+    engine = std::move(*createdEngine);
   }
 
   auto timer = ts.nest("JIT Execution");
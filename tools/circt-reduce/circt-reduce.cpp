@@ -121,6 +121,12 @@ static cl::opt<unsigned>
                           "ops per chunk (granularity upper bound)"),
                  cl::cat(granularityCategory));
 
+static cl::opt<unsigned> numJobs(
+    "j", cl::init(1),
+    cl::desc("Number of reduction attempts to test concurrently. The result is "
+             "identical to a sequential run."),
+    cl::cat(mainCategory));
+
 static cl::opt<bool> testMustFail(
     "test-must-fail", cl::init(false),
     cl::desc("Consider an input to be interesting on non-zero exit status."),
@@ -239,38 +245,51 @@ static LogicalResult execute(MLIRContext &context) {
       if (maxChunkSize > 0)
         rangeLength = std::min<size_t>(rangeLength, maxChunkSize);
 
-      // Apply the pattern to the subset of operations selected by `rangeBase`
-      // and `rangeLength`.
+      // Apply the pattern to the subset of operations selected by `chunkBase`
+      // and `chunkLength` on a copy of the current module. Also counts the
+      // number of operations the pattern applies to in `opIdx`.
       size_t opIdx = 0;
-      mlir::OwningOpRef<mlir::ModuleOp> newModule = module->clone();
-      pattern.beforeReduction(*newModule);
-      SmallVector<std::pair<Operation *, uint64_t>, 16> opBenefits;
-      SmallDenseSet<Operation *> opsTouched;
-      pattern.notifyOpErasedCallback = [&](Operation *op) {
-        opsTouched.insert(op);
-      };
-      newModule->walk([&](Operation *op) {
-        uint64_t benefit = pattern.match(op);
-        if (benefit > 0) {
-          opIdx++;
-          opBenefits.push_back(std::make_pair(op, benefit));
-        }
-      });
-      std::sort(opBenefits.begin(), opBenefits.end(),
-                [](auto a, auto b) { return a.second > b.second; });
-      for (size_t idx = rangeBase, num = 0;
-           num < rangeLength && idx < opBenefits.size(); ++idx) {
-        auto *op = opBenefits[idx].first;
-        if (opsTouched.contains(op))
-          continue;
-        if (pattern.match(op)) {
-          op->walk([&](Operation *subop) { opsTouched.insert(subop); });
-          (void)pattern.rewrite(op);
-          ++num;
+      auto applyChunk = [&](size_t chunkBase, size_t chunkLength) {
+        opIdx = 0;
+        mlir::OwningOpRef<mlir::ModuleOp> newModule = module->clone();
+        pattern.beforeReduction(*newModule);
+        SmallVector<std::pair<Operation *, uint64_t>, 16> opBenefits;
+        SmallDenseSet<Operation *> opsTouched;
+        pattern.notifyOpErasedCallback = [&](Operation *op) {
+          opsTouched.insert(op);
+        };
+        newModule->walk([&](Operation *op) {
+          uint64_t benefit = pattern.match(op);
+          if (benefit > 0) {
+            opIdx++;
+            opBenefits.push_back(std::make_pair(op, benefit));
+          }
+        });
+        std::sort(opBenefits.begin(), opBenefits.end(),
+                  [](auto a, auto b) { return a.second > b.second; });
+        for (size_t idx = chunkBase, num = 0;
+             num < chunkLength && idx < opBenefits.size(); ++idx) {
+          auto *op = opBenefits[idx].first;
+          if (opsTouched.contains(op))
+            continue;
+          if (pattern.match(op)) {
+            op->walk([&](Operation *subop) { opsTouched.insert(subop); });
+            (void)pattern.rewrite(op);
+            ++num;
+          }
         }
-      }
-      pattern.afterReduction(*newModule);
-      pattern.notifyOpErasedCallback = nullptr;
+        pattern.afterReduction(*newModule);
+        pattern.notifyOpErasedCallback = nullptr;
+        return newModule;
+      };
+
+      // A reduction attempt and the offset of the chunk it was created from.
+      struct Candidate {
+        size_t rangeBase;
+        mlir::OwningOpRef<mlir::ModuleOp> module;
+      };
+      SmallVector<Candidate, 1> candidates;
+      candidates.push_back({rangeBase, applyChunk(rangeBase, rangeLength)});
       if (opIdx == 0) {
         VERBOSE({
           clearSummary();
@@ -285,6 +304,17 @@ static LogicalResult execute(MLIRContext &context) {
         rangeLength = std::min<size_t>(rangeLength,
                                        std::max<size_t>(opIdx / minChunks, 1));
 
+      // Speculatively apply the pattern to the chunks that a sequential run
+      // would try next if the first one is rejected, such that their tests can
+      // run concurrently. Stop at the end of the input, where a sequential run
+      // would change the granularity.
+      for (unsigned job = 1; job < numJobs; ++job) {
+        size_t chunkBase = rangeBase + job * rangeLength;
+        if (chunkBase >= opIdx)
+          break;
+        candidates.push_back({chunkBase, applyChunk(chunkBase, rangeLength)});
+      }
+
       // Show some progress indication.
       VERBOSE({
         size_t boundLength = std::min(rangeLength, opIdx);
@@ -293,41 +323,63 @@ static LogicalResult execute(MLIRContext &context) {
         clearSummary();
         llvm::errs() << "  [" << numDone << "/" << numTotal << "; "
                      << (numDone * 100 / numTotal) << "%; " << opIdx << " ops, "
-                     << boundLength << " at once; " << pattern.getName()
-                     << "]\n";
+                     << boundLength << " at once; ";
+        if (candidates.size() > 1)
+          llvm::errs() << candidates.size() << " chunks in parallel; ";
+        llvm::errs() << pattern.getName() << "]\n";
         errsPosAfterLastSummary = llvm::errs().tell();
       });
 
       // Check if this reduced module is still interesting, and its overall size
       // is smaller than what we had before.
-      auto shouldAccept = [&](TestCase &test) {
+      auto isCandidate = [&](TestCase &test) {
         if (!test.isValid())
           return false; // don't write to disk if module is busted
         if (test.getSize() >= bestSize && !pattern.acceptSizeIncrease())
           return false; // don't run test if size already bad
-        return test.isInteresting();
+        return true;
       };
-      auto test = tester.get(newModule.get());
-      if (shouldAccept(test)) {
+      SmallVector<TestCase, 1> tests;
+      SmallVector<TestCase *, 1> testsToRun;
+      for (auto &candidate : candidates)
+        tests.push_back(tester.get(candidate.module.get()));
+      for (auto &test : tests)
+        if (isCandidate(test))
+          testsToRun.push_back(&test);
+      if (testsToRun.size() > 1)
+        tester.testConcurrently(testsToRun);
+
+      // Commit the first interesting candidate in chunk order. This is the one
+      // a sequential run would have accepted, which keeps the result
+      // deterministic regardless of the number of jobs.
+      auto acceptedIt = llvm::find_if(tests, [&](TestCase &test) {
+        return isCandidate(test) && test.isInteresting();
+      });
+      if (acceptedIt != tests.end()) {
+        auto &accepted = candidates[acceptedIt - tests.begin()];
+        if (accepted.rangeBase != rangeBase)
+          allDidReduce = false;
+        rangeBase = accepted.rangeBase;
+
         // Make this reduced module the new baseline and reset our search
         // strategy to start again from the beginning, since this reduction may
         // have created additional opportunities.
         patternDidReduce = true;
-        bestSize = test.getSize();
+        bestSize = acceptedIt->getSize();
         VERBOSE({
           clearSummary();
           llvm::errs() << "- Accepting module of size " << bestSize << "\n";
         });
-        module = std::move(newModule);
-
-        // We leave `rangeBase` and `rangeLength` untouched in this case. This
-        // causes the next iteration of the loop to try the same pattern again
-        // at the same offset. If the pattern has reached a fixed point, nothing
-        // changes and we proceed. If the pattern has removed an operation, this
-        // will already operate on the next batch of operations which have
-        // likely moved to this point. The only exception are operations that
-        // are marked as "one shot", which explicitly ask to not be re-applied
-        // at the same location.
+        module = std::move(accepted.module);
+
+        // We leave `rangeBase` at the accepted chunk and `rangeLength`
+        // untouched in this case. This causes the next iteration of the loop
+        // to try the same pattern again at the same offset. If the pattern has
+        // reached a fixed point, nothing changes and we proceed. If the pattern
+        // has removed an operation, this will already operate on the next
+        // batch of operations which have likely moved to this point. The only
+        // exception are operations that are marked as "one shot", which
+        // explicitly ask to not be re-applied at the same location.
         if (pattern.isOneShot())
           rangeBase += rangeLength;
 
@@ -338,7 +390,7 @@ static LogicalResult execute(MLIRContext &context) {
       } else {
         allDidReduce = false;
         // Try the pattern on the next `rangeLength` number of operations.
-        rangeBase += rangeLength;
+        rangeBase = candidates.back().rangeBase + rangeLength;
       }
 
       // If we have gone past the end of the input, reduce the size of the chunk
@@ -0,0 +1,555 @@
+//===- circt-sched-bench.cpp - Benchmark the scheduling algorithms --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Benchmark the algorithms in the scheduling infrastructure on SSP problem
+// instances. The instances are either read from an input file, or generated
+// parametrically with a configurable number of operations, operator types and
+// inter-iteration dependences. Every applicable scheduler is run on every
+// instance, and the runtime, memory usage and quality of the solution are
+// reported.
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Dialect/SSP/SSPDialect.h"
+#include "circt/Dialect/SSP/SSPOps.h"
+#include "circt/Dialect/SSP/Utilities.h"
+#include "circt/Scheduling/Algorithms.h"
+#include "circt/Scheduling/Problems.h"
+#include "circt/Support/ResourceUsage.h"
+#include "circt/Support/Version.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Support/FileUtilities.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/WithColor.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+
+using namespace llvm;
+using namespace mlir;
+using namespace circt;
+using namespace circt::scheduling;
+using namespace circt::ssp;
+
+static constexpr const char toolName[] = "circt-sched-bench";
+static cl::OptionCategory mainCategory("circt-sched-bench Options");
+static cl::OptionCategory generatorCategory("Instance Generator Options");
+
+static cl::opt<std::string> inputFilename(cl::Positional,
+                                          cl::desc("<input .mlir file>"),
+                                          cl::init("-"), cl::cat(mainCategory));
+
+static cl::opt<std::string> outputFilename("o", cl::desc("Output filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"),
+                                           cl::cat(mainCategory));
+
+static cl::list<std::string>
+    schedulerNames("schedulers",
+                   cl::desc("Schedulers to run (default: all applicable ones "
+                            "of asap, simplex, lp, cpsat)"),
+                   cl::CommaSeparated, cl::cat(mainCategory));
+
+static cl::opt<unsigned>
+    repetitions("repeat",
+                cl::desc("Run each scheduler this many times and report the "
+                         "fastest run"),
+                cl::init(1), cl::cat(mainCategory));
+
+static cl::opt<float> cycleTime(
+    "cycle-time",
+    cl::desc("Cycle time for chaining problems; these are skipped if unset"),
+    cl::init(0.0f), cl::cat(mainCategory));
+
+static cl::opt<bool>
+    emitInstances("emit-instances",
+                  cl::desc("Print the problem instances instead of running "
+                           "the schedulers"),
+                  cl::init(false), cl::cat(mainCategory));
+
+enum OutputFormat { OutputTable, OutputJSON };
+static cl::opt<OutputFormat> outputFormat(
+    "format", cl::desc("Output format"),
+    cl::values(clEnumValN(OutputTable, "table", "Human-readable table"),
+               clEnumValN(OutputJSON, "json", "JSON array of measurements")),
+    cl::init(OutputTable), cl::cat(mainCategory));
+
+static cl::opt<bool>
+    generate("generate",
+             cl::desc("Generate problem instances instead of reading them "
+                      "from the input file"),
+             cl::init(false), cl::cat(generatorCategory));
+
+static cl::opt<std::string>
+    problemName("problem",
+                cl::desc("Problem to generate instances of (Problem, "
+                         "CyclicProblem, SharedOperatorsProblem, "
+                         "ModuloProblem)"),
+                cl::init("Problem"), cl::cat(generatorCategory));
+
+static cl::list<unsigned>
+    numOps("num-ops",
+           cl::desc("Number of operations in each generated instance "
+                    "(default: 1000)"),
+           cl::CommaSeparated, cl::cat(generatorCategory));
+
+static cl::opt<unsigned> numOperatorTypes("num-operator-types",
+                                          cl::desc("Number of operator types"),
+                                          cl::init(16),
+                                          cl::cat(generatorCategory));
+
+static cl::opt<unsigned> numLimitedOperatorTypes(
+    "num-limited-operator-types",
+    cl::desc("Number of operator types with a limited number of instances, "
+             "in problems that support limits"),
+    cl::init(4), cl::cat(generatorCategory));
+
+static cl::opt<unsigned> maxLatency("max-latency",
+                                    cl::desc("Maximum operator latency"),
+                                    cl::init(8), cl::cat(generatorCategory));
+
+static cl::opt<unsigned> maxLimit("max-limit",
+                                  cl::desc("Maximum operator type limit"),
+                                  cl::init(4), cl::cat(generatorCategory));
+
+static cl::opt<unsigned>
+    maxFanIn("max-fan-in",
+             cl::desc("Maximum number of predecessors of an operation"),
+             cl::init(3), cl::cat(generatorCategory));
+
+static cl::opt<unsigned>
+    locality("locality",
+             cl::desc("Maximum distance between the positions of dependent "
+                      "operations"),
+             cl::init(64), cl::cat(generatorCategory));
+
+static cl::opt<double>
+    backEdgeRatio("back-edge-ratio",
+                  cl::desc("Inter-iteration dependences per operation, in "
+                           "cyclic problems"),
+                  cl::init(0.05), cl::cat(generatorCategory));
+
+static cl::opt<unsigned>
+    maxDistance("max-distance",
+                cl::desc("Maximum distance of inter-iteration dependences"),
+                cl::init(3), cl::cat(generatorCategory));
+
+static cl::opt<unsigned> seed("seed", cl::desc("Random seed"), cl::init(1),
+                              cl::cat(generatorCategory));
+
+/// Print error and return failure.
+static LogicalResult emitError(const Twine &err) {
+  WithColor::error(errs(), toolName) << err << "\n";
+  return failure();
+}
+
+//===----------------------------------------------------------------------===//
+// Instance generator
+//===----------------------------------------------------------------------===//
+
+static bool isKnownProblem(StringRef name) {
+  return name == "Problem" || name == "CyclicProblem" ||
+         name == "SharedOperatorsProblem" || name == "ModuloProblem";
+}
+
+/// Print a random SSP instance of the `problemName` problem with \p n
+/// operations. The operations form a layered DAG in which each operation
+/// depends on up to `maxFanIn` of its `locality` predecessors in program order.
+/// Cyclic problems additionally get inter-iteration dependences from later to
+/// earlier operations. A final operation `@last` depends on all operations
+/// without successors, such that it is the unique sink of the graph.
+static void generateInstance(raw_ostream &os, unsigned n, unsigned index) {
+  std::mt19937_64 rng(seed + index);
+  auto uniform = [&](unsigned lo, unsigned hi) {
+    return std::uniform_int_distribution<unsigned>(lo, hi)(rng);
+  };
+
+  bool isCyclic =
+      problemName == "CyclicProblem" || problemName == "ModuloProblem";
+  bool hasLimits =
+      problemName == "SharedOperatorsProblem" || problemName == "ModuloProblem";
+  unsigned nTypes = std::max(1u, numOperatorTypes.getValue());
+  // Keep the first operator type unlimited, as it is used by the sink.
+  unsigned nLimited =
+      hasLimits ? std::min(numLimitedOperatorTypes.getValue(), nTypes - 1) : 0;
+  n = std::max(1u, n);
+
+  os << "ssp.instance @" << problemName << "_" << n << "_" << index << " of \""
+     << problemName << "\" {\n";
+  os << "  library {\n";
+  for (unsigned k = 0; k < nTypes; ++k) {
+    bool isLimited = k >= nTypes - nLimited;
+    // Limited operator types must have a non-zero latency.
+    unsigned latency = uniform(isLimited ? 1 : 0, std::max(1u, maxLatency));
+    os << "    operator_type @t" << k << " [latency<" << latency << ">";
+    if (isLimited)
+      os << ", limit<" << uniform(1, std::max(1u, maxLimit)) << ">";
+    os << "]\n";
+  }
+  os << "  }\n";
+
+  // Draw the dependences first, as the inter-iteration dependences are printed
+  // at their destination, but refer to the source by name.
+  SmallVector<SmallVector<unsigned, 4>> preds(n);
+  SmallVector<SmallVector<std::pair<unsigned, unsigned>, 1>> backEdges(n);
+  BitVector hasSuccessor(n), isNamed(n);
+  unsigned window = std::max(1u, locality.getValue());
+  for (unsigned i = 1; i < n; ++i) {
+    unsigned numPreds = uniform(0, std::min(maxFanIn.getValue(), i));
+    for (unsigned p = 0; p < numPreds; ++p) {
+      unsigned pred = i - uniform(1, std::min(window, i));
+      if (llvm::is_contained(preds[i], pred))
+        continue;
+      preds[i].push_back(pred);
+      hasSuccessor.set(pred);
+    }
+  }
+  if (isCyclic && n > 1) {
+    auto numBackEdges = static_cast<unsigned>(backEdgeRatio * n);
+    for (unsigned e = 0; e < numBackEdges; ++e) {
+      unsigned dst = uniform(0, n - 2);
+      unsigned src = std::min(n - 1, dst + uniform(1, window));
+      backEdges[dst].emplace_back(src, uniform(1, std::max(1u, maxDistance)));
+      isNamed.set(src);
+    }
+  }
+
+  os << "  graph {\n";
+  for (unsigned i = 0; i < n; ++i) {
+    os << "    %" << i << " = operation<@t" << uniform(0, nTypes - 1) << ">";
+    if (isNamed[i])
+      os << " @op" << i;
+    os << "(";
+    llvm::interleaveComma(preds[i], os, [&](unsigned p) { os << "%" << p; });
+    if (!preds[i].empty() && !backEdges[i].empty())
+      os << ", ";
+    llvm::interleaveComma(backEdges[i], os, [&](auto edge) {
+      os << "@op" << edge.first << " [dist<" << edge.second << ">]";
+    });
+    os << ")\n";
+  }
+  os << "    operation<@t0> @last(";
+  bool first = true;
+  for (unsigned i = 0; i < n; ++i) {
+    if (hasSuccessor[i])
+      continue;
+    os << (first ? "" : ", ") << "%" << i;
+    first = false;
+  }
+  os << ")\n";
+  os << "  }\n";
+  os << "}\n";
+}
+
+//===----------------------------------------------------------------------===//
+// Measurements
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The outcome of running one scheduler on one problem instance.
+struct Measurement {
+  std::string instance;
+  std::string problem;
+  std::string scheduler;
+  size_t numOps = 0;
+  size_t numDependences = 0;
+  size_t numOperatorTypes = 0;
+  /// One of "ok", "invalid" (input constraints violated), "failed" (no
+  /// solution found), or "wrong" (solution constraints violated).
+  StringRef status = "ok";
+  double loadSeconds = 0.0;
+  double scheduleSeconds = 0.0;
+  /// Change of the heap usage across the scheduler call, and peak RSS after it.
+  int64_t mallocDelta = 0;
+  size_t peakRSS = 0;
+  /// Solution quality: the start time of the last operation, the time step at
+  /// which all operations have finished, and the II for cyclic problems.
+  std::optional<unsigned> lastOpStartTime;
+  std::optional<unsigned> makespan;
+  std::optional<unsigned> initiationInterval;
+};
+} // namespace
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static bool isSelected(StringRef scheduler) {
+  return schedulerNames.empty() || llvm::is_contained(schedulerNames, scheduler);
+}
+
+template <typename ProblemT>
+static void recordSolution(ProblemT &prob, Operation *lastOp,
+                           Measurement &result) {
+  unsigned makespan = 0;
+  for (auto *op : prob.getOperations())
+    makespan = std::max(makespan,
+                        *prob.getStartTime(op) +
+                            *prob.getLatency(*prob.getLinkedOperatorType(op)));
+  result.makespan = makespan;
+  result.lastOpStartTime = prob.getStartTime(lastOp);
+  if constexpr (std::is_base_of_v<CyclicProblem, ProblemT>)
+    result.initiationInterval = prob.getInitiationInterval();
+}
+
+/// Run a scheduler `repetitions` times on fresh copies of the problem loaded
+/// from \p instOp, and record the fastest run.
+template <typename ProblemT, typename SchedulerFn>
+static void measure(InstanceOp instOp, Operation *lastOp, StringRef scheduler,
+                    SchedulerFn runScheduler,
+                    SmallVectorImpl<Measurement> &results) {
+  if (!isSelected(scheduler))
+    return;
+
+  auto &result = results.emplace_back();
+  result.instance = instOp.getSymName().value_or("unnamed").str();
+  result.problem = instOp.getProblemName().str();
+  result.scheduler = scheduler.str();
+
+  for (unsigned rep = 0; rep < std::max(1u, repetitions.getValue()); ++rep) {
+    auto loadStart = Clock::now();
+    auto prob = loadProblem<ProblemT>(instOp);
+    auto loadSeconds = secondsSince(loadStart);
+
+    if (rep == 0) {
+      result.loadSeconds = loadSeconds;
+      result.numOps = prob.getOperations().size();
+      result.numOperatorTypes = prob.getOperatorTypes().size();
+      for (auto *op : prob.getOperations()) {
+        auto deps = prob.getDependences(op);
+        result.numDependences += std::distance(deps.begin(), deps.end());
+      }
+    }
+    result.loadSeconds = std::min(result.loadSeconds, loadSeconds);
+
+    if (failed(prob.check())) {
+      result.status = "invalid";
+      return;
+    }
+
+    auto mallocBefore = sys::Process::GetMallocUsage();
+    auto scheduleStart = Clock::now();
+    auto scheduled = runScheduler(prob, lastOp);
+    auto scheduleSeconds = secondsSince(scheduleStart);
+    auto mallocDelta =
+        int64_t(sys::Process::GetMallocUsage()) - int64_t(mallocBefore);
+
+    if (rep == 0 || scheduleSeconds < result.scheduleSeconds) {
+      result.scheduleSeconds = scheduleSeconds;
+      result.mallocDelta = mallocDelta;
+    }
+    result.peakRSS = getPeakRSS();
+
+    if (failed(scheduled)) {
+      result.status = "failed";
+      return;
+    }
+    if (failed(prob.verify())) {
+      result.status = "wrong";
+      return;
+    }
+    recordSolution(prob, lastOp, result);
+  }
+}
+
+/// Run all applicable and selected schedulers on \p instOp.
+static void benchmarkInstance(InstanceOp instOp,
+                              SmallVectorImpl<Measurement> &results) {
+  auto *graph = instOp.getDependenceGraph().getBodyBlock();
+  if (graph->empty())
+    return;
+  // Like `ssp-schedule`, minimize the start time of the last operation.
+  Operation *lastOp = &graph->back();
+
+  auto simplex = [](auto &prob, Operation *lastOp) {
+    return scheduleSimplex(prob, lastOp);
+  };
+  auto chainingSimplex = [](auto &prob, Operation *lastOp) {
+    return scheduleSimplex(prob, lastOp, cycleTime.getValue());
+  };
+  [[maybe_unused]] auto lp = [](auto &prob, Operation *lastOp) {
+    return scheduleLP(prob, lastOp);
+  };
+
+  StringRef problem = instOp.getProblemName();
+  if (problem == "Problem") {
+    measure<Problem>(
+        instOp, lastOp, "asap",
+        [](Problem &prob, Operation *) { return scheduleASAP(prob); }, results);
+    measure<Problem>(instOp, lastOp, "simplex", simplex, results);
+#ifdef SCHEDULING_OR_TOOLS
+    measure<Problem>(instOp, lastOp, "lp", lp, results);
+#endif
+  } else if (problem == "CyclicProblem") {
+    measure<CyclicProblem>(instOp, lastOp, "simplex", simplex, results);
+#ifdef SCHEDULING_OR_TOOLS
+    measure<CyclicProblem>(instOp, lastOp, "lp", lp, results);
+#endif
+  } else if (problem == "SharedOperatorsProblem") {
+    measure<SharedOperatorsProblem>(instOp, lastOp, "simplex", simplex,
+                                    results);
+#ifdef SCHEDULING_OR_TOOLS
+    measure<SharedOperatorsProblem>(
+        instOp, lastOp, "cpsat",
+        [](SharedOperatorsProblem &prob, Operation *lastOp) {
+          return scheduleCPSAT(prob, lastOp);
+        },
+        results);
+#endif
+  } else if (problem == "ModuloProblem") {
+    measure<ModuloProblem>(instOp, lastOp, "simplex", simplex, results);
+  } else if (problem == "ChainingProblem" && cycleTime > 0) {
+    measure<ChainingProblem>(instOp, lastOp, "simplex", chainingSimplex,
+                             results);
+  } else if (problem == "ChainingCyclicProblem" && cycleTime > 0) {
+    measure<ChainingCyclicProblem>(instOp, lastOp, "simplex", chainingSimplex,
+                                   results);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Reporting
+//===----------------------------------------------------------------------===//
+
+static void printTable(ArrayRef<Measurement> results, raw_ostream &os) {
+  auto printOptional = [&](std::optional<unsigned> value) {
+    if (value)
+      os << format(" %8u", *value);
+    else
+      os << format(" %8s", "-");
+  };
+
+  os << format("%-32s %-22s %9s %9s %-8s %-7s %10s %10s %12s %10s %8s %8s "
+               "%8s\n",
+               "instance", "problem", "ops", "deps", "sched", "status",
+               "load[ms]", "time[ms]", "malloc[KiB]", "RSS[MiB]", "II",
+               "last", "span");
+  for (auto &result : results) {
+    os << format("%-32s %-22s %9zu %9zu %-8s %-7s %10.2f %10.2f %12lld "
+                 "%10.1f",
+                 result.instance.c_str(), result.problem.c_str(),
+                 result.numOps, result.numDependences,
+                 result.scheduler.c_str(), result.status.str().c_str(),
+                 result.loadSeconds * 1e3, result.scheduleSeconds * 1e3,
+                 (long long)(result.mallocDelta / 1024),
+                 result.peakRSS / (1024.0 * 1024.0));
+    printOptional(result.initiationInterval);
+    printOptional(result.lastOpStartTime);
+    printOptional(result.makespan);
+    os << "\n";
+  }
+}
+
+static void printJSON(ArrayRef<Measurement> results, raw_ostream &os) {
+  json::OStream json(os, 2);
+  json.array([&] {
+    for (auto &result : results) {
+      json.object([&] {
+        json.attribute("instance", result.instance);
+        json.attribute("problem", result.problem);
+        json.attribute("scheduler", result.scheduler);
+        json.attribute("status", result.status);
+        json.attribute("operations", int64_t(result.numOps));
+        json.attribute("dependences", int64_t(result.numDependences));
+        json.attribute("operatorTypes", int64_t(result.numOperatorTypes));
+        json.attribute("loadSeconds", result.loadSeconds);
+        json.attribute("scheduleSeconds", result.scheduleSeconds);
+        json.attribute("mallocDelta", result.mallocDelta);
+        json.attribute("peakRSS", int64_t(result.peakRSS));
+        if (result.initiationInterval)
+          json.attribute("initiationInterval", *result.initiationInterval);
+        if (result.lastOpStartTime)
+          json.attribute("lastOpStartTime", *result.lastOpStartTime);
+        if (result.makespan)
+          json.attribute("makespan", *result.makespan);
+      });
+    }
+  });
+  os << "\n";
+}
+
+//===----------------------------------------------------------------------===//
+// Driver
+//===----------------------------------------------------------------------===//
+
+static LogicalResult execute(MLIRContext &context) {
+  SourceMgr srcMgr;
+  SourceMgrDiagnosticHandler handler(srcMgr, &context);
+
+  OwningOpRef<ModuleOp> module;
+  if (generate) {
+    if (!isKnownProblem(problemName))
+      return emitError("cannot generate instances of unknown problem '" +
+                       problemName + "'");
+    if (numOps.empty())
+      numOps.push_back(1000);
+
+    std::string text;
+    raw_string_ostream os(text);
+    for (auto [index, n] : llvm::enumerate(numOps))
+      generateInstance(os, n, index);
+    srcMgr.AddNewSourceBuffer(
+        MemoryBuffer::getMemBufferCopy(text, "<generated>"), SMLoc());
+    module = parseSourceFile<ModuleOp>(srcMgr, &context);
+  } else {
+    module = parseSourceFile<ModuleOp>(inputFilename, srcMgr, &context);
+  }
+  if (!module)
+    return failure();
+
+  std::string err;
+  auto output = openOutputFile(outputFilename, &err);
+  if (!output)
+    return emitError(err);
+
+  if (emitInstances) {
+    module->print(output->os());
+    output->keep();
+    return success();
+  }
+
+  SmallVector<Measurement> results;
+  module->walk([&](InstanceOp instOp) { benchmarkInstance(instOp, results); });
+
+  if (outputFormat == OutputJSON)
+    printJSON(results, output->os());
+  else
+    printTable(results, output->os());
+  output->keep();
+  return success();
+}
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+
+  // Set the bug report message to indicate users should file issues on
+  // llvm/circt and not llvm/llvm-project.
+  setBugReportMsg(circtBugReportMsg);
+
+  // Hide default LLVM options, other than for this tool.
+  cl::HideUnrelatedOptions({&mainCategory, &generatorCategory});
+
+  cl::ParseCommandLineOptions(argc, argv,
+                              "CIRCT scheduling algorithm benchmark\n");
+
+  MLIRContext context;
+  context.loadDialect<SSPDialect>();
+  exit(failed(execute(context)));
+}
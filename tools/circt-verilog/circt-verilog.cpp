@@ -84,6 +84,16 @@ struct CLOptions {
   cl::opt<bool> debugInfo{"g", cl::desc("Generate debug information"),
                           cl::cat(cat)};
 
+  cl::opt<bool> printMemoryUsage{
+      "print-memory-usage",
+      cl::desc("Print the memory used by the frontend after each phase"),
+      cl::init(false), cl::cat(cat)};
+
+  cl::opt<bool> parallelModuleBodies{
+      "parallel-module-bodies",
+      cl::desc("Convert module bodies concurrently (experimental)"),
+      cl::init(false), cl::cat(cat)};
+
   //===--------------------------------------------------------------------===//
   // Include paths
   //===--------------------------------------------------------------------===//
@@ -297,6 +307,8 @@ static LogicalResult executeWithSources(MLIRContext *context,
   else if (opts.loweringMode == LoweringMode::OnlyParse)
     options.mode = ImportVerilogOptions::Mode::OnlyParse;
   options.debugInfo = opts.debugInfo;
+  options.printMemoryUsage = opts.printMemoryUsage;
+  options.parallelModuleBodies = opts.parallelModuleBodies;
 
   options.includeDirs = opts.includeDirs;
   options.includeSystemDirs = opts.includeSystemDirs;
@@ -37,6 +37,7 @@
 #include "circt/Dialect/Verif/VerifPasses.h"
 #include "circt/Support/LoweringOptions.h"
 #include "circt/Support/LoweringOptionsParser.h"
+#include "circt/Support/PassTelemetry.h"
 #include "circt/Support/Passes.h"
 #include "circt/Support/Version.h"
 #include "circt/Target/DebugInfo.h"
@@ -217,6 +218,18 @@ static cl::opt<std::string>
                 cl::init(""), cl::value_desc("filename"),
                 cl::cat(mainCategory));
 
+static cl::opt<std::string> hwCheckpointFile(
+    "output-hw-checkpoint",
+    cl::desc("Optional file name to save the IR into as bytecode once FIRRTL "
+             "has been lowered to HW, to resume from with --resume-from-hw"),
+    cl::init(""), cl::value_desc("filename"), cl::cat(mainCategory));
+
+static cl::opt<bool>
+    resumeFromHW("resume-from-hw",
+                 cl::desc("Resume from IR saved with --output-hw-checkpoint, "
+                          "skipping the FIRRTL pipeline"),
+                 cl::init(false), cl::cat(mainCategory));
+
 static cl::opt<bool> emitHGLDD("emit-hgldd", cl::desc("Emit HGLDD debug info"),
                                cl::init(false), cl::cat(mainCategory));
 
@@ -254,6 +267,12 @@ static cl::opt<bool>
                           cl::desc("Log executions of toplevel module passes"),
                           cl::init(false), cl::cat(mainCategory));
 
+static cl::opt<std::string> passTelemetryFile(
+    "pass-telemetry",
+    cl::desc("Write per-pass time, memory, and op count telemetry as a Chrome "
+             "trace-event JSON file"),
+    cl::init(""), cl::value_desc("filename"), cl::cat(mainCategory));
+
 static LoweringOptionsOption loweringOptions(mainCategory);
 
 static cl::list<std::string>
@@ -333,18 +352,40 @@ struct EmitSplitHGLDDPass
   }
 };
 
+/// Wrapper pass to save the IR as a bytecode checkpoint, which later runs can
+/// resume from.
+struct SaveCheckpointPass
+    : public PassWrapper<SaveCheckpointPass, OperationPass<mlir::ModuleOp>> {
+  StringRef fileName;
+  SaveCheckpointPass(StringRef fileName) : fileName(fileName) {}
+  void runOnOperation() override {
+    markAllAnalysesPreserved();
+    std::string errorMessage;
+    auto file = openOutputFile(fileName, &errorMessage);
+    if (!file) {
+      getOperation().emitError(errorMessage);
+      return signalPassFailure();
+    }
+    if (failed(writeBytecodeToFile(
+            getOperation(), file->os(),
+            mlir::BytecodeWriterConfig(getCirctVersion()))))
+      return signalPassFailure();
+    file->keep();
+  }
+};
+
 /// Process a single buffer of the input.
 static LogicalResult processBuffer(
     MLIRContext &context, firtool::FirtoolOptions &firtoolOptions,
-    TimingScope &ts, llvm::SourceMgr &sourceMgr,
+    TimingScope &ts, const std::shared_ptr<llvm::SourceMgr> &sourceMgr,
     std::optional<std::unique_ptr<llvm::ToolOutputFile>> &outputFile) {
 
   // Add the annotation file if one was explicitly specified.
   unsigned numAnnotationFiles = 0;
   for (const auto &inputAnnotationFilename : inputAnnotationFilenames) {
     std::string annotationFilenameDetermined;
-    if (!sourceMgr.AddIncludeFile(inputAnnotationFilename, llvm::SMLoc(),
-                                  annotationFilenameDetermined)) {
+    if (!sourceMgr->AddIncludeFile(inputAnnotationFilename, llvm::SMLoc(),
+                                   annotationFilenameDetermined)) {
       llvm::errs() << "cannot open input annotation file '"
                    << inputAnnotationFilename
                    << "': No such file or directory\n";
@@ -355,7 +396,7 @@ static LogicalResult processBuffer(
 
   for (const auto &file : inputOMIRFilenames) {
     std::string filename;
-    if (!sourceMgr.AddIncludeFile(file, llvm::SMLoc(), filename)) {
+    if (!sourceMgr->AddIncludeFile(file, llvm::SMLoc(), filename)) {
       llvm::errs() << "cannot open input annotation file '" << file
                    << "': No such file or directory\n";
       return failure();
@@ -396,15 +437,26 @@ static LogicalResult processBuffer(
       break;
     }
 
-    module = importFIRFile(sourceMgr, &context, parserTimer, options);
+    module = importFIRFile(*sourceMgr, &context, parserTimer, options);
   } else {
     auto parserTimer = ts.nest("MLIR Parser");
     assert(inputFormat == InputMLIRFile);
+    // Parse through the shared source manager. This allows the bytecode reader
+    // to keep referencing resources in the memory-mapped input file, instead
+    // of copying them.
     module = parseSourceFile<ModuleOp>(sourceMgr, &context);
   }
   if (!module)
     return failure();
 
+  // Resuming from a checkpoint skips the FIRRTL pipeline, which would leave
+  // any FIRRTL in the input unlowered.
+  if (resumeFromHW && !module->getOps<firrtl::CircuitOp>().empty()) {
+    llvm::errs() << "input contains FIRRTL: --resume-from-hw expects IR saved "
+                    "with --output-hw-checkpoint\n";
+    return failure();
+  }
+
   if (verbosePassExecutions) {
     auto elapsed = std::chrono::duration<double>(
                        llvm::sys::TimePoint<>::clock::now() - parseStartTime) /
@@ -414,6 +466,7 @@ static LogicalResult processBuffer(
   }
 
   // Apply any pass manager command line options.
+  std::optional<PassTelemetry> telemetry;
   PassManager pm(&context);
   pm.enableVerifier(verifyPasses);
   pm.enableTiming(ts);
@@ -422,37 +475,54 @@ static LogicalResult processBuffer(
         std::make_unique<
             VerbosePassInstrumentation<firrtl::CircuitOp, mlir::ModuleOp>>(
             "firtool"));
+  if (!passTelemetryFile.empty()) {
+    telemetry.emplace();
+    pm.addInstrumentation(telemetry->createInstrumentation());
+  }
+  auto runPassManager = [&]() -> LogicalResult {
+    auto result = pm.run(module.get());
+    if (telemetry && failed(telemetry->writeToFile(passTelemetryFile)))
+      return failure();
+    return result;
+  };
   if (failed(applyPassManagerCLOptions(pm)))
     return failure();
 
-  if (failed(firtool::populatePreprocessTransforms(pm, firtoolOptions)))
-    return failure();
+  if (!resumeFromHW)
+    if (failed(firtool::populatePreprocessTransforms(pm, firtoolOptions)))
+      return failure();
 
   // If the user asked for --parse-only, stop after running LowerAnnotations.
   if (outputFormat == OutputParseOnly) {
-    if (failed(pm.run(module.get())))
+    if (failed(runPassManager()))
       return failure();
     auto outputTimer = ts.nest("Print .mlir output");
     return printOp(*module, (*outputFile)->os());
   }
 
-  if (!highFIRRTLPassPlugin.empty())
-    if (failed(parsePassPipeline(StringRef(highFIRRTLPassPlugin), pm)))
-      return failure();
-
-  if (failed(firtool::populateCHIRRTLToLowFIRRTL(pm, firtoolOptions,
-                                                 inputFilename)))
-    return failure();
+  if (!resumeFromHW) {
+    if (!highFIRRTLPassPlugin.empty())
+      if (failed(parsePassPipeline(StringRef(highFIRRTLPassPlugin), pm)))
+        return failure();
 
-  if (!lowFIRRTLPassPlugin.empty())
-    if (failed(parsePassPipeline(StringRef(lowFIRRTLPassPlugin), pm)))
+    if (failed(firtool::populateCHIRRTLToLowFIRRTL(pm, firtoolOptions,
+                                                   inputFilename)))
       return failure();
 
+    if (!lowFIRRTLPassPlugin.empty())
+      if (failed(parsePassPipeline(StringRef(lowFIRRTLPassPlugin), pm)))
+        return failure();
+  }
+
   // Lower if we are going to verilog or if lowering was specifically
   // requested.
   if (outputFormat != OutputIRFir) {
-    if (failed(firtool::populateLowFIRRTLToHW(pm, firtoolOptions)))
-      return failure();
+    if (!resumeFromHW)
+      if (failed(firtool::populateLowFIRRTLToHW(pm, firtoolOptions)))
+        return failure();
+    // Save a checkpoint that later runs can resume from with the HW pipeline.
+    if (!hwCheckpointFile.empty())
+      pm.addPass(std::make_unique<SaveCheckpointPass>(hwCheckpointFile));
     if (!hwPassPlugin.empty())
       if (failed(parsePassPipeline(StringRef(hwPassPlugin), pm)))
         return failure();
@@ -516,7 +586,7 @@ static LogicalResult processBuffer(
         return failure();
   }
 
-  if (failed(pm.run(module.get())))
+  if (failed(runPassManager()))
     return failure();
 
   if (outputFormat == OutputIRFir || outputFormat == OutputIRHW ||
@@ -581,17 +651,17 @@ static LogicalResult processInputSplit(
     MLIRContext &context, firtool::FirtoolOptions &firtoolOptions,
     TimingScope &ts, std::unique_ptr<llvm::MemoryBuffer> buffer,
     std::optional<std::unique_ptr<llvm::ToolOutputFile>> &outputFile) {
-  llvm::SourceMgr sourceMgr;
-  sourceMgr.AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
-  sourceMgr.setIncludeDirs(includeDirs);
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  sourceMgr->AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
+  sourceMgr->setIncludeDirs(includeDirs);
   if (!verifyDiagnostics) {
-    SourceMgrDiagnosticHandler sourceMgrHandler(sourceMgr,
+    SourceMgrDiagnosticHandler sourceMgrHandler(*sourceMgr,
                                                 &context /*, shouldShow */);
     FileLineColLocsAsNotesDiagnosticHandler addLocs(&context);
     return processBuffer(context, firtoolOptions, ts, sourceMgr, outputFile);
   }
 
-  SourceMgrDiagnosticVerifierHandler sourceMgrHandler(sourceMgr, &context);
+  SourceMgrDiagnosticVerifierHandler sourceMgrHandler(*sourceMgr, &context);
   context.printOpOnDiagnostic(false);
   (void)processBuffer(context, firtoolOptions, ts, sourceMgr, outputFile);
   return sourceMgrHandler.verify();
@@ -662,6 +732,19 @@ static LogicalResult executeFirtool(MLIRContext &context,
     }
   }
 
+  // Checkpoints are saved after lowering to HW, and resuming from one starts
+  // with the HW pipeline.
+  if (resumeFromHW && inputFormat != InputMLIRFile) {
+    llvm::errs() << "--resume-from-hw requires an .mlir or .mlirbc input\n";
+    return failure();
+  }
+  if ((resumeFromHW || !hwCheckpointFile.empty()) &&
+      (outputFormat == OutputParseOnly || outputFormat == OutputIRFir)) {
+    llvm::errs() << "--resume-from-hw and --output-hw-checkpoint require "
+                    "lowering to HW\n";
+    return failure();
+  }
+
   // Create the output directory or output file depending on our mode.
   std::optional<std::unique_ptr<llvm::ToolOutputFile>> outputFile;
   if (outputFormat != OutputSplitVerilog) {
@@ -0,0 +1,966 @@
+//===- CompiledSimulation.cpp - Compiled Handshake execution --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a compiled execution mode for handshake.func top-level
+// functions. Instead of interpreting the IR with values boxed in `llvm::Any`
+// and looked up by `mlir::Value`, the function is translated once into a flat
+// execution plan: every SSA value becomes an index into typed value slots,
+// every operation becomes a node with precomputed operand, result, and
+// consumer lists, and the ready list becomes a FIFO queue with constant-time
+// membership checks.
+//
+// The firing rules mirror the ExecutableOpInterface implementations used by
+// the interpreter, including the order in which operations are scheduled and
+// rescheduled, such that both modes produce identical results.
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Dialect/Handshake/HandshakeOps.h"
+#include "circt/Dialect/Handshake/Simulation.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <deque>
+#include <sstream>
+
+#define DEBUG_TYPE "runner"
+
+STATISTIC(nodesFired, "Compiled Nodes Fired");
+STATISTIC(compiledSimulatedTime, "Compiled Simulated Time");
+
+using namespace llvm;
+using namespace mlir;
+using namespace circt;
+using namespace circt::handshake;
+
+//===----------------------------------------------------------------------===//
+// Value representation
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// How the raw bits of a value slot are interpreted. Integers are stored
+/// zero-extended, floating-point values as the bit pattern of a double, and
+/// memrefs as the index of their buffer in the store.
+enum class SlotKind : uint8_t { Int, F32, F64, None, MemRef };
+
+struct SlotType {
+  SlotKind kind = SlotKind::None;
+  unsigned width = 0;
+};
+} // namespace
+
+/// Return the slot type used to represent values of `type`, or `std::nullopt`
+/// if the compiled engine does not support the type. Index values are 64 bits
+/// wide.
+static std::optional<SlotType> getSlotType(Type type) {
+  if (type.isIndex())
+    return SlotType{SlotKind::Int, 64};
+  if (auto intType = dyn_cast<IntegerType>(type)) {
+    unsigned width = intType.getWidth();
+    if (width == 0 || width > 64)
+      return std::nullopt;
+    return SlotType{SlotKind::Int, width};
+  }
+  if (type.isF32())
+    return SlotType{SlotKind::F32, 32};
+  if (type.isF64())
+    return SlotType{SlotKind::F64, 64};
+  if (isa<NoneType>(type))
+    return SlotType{SlotKind::None, 0};
+  if (auto memrefType = dyn_cast<MemRefType>(type)) {
+    auto elementType = getSlotType(memrefType.getElementType());
+    if (!memrefType.hasStaticShape() || !elementType ||
+        elementType->kind == SlotKind::None ||
+        elementType->kind == SlotKind::MemRef)
+      return std::nullopt;
+    return SlotType{SlotKind::MemRef, 0};
+  }
+  return std::nullopt;
+}
+
+static uint64_t truncate(uint64_t value, unsigned width) {
+  return width >= 64 ? value : value & maskTrailingOnes<uint64_t>(width);
+}
+
+static int64_t signExtend(uint64_t value, unsigned width) {
+  return SignExtend64(value, width);
+}
+
+static double toDouble(uint64_t bits) { return llvm::bit_cast<double>(bits); }
+
+static uint64_t fromDouble(double value) {
+  return llvm::bit_cast<uint64_t>(value);
+}
+
+static APFloat toAPFloat(uint64_t bits, SlotType type) {
+  if (type.kind == SlotKind::F32)
+    return APFloat(static_cast<float>(toDouble(bits)));
+  return APFloat(toDouble(bits));
+}
+
+/// Parse a scalar command line argument, following `readValueWithType`.
+static uint64_t parseValue(SlotType type, const std::string &text) {
+  std::stringstream stream(text);
+  switch (type.kind) {
+  case SlotKind::Int: {
+    int64_t x = 0;
+    stream >> x;
+    return truncate(x, type.width);
+  }
+  case SlotKind::F32: {
+    float x = 0;
+    stream >> x;
+    return fromDouble(x);
+  }
+  case SlotKind::F64: {
+    double x = 0;
+    stream >> x;
+    return fromDouble(x);
+  }
+  case SlotKind::None:
+  case SlotKind::MemRef:
+    return 0;
+  }
+  llvm_unreachable("unknown slot kind");
+}
+
+/// Print a value, following `printAnyValueWithType`.
+static void printValue(raw_ostream &os, SlotType type, uint64_t value) {
+  switch (type.kind) {
+  case SlotKind::Int:
+    os << signExtend(value, type.width);
+    return;
+  case SlotKind::F32:
+  case SlotKind::F64:
+    os << toDouble(value);
+    return;
+  case SlotKind::None:
+    os << "none";
+    return;
+  case SlotKind::MemRef:
+    llvm_unreachable("memrefs are printed element by element");
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Execution plan
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The firing rule of a node.
+enum class NodeKind : uint8_t {
+  // Handshake operations which fire once all operands are available and all
+  // results have been consumed.
+  Fork,
+  Join,
+  Forward, // sync, buffer, br
+  Constant,
+  Store,
+  // Handshake operations with custom firing rules.
+  Merge,
+  Mux,
+  ControlMerge,
+  ConditionalBranch,
+  Sink,
+  Memory,
+  ExternalMemory,
+  Load,
+  // Operations which fire once all operands are available.
+  Return,
+  ArithConstant,
+  AddI,
+  SubI,
+  MulI,
+  DivSI,
+  DivUI,
+  XOrI,
+  AddF,
+  SubF,
+  MulF,
+  DivF,
+  CmpI,
+  CmpF,
+  IndexCast,
+  ExtSI,
+  ExtUI,
+};
+
+struct Node {
+  Operation *op;
+  NodeKind kind;
+  /// Ranges into the flat operand and result slot arrays.
+  unsigned operandBegin = 0, numOperands = 0;
+  unsigned resultBegin = 0, numResults = 0;
+  /// The latency added by nodes with a uniform firing rule.
+  double latency = 0.0;
+  /// Kind-specific payload: the constant value, the comparison predicate, or
+  /// the buffer of a memory.
+  uint64_t payload = 0;
+  unsigned numLoads = 0, numStores = 0;
+};
+
+/// A handshake.func translated into an execution plan.
+class CompiledExecuter {
+public:
+  /// Translate `func`. Returns failure if the function uses constructs the
+  /// compiled engine does not support, in which case nothing has been run.
+  LogicalResult compile(handshake::FuncOp func);
+
+  /// Run the plan on the given command line arguments and print the results.
+  /// Returns true on failure, like `simulate`.
+  bool run(StringRef toplevelFunction, ArrayRef<std::string> inputArgs);
+
+private:
+  LogicalResult addNode(Operation *op);
+  LogicalResult addNode(Operation *op, NodeKind kind, double latency = 0.0,
+                        uint64_t payload = 0);
+
+  ArrayRef<unsigned> getOperands(const Node &node) const {
+    return ArrayRef<unsigned>(operandSlots)
+        .slice(node.operandBegin, node.numOperands);
+  }
+  ArrayRef<unsigned> getResults(const Node &node) const {
+    return ArrayRef<unsigned>(resultSlots)
+        .slice(node.resultBegin, node.numResults);
+  }
+  ArrayRef<unsigned> getUsers(unsigned slot) const {
+    return ArrayRef<unsigned>(users).slice(
+        userBegin[slot], userBegin[slot + 1] - userBegin[slot]);
+  }
+
+  void schedule(unsigned node) {
+    if (queued[node])
+      return;
+    queued[node] = true;
+    readyQueue.push_back(node);
+  }
+  void scheduleUses(unsigned slot) {
+    for (unsigned node : getUsers(slot))
+      schedule(node);
+  }
+  void produce(unsigned slot, uint64_t value, double time) {
+    values[slot] = value;
+    times[slot] = time;
+    valid[slot] = true;
+  }
+
+  bool fireHandshake(const Node &node);
+  bool fireMemory(const Node &node, unsigned buffer, unsigned operandIndex);
+  LogicalResult fireArith(const Node &node);
+
+  //===--------------------------------------------------------------------===//
+  // Plan
+  //===--------------------------------------------------------------------===//
+
+  handshake::FuncOp func;
+  DenseMap<Value, unsigned> slotIndices;
+  SmallVector<SlotType> slotTypes;
+  std::vector<Node> nodes;
+  std::vector<unsigned> operandSlots;
+  std::vector<unsigned> resultSlots;
+  /// The nodes consuming each slot, in use-list order, in CSR form.
+  std::vector<unsigned> userBegin;
+  std::vector<unsigned> users;
+  /// Element types of the store's buffers; memref arguments come first.
+  SmallVector<SlotType> bufferTypes;
+  SmallVector<int64_t> bufferSizes;
+
+  //===--------------------------------------------------------------------===//
+  // Execution state
+  //===--------------------------------------------------------------------===//
+
+  std::vector<uint64_t> values;
+  std::vector<double> times;
+  std::vector<char> valid;
+  std::vector<char> queued;
+  std::deque<unsigned> readyQueue;
+  std::vector<std::vector<uint64_t>> store;
+  bool failedFlag = false;
+};
+} // namespace
+
+LogicalResult CompiledExecuter::addNode(Operation *op, NodeKind kind,
+                                        double latency, uint64_t payload) {
+  Node node;
+  node.op = op;
+  node.kind = kind;
+  node.latency = latency;
+  node.payload = payload;
+  node.operandBegin = operandSlots.size();
+  node.numOperands = op->getNumOperands();
+  for (Value operand : op->getOperands()) {
+    auto it = slotIndices.find(operand);
+    if (it == slotIndices.end())
+      return failure();
+    operandSlots.push_back(it->second);
+  }
+  node.resultBegin = resultSlots.size();
+  node.numResults = op->getNumResults();
+  for (Value result : op->getResults()) {
+    auto type = getSlotType(result.getType());
+    if (!type || type->kind == SlotKind::MemRef)
+      return failure();
+    resultSlots.push_back(slotTypes.size());
+    slotIndices.insert({result, slotTypes.size()});
+    slotTypes.push_back(*type);
+  }
+  nodes.push_back(node);
+  return success();
+}
+
+LogicalResult CompiledExecuter::addNode(Operation *op) {
+  auto getConstant = [](Attribute attr) -> std::optional<uint64_t> {
+    auto intAttr = dyn_cast_or_null<IntegerAttr>(attr);
+    if (!intAttr || intAttr.getValue().getBitWidth() > 64)
+      return std::nullopt;
+    return intAttr.getValue().getZExtValue();
+  };
+
+  return TypeSwitch<Operation *, LogicalResult>(op)
+      .Case<ForkOp>([&](auto) { return addNode(op, NodeKind::Fork, 1); })
+      .Case<JoinOp>([&](auto) { return addNode(op, NodeKind::Join, 1); })
+      .Case<SyncOp>([&](auto) { return addNode(op, NodeKind::Forward, 1); })
+      .Case<BranchOp>([&](auto) { return addNode(op, NodeKind::Forward, 0); })
+      .Case<BufferOp>([&](auto bufferOp) {
+        if (bufferOp.getInitValues()) {
+          auto type = getSlotType(bufferOp.getResult().getType());
+          if (!type || type->kind != SlotKind::Int ||
+              bufferOp.getInitValueArray().size() != 1)
+            return failure();
+        }
+        return addNode(op, NodeKind::Forward, bufferOp.getNumSlots());
+      })
+      .Case<handshake::ConstantOp>([&](auto constOp) {
+        auto value = getConstant(constOp.getValueAttr());
+        if (!value)
+          return failure();
+        return addNode(op, NodeKind::Constant, 0, *value);
+      })
+      .Case<handshake::StoreOp>(
+          [&](auto) { return addNode(op, NodeKind::Store, 1); })
+      .Case<MergeOp>([&](auto) { return addNode(op, NodeKind::Merge); })
+      .Case<MuxOp>([&](auto) { return addNode(op, NodeKind::Mux); })
+      .Case<ControlMergeOp>(
+          [&](auto) { return addNode(op, NodeKind::ControlMerge); })
+      .Case<ConditionalBranchOp>(
+          [&](auto) { return addNode(op, NodeKind::ConditionalBranch); })
+      .Case<SinkOp>([&](auto) { return addNode(op, NodeKind::Sink); })
+      .Case<handshake::LoadOp>([&](auto loadOp) {
+        if (loadOp.getAddresses().size() != 1)
+          return failure();
+        return addNode(op, NodeKind::Load);
+      })
+      .Case<MemoryOp>([&](auto memOp) {
+        auto elementType = getSlotType(memOp.getMemRefType().getElementType());
+        if (!memOp.getMemRefType().hasStaticShape() || !elementType)
+          return failure();
+        uint64_t buffer = bufferTypes.size();
+        bufferTypes.push_back(*elementType);
+        bufferSizes.push_back(memOp.getMemRefType().getNumElements());
+        if (failed(addNode(op, NodeKind::Memory, 0, buffer)))
+          return failure();
+        nodes.back().numLoads = memOp.getLdCount();
+        nodes.back().numStores = memOp.getStCount();
+        return success();
+      })
+      .Case<ExternalMemoryOp>([&](auto memOp) {
+        if (failed(addNode(op, NodeKind::ExternalMemory)))
+          return failure();
+        nodes.back().numLoads = memOp.getLdCount();
+        nodes.back().numStores = memOp.getStCount();
+        return success();
+      })
+      .Case<handshake::ReturnOp>(
+          [&](auto) { return addNode(op, NodeKind::Return); })
+      .Case<arith::ConstantOp>([&](auto constOp) {
+        auto value = getConstant(constOp.getValue());
+        if (!value)
+          return failure();
+        return addNode(op, NodeKind::ArithConstant, 0, *value);
+      })
+      .Case<arith::AddIOp>([&](auto) { return addNode(op, NodeKind::AddI); })
+      .Case<arith::SubIOp>([&](auto) { return addNode(op, NodeKind::SubI); })
+      .Case<arith::MulIOp>([&](auto) { return addNode(op, NodeKind::MulI); })
+      .Case<arith::DivSIOp>([&](auto) { return addNode(op, NodeKind::DivSI); })
+      .Case<arith::DivUIOp>([&](auto) { return addNode(op, NodeKind::DivUI); })
+      .Case<arith::XOrIOp>([&](auto) { return addNode(op, NodeKind::XOrI); })
+      .Case<arith::AddFOp>([&](auto) { return addNode(op, NodeKind::AddF); })
+      .Case<arith::SubFOp>([&](auto) { return addNode(op, NodeKind::SubF); })
+      .Case<arith::MulFOp>([&](auto) { return addNode(op, NodeKind::MulF); })
+      .Case<arith::DivFOp>([&](auto) { return addNode(op, NodeKind::DivF); })
+      .Case<arith::CmpIOp>([&](auto cmpOp) {
+        return addNode(op, NodeKind::CmpI, 0,
+                       static_cast<uint64_t>(cmpOp.getPredicate()));
+      })
+      .Case<arith::CmpFOp>([&](auto cmpOp) {
+        return addNode(op, NodeKind::CmpF, 0,
+                       static_cast<uint64_t>(cmpOp.getPredicate()));
+      })
+      .Case<arith::IndexCastOp>(
+          [&](auto) { return addNode(op, NodeKind::IndexCast); })
+      .Case<arith::ExtSIOp>([&](auto) { return addNode(op, NodeKind::ExtSI); })
+      .Case<arith::ExtUIOp>([&](auto) { return addNode(op, NodeKind::ExtUI); })
+      .Default([](auto) { return failure(); });
+}
+
+LogicalResult CompiledExecuter::compile(handshake::FuncOp funcOp) {
+  func = funcOp;
+  Block &entryBlock = func.getBody().front();
+
+  // Block arguments occupy the first slots. Memref arguments are allocated in
+  // the store ahead of any handshake.memory, just like in the interpreter.
+  for (BlockArgument arg : entryBlock.getArguments()) {
+    auto type = getSlotType(arg.getType());
+    if (!type)
+      return failure();
+    if (type->kind == SlotKind::MemRef) {
+      auto memrefType = cast<MemRefType>(arg.getType());
+      bufferTypes.push_back(*getSlotType(memrefType.getElementType()));
+      bufferSizes.push_back(memrefType.getNumElements());
+    }
+    slotIndices.insert({arg, slotTypes.size()});
+    slotTypes.push_back(*type);
+  }
+
+  // Memories must have unique IDs; the interpreter aborts otherwise.
+  DenseSet<unsigned> memoryIds;
+  for (auto memOp : func.getOps<MemoryOp>())
+    if (!memoryIds.insert(memOp.getId()).second)
+      return failure();
+
+  DenseMap<Operation *, unsigned> nodeIndices;
+  for (Operation &op : entryBlock) {
+    if (op.getNumRegions() != 0) {
+      LLVM_DEBUG(dbgs() << "Not compiled: " << op << "\n");
+      return failure();
+    }
+    nodeIndices.insert({&op, nodes.size()});
+    if (failed(addNode(&op))) {
+      LLVM_DEBUG(dbgs() << "Not compiled: " << op << "\n");
+      return failure();
+    }
+  }
+
+  // Precompute the consumers of every slot in use-list order, which is the
+  // order in which the interpreter schedules them.
+  SmallVector<Value> slotValues(slotTypes.size());
+  for (auto [value, slot] : slotIndices)
+    slotValues[slot] = value;
+  userBegin.reserve(slotValues.size() + 1);
+  for (Value value : slotValues) {
+    userBegin.push_back(users.size());
+    for (OpOperand &use : value.getUses()) {
+      auto it = nodeIndices.find(use.getOwner());
+      if (it == nodeIndices.end())
+        return failure();
+      users.push_back(it->second);
+    }
+  }
+  userBegin.push_back(users.size());
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Firing rules
+//===----------------------------------------------------------------------===//
+
+bool CompiledExecuter::fireMemory(const Node &node, unsigned buffer,
+                                  unsigned operandIndex) {
+  auto operands = getOperands(node);
+  auto results = getResults(node);
+  if (buffer >= store.size()) {
+    node.op->emitOpError() << "Unknown memory identified by pointer '"
+                           << buffer << "'";
+    failedFlag = true;
+    return true;
+  }
+  auto &ref = store[buffer];
+  auto checkOffset = [&](uint64_t offset) {
+    if (offset < ref.size())
+      return true;
+    node.op->emitOpError() << "Out-of-bounds access to memory '" << buffer
+                           << "'. Memory has " << ref.size()
+                           << " elements but requested element " << offset;
+    failedFlag = true;
+    return false;
+  };
+
+  bool notReady = false;
+  for (unsigned i = 0; i < node.numStores; ++i) {
+    unsigned data = operands[operandIndex++];
+    unsigned address = operands[operandIndex++];
+    unsigned nonceOut = results[node.numLoads + i];
+    if (!valid[data] || !valid[address]) {
+      notReady = true;
+      continue;
+    }
+    unsigned offset = values[address];
+    if (!checkOffset(offset))
+      return true;
+    ref[offset] = values[data];
+    produce(nonceOut, 0, std::max(times[address], times[data]));
+    scheduleUses(nonceOut);
+    valid[data] = false;
+    valid[address] = false;
+  }
+
+  for (unsigned i = 0; i < node.numLoads; ++i) {
+    unsigned address = operands[operandIndex++];
+    unsigned dataOut = results[i];
+    unsigned nonceOut = results[node.numLoads + node.numStores + i];
+    if (!valid[address]) {
+      notReady = true;
+      continue;
+    }
+    unsigned offset = values[address];
+    if (!checkOffset(offset))
+      return true;
+    produce(dataOut, ref[offset], times[address]);
+    produce(nonceOut, 0, times[address]);
+    scheduleUses(dataOut);
+    scheduleUses(nonceOut);
+    valid[address] = false;
+  }
+  return !notReady;
+}
+
+bool CompiledExecuter::fireHandshake(const Node &node) {
+  auto operands = getOperands(node);
+  auto results = getResults(node);
+
+  switch (node.kind) {
+  case NodeKind::Fork:
+  case NodeKind::Join:
+  case NodeKind::Forward:
+  case NodeKind::Constant:
+  case NodeKind::Store: {
+    for (unsigned in : operands)
+      if (!valid[in])
+        return false;
+    for (unsigned out : results)
+      if (valid[out])
+        return false;
+    double time = 0.0;
+    for (unsigned in : operands) {
+      time = std::max(time, times[in]);
+      valid[in] = false;
+    }
+    time += node.latency;
+    switch (node.kind) {
+    case NodeKind::Fork:
+      for (unsigned out : results)
+        produce(out, values[operands[0]], time);
+      break;
+    case NodeKind::Join:
+      produce(results[0], values[operands[0]], time);
+      break;
+    case NodeKind::Forward:
+      for (auto [in, out] : llvm::zip(operands, results))
+        produce(out, values[in], time);
+      break;
+    case NodeKind::Constant:
+      produce(results[0], truncate(node.payload, slotTypes[results[0]].width),
+              time);
+      break;
+    case NodeKind::Store:
+      // Forward the address and data to the memory.
+      produce(results[0], values[operands[1]], time);
+      produce(results[1], values[operands[0]], time);
+      break;
+    default:
+      llvm_unreachable("not a uniform node");
+    }
+    for (unsigned out : results)
+      scheduleUses(out);
+    return true;
+  }
+
+  case NodeKind::Merge:
+  case NodeKind::ControlMerge: {
+    bool isMerge = node.kind == NodeKind::Merge;
+    bool found = false;
+    for (auto [index, in] : llvm::enumerate(operands)) {
+      if (!valid[in])
+        continue;
+      if (found)
+        node.op->emitOpError(isMerge ? "More than one valid input to Merge!"
+                                     : "More than one valid input to CMerge!");
+      produce(results[0], values[in], times[in]);
+      if (!isMerge)
+        produce(results[1], truncate(index, slotTypes[results[1]].width),
+                times[in]);
+      valid[in] = false;
+      found = true;
+    }
+    if (!found)
+      node.op->emitOpError(isMerge ? "No valid input to Merge!"
+                                   : "No valid input to CMerge!");
+    for (unsigned out : results)
+      scheduleUses(out);
+    return true;
+  }
+
+  case NodeKind::Mux: {
+    unsigned control = operands[0];
+    if (!valid[control])
+      return false;
+    uint64_t index = values[control];
+    if (index >= operands.size() - 1) {
+      node.op->emitOpError("Trying to select a non-existing mux operand");
+      failedFlag = true;
+      return true;
+    }
+    unsigned in = operands[1 + index];
+    if (!valid[in])
+      return false;
+    produce(results[0], values[in], std::max(times[control], times[in]));
+    valid[control] = false;
+    valid[in] = false;
+    scheduleUses(results[0]);
+    return true;
+  }
+
+  case NodeKind::ConditionalBranch: {
+    unsigned control = operands[0];
+    unsigned in = operands[1];
+    if (!valid[control] || !valid[in])
+      return false;
+    unsigned out = values[control] != 0 ? results[0] : results[1];
+    produce(out, values[in], std::max(times[control], times[in]));
+    scheduleUses(out);
+    valid[control] = false;
+    valid[in] = false;
+    return true;
+  }
+
+  case NodeKind::Sink:
+    valid[operands[0]] = false;
+    return true;
+
+  case NodeKind::Memory:
+    return fireMemory(node, node.payload, 0);
+
+  case NodeKind::ExternalMemory:
+    return fireMemory(node, values[operands[0]], 1);
+
+  case NodeKind::Load: {
+    unsigned address = operands[0];
+    unsigned data = operands[1];
+    unsigned nonce = operands[2];
+    if (valid[address] != valid[nonce] ||
+        (!valid[address] && !valid[nonce] && !valid[data]))
+      return false;
+    if (valid[address] && valid[nonce]) {
+      unsigned addressOut = results[1];
+      produce(addressOut, values[address],
+              std::max(times[address], times[nonce]));
+      scheduleUses(addressOut);
+      valid[address] = false;
+      valid[nonce] = false;
+    } else {
+      unsigned dataOut = results[0];
+      produce(dataOut, values[data], times[data]);
+      scheduleUses(dataOut);
+      valid[data] = false;
+    }
+    return true;
+  }
+
+  default:
+    llvm_unreachable("not a handshake node");
+  }
+}
+
+LogicalResult CompiledExecuter::fireArith(const Node &node) {
+  auto operands = getOperands(node);
+  auto results = getResults(node);
+  SlotType inType = operands.empty() ? SlotType() : slotTypes[operands[0]];
+  SlotType outType = results.empty() ? SlotType() : slotTypes[results[0]];
+  auto in = [&](unsigned i) { return values[operands[i]]; };
+  auto floatOp = [&](auto fn) {
+    double lhs = toDouble(in(0)), rhs = toDouble(in(1));
+    if (inType.kind == SlotKind::F32)
+      return fromDouble(fn(static_cast<float>(lhs), static_cast<float>(rhs)));
+    return fromDouble(fn(lhs, rhs));
+  };
+
+  uint64_t result = 0;
+  switch (node.kind) {
+  case NodeKind::ArithConstant:
+    result = node.payload;
+    break;
+  case NodeKind::AddI:
+    result = in(0) + in(1);
+    break;
+  case NodeKind::SubI:
+    result = in(0) - in(1);
+    break;
+  case NodeKind::MulI:
+    result = in(0) * in(1);
+    break;
+  case NodeKind::XOrI:
+    result = in(0) ^ in(1);
+    break;
+  case NodeKind::DivSI:
+  case NodeKind::DivUI: {
+    if (in(1) == 0)
+      return node.op->emitOpError() << "Division By Zero!";
+    if (node.kind == NodeKind::DivUI) {
+      result = in(0) / in(1);
+      break;
+    }
+    int64_t lhs = signExtend(in(0), inType.width);
+    int64_t rhs = signExtend(in(1), inType.width);
+    // The only overflowing case wraps around, like APInt::sdiv.
+    if (lhs == std::numeric_limits<int64_t>::min() && rhs == -1)
+      result = lhs;
+    else
+      result = lhs / rhs;
+    break;
+  }
+  case NodeKind::AddF:
+    result = floatOp([](auto lhs, auto rhs) { return lhs + rhs; });
+    break;
+  case NodeKind::SubF:
+    result = floatOp([](auto lhs, auto rhs) { return lhs - rhs; });
+    break;
+  case NodeKind::MulF:
+    result = floatOp([](auto lhs, auto rhs) { return lhs * rhs; });
+    break;
+  case NodeKind::DivF:
+    result = floatOp([](auto lhs, auto rhs) { return lhs / rhs; });
+    break;
+  case NodeKind::CmpI: {
+    uint64_t lhs = in(0), rhs = in(1);
+    int64_t slhs = signExtend(lhs, inType.width);
+    int64_t srhs = signExtend(rhs, inType.width);
+    switch (static_cast<arith::CmpIPredicate>(node.payload)) {
+    case arith::CmpIPredicate::eq:
+      result = lhs == rhs;
+      break;
+    case arith::CmpIPredicate::ne:
+      result = lhs != rhs;
+      break;
+    case arith::CmpIPredicate::slt:
+      result = slhs < srhs;
+      break;
+    case arith::CmpIPredicate::sle:
+      result = slhs <= srhs;
+      break;
+    case arith::CmpIPredicate::sgt:
+      result = slhs > srhs;
+      break;
+    case arith::CmpIPredicate::sge:
+      result = slhs >= srhs;
+      break;
+    case arith::CmpIPredicate::ult:
+      result = lhs < rhs;
+      break;
+    case arith::CmpIPredicate::ule:
+      result = lhs <= rhs;
+      break;
+    case arith::CmpIPredicate::ugt:
+      result = lhs > rhs;
+      break;
+    case arith::CmpIPredicate::uge:
+      result = lhs >= rhs;
+      break;
+    }
+    break;
+  }
+  case NodeKind::CmpF:
+    result = arith::applyCmpPredicate(
+        static_cast<arith::CmpFPredicate>(node.payload),
+        toAPFloat(in(0), inType), toAPFloat(in(1), inType));
+    break;
+  case NodeKind::IndexCast:
+  case NodeKind::ExtUI:
+    // Both zero-extend, matching the interpreter.
+    result = in(0);
+    break;
+  case NodeKind::ExtSI:
+    result = signExtend(in(0), inType.width);
+    break;
+  default:
+    llvm_unreachable("not an arithmetic node");
+  }
+
+  double time = 0.0;
+  for (unsigned operand : operands) {
+    time = std::max(time, times[operand]);
+    valid[operand] = false;
+  }
+  if (!results.empty()) {
+    produce(results[0], truncate(result, outType.width), time + 1);
+    scheduleUses(results[0]);
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Execution
+//===----------------------------------------------------------------------===//
+
+bool CompiledExecuter::run(StringRef toplevelFunction,
+                           ArrayRef<std::string> inputArgs) {
+  Block &entryBlock = func.getBody().front();
+  auto blockArgs = entryBlock.getArguments();
+  auto ftype = func.getFunctionType();
+  unsigned inputs = func.getNumArguments();
+  unsigned outputs = func.getNumResults();
+  if (inputs == 0) {
+    errs() << "Function " << toplevelFunction << " is expected to have "
+           << "at least one dummy argument.\n";
+    return true;
+  }
+  if (outputs == 0) {
+    errs() << "Function " << toplevelFunction << " is expected to have "
+           << "at least one dummy result.\n";
+    return true;
+  }
+  unsigned realInputs = inputs - 1;
+  unsigned realOutputs = outputs - 1;
+  if (inputArgs.size() != realInputs) {
+    errs() << "Toplevel function " << toplevelFunction << " has " << realInputs
+           << " actual arguments, but " << inputArgs.size()
+           << " arguments were provided on the command line.\n";
+    return true;
+  }
+
+  values.assign(slotTypes.size(), 0);
+  times.assign(slotTypes.size(), 0.0);
+  valid.assign(slotTypes.size(), false);
+  queued.assign(nodes.size(), false);
+  store.clear();
+  for (int64_t size : bufferSizes)
+    store.emplace_back(size, 0);
+
+  // Bind the arguments.
+  unsigned nextBuffer = 0;
+  for (unsigned i = 0; i < realInputs; ++i) {
+    unsigned slot = slotIndices.lookup(blockArgs[i]);
+    if (slotTypes[slot].kind != SlotKind::MemRef) {
+      produce(slot, parseValue(slotTypes[slot], inputArgs[i]), 0.0);
+      continue;
+    }
+    unsigned buffer = nextBuffer++;
+    produce(slot, buffer, 0.0);
+    std::stringstream arg(inputArgs[i]);
+    std::string x;
+    size_t j = 0;
+    while (!arg.eof()) {
+      getline(arg, x, ',');
+      if (j >= store[buffer].size()) {
+        errs() << "Too many values provided for memref argument " << i
+               << ".\n";
+        return true;
+      }
+      store[buffer][j++] = parseValue(bufferTypes[buffer], x);
+    }
+  }
+  // Implicit none argument.
+  produce(slotIndices.lookup(blockArgs.back()), 0, 0.0);
+
+  // Initialize buffers with initial values.
+  for (auto bufferOp : func.getOps<BufferOp>()) {
+    if (!bufferOp.getInitValues())
+      continue;
+    unsigned slot = slotIndices.lookup(bufferOp.getResult());
+    produce(slot,
+            truncate(bufferOp.getInitValueArray().front(),
+                     slotTypes[slot].width),
+            0.0);
+    scheduleUses(slot);
+  }
+  for (auto blockArg : blockArgs)
+    scheduleUses(slotIndices.lookup(blockArg));
+
+  // Main execution loop.
+  const Node *returnNode = nullptr;
+  while (!returnNode) {
+    if (readyQueue.empty()) {
+      errs() << "Execution of " << toplevelFunction
+             << " deadlocked before reaching the return operation.\n";
+      return true;
+    }
+    unsigned index = readyQueue.front();
+    readyQueue.pop_front();
+    queued[index] = false;
+    const Node &node = nodes[index];
+
+    if (node.kind < NodeKind::Return) {
+      if (!fireHandshake(node))
+        schedule(index);
+      else
+        ++nodesFired;
+      if (failedFlag)
+        return true;
+      continue;
+    }
+
+    // All other operations wait for all of their operands.
+    if (!llvm::all_of(getOperands(node),
+                      [&](unsigned slot) { return valid[slot]; })) {
+      schedule(index);
+      continue;
+    }
+    ++nodesFired;
+    if (node.kind == NodeKind::Return) {
+      returnNode = &node;
+      break;
+    }
+    if (failed(fireArith(node)))
+      return true;
+  }
+
+  // Print the results and the final contents of memref arguments.
+  auto returnOperands = getOperands(*returnNode);
+  double time = 0.0;
+  for (unsigned i = 0; i < realOutputs; ++i) {
+    unsigned slot = returnOperands[i];
+    printValue(outs(), slotTypes[slot], values[slot]);
+    outs() << " ";
+    time = std::max(time, times[slot]);
+  }
+  nextBuffer = 0;
+  for (unsigned i = 0; i < realInputs; ++i) {
+    if (!isa<MemRefType>(ftype.getInput(i)))
+      continue;
+    unsigned buffer = nextBuffer++;
+    for (auto [j, value] : llvm::enumerate(store[buffer])) {
+      if (j != 0)
+        outs() << ",";
+      printValue(outs(), bufferTypes[buffer], value);
+    }
+    outs() << " ";
+  }
+  outs() << "\n";
+
+  compiledSimulatedTime += (int)time;
+  return false;
+}
+
+std::optional<bool>
+circt::handshake::simulateCompiled(StringRef toplevelFunction,
+                                   ArrayRef<std::string> inputArgs,
+                                   mlir::OwningOpRef<mlir::ModuleOp> &module,
+                                   mlir::MLIRContext &) {
+  auto func = module->lookupSymbol<handshake::FuncOp>(toplevelFunction);
+  if (!func)
+    return std::nullopt;
+  CompiledExecuter executer;
+  if (failed(executer.compile(func)))
+    return std::nullopt;
+  return executer.run(toplevelFunction, inputArgs);
+}
@@ -43,6 +43,13 @@ static cl::opt<std::string>
                      cl::desc("The top-level function to execute"),
                      cl::init("main"), cl::cat(mainCategory));
 
+static cl::opt<bool> compiled(
+    "compiled",
+    cl::desc("Translate handshake.func top-level functions into a flat "
+             "execution plan before running them, falling back to the "
+             "interpreter for unsupported constructs"),
+    cl::init(false), cl::cat(mainCategory));
+
 int main(int argc, char **argv) {
   InitLLVM y(argc, argv);
 
@@ -90,5 +97,10 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  if (compiled)
+    if (auto result = handshake::simulateCompiled(toplevelFunction, inputArgs,
+                                                  module, context))
+      return *result;
+
   return handshake::simulate(toplevelFunction, inputArgs, module, context);
 }
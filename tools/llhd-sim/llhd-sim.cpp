@@ -0,0 +1,147 @@
+//===- llhd-sim.cpp - Event-driven simulation of LLHD designs -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements 'llhd-sim', which simulates a design made of `hw`
+// modules with `llhd` signals and processes, and writes a trace of all signal
+// changes.
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Dialect/Comb/CombDialect.h"
+#include "circt/Dialect/HW/HWDialect.h"
+#include "circt/Dialect/LLHD/IR/LLHDDialect.h"
+#include "circt/Dialect/LLHD/Simulator/Engine.h"
+#include "circt/Dialect/Seq/SeqDialect.h"
+#include "circt/Dialect/Sim/SimDialect.h"
+#include "circt/Support/Version.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlow.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Support/FileUtilities.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+using namespace llvm;
+using namespace mlir;
+using namespace circt;
+
+static cl::OptionCategory mainCategory("llhd-sim Options");
+
+static cl::opt<std::string> inputFilename(cl::Positional,
+                                          cl::desc("<input file>"),
+                                          cl::init("-"), cl::cat(mainCategory));
+
+static cl::opt<std::string> outputFilename("o",
+                                           cl::desc("Trace output filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"),
+                                           cl::cat(mainCategory));
+
+static cl::opt<std::string> root("root", cl::desc("The top-level module"),
+                                 cl::value_desc("name"), cl::init("root"),
+                                 cl::cat(mainCategory));
+static cl::alias rootAlias("r", cl::desc("Alias for -root"),
+                           cl::aliasopt(root), cl::cat(mainCategory));
+
+static cl::opt<uint64_t>
+    maxSteps("n", cl::desc("Stop after this many time steps, including the "
+                           "initial one (0 for no limit)"),
+             cl::init(0), cl::cat(mainCategory));
+
+static cl::opt<uint64_t>
+    maxTime("T", cl::desc("Stop after this real time in picoseconds (0 for no "
+                          "limit)"),
+            cl::init(0), cl::cat(mainCategory));
+
+static cl::opt<uint64_t>
+    maxDeltas("max-deltas",
+              cl::desc("Maximum number of delta and epsilon steps within a "
+                       "single real time step"),
+              cl::init(100000), cl::cat(mainCategory));
+
+static cl::opt<llhd::sim::TraceFormat> traceFormat(
+    "trace-format", cl::desc("Format of the signal trace"),
+    cl::values(
+        clEnumValN(llhd::sim::TraceFormat::Full, "full",
+                   "All changes of all signals at every step"),
+        clEnumValN(llhd::sim::TraceFormat::Reduced, "reduced",
+                   "Only the signals of the root module"),
+        clEnumValN(llhd::sim::TraceFormat::Merged, "merged",
+                   "The changes within each real time step, merged"),
+        clEnumValN(llhd::sim::TraceFormat::MergedReduce, "merged-reduce",
+                   "Merged, only the signals of the root module"),
+        clEnumValN(llhd::sim::TraceFormat::NamedOnly, "named-only",
+                   "Only explicitly named signals"),
+        clEnumValN(llhd::sim::TraceFormat::None, "none", "No trace")),
+    cl::init(llhd::sim::TraceFormat::Full), cl::cat(mainCategory));
+
+static cl::opt<std::string>
+    vcdFilename("vcd", cl::desc("Also write a value change dump to a file"),
+                cl::value_desc("filename"), cl::cat(mainCategory));
+
+/// Simulate the root module of the input file.
+static LogicalResult executeSim(MLIRContext &context) {
+  SourceMgr sourceMgr;
+  SourceMgrDiagnosticHandler diagHandler(sourceMgr, &context);
+  auto module = parseSourceFile<ModuleOp>(inputFilename, sourceMgr, &context);
+  if (!module)
+    return failure();
+
+  llhd::sim::Engine engine(*module, root);
+  if (failed(engine.elaborate()))
+    return failure();
+
+  std::string errorMessage;
+  auto outputFile = openOutputFile(outputFilename, &errorMessage);
+  if (!outputFile) {
+    errs() << errorMessage << "\n";
+    return failure();
+  }
+  std::unique_ptr<ToolOutputFile> vcdFile;
+  if (!vcdFilename.empty()) {
+    vcdFile = openOutputFile(vcdFilename, &errorMessage);
+    if (!vcdFile) {
+      errs() << errorMessage << "\n";
+      return failure();
+    }
+  }
+
+  llhd::sim::EngineOptions options;
+  options.maxSteps = maxSteps;
+  options.maxTime = maxTime * 1000;
+  options.maxDeltas = maxDeltas;
+  options.traceFormat = traceFormat;
+  if (failed(engine.run(options, outputFile->os(),
+                        vcdFile ? &vcdFile->os() : nullptr)))
+    return failure();
+
+  outputFile->keep();
+  if (vcdFile)
+    vcdFile->keep();
+  return success();
+}
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+  setBugReportMsg(circtBugReportMsg);
+  cl::HideUnrelatedOptions(mainCategory);
+  registerMLIRContextCLOptions();
+  cl::AddExtraVersionPrinter(
+      [](raw_ostream &os) { os << getCirctVersion() << '\n'; });
+  cl::ParseCommandLineOptions(argc, argv, "LLHD simulator\n");
+
+  MLIRContext context;
+  context.loadDialect<comb::CombDialect, hw::HWDialect, llhd::LLHDDialect,
+                      seq::SeqDialect, sim::SimDialect,
+                      cf::ControlFlowDialect>();
+
+  // Use "exit" instead of returning to avoid tearing down the context.
+  exit(failed(executeSim(context)));
+}
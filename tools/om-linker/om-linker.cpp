@@ -28,6 +28,7 @@
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Support/Timing.h"
 #include "mlir/Support/ToolUtilities.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
@@ -130,7 +131,19 @@ static LogicalResult executeOMLinker(MLIRContext &context) {
     return success();
   };
 
-  if (failed(failableParallelForEachN(&context, 0, numFiles, loadFile))) {
+  // Parse the largest inputs first, such that a large input picked up late
+  // does not leave the other threads idle at the end.
+  SmallVector<uint64_t> fileSizes(numFiles, 0);
+  for (size_t i = 0; i != numFiles; ++i)
+    (void)llvm::sys::fs::file_size(inputFilenames[i], fileSizes[i]);
+  auto parseOrder = llvm::to_vector(llvm::seq<size_t>(0, numFiles));
+  llvm::stable_sort(parseOrder, [&](size_t a, size_t b) {
+    return fileSizes[a] > fileSizes[b];
+  });
+
+  if (failed(failableParallelForEachN(
+          &context, 0, numFiles,
+          [&](size_t i) { return loadFile(parseOrder[i]); }))) {
     errs() << "error reading inputs\n";
     return failure();
   }
@@ -0,0 +1,99 @@
+//===- TimingWheelTest.cpp - LLHD simulator event queue unit tests --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "circt/Dialect/LLHD/Simulator/TimingWheel.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <random>
+
+using namespace circt::llhd::sim;
+
+namespace {
+
+TEST(TimingWheelTest, AddDelay) {
+  SimTime now{5000, 2, 3};
+  EXPECT_EQ(now + SimTime({1000, 0, 0}), (SimTime{6000, 0, 0}));
+  EXPECT_EQ(now + SimTime({1000, 1, 2}), (SimTime{6000, 1, 2}));
+  EXPECT_EQ(now + SimTime({0, 1, 0}), (SimTime{5000, 3, 0}));
+  EXPECT_EQ(now + SimTime({0, 1, 4}), (SimTime{5000, 3, 4}));
+  EXPECT_EQ(now + SimTime({0, 0, 1}), (SimTime{5000, 2, 4}));
+}
+
+TEST(TimingWheelTest, OrderWithinSlot) {
+  TimingWheel<int> wheel(1000, 4);
+  wheel.schedule({0, 1, 0}, 1);
+  wheel.schedule({0, 0, 1}, 2);
+  wheel.schedule({0, 1, 0}, 3);
+  wheel.schedule({500, 0, 0}, 4);
+
+  std::vector<int> items;
+  EXPECT_EQ(wheel.popNext(items), (SimTime{0, 0, 1}));
+  EXPECT_EQ(items, std::vector<int>({2}));
+  items.clear();
+  EXPECT_EQ(wheel.popNext(items), (SimTime{0, 1, 0}));
+  EXPECT_EQ(items, std::vector<int>({1, 3}));
+  items.clear();
+  EXPECT_EQ(wheel.popNext(items), (SimTime{500, 0, 0}));
+  EXPECT_EQ(items, std::vector<int>({4}));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, Overflow) {
+  TimingWheel<int> wheel(1000, 4);
+  wheel.schedule({1000000, 0, 0}, 1);
+  wheel.schedule({3000, 0, 0}, 2);
+  wheel.schedule({1000000, 0, 0}, 3);
+  wheel.schedule({4000, 0, 0}, 4);
+
+  std::vector<int> items;
+  EXPECT_EQ(wheel.popNext(items), (SimTime{3000, 0, 0}));
+  EXPECT_EQ(wheel.popNext(items), (SimTime{4000, 0, 0}));
+  // Scheduled into the ring after the overflowing items, but due earlier.
+  wheel.schedule({5000, 0, 0}, 5);
+  EXPECT_EQ(wheel.popNext(items), (SimTime{5000, 0, 0}));
+  EXPECT_EQ(wheel.popNext(items), (SimTime{1000000, 0, 0}));
+  EXPECT_EQ(items, std::vector<int>({2, 4, 5, 1, 3}));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, MatchesReferenceQueue) {
+  std::mt19937_64 rng(42);
+  for (unsigned iteration = 0; iteration < 50; ++iteration) {
+    TimingWheel<unsigned> wheel(rng() % 5 + 1, rng() % 8 + 1);
+    std::multimap<std::tuple<uint64_t, uint64_t, uint64_t, unsigned>,
+                  unsigned>
+        reference;
+    SimTime now;
+    unsigned nextItem = 0;
+    for (unsigned step = 0; step < 200; ++step) {
+      for (unsigned i = 0, e = rng() % 4; i < e; ++i) {
+        SimTime delay{rng() % 3 ? 0 : rng() % 100, rng() % 2, rng() % 3};
+        SimTime time = now + delay;
+        wheel.schedule(time, nextItem);
+        reference.insert(
+            {{time.time, time.delta, time.epsilon, nextItem}, nextItem});
+        ++nextItem;
+      }
+      if (wheel.empty()) {
+        EXPECT_TRUE(reference.empty());
+        continue;
+      }
+      std::vector<unsigned> items;
+      now = wheel.popNext(items);
+      for (auto item : items) {
+        auto it = reference.begin();
+        auto [time, delta, epsilon, order] = it->first;
+        EXPECT_EQ(now, (SimTime{time, delta, epsilon}));
+        EXPECT_EQ(item, it->second);
+        reference.erase(it);
+      }
+    }
+  }
+}
+
+} // namespace
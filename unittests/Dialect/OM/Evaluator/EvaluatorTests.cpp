@@ -523,6 +523,74 @@ TEST(EvaluatorTests, AnyCastParam) {
   ASSERT_EQ(innerFieldValue->getAs<mlir::IntegerAttr>().getValue(), 42);
 }
 
+TEST(EvaluatorTests, InstantiateObjectMemoizedInstances) {
+  StringRef mod =
+      "!leaf = !om.class.type<@Leaf>"
+      "!mid = !om.class.type<@Mid>"
+      "om.class @Leaf(%v: !om.integer) {"
+      "  om.class.field @v, %v : !om.integer"
+      "}"
+      "om.class @Mid(%v: !om.integer) {"
+      "  %0 = om.object @Leaf(%v) : (!om.integer) -> !leaf"
+      "  om.class.field @leaf, %0 : !leaf"
+      "}"
+      "om.class @Top() {"
+      "  %0 = om.constant #om.integer<1 : si8> : !om.integer"
+      "  %1 = om.constant #om.integer<1 : si8> : !om.integer"
+      "  %2 = om.constant #om.integer<2 : si8> : !om.integer"
+      "  %a = om.object @Mid(%0) : (!om.integer) -> !mid"
+      "  %b = om.object @Mid(%1) : (!om.integer) -> !mid"
+      "  %c = om.object @Mid(%2) : (!om.integer) -> !mid"
+      "  om.class.field @a, %a : !mid"
+      "  om.class.field @b, %b : !mid"
+      "  om.class.field @c, %c : !mid"
+      "}";
+
+  DialectRegistry registry;
+  registry.insert<OMDialect>();
+
+  MLIRContext context(registry);
+  context.getOrLoadDialect<OMDialect>();
+
+  OwningOpRef<ModuleOp> owning =
+      parseSourceString<ModuleOp>(mod, ParserConfig(&context));
+
+  auto getField = [](const EvaluatorValuePtr &object, StringRef name) {
+    return llvm::cast<evaluator::ObjectValue>(object.get())
+        ->getField(name)
+        .value();
+  };
+
+  EvaluatorOptions options;
+  options.memoizeInstances = true;
+  Evaluator evaluator(owning.get(), options);
+  auto result = evaluator.instantiate(StringAttr::get(&context, "Top"), {});
+  ASSERT_TRUE(succeeded(result));
+
+  // Every instance has its own Object, but identical instances share values.
+  auto a = getField(result.value(), "a");
+  auto b = getField(result.value(), "b");
+  auto c = getField(result.value(), "c");
+  ASSERT_NE(a, b);
+  ASSERT_EQ(getField(a, "leaf"), getField(b, "leaf"));
+  ASSERT_NE(getField(a, "leaf"), getField(c, "leaf"));
+  ASSERT_EQ(1u, evaluator.getNumMemoizedInstances());
+  ASSERT_EQ(2, llvm::cast<evaluator::AttributeValue>(
+                   getField(getField(c, "leaf"), "v").get())
+                   ->getAs<circt::om::IntegerAttr>()
+                   .getValue()
+                   .getInt());
+
+  // Instances are evaluated separately by default.
+  Evaluator plainEvaluator(owning.get());
+  result = plainEvaluator.instantiate(StringAttr::get(&context, "Top"), {});
+  ASSERT_TRUE(succeeded(result));
+  a = getField(result.value(), "a");
+  b = getField(result.value(), "b");
+  ASSERT_NE(getField(a, "leaf"), getField(b, "leaf"));
+  ASSERT_EQ(0u, plainEvaluator.getNumMemoizedInstances());
+}
+
 TEST(EvaluatorTests, InstantiateGraphRegion) {
   StringRef module =
       "!ty = !om.class.type<@LinkedList>"
@@ -987,6 +1055,149 @@ TEST(EvaluatorTests, IntegerBinaryArithmeticObjectsDelayed) {
                    .getValue());
 }
 
+TEST(EvaluatorTests, LazyEvaluation) {
+  StringRef mod =
+      "om.class @Class1(%input: !om.integer) {"
+      "  %0 = om.constant #om.integer<1 : si3> : !om.integer"
+      "  om.class.field @value, %0 : !om.integer"
+      "  om.class.field @input, %input : !om.integer"
+      "}"
+      ""
+      "om.class @Bad() {"
+      "  %0 = om.constant #om.integer<8 : si5> : !om.integer"
+      "  %1 = om.constant #om.integer<-2 : si3> : !om.integer"
+      "  %2 = om.integer.shr %0, %1 : !om.integer"
+      "  om.class.field @result, %2 : !om.integer"
+      "}"
+      ""
+      "om.class @LazyEvaluation() {"
+      "  %0 = om.object @Class1(%2) : (!om.integer) -> !om.class.type<@Class1>"
+      "  %1 = om.object.field %0, [@value] : "
+      "(!om.class.type<@Class1>) -> !om.integer"
+      "  %2 = om.integer.add %1, %1 : !om.integer"
+      "  %3 = om.object @Bad() : () -> !om.class.type<@Bad>"
+      "  om.class.field @result, %2 : !om.integer"
+      "  om.class.field @bad, %3 : !om.class.type<@Bad>"
+      "}";
+
+  DialectRegistry registry;
+  registry.insert<OMDialect>();
+
+  MLIRContext context(registry);
+  context.getOrLoadDialect<OMDialect>();
+
+  bool sawError = false;
+  context.getDiagEngine().registerHandler([&](Diagnostic &diag) {
+    if (StringRef(diag.str()).starts_with("'om.integer.shr'"))
+      sawError = true;
+  });
+
+  OwningOpRef<ModuleOp> owning =
+      parseSourceString<ModuleOp>(mod, ParserConfig(&context));
+
+  // Eager evaluation fails on the unused object.
+  Evaluator eagerEvaluator(owning.get());
+  ASSERT_TRUE(failed(eagerEvaluator.instantiate(
+      StringAttr::get(&context, "LazyEvaluation"), {})));
+  ASSERT_TRUE(sawError);
+  sawError = false;
+
+  EvaluatorOptions options;
+  options.lazy = true;
+  Evaluator evaluator(owning.get(), options);
+
+  auto result =
+      evaluator.instantiate(StringAttr::get(&context, "LazyEvaluation"), {});
+  ASSERT_TRUE(succeeded(result));
+
+  auto *object = llvm::cast<evaluator::ObjectValue>(result.value().get());
+  ASSERT_FALSE(object->isExpanded());
+
+  // Reading a field evaluates the class body and the objects it reads from.
+  auto fieldValue = object->getField("result").value();
+  ASSERT_EQ(2, llvm::cast<evaluator::AttributeValue>(fieldValue.get())
+                   ->getAs<circt::om::IntegerAttr>()
+                   .getValue()
+                   .getValue());
+
+  // Objects whose fields were never read are not evaluated.
+  auto *bad =
+      llvm::cast<evaluator::ObjectValue>(object->getField("bad").value().get());
+  ASSERT_FALSE(bad->isExpanded());
+  ASSERT_FALSE(sawError);
+
+  ASSERT_TRUE(failed(bad->getField("result")));
+  ASSERT_TRUE(sawError);
+}
+
+TEST(EvaluatorTests, LazyEvaluationFailure) {
+  StringRef mod =
+      "om.class @Bad() {"
+      "  %0 = om.constant #om.integer<8 : si5> : !om.integer"
+      "  %1 = om.constant #om.integer<-2 : si3> : !om.integer"
+      "  %2 = om.integer.shr %0, %1 : !om.integer"
+      "  om.class.field @result, %2 : !om.integer"
+      "}"
+      ""
+      "om.class @Reader(%bad: !om.class.type<@Bad>) {"
+      "  %0 = om.object.field %bad, [@result] : "
+      "(!om.class.type<@Bad>) -> !om.integer"
+      "  om.class.field @result, %0 : !om.integer"
+      "}"
+      ""
+      "om.class @LazyEvaluationFailure() {"
+      "  %0 = om.object @Bad() : () -> !om.class.type<@Bad>"
+      "  %1 = om.object @Reader(%0) : "
+      "(!om.class.type<@Bad>) -> !om.class.type<@Reader>"
+      "  om.class.field @bad, %0 : !om.class.type<@Bad>"
+      "  om.class.field @reader, %1 : !om.class.type<@Reader>"
+      "}";
+
+  DialectRegistry registry;
+  registry.insert<OMDialect>();
+
+  MLIRContext context(registry);
+  context.getOrLoadDialect<OMDialect>();
+
+  unsigned numShrErrors = 0, numStickyErrors = 0;
+  context.getDiagEngine().registerHandler([&](Diagnostic &diag) {
+    if (StringRef(diag.str()).starts_with("'om.integer.shr'"))
+      ++numShrErrors;
+    if (StringRef(diag.str()).ends_with("the evaluation of the object failed "
+                                        "before"))
+      ++numStickyErrors;
+  });
+
+  OwningOpRef<ModuleOp> owning =
+      parseSourceString<ModuleOp>(mod, ParserConfig(&context));
+
+  EvaluatorOptions options;
+  options.lazy = true;
+  Evaluator evaluator(owning.get(), options);
+
+  auto result = evaluator.instantiate(
+      StringAttr::get(&context, "LazyEvaluationFailure"), {});
+  ASSERT_TRUE(succeeded(result));
+
+  auto *object = llvm::cast<evaluator::ObjectValue>(result.value().get());
+  auto *bad =
+      llvm::cast<evaluator::ObjectValue>(object->getField("bad").value().get());
+  auto *reader = llvm::cast<evaluator::ObjectValue>(
+      object->getField("reader").value().get());
+
+  // Reading the field evaluates the Bad object through om.object.field.
+  ASSERT_TRUE(failed(reader->getField("result")));
+  ASSERT_EQ(numShrErrors, 1u);
+  ASSERT_EQ(numStickyErrors, 0u);
+
+  // Later reads fail without evaluating anything again, both for the forced
+  // object and for the object it read from.
+  ASSERT_TRUE(failed(reader->getField("result")));
+  ASSERT_TRUE(failed(bad->getField("result")));
+  ASSERT_EQ(numShrErrors, 1u);
+  ASSERT_EQ(numStickyErrors, 2u);
+}
+
 TEST(EvaluatorTests, IntegerBinaryArithmeticWidthMismatch) {
   StringRef mod = "om.class @IntegerBinaryArithmeticWidthMismatch() {"
                   "  %0 = om.constant #om.integer<1 : si3> : !om.integer"
@@ -398,6 +398,54 @@ TEST(PrettyPrinterTest, Builder) {
   EXPECT_EQ(out.str(), StringRef("test\ntest\ntest"));
 }
 
+TEST(PrettyPrinterTest, FittingGroups) {
+  SmallString<128> out;
+  raw_svector_ostream os(out);
+
+  {
+    PrettyPrinter pp(os, 20);
+    TokenBuilder<> b(pp);
+    b.ibox(2);
+    b.literal("aaaa");
+    b.space();
+    {
+      b.cbox(0);
+      b.literal("b");
+      b.space();
+      b.literal("c");
+      b.end();
+    }
+    b.space();
+    b.literal("dddddddddddddddd");
+    b.end();
+    b.newline();
+    b.eof();
+  }
+  EXPECT_EQ(out.str(), StringRef("aaaa b c\n  dddddddddddddddd\n"));
+
+  // Many small groups that fit within a group that breaks.
+  out.clear();
+  {
+    PrettyPrinter pp(os, 10);
+    TokenBuilder<> b(pp);
+    b.cbox(0);
+    for (unsigned i = 0; i < 1000; ++i) {
+      b.ibox(2);
+      b.literal("ab");
+      b.space();
+      b.literal("cd");
+      b.end();
+      b.space();
+    }
+    b.end();
+    b.eof();
+  }
+  std::string expected;
+  for (unsigned i = 0; i < 1000; ++i)
+    expected += "ab cd\n";
+  EXPECT_EQ(out.str(), StringRef(expected));
+}
+
 TEST(PrettyPrinterTest, Stream) {
   SmallString<128> out;
   raw_svector_ostream os(out);